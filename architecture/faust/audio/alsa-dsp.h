@@ -56,6 +56,7 @@ Some default parameters of Faust's ALSA applications are controlled by the follo
     FAUST2ALSA_FREQUENCY= 44100
     FAUST2ALSA_BUFFER   = 512
     FAUST2ALSA_PERIODS  = 2
+    FAUST2ALSA_MMAP     = 0     (1 : use the mmap access mode when available)
 
 */
 
@@ -86,6 +87,77 @@ Some default parameters of Faust's ALSA applications are controlled by the follo
 #define check_error_msg(err,msg) if (err) { fprintf(stderr, "%s:%d, %s : %s(%d)\n", __FILE__, __LINE__, msg, snd_strerror(err), err); exit(1); }
 #define display_error_msg(err,msg) if (err) { fprintf(stderr, "%s:%d, %s : %s(%d)\n", __FILE__, __LINE__, msg, snd_strerror(err), err); }
 
+/******************************************************************************
+*******************************************************************************
+
+							SAMPLE FORMAT CONVERSIONS
+
+	The card side is accessed with a stride (in samples, or in bytes for the
+	packed 24-bits format) so that the same kernels are used for interleaved,
+	non-interleaved and mmap buffers. The float side is contiguous. There is
+	no dependency between iterations and the scale factors are floats, so
+	these loops can be vectorized by the C++ compiler.
+
+*******************************************************************************
+*******************************************************************************/
+
+// largest float not above INT_MAX (float(INT_MAX) would overflow when converted back)
+static const float kMaxS32 = 2147483520.0f;
+static const float kMaxS24 = 8388607.0f;
+
+static inline void convertS16ToFloat(const short* src, int stride, float* dst, int count)
+{
+    const float k = 1.0f/float(SHRT_MAX);
+    for (int s = 0; s < count; s++) dst[s] = float(src[s*stride]) * k;
+}
+
+static inline void convertS32ToFloat(const int32* src, int stride, float* dst, int count)
+{
+    const float k = 1.0f/float(INT_MAX);
+    for (int s = 0; s < count; s++) dst[s] = float(src[s*stride]) * k;
+}
+
+static inline void convertS24ToFloat(const unsigned char* src, int stride, float* dst, int count)
+{
+    const float k = 1.0f/kMaxS24;
+    for (int s = 0; s < count; s++) {
+        const unsigned char* p = src + s*stride;
+        int32 x = int32(((unsigned int)p[0] << 8) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 24));
+        dst[s] = float(x >> 8) * k;
+    }
+}
+
+static inline void convertFloatToFloat(const float* src, int stride, float* dst, int count)
+{
+    for (int s = 0; s < count; s++) dst[s] = src[s*stride];
+}
+
+static inline float clip(float x) { return (x > 1.0f) ? 1.0f : ((x < -1.0f) ? -1.0f : x); }
+
+static inline void convertFloatToS16(const float* src, short* dst, int stride, int count)
+{
+    for (int s = 0; s < count; s++) dst[s*stride] = short(clip(src[s]) * float(SHRT_MAX));
+}
+
+static inline void convertFloatToS32(const float* src, int32* dst, int stride, int count)
+{
+    for (int s = 0; s < count; s++) dst[s*stride] = int32(clip(src[s]) * kMaxS32);
+}
+
+static inline void convertFloatToS24(const float* src, unsigned char* dst, int stride, int count)
+{
+    for (int s = 0; s < count; s++) {
+        int32 x = int32(clip(src[s]) * kMaxS24);
+        unsigned char* p = dst + s*stride;
+        p[0] = (unsigned char)x; p[1] = (unsigned char)(x >> 8); p[2] = (unsigned char)(x >> 16);
+    }
+}
+
+static inline void convertFloatToFloat(const float* src, float* dst, int stride, int count)
+{
+    for (int s = 0; s < count; s++) dst[s*stride] = src[s];
+}
+
 
 /**
  * Used to set the priority and scheduling of the audi#include <sys/types.h>
@@ -133,6 +205,8 @@ class AudioParam
 	unsigned int	fSoftInputs;
 	unsigned int	fSoftOutputs;
 
+	bool			fMmap;
+
   public :
 	AudioParam() :
 		fCardName("hw:0"),
@@ -140,7 +214,8 @@ class AudioParam
 		fBuffering(512),
 		fPeriods(2),
 		fSoftInputs(2),
-		fSoftOutputs(2)
+		fSoftOutputs(2),
+		fMmap(false)
 	{}
 
 	AudioParam&	cardName(const char* n)	{ fCardName = n; 		return *this; }
@@ -149,6 +224,7 @@ class AudioParam
 	AudioParam&	periods(int p)			{ fPeriods = p; 		return *this; }
 	AudioParam&	inputs(int n)			{ fSoftInputs = n; 		return *this; }
 	AudioParam&	outputs(int n)			{ fSoftOutputs = n; 	return *this; }
+	AudioParam&	useMmap(bool b)			{ fMmap = b; 			return *this; }
 };
 
 /**
@@ -164,6 +240,7 @@ class AudioInterface : public AudioParam
 
 	snd_pcm_format_t 		fSampleFormat;
 	snd_pcm_access_t 		fSampleAccess;
+	int						fSampleSize;		// in bytes
 
 	unsigned int			fCardInputs;
 	unsigned int			fCardOutputs;
@@ -182,9 +259,20 @@ class AudioInterface : public AudioParam
 	void*		fOutputCardChannels[256];
 
 	// non interleaved mod, floating point software buffers
+	float*		fInputSoftBuffers[256];
+	float*		fOutputSoftBuffers[256];
+
+	// channels used by the dsp : the software buffers, or the mmaped
+	// period buffers when they can be used directly (float format)
 	float*		fInputSoftChannels[256];
 	float*		fOutputSoftChannels[256];
 
+	// mmaped period buffers used directly by the dsp, to be committed by write()
+	bool					fInputMapped;
+	bool					fOutputMapped;
+	snd_pcm_uframes_t		fInputOffset;
+	snd_pcm_uframes_t		fOutputOffset;
+
  public :
 
 	const char*	cardName()				{ return fCardName;  	}
@@ -197,6 +285,9 @@ class AudioInterface : public AudioParam
 
 	bool		duplexMode()			{ return fDuplexMode; }
 
+	bool		mmapMode()				{ return (fSampleAccess == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+												|| (fSampleAccess == SND_PCM_ACCESS_MMAP_NONINTERLEAVED); }
+
 	AudioInterface(const AudioParam& ap = AudioParam()) : AudioParam(ap)
 	{
 
@@ -204,6 +295,8 @@ class AudioInterface : public AudioParam
 		fOutputDevice 			= 0;
 		fInputParams			= 0;
 		fOutputParams			= 0;
+		fInputMapped			= false;
+		fOutputMapped			= false;
 	}
 
 	/**
@@ -224,10 +317,10 @@ class AudioInterface : public AudioParam
 		snd_pcm_hw_params_set_channels_near(fOutputDevice, fOutputParams, &fCardOutputs);
 		err = snd_pcm_hw_params (fOutputDevice, fOutputParams );	check_error(err);
 
-		// allocate alsa output buffers
+		// allocate alsa output buffers (not needed in mmap mode)
 		if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
 			fOutputCardBuffer = calloc(interleavedBufferSize(fOutputParams), 1);
-		} else {
+		} else if (fSampleAccess == SND_PCM_ACCESS_RW_NONINTERLEAVED) {
 			for (unsigned int i = 0; i < fCardOutputs; i++) {
 				fOutputCardChannels[i] = calloc(noninterleavedBufferSize(fOutputParams), 1);
 			}
@@ -259,10 +352,10 @@ class AudioInterface : public AudioParam
 			snd_pcm_hw_params_set_channels_near(fInputDevice, fInputParams, &fCardInputs);
 			err = snd_pcm_hw_params (fInputDevice,  fInputParams );	 	check_error(err);
 
-			// allocation of alsa buffers
+			// allocation of alsa buffers (not needed in mmap mode)
 			if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
 				fInputCardBuffer = calloc(interleavedBufferSize(fInputParams), 1);
-			} else {
+			} else if (fSampleAccess == SND_PCM_ACCESS_RW_NONINTERLEAVED) {
 				for (unsigned int i = 0; i < fCardInputs; i++) {
 					fInputCardChannels[i] = calloc(noninterleavedBufferSize(fInputParams), 1);
 				}
@@ -277,17 +370,11 @@ class AudioInterface : public AudioParam
 		fChanOutputs = max(fSoftOutputs, fCardOutputs);		assert (fChanOutputs < 256);
 
 		for (unsigned int i = 0; i < fChanInputs; i++) {
-			fInputSoftChannels[i] = (float*) calloc (fBuffering, sizeof(float));
-			for (unsigned int j = 0; j < fBuffering; j++) {
-				fInputSoftChannels[i][j] = 0.0;
-			}
+			fInputSoftBuffers[i] = fInputSoftChannels[i] = (float*) calloc (fBuffering, sizeof(float));
 		}
 
 		for (unsigned int i = 0; i < fChanOutputs; i++) {
-			fOutputSoftChannels[i] = (float*) calloc (fBuffering, sizeof(float));
-			for (unsigned int j = 0; j < fBuffering; j++) {
-				fOutputSoftChannels[i][j] = 0.0;
-			}
+			fOutputSoftBuffers[i] = fOutputSoftChannels[i] = (float*) calloc (fBuffering, sizeof(float));
 		}
 	}
 
@@ -299,22 +386,39 @@ class AudioInterface : public AudioParam
 		err = snd_pcm_hw_params_any	( stream, params );
 		check_error_msg(err, "unable to init parameters")
 
-		// set alsa access mode (and fSampleAccess field) either to non interleaved or interleaved
+		// set alsa access mode (and fSampleAccess field) either to non interleaved or interleaved,
+		// using the mmaped buffers of the card when requested and available
 
-		err = snd_pcm_hw_params_set_access (stream, params, SND_PCM_ACCESS_RW_NONINTERLEAVED );
+		err = -1;
+		if (fMmap) {
+			err = snd_pcm_hw_params_set_access (stream, params, SND_PCM_ACCESS_MMAP_NONINTERLEAVED );
+			if (err) {
+				err = snd_pcm_hw_params_set_access (stream, params, SND_PCM_ACCESS_MMAP_INTERLEAVED );
+			}
+		}
+		if (err) {
+			err = snd_pcm_hw_params_set_access (stream, params, SND_PCM_ACCESS_RW_NONINTERLEAVED );
+		}
 		if (err) {
 			err = snd_pcm_hw_params_set_access (stream, params, SND_PCM_ACCESS_RW_INTERLEAVED );
 			check_error_msg(err, "unable to set access mode neither to non-interleaved or to interleaved");
 		}
 		snd_pcm_hw_params_get_access(params, &fSampleAccess);
 
-		// search for 32-bits or 16-bits format
-		err = snd_pcm_hw_params_set_format (stream, params, SND_PCM_FORMAT_S32);
+		// search for float, 32-bits, 24-bits or 16-bits format
+		err = snd_pcm_hw_params_set_format (stream, params, SND_PCM_FORMAT_FLOAT);
+		if (err) {
+			err = snd_pcm_hw_params_set_format (stream, params, SND_PCM_FORMAT_S32);
+		}
+		if (err) {
+			err = snd_pcm_hw_params_set_format (stream, params, SND_PCM_FORMAT_S24_3LE);
+		}
 		if (err) {
 			err = snd_pcm_hw_params_set_format (stream, params, SND_PCM_FORMAT_S16);
-		 	check_error_msg(err, "unable to set format to either 32-bits or 16-bits");
+		 	check_error_msg(err, "unable to set format to either float, 32-bits, 24-bits or 16-bits");
 		}
 		snd_pcm_hw_params_get_format(params, &fSampleFormat);
+		fSampleSize = snd_pcm_format_physical_width(fSampleFormat) / 8;
 		// set sample frequency
 		snd_pcm_hw_params_set_rate_near (stream, params, &fFrequency, 0);
 
@@ -346,6 +450,89 @@ class AudioInterface : public AudioParam
 	void close()
 	{}
 
+	/**
+	 * Convert count samples of a card buffer to floats
+	 * @param src the first sample of the channel
+	 * @param stride the distance between two samples of the channel, in bytes
+	 */
+	void convertInput(const char* src, int stride, float* dst, int count)
+	{
+		if (fSampleFormat == SND_PCM_FORMAT_S16) {
+			convertS16ToFloat((const short*)src, stride/sizeof(short), dst, count);
+		} else if (fSampleFormat == SND_PCM_FORMAT_S32) {
+			convertS32ToFloat((const int32*)src, stride/sizeof(int32), dst, count);
+		} else if (fSampleFormat == SND_PCM_FORMAT_S24_3LE) {
+			convertS24ToFloat((const unsigned char*)src, stride, dst, count);
+		} else if (fSampleFormat == SND_PCM_FORMAT_FLOAT) {
+			convertFloatToFloat((const float*)src, stride/sizeof(float), dst, count);
+		} else {
+			printf("unrecognized input sample format : %u\n", fSampleFormat);
+			exit(1);
+		}
+	}
+
+	/**
+	 * Convert count floats to samples of a card buffer
+	 * @param dst the first sample of the channel
+	 * @param stride the distance between two samples of the channel, in bytes
+	 */
+	void convertOutput(const float* src, char* dst, int stride, int count)
+	{
+		if (fSampleFormat == SND_PCM_FORMAT_S16) {
+			convertFloatToS16(src, (short*)dst, stride/sizeof(short), count);
+		} else if (fSampleFormat == SND_PCM_FORMAT_S32) {
+			convertFloatToS32(src, (int32*)dst, stride/sizeof(int32), count);
+		} else if (fSampleFormat == SND_PCM_FORMAT_S24_3LE) {
+			convertFloatToS24(src, (unsigned char*)dst, stride, count);
+		} else if (fSampleFormat == SND_PCM_FORMAT_FLOAT) {
+			convertFloatToFloat(src, (float*)dst, stride/sizeof(float), count);
+		} else {
+			printf("unrecognized output sample format : %u\n", fSampleFormat);
+			exit(1);
+		}
+	}
+
+	/**
+	 * Address of the sample at offset in a mmaped channel area
+	 */
+	static char* areaAddress(const snd_pcm_channel_area_t& area, snd_pcm_uframes_t offset)
+	{
+		return (char*)area.addr + (area.first + offset*area.step)/8;
+	}
+
+	/**
+	 * True when the mmaped channels are contiguous floats the dsp can use directly
+	 */
+	bool isDirect(const snd_pcm_channel_area_t* areas, unsigned int channels)
+	{
+		if (fSampleFormat != SND_PCM_FORMAT_FLOAT) return false;
+		for (unsigned int c = 0; c < channels; c++) {
+			if ((areas[c].step != 8*sizeof(float)) || (areas[c].first % (8*sizeof(float)) != 0)) return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Wait until a full period can be transfered in mmap mode, recovering
+	 * from xruns and starting the stream when needed
+	 */
+	void waitPeriod(snd_pcm_t* device)
+	{
+		while (true) {
+			snd_pcm_sframes_t avail = snd_pcm_avail_update(device);
+			if (avail < 0) {
+				snd_pcm_prepare(device);
+			} else if (avail >= (snd_pcm_sframes_t)fBuffering) {
+				return;
+			} else if (snd_pcm_state(device) == SND_PCM_STATE_PREPARED) {
+				// playback buffer full or capture not started yet
+				snd_pcm_start(device);
+			} else {
+				snd_pcm_wait(device, 1000);
+			}
+		}
+	}
+
 	/**
 	 * Read audio samples from the audio card. Convert samples to floats and take
 	 * care of interleaved buffers
@@ -361,27 +548,9 @@ class AudioInterface : public AudioParam
 				 //check_error_msg(err, "preparing input stream");
 			}
 
-			if (fSampleFormat == SND_PCM_FORMAT_S16) {
-
-				short* buffer16b = (short*)fInputCardBuffer;
-				for (unsigned int s = 0; s < fBuffering; s++) {
-					for (unsigned int c = 0; c < fCardInputs; c++) {
-						fInputSoftChannels[c][s] = float(buffer16b[c + s*fCardInputs])*(1.0/float(SHRT_MAX));
-					}
-				}
-
-			} else if (fSampleFormat == SND_PCM_FORMAT_S32) {
-
-				int32* buffer32b = (int32*)fInputCardBuffer;
-				for (unsigned int s = 0; s < fBuffering; s++) {
-					for (unsigned int c = 0; c < fCardInputs; c++) {
-						fInputSoftChannels[c][s] = float(buffer32b[c + s*fCardInputs])*(1.0/float(INT_MAX));
-					}
-				}
-			} else {
-
-				printf("unrecognized input sample format : %u\n", fSampleFormat);
-				exit(1);
+			// channel by channel, so that the float buffers are written contiguously
+			for (unsigned int c = 0; c < fCardInputs; c++) {
+				convertInput((const char*)fInputCardBuffer + c*fSampleSize, fCardInputs*fSampleSize, fInputSoftChannels[c], fBuffering);
 			}
 
 		} else if (fSampleAccess == SND_PCM_ACCESS_RW_NONINTERLEAVED) {
@@ -393,26 +562,39 @@ class AudioInterface : public AudioParam
 				 //check_error_msg(err, "preparing input stream");
 			}
 
-			if (fSampleFormat == SND_PCM_FORMAT_S16) {
+			for (unsigned int c = 0; c < fCardInputs; c++) {
+				convertInput((const char*)fInputCardChannels[c], fSampleSize, fInputSoftChannels[c], fBuffering);
+			}
 
-				for (unsigned int c = 0; c < fCardInputs; c++) {
-					short* chan16b = (short*)fInputCardChannels[c];
-					for (unsigned int s = 0; s < fBuffering; s++) {
-						fInputSoftChannels[c][s] = float(chan16b[s])*(1.0/float(SHRT_MAX));
+		} else if (mmapMode()) {
+
+			waitPeriod(fInputDevice);
+			snd_pcm_uframes_t done = 0;
+			while (done < fBuffering) {
+				const snd_pcm_channel_area_t* areas;
+				snd_pcm_uframes_t offset, frames = fBuffering - done;
+				int err = snd_pcm_mmap_begin(fInputDevice, &areas, &offset, &frames);
+				if (err < 0) {
+					snd_pcm_prepare(fInputDevice);
+					return;
+				}
+				if ((done == 0) && (frames == fBuffering) && isDirect(areas, fCardInputs)) {
+					// the dsp reads the period buffer, committed after the computation by write()
+					for (unsigned int c = 0; c < fCardInputs; c++) {
+						fInputSoftChannels[c] = (float*)areaAddress(areas[c], offset);
 					}
+					fInputOffset = offset;
+					fInputMapped = true;
+					return;
 				}
-
-			} else if (fSampleFormat == SND_PCM_FORMAT_S32) {
-
 				for (unsigned int c = 0; c < fCardInputs; c++) {
-					int32* chan32b = (int32*)fInputCardChannels[c];
-					for (unsigned int s = 0; s < fBuffering; s++) {
-						fInputSoftChannels[c][s] = float(chan32b[s])*(1.0/float(INT_MAX));
-					}
+					convertInput(areaAddress(areas[c], offset), areas[c].step/8, fInputSoftBuffers[c] + done, frames);
 				}
-			} else {
-				printf("unrecognized input sample format : %u\n", fSampleFormat);
-				exit(1);
+				if (snd_pcm_mmap_commit(fInputDevice, offset, frames) < 0) {
+					snd_pcm_prepare(fInputDevice);
+					return;
+				}
+				done += frames;
 			}
 
 		} else {
@@ -420,39 +602,66 @@ class AudioInterface : public AudioParam
 		}
     }
 
+	/**
+	 * In mmap mode with float samples, map the output period buffer before
+	 * the computation, so that the dsp writes directly into it
+	 */
+	void prepareOutput()
+	{
+		if (!mmapMode() || (fSampleFormat != SND_PCM_FORMAT_FLOAT)) return;
+
+		waitPeriod(fOutputDevice);
+		const snd_pcm_channel_area_t* areas;
+		snd_pcm_uframes_t offset, frames = fBuffering;
+		if (snd_pcm_mmap_begin(fOutputDevice, &areas, &offset, &frames) < 0) return;
+
+		if ((frames == fBuffering) && isDirect(areas, fCardOutputs)) {
+			for (unsigned int c = 0; c < fCardOutputs; c++) {
+				fOutputSoftChannels[c] = (float*)areaAddress(areas[c], offset);
+			}
+			fOutputOffset = offset;
+			fOutputMapped = true;
+		} else {
+			// release the mapping, write() will convert the samples
+			snd_pcm_mmap_commit(fOutputDevice, offset, 0);
+		}
+	}
+
 	/**
 	 * write the output soft channels to the audio card. Convert sample
 	 * format and interleaves buffers when needed
 	 */
 	void write()
 	{
-		recovery :
-
-		if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
-
-			if (fSampleFormat == SND_PCM_FORMAT_S16) {
+		if (fInputMapped) {
+			// the dsp has read the input period buffer
+			if (snd_pcm_mmap_commit(fInputDevice, fInputOffset, fBuffering) < 0) {
+				snd_pcm_prepare(fInputDevice);
+			}
+			for (unsigned int c = 0; c < fCardInputs; c++) {
+				fInputSoftChannels[c] = fInputSoftBuffers[c];
+			}
+			fInputMapped = false;
+		}
 
-				short* buffer16b = (short*)fOutputCardBuffer;
-				for (unsigned int f = 0; f < fBuffering; f++) {
-					for (unsigned int c = 0; c < fCardOutputs; c++) {
-						float x = fOutputSoftChannels[c][f];
-						buffer16b[c + f*fCardOutputs] = short( max(min(x,1.0f),-1.0f) * float(SHRT_MAX) ) ;
-					}
-				}
+		if (fOutputMapped) {
+			// the dsp has written the output period buffer
+			if (snd_pcm_mmap_commit(fOutputDevice, fOutputOffset, fBuffering) < 0) {
+				snd_pcm_prepare(fOutputDevice);
+			}
+			for (unsigned int c = 0; c < fCardOutputs; c++) {
+				fOutputSoftChannels[c] = fOutputSoftBuffers[c];
+			}
+			fOutputMapped = false;
+			return;
+		}
 
-			} else if (fSampleFormat == SND_PCM_FORMAT_S32)  {
+		recovery :
 
-				int32* buffer32b = (int32*)fOutputCardBuffer;
-				for (unsigned int f = 0; f < fBuffering; f++) {
-					for (unsigned int c = 0; c < fCardOutputs; c++) {
-						float x = fOutputSoftChannels[c][f];
-						buffer32b[c + f*fCardOutputs] = int( max(min(x,1.0f),-1.0f) * float(INT_MAX) ) ;
-					}
-				}
-			} else {
+		if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
 
-				printf("unrecognized output sample format : %u\n", fSampleFormat);
-				exit(1);
+			for (unsigned int c = 0; c < fCardOutputs; c++) {
+				convertOutput(fOutputSoftChannels[c], (char*)fOutputCardBuffer + c*fSampleSize, fCardOutputs*fSampleSize, fBuffering);
 			}
 
 			int count = snd_pcm_writei(fOutputDevice, fOutputCardBuffer, fBuffering);
@@ -466,30 +675,8 @@ class AudioInterface : public AudioParam
 
 		} else if (fSampleAccess == SND_PCM_ACCESS_RW_NONINTERLEAVED) {
 
-			if (fSampleFormat == SND_PCM_FORMAT_S16) {
-
-				for (unsigned int c = 0; c < fCardOutputs; c++) {
-					short* chan16b = (short*) fOutputCardChannels[c];
-					for (unsigned int f = 0; f < fBuffering; f++) {
-						float x = fOutputSoftChannels[c][f];
-						chan16b[f] = short( max(min(x,1.0f),-1.0f) * float(SHRT_MAX) ) ;
-					}
-				}
-
-			} else if (fSampleFormat == SND_PCM_FORMAT_S32) {
-
-				for (unsigned int c = 0; c < fCardOutputs; c++) {
-					int32* chan32b = (int32*) fOutputCardChannels[c];
-					for (unsigned int f = 0; f < fBuffering; f++) {
-						float x = fOutputSoftChannels[c][f];
-						chan32b[f] = int( max(min(x,1.0f),-1.0f) * float(INT_MAX) ) ;
-					}
-				}
-
-			} else {
-
-				printf("unrecognized output sample format : %u\n", fSampleFormat);
-				exit(1);
+			for (unsigned int c = 0; c < fCardOutputs; c++) {
+				convertOutput(fOutputSoftChannels[c], (char*)fOutputCardChannels[c], fSampleSize, fBuffering);
 			}
 
 			int count = snd_pcm_writen(fOutputDevice, fOutputCardChannels, fBuffering);
@@ -500,6 +687,28 @@ class AudioInterface : public AudioParam
 				goto recovery;
 			}
 
+		} else if (mmapMode()) {
+
+			waitPeriod(fOutputDevice);
+			snd_pcm_uframes_t done = 0;
+			while (done < fBuffering) {
+				const snd_pcm_channel_area_t* areas;
+				snd_pcm_uframes_t offset, frames = fBuffering - done;
+				int err = snd_pcm_mmap_begin(fOutputDevice, &areas, &offset, &frames);
+				if (err < 0) {
+					snd_pcm_prepare(fOutputDevice);
+					return;
+				}
+				for (unsigned int c = 0; c < fCardOutputs; c++) {
+					convertOutput(fOutputSoftChannels[c] + done, areaAddress(areas[c], offset), areas[c].step/8, frames);
+				}
+				if (snd_pcm_mmap_commit(fOutputDevice, offset, frames) < 0) {
+					snd_pcm_prepare(fOutputDevice);
+					return;
+				}
+				done += frames;
+			}
+
 		} else {
 			check_error_msg(-10000, "unknow access mode");
 		}
@@ -659,7 +868,8 @@ class alsaaudio : public audio
 				.buffering( lopt(argc, argv, "--buffer", "-b",    			getDefaultEnv("FAUST2ALSA_BUFFER",512)     ) )
 				.periods( lopt(argc, argv, "--periods", "-p",     			getDefaultEnv("FAUST2ALSA_PERIODS",2)       ) )
 				.inputs(DSP->getNumInputs())
-				.outputs(DSP->getNumOutputs()));
+				.outputs(DSP->getNumOutputs())
+				.useMmap( fopt(argc, argv, "--mmap", "-mmap") || getDefaultEnv("FAUST2ALSA_MMAP", 0) ));
 		}
 
 	virtual ~alsaaudio() { stop(); delete fAudio; }
@@ -697,12 +907,14 @@ class alsaaudio : public audio
 			fAudio->write();
 			while (fRunning) {
 				fAudio->read();
+				fAudio->prepareOutput();
 				fDSP->compute(fAudio->buffering(), fAudio->inputSoftChannels(), fAudio->outputSoftChannels());
 				fAudio->write();
 			}
         } else {
             fAudio->write();
 			while (fRunning) {
+				fAudio->prepareOutput();
 				fDSP->compute(fAudio->buffering(), fAudio->inputSoftChannels(), fAudio->outputSoftChannels());
 				fAudio->write();
 			}
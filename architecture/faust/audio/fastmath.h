@@ -0,0 +1,276 @@
+/************************************************************************
+ ************************************************************************
+    FAUST Architecture File
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This Architecture section is free software; you can redistribute it
+    and/or modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 3 of
+	the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+	along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+	EXCEPTION : As a special exception, you may create a larger work
+	that contains this FAUST architecture section and distribute
+	that work under terms of your choice, so long as this FAUST
+	architecture section is not modified.
+
+ ************************************************************************
+ ************************************************************************/
+
+
+/******************************************************************************
+*******************************************************************************
+
+							FAST MATHEMATICAL FUNCTIONS
+
+	Runtime support for the code generated with the -fm option. Polynomial
+	approximations of sin, cos, tan, exp, log, log10 and pow for float and
+	double. N is the accuracy tier : 1 for -fm fast, 2 for -fm faster.
+
+	The functions have no branches and no calls, so the loops of the -vec
+	code using them can be auto-vectorized. The maximal errors, measured
+	in double precision for |x| < 1e4 :
+
+						N = 1			N = 2
+		sin, cos		2e-9			4e-5		absolute
+		tan				3e-9			6e-5		relative
+		exp				7e-9			6e-5		relative
+		log, log10		1e-9			2e-6		absolute
+		pow(x,y)		exp and log errors, amplified by |y*log(x)|, x > 0
+
+	In single precision, the N = 1 errors are those of the float rounding
+	(about 1e-7, or 1e-5 absolute for the log of very large or very small
+	numbers). The range reduction of sin, cos and tan stays exact in single
+	precision for |x| < 1e5.
+
+	The variants used when the compiler knows the interval of the argument :
+		_s : sin, cos and tan without range reduction, for |x| <= pi/4
+		_b : sin, cos and tan without the test of the range, for |x| < 1e9
+			 exp without saturation, for x in [-87, 88]
+	The other versions accept any argument. sin, cos and tan of |x| > 1e9
+	are those of 0 (the reduction would be meaningless), exp saturates at
+	the limits of the representable numbers (exp of NaN is NaN). log only accepts positive
+	normal numbers (log of 0 is a large negative number instead of -inf).
+
+*******************************************************************************
+*******************************************************************************/
+
+#ifndef __faust_fastmath__
+#define __faust_fastmath__
+
+#include <string.h>
+#include <math.h>
+
+// -- bit level helpers
+
+// 2^k, for k in the exponent range
+inline float faustpow2i(int k, float)
+{
+    int b = (k + 127) << 23;
+    float r; memcpy(&r, &b, sizeof(r));
+    return r;
+}
+
+inline double faustpow2i(int k, double)
+{
+    long long b = (long long)(k + 1023) << 52;
+    double r; memcpy(&r, &b, sizeof(r));
+    return r;
+}
+
+// x = m * 2^e with m in [sqrt(1/2), sqrt(2)), for x positive and normal
+inline float faustsplit(float x, int& e)
+{
+    int b; memcpy(&b, &x, sizeof(b));
+    int k = ((b >> 23) & 0xff) - 127;
+    b = (b & 0x007fffff) | 0x3f800000;
+    float m; memcpy(&m, &b, sizeof(m));
+    int big = m > 1.41421356f;
+    e = k + big;
+    return m - (m * 0.5f) * float(big);
+}
+
+inline double faustsplit(double x, int& e)
+{
+    long long b; memcpy(&b, &x, sizeof(b));
+    int k = int((b >> 52) & 0x7ff) - 1023;
+    b = (b & 0x000fffffffffffffLL) | 0x3ff0000000000000LL;
+    double m; memcpy(&m, &b, sizeof(m));
+    int big = m > 1.4142135623730951;
+    e = k + big;
+    return m - (m * 0.5) * double(big);
+}
+
+// c ? a : b with bit masks, the compilers don't turn it into a branch
+inline float faustselect(bool c, float a, float b)
+{
+    int ia, ib; memcpy(&ia, &a, sizeof(ia)); memcpy(&ib, &b, sizeof(ib));
+    int m = -int(c);
+    int ir = (ia & m) | (ib & ~m);
+    float r; memcpy(&r, &ir, sizeof(r));
+    return r;
+}
+
+inline double faustselect(bool c, double a, double b)
+{
+    long long ia, ib; memcpy(&ia, &a, sizeof(ia)); memcpy(&ib, &b, sizeof(ib));
+    long long m = -(long long)(c);
+    long long ir = (ia & m) | (ib & ~m);
+    double r; memcpy(&r, &ir, sizeof(r));
+    return r;
+}
+
+inline float faustexpmin(float)     { return -87.33f; }
+inline float faustexpmax(float)     { return 88.72f; }
+inline double faustexpmin(double)   { return -708.39; }
+inline double faustexpmax(double)   { return 709.78; }
+
+// -- sin and cos for |r| <= pi/4 (Taylor series)
+
+template <int N, typename REAL>
+inline REAL faustpolysin(REAL r)
+{
+    REAL r2 = r*r;
+    if (N == 1) {
+        return r + r*r2*(REAL(-1.0/6) + r2*(REAL(1.0/120) + r2*(REAL(-1.0/5040) + r2*REAL(1.0/362880))));
+    } else {
+        return r + r*r2*(REAL(-1.0/6) + r2*REAL(1.0/120));
+    }
+}
+
+template <int N, typename REAL>
+inline REAL faustpolycos(REAL r)
+{
+    REAL r2 = r*r;
+    if (N == 1) {
+        return REAL(1) + r2*(REAL(-0.5) + r2*(REAL(1.0/24) + r2*(REAL(-1.0/720) + r2*(REAL(1.0/40320) + r2*REAL(-1.0/3628800)))));
+    } else {
+        return REAL(1) + r2*(REAL(-0.5) + r2*(REAL(1.0/24) + r2*REAL(-1.0/720)));
+    }
+}
+
+// -- range reduction : x = q*pi/2 + r, with |r| <= pi/4, returns the quadrant q mod 4
+// (pi/2 is split in three parts, the first two being exact when multiplied by q)
+
+template <typename REAL>
+inline int faustquadrant_b(REAL x, REAL& r)
+{
+    int q = int(x * REAL(0.63661977236758134) + copysign(REAL(0.5), x));
+    REAL qf = REAL(q);
+    r = ((x - qf*REAL(1.5703125)) - qf*REAL(4.837512969970703125e-4)) - qf*REAL(7.549789954891882e-08);
+    return q & 3;
+}
+
+// any x : beyond 1e9, where the reduction isn't meaningful anymore, r is 0
+template <typename REAL>
+inline int faustquadrant(REAL x, REAL& r)
+{
+    bool big = fabs(x) > REAL(1e9);
+    return faustquadrant_b(faustselect(big, REAL(0), x), r);
+}
+
+template <int N, typename REAL>
+inline REAL faustsinq(int q, REAL r)
+{
+    REAL s = faustpolysin<N>(r);
+    REAL c = faustpolycos<N>(r);
+    // selects and sign without branches (multiplications by 0, 1 or -1 are exact)
+    REAL odd = REAL(q & 1);
+    return (s*(REAL(1) - odd) + c*odd) * REAL(1 - (q & 2));
+}
+
+template <int N, typename REAL>
+inline REAL fausttanq(int q, REAL r)
+{
+    REAL s = faustpolysin<N>(r);
+    REAL c = faustpolycos<N>(r);
+    REAL n = (q & 1) ? -c : s;
+    REAL d = (q & 1) ? s : c;
+    return n / d;
+}
+
+// -- sin, cos, tan
+
+template <int N, typename REAL> inline REAL faustfastsin_s(REAL x)  { return faustpolysin<N>(x); }
+template <int N, typename REAL> inline REAL faustfastcos_s(REAL x)  { return faustpolycos<N>(x); }
+template <int N, typename REAL> inline REAL faustfasttan_s(REAL x)  { return faustpolysin<N>(x) / faustpolycos<N>(x); }
+
+template <int N, typename REAL> inline REAL faustfastsin_b(REAL x)  { REAL r; int q = faustquadrant_b(x, r); return faustsinq<N>(q, r); }
+template <int N, typename REAL> inline REAL faustfastcos_b(REAL x)  { REAL r; int q = faustquadrant_b(x, r); return faustsinq<N>(q + 1, r); }
+template <int N, typename REAL> inline REAL faustfasttan_b(REAL x)  { REAL r; int q = faustquadrant_b(x, r); return fausttanq<N>(q, r); }
+
+template <int N, typename REAL> inline REAL faustfastsin(REAL x)    { REAL r; int q = faustquadrant(x, r); return faustsinq<N>(q, r); }
+template <int N, typename REAL> inline REAL faustfastcos(REAL x)    { REAL r; int q = faustquadrant(x, r); return faustsinq<N>(q + 1, r); }
+template <int N, typename REAL> inline REAL faustfasttan(REAL x)    { REAL r; int q = faustquadrant(x, r); return fausttanq<N>(q, r); }
+
+// -- exp : x = k*log(2) + r with |r| <= log(2)/2, exp(x) = 2^k * exp(r)
+
+template <int N, typename REAL>
+inline REAL faustfastexp_b(REAL x)
+{
+    // x*log2(e) > -1024, truncation of a positive number rounds it
+    int k = int(x * REAL(1.4426950408889634) + REAL(1024.5)) - 1024;
+    REAL r = (x - REAL(k)*REAL(0.693145751953125)) - REAL(k)*REAL(1.4286068203094173e-06);
+    REAL p;
+    if (N == 1) {
+        p = REAL(1) + r*(REAL(1) + r*(REAL(1.0/2) + r*(REAL(1.0/6) + r*(REAL(1.0/24) + r*(REAL(1.0/120) + r*(REAL(1.0/720) + r*REAL(1.0/5040)))))));
+    } else {
+        p = REAL(1) + r*(REAL(1) + r*(REAL(1.0/2) + r*(REAL(1.0/6) + r*REAL(1.0/24))));
+    }
+    // near faustexpmax, 2^k is the infinite exponent : it is applied in two halves
+    int h = k / 2;
+    return (p * faustpow2i(k - h, x)) * faustpow2i(h, x);
+}
+
+template <int N, typename REAL>
+inline REAL faustfastexp(REAL x)
+{
+    REAL lo = faustexpmin(x);
+    REAL hi = faustexpmax(x);
+    REAL y = faustselect(x < lo, lo, x);
+    y = faustselect(y > hi, hi, y);
+    // NaN is not converted to int (undefined), exp(NaN) is NaN
+    y = faustselect(y == y, y, REAL(0));
+    return faustselect(x == x, faustfastexp_b<N>(y), x);
+}
+
+// -- log : x = m * 2^e, log(x) = e*log(2) + log(m), log(m) = 2*atanh((m-1)/(m+1))
+
+template <int N, typename REAL>
+inline REAL faustfastlog(REAL x)
+{
+    int e;
+    REAL m = faustsplit(x, e);
+    REAL s = (m - REAL(1)) / (m + REAL(1));
+    REAL s2 = s*s;
+    REAL p;
+    if (N == 1) {
+        p = s*(REAL(2) + s2*(REAL(2.0/3) + s2*(REAL(2.0/5) + s2*(REAL(2.0/7) + s2*REAL(2.0/9)))));
+    } else {
+        p = s*(REAL(2) + s2*(REAL(2.0/3) + s2*REAL(2.0/5)));
+    }
+    return (REAL(e)*REAL(0.693145751953125) + p) + REAL(e)*REAL(1.4286068203094173e-06);
+}
+
+template <int N, typename REAL>
+inline REAL faustfastlog10(REAL x)
+{
+    return faustfastlog<N>(x) * REAL(0.43429448190325182);
+}
+
+// -- pow for x > 0
+
+template <int N, typename REAL>
+inline REAL faustfastpow(REAL x, REAL y)
+{
+    return faustfastexp<N>(y * faustfastlog<N>(x));
+}
+
+#endif
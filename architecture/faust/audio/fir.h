@@ -0,0 +1,315 @@
+/************************************************************************
+ ************************************************************************
+    FAUST Architecture File
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This Architecture section is free software; you can redistribute it
+    and/or modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 3 of
+	the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+	along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+	EXCEPTION : As a special exception, you may create a larger work
+	that contains this FAUST architecture section and distribute
+	that work under terms of your choice, so long as this FAUST
+	architecture section is not modified.
+
+ ************************************************************************
+ ************************************************************************/
+
+/******************************************************************************
+*******************************************************************************
+
+								FIR FILTERS
+
+	Runtime support for the code generated with the -fir option. A sum
+	c0*x + c1*x@1 + ... + cn*x@n is compiled as a faustfir object ticked
+	once per sample. Short filters use a direct form, long filters use a
+	direct form for the first partition and a uniformly partitioned FFT
+	convolution for the remaining taps, without any added latency.
+
+*******************************************************************************
+*******************************************************************************/
+
+#ifndef __faust_fir__
+#define __faust_fir__
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+// number of taps above which a partitioned FFT convolution is used
+#ifndef FAUSTFIR_FFT_THRESHOLD
+#define FAUSTFIR_FFT_THRESHOLD 256
+#endif
+
+// size of the partitions (must be a power of two)
+#ifndef FAUSTFIR_PARTITION
+#define FAUSTFIR_PARTITION 64
+#endif
+
+/**
+ * Direct form FIR filter. The history is stored twice so that the
+ * last N input samples are always contiguous : the dot product doesn't
+ * need any index wrapping and can be vectorized by the C++ compiler.
+ */
+template <typename REAL>
+class firdirect
+{
+    private:
+
+        std::vector<REAL>   fCoefs;     // c[0..N-1]
+        std::vector<REAL>   fHistory;   // x[n-k] at fPos+k and fPos+N+k
+        int                 fSize;
+        int                 fPos;
+
+    public:
+
+        firdirect() : fSize(0), fPos(0) {}
+
+        void init(const REAL* coefs, int size)
+        {
+            fSize = size;
+            fCoefs.assign(coefs, coefs + size);
+            fHistory.assign(2*size, REAL(0));
+            fPos = 0;
+        }
+
+        void reset()
+        {
+            std::fill(fHistory.begin(), fHistory.end(), REAL(0));
+            fPos = 0;
+        }
+
+        inline REAL tick(REAL x)
+        {
+            fPos = (fPos == 0) ? fSize-1 : fPos-1;
+            fHistory[fPos] = fHistory[fPos+fSize] = x;
+
+            const REAL* c = &fCoefs[0];
+            const REAL* h = &fHistory[fPos];
+            REAL a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+            int k = 0;
+            for (; k+4 <= fSize; k += 4) {
+                a0 += c[k]   * h[k];
+                a1 += c[k+1] * h[k+1];
+                a2 += c[k+2] * h[k+2];
+                a3 += c[k+3] * h[k+3];
+            }
+            for (; k < fSize; k++) {
+                a0 += c[k] * h[k];
+            }
+            return (a0 + a1) + (a2 + a3);
+        }
+};
+
+/**
+ * Uniformly partitioned overlap-save convolution of the taps c[P..N-1]
+ * of a FIR filter (the first partition being computed in direct form).
+ * The spectrum of each input block is computed once and kept in a
+ * frequency domain delay line, the output of the next block is computed
+ * when the current block is complete.
+ */
+template <typename REAL>
+class firpartitioned
+{
+    private:
+
+        int                 fP;         // partition size
+        int                 fM;         // FFT size (2*fP)
+        int                 fK;         // number of partitions
+        int                 fPhase;     // position in the current block
+        int                 fCurrent;   // most recent spectrum in the delay line
+
+        std::vector<int>    fBitRev;
+        std::vector<REAL>   fCos, fSin;                 // twiddle factors
+        std::vector<REAL>   fFiltRe, fFiltIm;           // K spectra of the partitions
+        std::vector<REAL>   fLineRe, fLineIm;           // K spectra of the past input blocks
+        std::vector<REAL>   fWorkRe, fWorkIm;
+        std::vector<REAL>   fInput;                     // previous and current input blocks
+        std::vector<REAL>   fOutput;                    // output of the current block
+
+        void fft(REAL* re, REAL* im, bool inverse)
+        {
+            for (int i = 0; i < fM; i++) {
+                int j = fBitRev[i];
+                if (i < j) {
+                    std::swap(re[i], re[j]);
+                    std::swap(im[i], im[j]);
+                }
+            }
+            REAL s = (inverse) ? REAL(1) : REAL(-1);
+            for (int len = 2; len <= fM; len <<= 1) {
+                int half = len/2;
+                int step = fM/len;
+                for (int i = 0; i < fM; i += len) {
+                    for (int k = 0; k < half; k++) {
+                        REAL wr = fCos[k*step];
+                        REAL wi = s*fSin[k*step];
+                        int  a = i+k, b = i+k+half;
+                        REAL vr = re[b]*wr - im[b]*wi;
+                        REAL vi = re[b]*wi + im[b]*wr;
+                        re[b] = re[a] - vr; im[b] = im[a] - vi;
+                        re[a] = re[a] + vr; im[a] = im[a] + vi;
+                    }
+                }
+            }
+        }
+
+        void forward(const REAL* x, int n, REAL* re, REAL* im)
+        {
+            for (int i = 0; i < fM; i++) {
+                re[i] = (i < n) ? x[i] : REAL(0);
+                im[i] = 0;
+            }
+            fft(re, im, false);
+        }
+
+        // called when the current block is complete : computes the next output block
+        void process()
+        {
+            fCurrent = (fCurrent == 0) ? fK-1 : fCurrent-1;
+            forward(&fInput[0], fM, &fLineRe[fCurrent*fM], &fLineIm[fCurrent*fM]);
+
+            // multiply-accumulate of the non redundant bins of the real spectra
+            std::fill(fWorkRe.begin(), fWorkRe.end(), REAL(0));
+            std::fill(fWorkIm.begin(), fWorkIm.end(), REAL(0));
+            for (int j = 0; j < fK; j++) {
+                int l = (fCurrent + j) % fK;
+                const REAL* xr = &fLineRe[l*fM];
+                const REAL* xi = &fLineIm[l*fM];
+                const REAL* hr = &fFiltRe[j*fM];
+                const REAL* hi = &fFiltIm[j*fM];
+                for (int b = 0; b <= fP; b++) {
+                    fWorkRe[b] += xr[b]*hr[b] - xi[b]*hi[b];
+                    fWorkIm[b] += xr[b]*hi[b] + xi[b]*hr[b];
+                }
+            }
+            for (int b = fP+1; b < fM; b++) {
+                fWorkRe[b] = fWorkRe[fM-b];
+                fWorkIm[b] = -fWorkIm[fM-b];
+            }
+            fft(&fWorkRe[0], &fWorkIm[0], true);
+
+            // overlap-save : keep the last half
+            REAL g = REAL(1)/REAL(fM);
+            for (int i = 0; i < fP; i++) {
+                fOutput[i] = fWorkRe[fP+i]*g;
+            }
+            std::copy(fInput.begin()+fP, fInput.end(), fInput.begin());
+        }
+
+    public:
+
+        firpartitioned() : fP(0), fM(0), fK(0), fPhase(0), fCurrent(0) {}
+
+        void init(const REAL* coefs, int size, int partition)
+        {
+            fP = partition;
+            fM = 2*partition;
+            fK = (size + fP - 1)/fP;
+
+            int bits = 0;
+            while ((1 << bits) < fM) bits++;
+            fBitRev.resize(fM);
+            for (int i = 0; i < fM; i++) {
+                int r = 0;
+                for (int b = 0; b < bits; b++) {
+                    if (i & (1 << b)) r |= 1 << (bits-1-b);
+                }
+                fBitRev[i] = r;
+            }
+            fCos.resize(fM/2);
+            fSin.resize(fM/2);
+            const double pi = 3.14159265358979323846;     // M_PI is not standard (MSVC)
+            for (int k = 0; k < fM/2; k++) {
+                fCos[k] = REAL(cos(2*pi*k/fM));
+                fSin[k] = REAL(sin(2*pi*k/fM));
+            }
+
+            fFiltRe.resize(fK*fM);
+            fFiltIm.resize(fK*fM);
+            for (int j = 0; j < fK; j++) {
+                forward(coefs + j*fP, std::min(fP, size - j*fP), &fFiltRe[j*fM], &fFiltIm[j*fM]);
+            }
+
+            fLineRe.resize(fK*fM);
+            fLineIm.resize(fK*fM);
+            fWorkRe.resize(fM);
+            fWorkIm.resize(fM);
+            fInput.resize(fM);
+            fOutput.resize(fP);
+            reset();
+        }
+
+        void reset()
+        {
+            std::fill(fLineRe.begin(), fLineRe.end(), REAL(0));
+            std::fill(fLineIm.begin(), fLineIm.end(), REAL(0));
+            std::fill(fInput.begin(), fInput.end(), REAL(0));
+            std::fill(fOutput.begin(), fOutput.end(), REAL(0));
+            fPhase = 0;
+            fCurrent = 0;
+        }
+
+        inline REAL tick(REAL x)
+        {
+            if (fPhase == fP) {
+                process();
+                fPhase = 0;
+            }
+            REAL y = fOutput[fPhase];
+            fInput[fP + fPhase] = x;
+            fPhase++;
+            return y;
+        }
+};
+
+/**
+ * FIR filter used by the generated code : a direct form filter,
+ * extended by a partitioned convolution for long filters.
+ */
+template <typename REAL>
+class faustfir
+{
+    private:
+
+        firdirect<REAL>         fHead;
+        firpartitioned<REAL>    fTail;
+        bool                    fHasTail;
+
+    public:
+
+        faustfir() : fHasTail(false) {}
+
+        void init(const REAL* coefs, int size)
+        {
+            fHasTail = (size > FAUSTFIR_FFT_THRESHOLD) && (size > FAUSTFIR_PARTITION);
+            if (fHasTail) {
+                fHead.init(coefs, FAUSTFIR_PARTITION);
+                fTail.init(coefs + FAUSTFIR_PARTITION, size - FAUSTFIR_PARTITION, FAUSTFIR_PARTITION);
+            } else {
+                fHead.init(coefs, size);
+            }
+        }
+
+        void reset()
+        {
+            fHead.reset();
+            if (fHasTail) fTail.reset();
+        }
+
+        inline REAL tick(REAL x)
+        {
+            return (fHasTail) ? fHead.tick(x) + fTail.tick(x) : fHead.tick(x);
+        }
+};
+
+#endif
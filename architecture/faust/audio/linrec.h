@@ -0,0 +1,97 @@
+/************************************************************************
+ ************************************************************************
+    FAUST Architecture File
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This Architecture section is free software; you can redistribute it
+    and/or modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 3 of
+	the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+	along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+	EXCEPTION : As a special exception, you may create a larger work
+	that contains this FAUST architecture section and distribute
+	that work under terms of your choice, so long as this FAUST
+	architecture section is not modified.
+
+ ************************************************************************
+ ************************************************************************/
+
+
+/******************************************************************************
+*******************************************************************************
+
+							LINEAR RECURSIONS
+
+	Runtime support for the code generated with the -lrec option. First and
+	second order linear recursions with block-constant coefficients
+
+		y[i] = u[i] + a1*y[i-1] (+ a2*y[i-2])
+
+	are computed in place over a vector holding u[0..count-1] and the past
+	outputs at negative indexes. Four samples are computed at once using the
+	state-space (look-ahead) form of the recursion : the four outputs only
+	depend on the last two outputs of the previous group, so they can be
+	computed in parallel, and the loop carried dependency is four times
+	shorter than the sample by sample recursion. The rounding errors differ
+	from the sample by sample computation, and can be noticeable in single
+	precision for poles very close to the unit circle.
+
+*******************************************************************************
+*******************************************************************************/
+
+#ifndef __faust_linrec__
+#define __faust_linrec__
+
+template <typename REAL>
+inline void faustlinrec1(int count, REAL a1, REAL* y)
+{
+    // impulse response h[n] = a1^n
+    REAL h1 = a1, h2 = a1*h1, h3 = a1*h2, h4 = a1*h3;
+    REAL s1 = y[-1];
+    int i = 0;
+    for (; i+4 <= count; i += 4) {
+        REAL u0 = y[i], u1 = y[i+1], u2 = y[i+2], u3 = y[i+3];
+        REAL y0 = u0 + h1*s1;
+        REAL y1 = u1 + h1*u0 + h2*s1;
+        REAL y2 = u2 + h1*u1 + h2*u0 + h3*s1;
+        REAL y3 = u3 + h1*u2 + h2*u1 + h3*u0 + h4*s1;
+        y[i] = y0; y[i+1] = y1; y[i+2] = y2; y[i+3] = y3;
+        s1 = y3;
+    }
+    for (; i < count; i++) {
+        y[i] += a1*y[i-1];
+    }
+}
+
+template <typename REAL>
+inline void faustlinrec2(int count, REAL a1, REAL a2, REAL* y)
+{
+    // impulse response h[n] = a1*h[n-1] + a2*h[n-2]
+    REAL h1 = a1, h2 = a1*h1 + a2, h3 = a1*h2 + a2*h1, h4 = a1*h3 + a2*h2;
+    // contribution of y[-2] to y[j] is a2*h[j]
+    REAL g1 = a2, g2 = a2*h1, g3 = a2*h2, g4 = a2*h3;
+    REAL s1 = y[-1], s2 = y[-2];
+    int i = 0;
+    for (; i+4 <= count; i += 4) {
+        REAL u0 = y[i], u1 = y[i+1], u2 = y[i+2], u3 = y[i+3];
+        REAL y0 = u0 + h1*s1 + g1*s2;
+        REAL y1 = u1 + h1*u0 + h2*s1 + g2*s2;
+        REAL y2 = u2 + h1*u1 + h2*u0 + h3*s1 + g3*s2;
+        REAL y3 = u3 + h1*u2 + h2*u1 + h3*u0 + h4*s1 + g4*s2;
+        y[i] = y0; y[i+1] = y1; y[i+2] = y2; y[i+3] = y3;
+        s1 = y3; s2 = y2;
+    }
+    for (; i < count; i++) {
+        y[i] += a1*y[i-1] + a2*y[i-2];
+    }
+}
+
+#endif
@@ -54,6 +54,17 @@ struct mydsp_voice : public MapUI {
         fVoice.buildUserInterface(this);
         fNote = -1;
     }
+    
+    // Copy of an initialized voice : no init() and no buildUserInterface(),
+    // the zones of the copied map are moved to the new dsp
+    mydsp_voice(const mydsp_voice& voice):MapUI(voice), fVoice(voice.fVoice)
+    {
+        std::map<std::string, FAUSTFLOAT*>::iterator it;
+        for (it = fZoneMap.begin(); it != fZoneMap.end(); it++) {
+            (*it).second = (FAUSTFLOAT*)((char*)&fVoice + ((char*)(*it).second - (char*)&voice.fVoice));
+        }
+        fNote = -1;
+    }
 };
 
 struct mydsp_poly
@@ -107,9 +118,10 @@ struct mydsp_poly
         fMaxPolyphony = max_polyphony;
         fVoiceTable = new mydsp_voice*[max_polyphony];
         
-        // Init it with supplied sample_rate 
-        for (int i = 0; i < fMaxPolyphony; i++) {
-            fVoiceTable[i] = new mydsp_voice(sample_rate);
+        // Init the first voice with supplied sample_rate, the others are copies of it
+        fVoiceTable[0] = new mydsp_voice(sample_rate);
+        for (int i = 1; i < fMaxPolyphony; i++) {
+            fVoiceTable[i] = new mydsp_voice(*fVoiceTable[0]);
         }
         
         // Init audio output buffers
@@ -0,0 +1,289 @@
+#ifndef FAUST_CONTROLQUEUE_H
+#define FAUST_CONTROLQUEUE_H
+
+#ifndef FAUSTFLOAT
+#define FAUSTFLOAT float
+#endif
+
+#include "faust/gui/UI.h"
+#include "faust/audio/dsp.h"
+#include <vector>
+
+#if defined(_MSC_VER)
+// x86 keeps the order of the stores, only the compiler must be prevented from reordering
+#include <intrin.h>
+#define FAUST_MEMORY_BARRIER() _ReadWriteBarrier()
+#define FAUST_TRY_LOCK(l) (_InterlockedExchange(&(l), 1) == 0)
+#define FAUST_UNLOCK(l) _InterlockedExchange(&(l), 0)
+#else
+#define FAUST_MEMORY_BARRIER() __sync_synchronize()
+#define FAUST_TRY_LOCK(l) (__sync_lock_test_and_set(&(l), 1) == 0)
+#define FAUST_UNLOCK(l) __sync_lock_release(&(l))
+#endif
+
+/*******************************************************************************
+ * lfqueue : single producer, single consumer lock-free FIFO of fixed size.
+ * The producer only writes fWrite, the consumer only writes fRead.
+ ******************************************************************************/
+
+template <typename T>
+class lfqueue
+{
+    private:
+
+        std::vector<T>          fBuffer;
+        unsigned int            fMask;
+        volatile unsigned int   fRead;
+        volatile unsigned int   fWrite;
+
+    public:
+
+        // size is rounded up to a power of two
+        lfqueue(unsigned int size) : fRead(0), fWrite(0)
+        {
+            unsigned int n = 1;
+            while (n < size) n <<= 1;
+            fBuffer.resize(n);
+            fMask = n - 1;
+        }
+
+        // producer side, returns false when the queue is full
+        bool push(const T& x)
+        {
+            unsigned int w = fWrite;
+            if (w - fRead > fMask) return false;
+            fBuffer[w & fMask] = x;
+            FAUST_MEMORY_BARRIER();
+            fWrite = w + 1;
+            return true;
+        }
+
+        // consumer side, returns false when the queue is empty
+        bool front(T& x)
+        {
+            unsigned int r = fRead;
+            if (r == fWrite) return false;
+            FAUST_MEMORY_BARRIER();
+            x = fBuffer[r & fMask];
+            return true;
+        }
+
+        void pop()
+        {
+            FAUST_MEMORY_BARRIER();
+            fRead = fRead + 1;
+        }
+};
+
+/*******************************************************************************
+ * computeSlice : computes the samples [pos, pos+count) of the buffers, for
+ * the blocks split at the date of an update or along a ramp. The pointers to
+ * the slices of the channels are on the stack : a block is only split for
+ * at most kMaxSliceChannels inputs and outputs (see canSlice).
+ ******************************************************************************/
+
+enum { kMaxSliceChannels = 256 };
+
+inline bool canSlice(dsp* DSP)
+{
+    return (DSP->getNumInputs() <= kMaxSliceChannels) && (DSP->getNumOutputs() <= kMaxSliceChannels);
+}
+
+inline void computeSlice(dsp* DSP, int pos, int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs)
+{
+    FAUSTFLOAT* ins[kMaxSliceChannels];
+    FAUSTFLOAT* outs[kMaxSliceChannels];
+    int ni = DSP->getNumInputs();
+    int no = DSP->getNumOutputs();
+    for (int i = 0; i < ni; i++) ins[i] = inputs[i] + pos;
+    for (int i = 0; i < no; i++) outs[i] = outputs[i] + pos;
+    DSP->compute(count, ins, outs);
+}
+
+/*******************************************************************************
+ * ControlQueue : carries parameter updates from a control thread to the
+ * audio thread, and the values of the bargraphs and of the applied updates
+ * back to the control thread, without locks.
+ *
+ * The control thread pushes (zone, value, date) updates. The audio thread
+ * computes the dsp with ControlQueue::compute (or a queuedsp), which writes
+ * the zones at block start, or at the exact sample given by the date, and
+ * publishes the changed bargraphs. The control thread pops the published
+ * values to update its widgets instead of polling all the zones.
+ *
+ * Several control threads (GUI, OSC, HTTP...) can push on the same queue :
+ * they are serialized by a spin lock that the audio thread never takes.
+ * Dates are in samples, as given by date() ; updates are applied in the
+ * order of their dates, in the order they are pushed for the same date. An
+ * update dated after the current block waits in the audio thread without
+ * holding back the updates pushed after it.
+ ******************************************************************************/
+
+struct zoneupdate
+{
+    FAUSTFLOAT*     fZone;
+    FAUSTFLOAT      fValue;
+    unsigned int    fDate;
+};
+
+class ControlQueue : public UI
+{
+    private:
+
+        lfqueue<zoneupdate>         fInput;         // control thread -> audio thread
+        lfqueue<zoneupdate>         fOutput;        // audio thread -> control thread
+        std::vector<zoneupdate>     fPending;       // audio thread only : received updates, sorted by date
+        std::vector<FAUSTFLOAT*>    fPassiveZones;
+        std::vector<FAUSTFLOAT>     fPassiveValues;
+        volatile unsigned int       fDate;          // date of the current block
+        volatile long               fPushLock;      // serializes the control threads
+
+        void publish(FAUSTFLOAT* zone, FAUSTFLOAT v)
+        {
+            zoneupdate u = { zone, v, fDate };
+            fOutput.push(u);    // values are lost if the control thread doesn't read them
+        }
+
+    public:
+
+        ControlQueue(unsigned int size = 1024) : fInput(size), fOutput(size), fDate(0), fPushLock(0)
+        {
+            fPending.reserve(size);     // never grows in the audio thread
+        }
+        virtual ~ControlQueue() {}
+
+        // -- control thread side
+
+        unsigned int date() { return fDate; }
+
+        bool push(FAUSTFLOAT* zone, FAUSTFLOAT v)
+        {
+            return push(zone, v, fDate);
+        }
+
+        // returns false when the queue is full, the update is then dropped
+        bool push(FAUSTFLOAT* zone, FAUSTFLOAT v, unsigned int date)
+        {
+            zoneupdate u = { zone, v, date };
+            while (!FAUST_TRY_LOCK(fPushLock)) {}
+            bool res = fInput.push(u);
+            FAUST_UNLOCK(fPushLock);
+            return res;
+        }
+
+        bool pop(zoneupdate& u)
+        {
+            if (!fOutput.front(u)) return false;
+            fOutput.pop();
+            return true;
+        }
+
+        // -- audio thread side
+
+        /**
+         * Compute count samples, applying the pending updates at their date.
+         * The block is split when an update is dated inside the block.
+         */
+        void compute(dsp* DSP, int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs)
+        {
+            bool split = canSlice(DSP);     // else the updates are applied at block start
+            int pos = 0;
+            zoneupdate u;
+
+            // receive the new updates, keeping them sorted by date
+            while (fPending.size() < fPending.capacity() && fInput.front(u)) {
+                unsigned int i = fPending.size();
+                while (i > 0 && int(fPending[i-1].fDate - u.fDate) > 0) i--;
+                fPending.insert(fPending.begin() + i, u);
+                fInput.pop();
+            }
+
+            unsigned int k = 0;
+            for (; k < fPending.size(); k++) {
+                u = fPending[k];
+                int offset = int(u.fDate - fDate);
+                if (offset >= count) break;
+                if (split && offset > pos) {
+                    computeSlice(DSP, pos, offset - pos, inputs, outputs);
+                    pos = offset;
+                }
+                *u.fZone = u.fValue;
+                publish(u.fZone, u.fValue);
+            }
+            fPending.erase(fPending.begin(), fPending.begin() + k);
+            if (pos == 0) {
+                DSP->compute(count, inputs, outputs);
+            } else if (pos < count) {
+                computeSlice(DSP, pos, count - pos, inputs, outputs);
+            }
+            fDate = fDate + count;
+
+            for (unsigned int i = 0; i < fPassiveZones.size(); i++) {
+                FAUSTFLOAT v = *fPassiveZones[i];
+                if (v != fPassiveValues[i]) {
+                    fPassiveValues[i] = v;
+                    publish(fPassiveZones[i], v);
+                }
+            }
+        }
+
+        // -- widget's layouts
+
+        void openTabBox(const char* label) {}
+        void openHorizontalBox(const char* label) {}
+        void openVerticalBox(const char* label) {}
+        void closeBox() {}
+
+        // -- active widgets
+
+        void addButton(const char* label, FAUSTFLOAT* zone) {}
+        void addCheckButton(const char* label, FAUSTFLOAT* zone) {}
+        void addVerticalSlider(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) {}
+        void addHorizontalSlider(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) {}
+        void addNumEntry(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) {}
+
+        // -- passive widgets
+
+        void addHorizontalBargraph(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT min, FAUSTFLOAT max)
+        {
+            fPassiveZones.push_back(zone);
+            fPassiveValues.push_back(*zone);
+        }
+        void addVerticalBargraph(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT min, FAUSTFLOAT max)
+        {
+            fPassiveZones.push_back(zone);
+            fPassiveValues.push_back(*zone);
+        }
+};
+
+/*******************************************************************************
+ * queuedsp : a dsp decorator applying the updates of a ControlQueue, to be
+ * given to the audio drivers in place of the decorated dsp.
+ ******************************************************************************/
+
+class queuedsp : public dsp
+{
+    private:
+
+        dsp*            fDSP;
+        ControlQueue*   fQueue;
+
+    public:
+
+        queuedsp(dsp* DSP, ControlQueue* queue) : fDSP(DSP), fQueue(queue)
+        {
+            fDSP->buildUserInterface(fQueue);
+        }
+        virtual ~queuedsp() {}
+
+        virtual int getNumInputs() { return fDSP->getNumInputs(); }
+        virtual int getNumOutputs() { return fDSP->getNumOutputs(); }
+        virtual void buildUserInterface(UI* ui_interface) { fDSP->buildUserInterface(ui_interface); }
+        virtual void init(int samplingRate) { fDSP->init(samplingRate); }
+        virtual void compute(int len, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs)
+        {
+            fQueue->compute(fDSP, len, inputs, outputs);
+        }
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define FAUST_FUI_H
 
 #include "faust/gui/UI.h"
+#include "faust/gui/ControlQueue.h"
 
 #include <string>
 #include <map>
@@ -21,8 +22,25 @@
  * This class provides essentially two new methods saveState() and recallState()
  * used to save on file and recall from file the state of the user interface.
  * The file is human readble and editable
+ *
+ * It also keeps presets in memory : arrays of values indexed by the order of
+ * declaration of the parameters. They are saved in a compact binary format,
+ * checked against a hash of the full names of the parameters, and the text
+ * format can be used to import and export them. recallPreset() is called by
+ * a control thread, and the preset is applied by the audio thread at the
+ * next block boundary, in FUI::compute or through a presetdsp, optionally
+ * with a linear ramp of the continuous parameters to avoid clicks.
  ******************************************************************************/
 
+#define FUI_PRESET_MAGIC    "FUIP"
+#define FUI_PRESET_VERSION  1
+
+struct presetrequest
+{
+    const FAUSTFLOAT*   fValues;
+    int                 fRamp;      // in samples
+};
+
 class FUI : public UI
 {
     
@@ -30,6 +48,20 @@ class FUI : public UI
 	std::vector<std::string>            fNameList;
 	std::map<std::string, FAUSTFLOAT*>	fName2Zone;
 
+    // -- presets
+    std::vector<FAUSTFLOAT*>            fZones;         // indexed like fNameList
+    std::vector<bool>                   fRamped;        // false for the buttons and check buttons
+    std::vector<FAUSTFLOAT*>            fPresets;
+    lfqueue<presetrequest>              fRequests;      // control thread -> audio thread
+
+    // -- ramp in progress (audio thread only)
+    std::vector<FAUSTFLOAT>             fRampStart;
+    const FAUSTFLOAT*                   fRampTarget;
+    int                                 fRampLength;
+    int                                 fRampLeft;
+
+    enum { kRampChunk = 32 };           // the parameters are updated every kRampChunk samples while ramping
+
  protected:
 
  	// labels are normalized by replacing white spaces by underscores and by
@@ -48,11 +80,13 @@ class FUI : public UI
 	}
 
 	// add an element by relating its full name and memory zone
-	virtual void addElement(const char* label, FAUSTFLOAT* zone)
+	virtual void addElement(const char* label, FAUSTFLOAT* zone, bool ramped = true)
 	{
 		std::string fullname (fGroupStack.top() + '/' + normalizeLabel(label));
 		fNameList.push_back(fullname);
 		fName2Zone[fullname] = zone;
+		fZones.push_back(zone);
+		fRamped.push_back(ramped);
 	}
 
 	// keep track of full group names in a stack
@@ -72,8 +106,11 @@ class FUI : public UI
 
  public:
 
-	FUI() 			{}
-	virtual ~FUI() 	{}
+	FUI() : fRequests(16), fRampTarget(0), fRampLength(0), fRampLeft(0) {}
+	virtual ~FUI()
+	{
+		for (unsigned int i=0; i<fPresets.size(); i++) delete [] fPresets[i];
+	}
 
 	// -- Save and recall methods
 
@@ -110,6 +147,183 @@ class FUI : public UI
 		f.close();
 	}
 
+	// -- Presets, to be managed by a single control thread
+
+	// FNV-1a hash of the full names, identifies the layout of the binary presets
+	unsigned int layoutHash()
+	{
+		unsigned int h = 2166136261u;
+		for (unsigned int i=0; i<fNameList.size(); i++) {
+			const std::string& n = fNameList[i];
+			for (unsigned int k=0; k<=n.size(); k++) {		// including the terminating 0
+				h = (h ^ (unsigned char)n.c_str()[k]) * 16777619u;
+			}
+		}
+		return h;
+	}
+
+	int presetCount()	{ return int(fPresets.size()); }
+
+	// keep the current values as a new preset, returns its number
+	int storePreset()
+	{
+		FAUSTFLOAT* p = new FAUSTFLOAT[fZones.size()];
+		for (unsigned int i=0; i<fZones.size(); i++) p[i] = *fZones[i];
+		fPresets.push_back(p);
+		return int(fPresets.size()) - 1;
+	}
+
+	// write a preset in the binary format
+	bool savePreset(int preset, const char* filename)
+	{
+		if (preset < 0 || preset >= presetCount()) return false;
+		std::ofstream f(filename, std::ios::out | std::ios::binary);
+		unsigned int header[3] = { FUI_PRESET_VERSION, layoutHash(), (unsigned int)fZones.size() };
+		f.write(FUI_PRESET_MAGIC, 4);
+		f.write((const char*)header, sizeof(header));
+		for (unsigned int i=0; i<fZones.size(); i++) {
+			double v = fPresets[preset][i];
+			f.write((const char*)&v, sizeof(v));
+		}
+		return f.good();
+	}
+
+	// read a preset in the binary format, returns its number or -1 if the
+	// file is not a preset of this user interface
+	int loadPreset(const char* filename)
+	{
+		std::ifstream f(filename, std::ios::in | std::ios::binary);
+		char magic[4];
+		unsigned int header[3];
+		f.read(magic, 4);
+		f.read((char*)header, sizeof(header));
+		if (!f.good() || std::string(magic, 4) != FUI_PRESET_MAGIC || header[0] != FUI_PRESET_VERSION
+			|| header[1] != layoutHash() || header[2] != fZones.size()) {
+			std::cerr << "loadPreset : " << filename << " is not a preset of this user interface" << std::endl;
+			return -1;
+		}
+		std::vector<double> values(fZones.size());
+		if (values.size() > 0) f.read((char*)&values[0], values.size() * sizeof(double));
+		if (!f.good()) {
+			std::cerr << "loadPreset : " << filename << " is truncated" << std::endl;
+			return -1;
+		}
+		FAUSTFLOAT* p = new FAUSTFLOAT[fZones.size()];
+		for (unsigned int i=0; i<fZones.size(); i++) p[i] = FAUSTFLOAT(values[i]);
+		fPresets.push_back(p);
+		return int(fPresets.size()) - 1;
+	}
+
+	// read a preset in the text format of saveState, the missing parameters
+	// keep their current values
+	int importPreset(const char* filename)
+	{
+		std::map<std::string, int> index;
+		for (unsigned int i=0; i<fNameList.size(); i++) index[fNameList[i]] = i;
+
+		int preset = storePreset();
+		std::ifstream f(filename);
+		FAUSTFLOAT	v;
+		std::string	n;
+		while (f >> v >> n) {
+			if (index.count(n) > 0) {
+				fPresets[preset][index[n]] = v;
+			} else {
+				std::cerr << "importPreset : parameter not found : " << n.c_str() << " with value : " << v << std::endl;
+			}
+		}
+		return preset;
+	}
+
+	// write a preset in the text format of saveState
+	bool exportPreset(int preset, const char* filename)
+	{
+		if (preset < 0 || preset >= presetCount()) return false;
+		std::ofstream f(filename);
+		for (unsigned int i=0; i<fNameList.size(); i++) {
+			f << fPresets[preset][i] << ' ' << fNameList[i].c_str() << std::endl;
+		}
+		f << std::endl;
+		return f.good();
+	}
+
+	// ask the audio thread to apply a preset at the next block, with a ramp
+	// of ramp samples for the continuous parameters
+	bool recallPreset(int preset, int ramp = 0)
+	{
+		if (preset < 0 || preset >= presetCount()) return false;
+		presetrequest r = { fPresets[preset], ramp };
+		return fRequests.push(r);
+	}
+
+	// -- audio thread side
+
+	/**
+	 * Compute count samples, applying the last recalled preset at the start
+	 * of the block. The block is computed in chunks while ramping.
+	 */
+	void compute(dsp* DSP, int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs)
+	{
+		presetrequest r;
+		bool recalled = false;
+		while (fRequests.front(r)) {
+			fRequests.pop();
+			recalled = true;
+		}
+		if (recalled) startRecall(r);
+
+		if (fRampLeft == 0) {
+			DSP->compute(count, inputs, outputs);
+			return;
+		}
+
+		int pos = 0;
+
+		if (!canSlice(DSP)) {
+			// too many channels to split the block : the ramp advances by whole blocks
+			fRampLeft = (fRampLeft > count) ? fRampLeft - count : 0;
+			updateRamp();
+			DSP->compute(count, inputs, outputs);
+			return;
+		}
+
+		while (pos < count) {
+			int n = count - pos;
+			if (fRampLeft > 0) {
+				if (n > kRampChunk) n = kRampChunk;
+				if (n > fRampLeft) n = fRampLeft;
+				fRampLeft -= n;
+				updateRamp();
+			}
+			computeSlice(DSP, pos, n, inputs, outputs);
+			pos += n;
+		}
+	}
+
+ private:
+
+	void startRecall(const presetrequest& r)
+	{
+		fRampTarget = r.fValues;
+		fRampLength = fRampLeft = (r.fRamp > 0) ? r.fRamp : 0;
+		fRampStart.resize(fZones.size());
+		for (unsigned int i=0; i<fZones.size(); i++) {
+			fRampStart[i] = *fZones[i];
+			if (fRampLeft == 0 || !fRamped[i]) *fZones[i] = fRampTarget[i];
+		}
+	}
+
+	// values at the end of the next chunk
+	void updateRamp()
+	{
+		FAUSTFLOAT t = FAUSTFLOAT(fRampLength - fRampLeft) / FAUSTFLOAT(fRampLength);
+		for (unsigned int i=0; i<fZones.size(); i++) {
+			if (!fRamped[i]) continue;
+			*fZones[i] = (fRampLeft == 0) ? fRampTarget[i] : fRampStart[i] + (fRampTarget[i] - fRampStart[i]) * t;
+		}
+	}
+
+ public:
 
     // -- widget's layouts (just keep track of group labels)
 
@@ -120,8 +334,8 @@ class FUI : public UI
 
     // -- active widgets (just add an element)
 
-    virtual void addButton(const char* label, FAUSTFLOAT* zone) 		{ addElement(label, zone); }
-    virtual void addCheckButton(const char* label, FAUSTFLOAT* zone) 	{ addElement(label, zone); }
+    virtual void addButton(const char* label, FAUSTFLOAT* zone) 		{ addElement(label, zone, false); }
+    virtual void addCheckButton(const char* label, FAUSTFLOAT* zone) 	{ addElement(label, zone, false); }
     virtual void addVerticalSlider(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT , FAUSTFLOAT , FAUSTFLOAT , FAUSTFLOAT)
     																{ addElement(label, zone); }
     virtual void addHorizontalSlider(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT , FAUSTFLOAT , FAUSTFLOAT , FAUSTFLOAT)
@@ -138,6 +352,33 @@ class FUI : public UI
 
     virtual void declare(FAUSTFLOAT*, const char*, const char*) {}
 };
+
+/*******************************************************************************
+ * presetdsp : a dsp decorator applying the presets recalled on a FUI, to be
+ * given to the audio drivers in place of the decorated dsp.
+ ******************************************************************************/
+
+class presetdsp : public dsp
+{
+    private:
+
+        dsp*    fDSP;
+        FUI*    fFUI;
+
+    public:
+
+        presetdsp(dsp* DSP, FUI* fui) : fDSP(DSP), fFUI(fui) {}
+        virtual ~presetdsp() {}
+
+        virtual int getNumInputs() { return fDSP->getNumInputs(); }
+        virtual int getNumOutputs() { return fDSP->getNumOutputs(); }
+        virtual void buildUserInterface(UI* ui_interface) { fDSP->buildUserInterface(ui_interface); }
+        virtual void init(int samplingRate) { fDSP->init(samplingRate); }
+        virtual void compute(int len, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs)
+        {
+            fFUI->compute(fDSP, len, inputs, outputs);
+        }
+};
 #endif
 
 #endif
@@ -2,8 +2,10 @@
 #define FAUST_GUI_H
 
 #include "faust/gui/UI.h"
+#include "faust/gui/ControlQueue.h"
 #include <list>
 #include <map>
+#include <algorithm>
 
 /*******************************************************************************
  * GUI : Abstract Graphic User Interface
@@ -31,10 +33,11 @@ class GUI : public UI
  	static std::list<GUI*>	fGuiList;
 	zmap                    fZoneMap;
 	bool                    fStopped;
+	ControlQueue*           fQueue;
 	
  public:
 		
-    GUI() : fStopped(false) 
+    GUI() : fStopped(false), fQueue(0) 
     {	
 		fGuiList.push_back(this);
 	}
@@ -62,13 +65,37 @@ class GUI : public UI
 	
 	void updateZone(FAUSTFLOAT* z);
 	
+	static void updateQueuedZones(ControlQueue* q);
+	
 	static void updateAllGuis()
 	{
+		std::list<ControlQueue*> queues;
 		std::list<GUI*>::iterator g;
 		for (g = fGuiList.begin(); g != fGuiList.end(); g++) {
-			(*g)->updateAllZones();
+			if (!(*g)->fQueue) {
+				(*g)->updateAllZones();
+			} else if (std::find(queues.begin(), queues.end(), (*g)->fQueue) == queues.end()) {
+				queues.push_back((*g)->fQueue);
+			}
 		}
+		// each queue is drained once, by its single consumer
+		std::list<ControlQueue*>::iterator q;
+		for (q = queues.begin(); q != queues.end(); q++) updateQueuedZones(*q);
 	}
+	
+	// -- setQueue(q) : zones are written by the audio thread through q (see ControlQueue.h)
+	
+	void setQueue(ControlQueue* q) { fQueue = q; }
+	
+	// -- pushZone(z,v) : false without a queue, v is dropped when the queue is full
+	
+	bool pushZone(FAUSTFLOAT* z, FAUSTFLOAT v)
+	{
+		if (!fQueue) return false;
+		fQueue->push(z, v);
+		return true;
+	}
+	
     void addCallback(FAUSTFLOAT* zone, uiCallback foo, void* data);
     virtual void show() {};	
     virtual void run() {};
@@ -105,6 +132,8 @@ class uiItem
 	{ 
 		fCache = v;
 		if (*fZone != v) {
+			// with a queue, the other items are updated when the audio thread applies v
+			if (fGUI->pushZone(fZone, v)) return;
 			*fZone = v;
 			fGUI->updateZone(fZone);
 		}
@@ -164,6 +193,25 @@ inline void GUI::updateAllZones()
 	}
 }
 
+/**
+ * Update the user items of the zones written by the audio thread : the
+ * queue is drained once, and each value goes to all the GUIs sharing
+ * the queue that have the zone
+ */
+
+inline void GUI::updateQueuedZones(ControlQueue* q)
+{
+	zoneupdate u;
+	while (q->pop(u)) {
+		std::list<GUI*>::iterator g;
+		for (g = fGuiList.begin(); g != fGuiList.end(); g++) {
+			if ((*g)->fQueue == q && (*g)->fZoneMap.find(u.fZone) != (*g)->fZoneMap.end()) {
+				(*g)->updateZone(u.fZone);
+			}
+		}
+	}
+}
+
 inline void GUI::addCallback(FAUSTFLOAT* zone, uiCallback foo, void* data) 
 { 
 	new uiCallbackItem(this, zone, foo, data); 
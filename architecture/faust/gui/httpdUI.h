@@ -14,6 +14,7 @@
 //#else
 #include "faust/gui/HTTPDControler.h"
 #include "faust/gui/UI.h"
+#include "faust/gui/ControlQueue.h"
 //#endif
 /******************************************************************************
 *******************************************************************************
@@ -41,9 +42,31 @@ Space or tabulation are replaced with '_' (underscore)
 
 //using namespace std;
 
+/**
+ * Writes the values received by the server through a ControlQueue, when there is one
+ */
+class httpdZoneWriter : public httpdfaust::ZoneWriter
+{
+	ControlQueue*	fQueue;
+
+	void store(FAUSTFLOAT* zone, FAUSTFLOAT val)	{ if (fQueue) fQueue->push(zone, val); else *zone = val; }
+	template <typename C> void store(C* zone, C val)	{ *zone = val; }
+
+ public:
+
+	httpdZoneWriter() : fQueue(0) {}
+
+	void setQueue(ControlQueue* q)	{ fQueue = q; }
+
+	// dropped when the queue is full
+	virtual void write(float* zone, float val)		{ store(zone, val); }
+	virtual void write(double* zone, double val)	{ store(zone, val); }
+};
+
 class httpdUI : public UI 
 {
 	httpdfaust::HTTPDControler*	fCtrl;	
+	httpdZoneWriter				fWriter;
 	const char* tr(const char* label) const;
 
  public:
@@ -51,6 +74,7 @@ class httpdUI : public UI
 	httpdUI(const char* applicationname, int inputs, int outputs, int argc, char *argv[], bool init = true) 
     { 
 		fCtrl = new httpdfaust::HTTPDControler(argc, argv, applicationname, init); 
+		fCtrl->setWriter(&fWriter);
         fCtrl->setInputs(inputs);
         fCtrl->setOutputs(outputs);
 	}
@@ -82,6 +106,8 @@ class httpdUI : public UI
     virtual void declare (FAUSTFLOAT*, const char* key, const char* val) { fCtrl->declare(key, val); }
 
 	void run()						{ fCtrl->run(); }
+	// the received values are written by the audio thread through q (see ControlQueue.h)
+	void setQueue(ControlQueue* q)	{ fWriter.setQueue(q); }
 	int getTCPPort()                { return fCtrl->getTCPPort(); }
     
     std::string getJSONInterface(){ return fCtrl->getJSONInterface(); }
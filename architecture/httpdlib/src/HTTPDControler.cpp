@@ -45,10 +45,13 @@ using namespace std;
 namespace httpdfaust
 {
 
-#define kVersion	 0.72f
-#define kVersionStr	"0.72"
+#define kVersion	 0.73f
+#define kVersionStr	"0.73"
 
-static const char* kPortOpt	= "-port";
+#define kMaxWait	30000		// the maximum duration of a long-poll request, in ms
+
+static const char* kPortOpt		= "-port";
+static const char* kThreadsOpt	= "-httpdthreads";
 
 //--------------------------------------------------------------------------
 // utility for command line arguments 
@@ -64,6 +67,18 @@ static int getPortOption (int argc, char *argv[], const std::string& option, int
 	return defaultValue;
 }
 
+static int getThreadsOption (int argc, char *argv[], const std::string& option, int defaultValue)
+{
+	for (int i=0; i < argc-1; i++) {
+		if (option == argv[i]) {
+			char* end;
+			int val = strtol( argv[i+1], &end, 10);
+			if ((end != argv[i+1]) && (val >= 0)) return val;
+		}
+	}
+	return defaultValue;
+}
+
 //--------------------------------------------------------------------------
 // utility for host name and ip address 
 //--------------------------------------------------------------------------
@@ -88,9 +103,10 @@ static bool getNetInfos(string& name, string& ip)
 
 //--------------------------------------------------------------------------
 HTTPDControler::HTTPDControler (int argc, char *argv[], const char* applicationname, bool init)
-	: fTCPPort(kTCPBasePort), fJson(0), fInit(init)
+	: fTCPPort(kTCPBasePort), fThreads(1), fJson(0), fInit(init)
 {
 	fTCPPort = getPortOption (argc, argv, kPortOpt, fTCPPort);
+	fThreads = getThreadsOption (argc, argv, kThreadsOpt, fThreads);
 	fFactory = new FaustFactory();
 	fHttpd = new HTTPDSetup();
 	
@@ -110,6 +126,9 @@ HTTPDControler::~HTTPDControler ()
 	delete fJson;
 }
 
+//--------------------------------------------------------------------------
+void HTTPDControler::setWriter (ZoneWriter* writer)	{ fFactory->setWriter (writer); }
+
 //--------------------------------------------------------------------------
 float HTTPDControler::version()				{ return kVersion; }
 const char* HTTPDControler::versionstr()	{ return kVersionStr; }
@@ -186,8 +205,14 @@ void HTTPDControler::run ()
 	if (root) {
 		// and cast it to a RootNode
 		RootNode * rootnode = dynamic_cast<RootNode*> ((MessageDriven*)root);
+		if (rootnode) {
+			rootnode->indexNodes();
+			// a waiting long-poll request holds its thread : with a single thread or a pool,
+			// a few waiting clients would block all the other requests
+			rootnode->setMaxWait (fThreads == 0 ? kMaxWait : 0);
+		}
 		// starts the network services
-		if (fHttpd->start (root, fTCPPort)) {
+		if (fHttpd->start (root, fTCPPort, fThreads)) {
 			stringstream strjson;
 			fJson->root().setPort (fTCPPort);
 			fJson->root().print(strjson);
@@ -197,6 +222,7 @@ void HTTPDControler::run ()
 			fHtml->root().setPort (fTCPPort);
 			fHtml->root().print(strhtml, strjson.str());
 			if (rootnode) rootnode->setHtml (strhtml.str());
+			fHttpd->setPages (strhtml.str(), strjson.str());
 			// and outputs a message
 			cout << "Faust httpd server version " << version() <<  " is running on TCP port " << fTCPPort << endl;
 		}
@@ -100,20 +100,120 @@ static int _get_params (void *cls, enum MHD_ValueKind kind, const char *key, con
 //--------------------------------------------------------------------------
 // the http server
 //--------------------------------------------------------------------------
-HTTPDServer::HTTPDServer(MessageProcessor* mp)
-	: fProcessor(mp), fServer(0), fDebug(false)
+HTTPDServer::HTTPDServer(MessageProcessor* mp, int threads)
+	: fProcessor(mp), fServer(0), fThreads(threads), fDebug(false)
 {
+	for (int i=0; i<kCachedPages; i++) fCache[i] = 0;
+#ifdef _WIN32
+	InitializeCriticalSection (&fCacheLock);
+#else
+	pthread_mutex_init (&fCacheLock, 0);
+#endif
 }
 
-HTTPDServer::~HTTPDServer() { stop(); }
+HTTPDServer::~HTTPDServer()
+{
+	stop();
+#ifdef _WIN32
+	DeleteCriticalSection (&fCacheLock);
+#else
+	pthread_mutex_destroy (&fCacheLock);
+#endif
+}
 
 //--------------------------------------------------------------------------
 bool HTTPDServer::start(int port)
 {
-	fServer = MHD_start_daemon (MHD_USE_SELECT_INTERNALLY, port, NULL, NULL, _answer_to_connection, this, MHD_OPTION_END);
+	if (fThreads == 0)
+		fServer = MHD_start_daemon (MHD_USE_THREAD_PER_CONNECTION, port, NULL, NULL, _answer_to_connection, this, MHD_OPTION_END);
+	else if (fThreads == 1)
+		fServer = MHD_start_daemon (MHD_USE_SELECT_INTERNALLY, port, NULL, NULL, _answer_to_connection, this, MHD_OPTION_END);
+	else {
+		unsigned int flags = MHD_USE_SELECT_INTERNALLY;
+#if defined(__linux__) && (MHD_VERSION >= 0x00093300)
+		// the threads of the pool share the listening socket using epoll
+		fServer = MHD_start_daemon (flags | MHD_USE_EPOLL_LINUX_ONLY, port, NULL, NULL, _answer_to_connection, this,
+									MHD_OPTION_THREAD_POOL_SIZE, (unsigned int)fThreads, MHD_OPTION_END);
+		if (fServer) return true;		// otherwise the library may have been compiled without epoll support
+#endif
+		fServer = MHD_start_daemon (flags, port, NULL, NULL, _answer_to_connection, this,
+									MHD_OPTION_THREAD_POOL_SIZE, (unsigned int)fThreads, MHD_OPTION_END);
+	}
 	return fServer != 0;
 }
 
+//--------------------------------------------------------------------------
+void HTTPDServer::stop()
+{
+	if (fServer) MHD_stop_daemon (fServer);
+	fServer = 0;
+	for (int i=0; i<kCachedPages; i++) {
+		if (fCache[i]) MHD_destroy_response (fCache[i]);
+		fCache[i] = 0;
+	}
+}
+
+//--------------------------------------------------------------------------
+// the lock publishes the responses : a server thread reading a pointer also
+// sees the content of the response
+struct MHD_Response * HTTPDServer::getCache (int page)
+{
+#ifdef _WIN32
+	EnterCriticalSection (&fCacheLock);
+	struct MHD_Response * response = fCache[page];
+	LeaveCriticalSection (&fCacheLock);
+#else
+	pthread_mutex_lock (&fCacheLock);
+	struct MHD_Response * response = fCache[page];
+	pthread_mutex_unlock (&fCacheLock);
+#endif
+	return response;
+}
+
+void HTTPDServer::setCache (int page, struct MHD_Response * response)
+{
+#ifdef _WIN32
+	EnterCriticalSection (&fCacheLock);
+	fCache[page] = response;
+	LeaveCriticalSection (&fCacheLock);
+#else
+	pthread_mutex_lock (&fCacheLock);
+	fCache[page] = response;
+	pthread_mutex_unlock (&fCacheLock);
+#endif
+}
+
+//--------------------------------------------------------------------------
+// the content is copied once by the library, the response can then be
+// queued any number of times, from any thread
+struct MHD_Response * HTTPDServer::response (const string& content, const char* type)
+{
+	struct MHD_Response *response = MHD_create_response_from_buffer (content.size(), (void *) content.c_str(), MHD_RESPMEM_MUST_COPY);
+	if (response) {
+		MHD_add_response_header (response, "Content-Type", type);
+		MHD_add_response_header (response, "Access-Control-Allow-Origin", "*");
+	}
+	return response;
+}
+
+//--------------------------------------------------------------------------
+void HTTPDServer::setPages (const string& html, const string& json)
+{
+	// the pages are set once, while the server is already running: the responses
+	// are complete when their pointers are published, a request can only miss them
+	setCache (kUIPage, response (html, "text/html"));
+	setCache (kJSONPage, response (json, "application/json"));
+}
+
+//--------------------------------------------------------------------------
+int HTTPDServer::cached (struct MHD_Connection *connection, const char *url)
+{
+	struct MHD_Response *response = 0;
+	if (!strcmp (url, "/"))				response = getCache (kUIPage);
+	else if (!strcmp (url, "/JSON"))	response = getCache (kJSONPage);
+	return response ? MHD_queue_response (connection, MHD_HTTP_OK, response) : MHD_NO;
+}
+
 //--------------------------------------------------------------------------
 int HTTPDServer::send (struct MHD_Connection *connection, const char *page, const char* type, int status)
 {
@@ -206,6 +306,11 @@ int HTTPDServer::answer (struct MHD_Connection *connection, const char *url, con
 		return send (connection, msg.c_str(), 0, MHD_HTTP_BAD_REQUEST);
 	}
 
+	// the UI page and the JSON description don't depend on the server state
+	if ((t == MHD_GET_ARGUMENT_KIND) && !fDebug && (MHD_get_connection_values (connection, t, NULL, NULL) == 0)) {
+		if (cached (connection, url) == MHD_YES) return MHD_YES;
+	}
+
 	Message msg (url);
 	MHD_get_connection_values (connection, t, _get_params, &msg);
 	vector<Message*> outMsgs;
@@ -47,6 +47,8 @@
 #ifdef __MINGW32__
 typedef size_t socklen_t;
 #endif
+#else
+#include <pthread.h>
 #endif
 
 #include <microhttpd.h>
@@ -63,21 +65,37 @@ class MessageProcessor;
 */
 class HTTPDServer
 {
+	enum { kUIPage, kJSONPage, kCachedPages };
+
 	MessageProcessor*	fProcessor;
 	struct MHD_Daemon *	fServer;
+	int					fThreads;		// 0: one thread per connection, 1: a single select thread, n: a pool of n threads
 	bool				fDebug;
+	struct MHD_Response *	fCache[kCachedPages];	// persistent responses for the immutable pages
+#ifdef _WIN32
+	CRITICAL_SECTION	fCacheLock;		// fCache is set by the application thread, read by the server threads
+#else
+	pthread_mutex_t		fCacheLock;		// fCache is set by the application thread, read by the server threads
+#endif
 	
 	int send (struct MHD_Connection *connection, std::vector<Message*> msgs);
 	int page (struct MHD_Connection *connection, const char *page);
+	int cached (struct MHD_Connection *connection, const char *url);
 	const char* getMIMEType (const std::string& page);
+	struct MHD_Response * response (const std::string& content, const char* type);
+	struct MHD_Response * getCache (int page);
+	void				setCache (int page, struct MHD_Response * response);
 
 	public:
-				 HTTPDServer(MessageProcessor* mp);
+				 HTTPDServer(MessageProcessor* mp, int threads=1);
 		virtual ~HTTPDServer();
 
 		/// \brief starts the httpd server
 		bool start (int port);
-		void stop ()			{ if (fServer) MHD_stop_daemon (fServer); fServer=0; }
+		void stop ();
+
+		/// \brief sets the UI page and the JSON description, answered without copy from then on
+		void setPages (const std::string& html, const std::string& json);
 		int answer (struct MHD_Connection *connection, const char *url, const char *method, const char *version, 
 					const char *upload_data, size_t *upload_data_size, void **con_cls);
 
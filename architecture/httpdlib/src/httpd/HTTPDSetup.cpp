@@ -41,11 +41,11 @@ bool HTTPDSetup::running() const	{ return fServer ? true : false; }
 //bool HTTPDSetup::running() const	{ return fServer ? fServer->isRunning() : false; }
 
 //--------------------------------------------------------------------------
-bool HTTPDSetup::start(MessageProcessor* mp, int& tcpport )
+bool HTTPDSetup::start(MessageProcessor* mp, int& tcpport, int threads )
 {
 	int port = tcpport;
 	bool done = false;
-	fServer = new HTTPDServer (mp);
+	fServer = new HTTPDServer (mp, threads);
 	do {
 		done = fServer->start(port);
 		if (!done) {
@@ -57,6 +57,12 @@ bool HTTPDSetup::start(MessageProcessor* mp, int& tcpport )
 	return true;
 }
 
+//--------------------------------------------------------------------------
+void HTTPDSetup::setPages(const std::string& html, const std::string& json)
+{
+	if (fServer) fServer->setPages (html, json);
+}
+
 //--------------------------------------------------------------------------
 void HTTPDSetup::stop()
 {
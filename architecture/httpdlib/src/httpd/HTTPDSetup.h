@@ -44,7 +44,8 @@ class HTTPDSetup
 		 		 HTTPDSetup() : fServer(0) {} 
 		virtual ~HTTPDSetup();
 
-		bool start(MessageProcessor* mp, int& port);
+		bool start(MessageProcessor* mp, int& port, int threads=1);
+		void setPages(const std::string& html, const std::string& json);
 
 		void stop();
 		bool running() const;
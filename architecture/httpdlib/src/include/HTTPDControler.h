@@ -38,6 +38,21 @@ class FaustFactory;
 class jsonfactory;
 class htmlfactory;
 
+//--------------------------------------------------------------------------
+/*!
+	\brief writes the values received from the network into the parameter zones
+	
+	The HTTP server threads call it instead of writing the zones, so that the zones
+	can be written by the audio thread (see httpdUI::setQueue).
+*/
+class ZoneWriter
+{
+	public:
+		virtual ~ZoneWriter() {}
+		virtual void write (float* zone, float val) = 0;
+		virtual void write (double* zone, double val) = 0;
+};
+
 //--------------------------------------------------------------------------
 /*!
 	\brief the main Faust HTTPD Lib API
@@ -48,6 +63,7 @@ class htmlfactory;
 class HTTPDControler
 {
 	int fTCPPort;				// the tcp port number
+	int fThreads;				// the server threads count (0 for one thread per connection)
 	FaustFactory *	fFactory;	// a factory to build the memory representation
 	jsonfactory*	fJson;
 	htmlfactory*	fHtml;
@@ -79,6 +95,8 @@ class HTTPDControler
 		void opengroup (const char* type, const char* label);
 		void closegroup ();
 
+		void setWriter (ZoneWriter* writer);	// to be called before the nodes are added
+
 		//--------------------------------------------------------------------------
 		void run ();				// start the httpd server
 		void quit ();				// stop the httpd server
@@ -30,6 +30,7 @@
 
 #include "MessageDriven.h"
 #include "FaustNode.h"
+#include "HTTPDControler.h"
 
 namespace httpdfaust
 {
@@ -48,9 +49,10 @@ class FaustFactory
 {
 	std::stack<SMessageDriven>	fNodes;		///< maintains the current hierarchy level
 	SMessageDriven				fRoot;		///< keep track of the root node
+	ZoneWriter*					fWriter;	///< writes the received values, 0 to write them directly
 
 	public:
-				 FaustFactory() {}
+				 FaustFactory() : fWriter(0) {}
 		virtual ~FaustFactory() {}
 
 		/**
@@ -61,7 +63,7 @@ class FaustFactory
 			SMessageDriven top = fNodes.size() ? fNodes.top() : fRoot;
 			if (top) {
 				std::string prefix = top->getAddress();
-				top->add( FaustNode<C>::create (label, zone, init, min, max, prefix.c_str(), initZone));
+				top->add( FaustNode<C>::create (label, zone, init, min, max, prefix.c_str(), initZone, fWriter));
 			}
 		}
 
@@ -73,13 +75,15 @@ class FaustFactory
 			SMessageDriven top = fNodes.size() ? fNodes.top() : fRoot;
 			if (top) {
 				std::string prefix = top->getAddress();
-				top->add( FaustNode<C>::create (label, zone, min, max, prefix.c_str(), initZone) );
+				top->add( FaustNode<C>::create (label, zone, min, max, prefix.c_str(), initZone, fWriter) );
 			}
 		}
 
 		void opengroup (const char* label);
 		void closegroup ();
 
+		void setWriter (ZoneWriter* writer)	{ fWriter = writer; }
+
 		SMessageDriven	root() const	{ return fRoot; }
 };
 
@@ -30,6 +30,7 @@
 
 #include "MessageDriven.h"
 #include "Message.h"
+#include "HTTPDControler.h"
 
 namespace httpdfaust
 {
@@ -60,27 +61,33 @@ template <typename C> class FaustNode : public MessageDriven
 {
 	C *	fZone;			// the parameter memory zone
 	mapping<C>	fMapping;
+	ZoneWriter*	fWriter;	// writes the received values, 0 to write them directly
 	
-	bool store (C val)			{ *fZone = fMapping.scale(val); return true; }
+	bool store (C val)
+	{
+		if (fWriter) fWriter->write (fZone, fMapping.scale(val));
+		else *fZone = fMapping.scale(val);
+		return true;
+	}
 
 
 	protected:
-		FaustNode(const char *name, C* zone, C min, C max, const char* prefix, bool initZone) 
-			: MessageDriven (name, prefix), fZone(zone), fMapping(min, max, min, max) 
+		FaustNode(const char *name, C* zone, C min, C max, const char* prefix, bool initZone, ZoneWriter* writer) 
+			: MessageDriven (name, prefix), fZone(zone), fMapping(min, max, min, max), fWriter(writer) 
 			{ 
                 if(initZone)
                     *zone = min; 
             }
 
-		FaustNode(const char *name, C* zone, C init, C min, C max, const char* prefix, bool initZone)
-			: MessageDriven (name, prefix), fZone(zone), fMapping(min, max, min, max) 
+		FaustNode(const char *name, C* zone, C init, C min, C max, const char* prefix, bool initZone, ZoneWriter* writer)
+			: MessageDriven (name, prefix), fZone(zone), fMapping(min, max, min, max), fWriter(writer) 
 			{ 
                 if(initZone)
                     *zone = init; 
             }
 			
-		FaustNode(const char *name, C* zone,  C imin, C imax, C init, C min, C max, const char* prefix, bool initZone) 
-			: MessageDriven (name, prefix), fZone(zone), fMapping(imin, imax, min, max) 
+		FaustNode(const char *name, C* zone,  C imin, C imax, C init, C min, C max, const char* prefix, bool initZone, ZoneWriter* writer) 
+			: MessageDriven (name, prefix), fZone(zone), fMapping(imin, imax, min, max), fWriter(writer) 
 			{ 
                 if(initZone)
                     *zone = init; 
@@ -89,12 +96,12 @@ template <typename C> class FaustNode : public MessageDriven
 
 	public:
 		typedef SMARTP<FaustNode<C> > SFaustNode;
-		static SFaustNode create (const char* name, C* zone, C min, C max, const char* prefix, bool initZone)
-							{ return new FaustNode(name, zone, min, max, prefix, initZone); }
-		static SFaustNode create (const char* name, C* zone, C init, C min, C max, const char* prefix, bool initZone)	
-							{ return new FaustNode(name, zone, init, min, max, prefix, initZone); }
-		static SFaustNode create (const char* name, C* zone, C imin, C imax, C init, C min, C max, const char* prefix, bool initZone)	
-							{ return new FaustNode(name, zone, imin, imax, init, min, max, prefix, initZone); }
+		static SFaustNode create (const char* name, C* zone, C min, C max, const char* prefix, bool initZone, ZoneWriter* writer = 0)
+							{ return new FaustNode(name, zone, min, max, prefix, initZone, writer); }
+		static SFaustNode create (const char* name, C* zone, C init, C min, C max, const char* prefix, bool initZone, ZoneWriter* writer = 0)	
+							{ return new FaustNode(name, zone, init, min, max, prefix, initZone, writer); }
+		static SFaustNode create (const char* name, C* zone, C imin, C imax, C init, C min, C max, const char* prefix, bool initZone, ZoneWriter* writer = 0)	
+							{ return new FaustNode(name, zone, imin, imax, init, min, max, prefix, initZone, writer); }
 
 
 		virtual bool	accept( const Message* msg, std::vector<Message*>& outMsg )	///< handler for the 'accept' message
@@ -120,6 +127,8 @@ template <typename C> class FaustNode : public MessageDriven
 					msg->add (float(*fZone));
 					outMsg.push_back(msg);
 				}
+
+		virtual bool	getValue (float& val) const		{ val = float(*fZone); return true; }
 };
 
 } // end namespoace
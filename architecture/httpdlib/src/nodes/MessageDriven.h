@@ -107,6 +107,12 @@ class MessageDriven : public MessageProcessor, public smartable
 		*/
 		virtual void	get (std::vector<Message*>& outMsg) const;		///< handler for the 'get' message
 
+		/*!
+			\brief gives the node value
+			\return false when the node has no value (i.e. when it is not a terminal node)
+		*/
+		virtual bool	getValue (float& val) const		{ return false; }
+
 		void			add ( SMessageDriven node )	{ fSubNodes.push_back (node); }
 		const char*		getName() const				{ return fName.c_str(); }
 		std::string		getAddress() const;
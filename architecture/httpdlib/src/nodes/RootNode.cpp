@@ -21,7 +21,20 @@
 
 */
 
+#ifdef _WIN32
+#include <windows.h>
+#define sleepms(ms)	Sleep(ms)
+#else
+#include <unistd.h>
+#define sleepms(ms)	usleep((ms)*1000)
+#endif
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
 #include <string>
+#include <sstream>
 
 #include "RootNode.h"
 #include "Message.h"
@@ -32,6 +45,111 @@ namespace httpdfaust
 {
 
 static const char * kJSONAddr = "/JSON";
+static const char * kValuesAddr = "/VALUES";
+
+#define kPollPeriod		10		// the values polling period of the long-poll requests, in ms
+
+//--------------------------------------------------------------------------
+// a JSON string : the quotes, the backslashes and the control characters of
+// the labels are escaped
+static string jsonString (const string& str)
+{
+	string out = "\"";
+	for (unsigned int i=0; i<str.size(); i++) {
+		unsigned char c = str[i];
+		if ((c == '"') || (c == '\\')) {
+			out += '\\';
+			out += c;
+		}
+		else if (c < 0x20) {
+			char esc[8];
+			snprintf (esc, sizeof(esc), "\\u%04x", c);
+			out += esc;
+		}
+		else out += c;
+	}
+	return out + "\"";
+}
+
+//--------------------------------------------------------------------------
+void RootNode::indexNodes()
+{
+	fAddresses.clear();
+	fValues.clear();
+	fKeys.clear();
+	index (this);
+}
+
+void RootNode::index (MessageDriven* node)
+{
+	string address = node->getAddress();
+	if (fAddresses.find(address) == fAddresses.end())
+		fAddresses[address] = node;
+	float val;
+	if (node->getValue (val)) {
+		fValues.push_back (node);
+		fKeys.push_back (string("\n\t\t") + jsonString(address) + ": ");
+	}
+	for (int i=0; i<node->size(); i++)
+		index (node->subnode(i));
+}
+
+//--------------------------------------------------------------------------
+// reads the values of the terminal nodes
+// and returns a state string that changes with the values
+string RootNode::read (vector<float>& values) const
+{
+	unsigned int h = 2166136261u;		// FNV-1a hash of the values
+	values.resize (fValues.size());
+	for (unsigned int i=0; i<fValues.size(); i++) {
+		float v = 0;
+		fValues[i]->getValue (v);
+		values[i] = v;
+		unsigned char b[sizeof(float)];
+		memcpy (b, &v, sizeof(float));
+		for (unsigned int j=0; j<sizeof(float); j++) h = (h ^ b[j]) * 16777619u;
+	}
+	char state[16];
+	snprintf (state, sizeof(state), "v%08x", h);
+	return state;
+}
+
+//--------------------------------------------------------------------------
+// answers all the values at once, with the 'state' of the values
+// when the request carries the current state and a 'wait' duration, the
+// answer is delayed until a value changes or the duration expires (long-poll)
+void RootNode::values (const Message* msg, vector<Message*>& outMsg) const
+{
+	string state;
+	float wait = 0;
+	for (int i=0; i+1 < msg->size(); i+=2) {
+		string key;
+		if (!msg->param(i, key)) continue;
+		if (key == "state")		msg->param(i+1, state);
+		else if (key == "wait")	msg->param(i+1, wait);
+	}
+	int maxwait = (wait < fMaxWait) ? int(wait) : fMaxWait;
+
+	vector<float> vals;
+	string current = read (vals);
+	for (int t=0; (current == state) && (t < maxwait); t += kPollPeriod) {
+		sleepms (kPollPeriod);
+		current = read (vals);
+	}
+
+	stringstream out;
+	out << "{\n\t\"state\": \"" << current << "\",\n\t\"values\": {";
+	for (unsigned int i=0; i<vals.size(); i++) {
+		if (i) out << ",";
+		out << fKeys[i];
+		if ((vals[i] == vals[i]) && (fabs(vals[i]) <= FLT_MAX)) out << vals[i];
+		else out << "null";
+	}
+	out << "\n\t}\n}";
+	Message* answer = new Message (out.str());
+	answer->setMIMEType ("application/json");
+	outMsg.push_back (answer);
+}
 
 
 //--------------------------------------------------------------------------
@@ -47,6 +165,14 @@ bool RootNode::processMessage( const Message* msg, vector<Message*>& outMsg )
 		outMsg.push_back (msg);
 		return true;
 	}
+	else if (addr == kValuesAddr) {
+		values (msg, outMsg);
+		return true;
+	}
+	// exact addresses are dispatched without walking the tree
+	map<string, MessageDriven*>::const_iterator i = fAddresses.find (addr);
+	if ((i != fAddresses.end()) && i->second->accept (msg, outMsg))
+		return true;
 	return MessageDriven::processMessage( msg, outMsg );
 }
 
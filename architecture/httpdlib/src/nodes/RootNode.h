@@ -25,7 +25,9 @@
 #ifndef __RootNode__
 #define __RootNode__
 
+#include <map>
 #include <string>
+#include <vector>
 #include "MessageDriven.h"
 
 namespace httpdfaust
@@ -42,9 +44,17 @@ class RootNode : public MessageDriven
 {
 	std::string fJson;
 	std::string fHtml;
+	std::map<std::string, MessageDriven*>	fAddresses;	///< the nodes indexed by their address
+	std::vector<const MessageDriven*>		fValues;	///< the terminal nodes
+	std::vector<std::string>				fKeys;		///< the JSON keys of the terminal nodes
+	int										fMaxWait;	///< the maximum long-poll duration in ms
+
+	void			index (MessageDriven* node);
+	std::string		read (std::vector<float>& values) const;
+	void			values (const Message* msg, std::vector<Message*>& outMsg) const;
 	
 	protected:
-				 RootNode(const char *name) : MessageDriven (name, "") {}
+				 RootNode(const char *name) : MessageDriven (name, ""), fMaxWait(0) {}
 		virtual ~RootNode() {}
 
 	public:
@@ -52,6 +62,10 @@ class RootNode : public MessageDriven
 
 		void			setJSON( const std::string& uidesc )	{ fJson = uidesc; }
 		void			setHtml( const std::string& html )		{ fHtml = html; }
+		void			setMaxWait( int ms )					{ fMaxWait = ms; }
+
+		/// \brief indexes the tree by address, to be called once the tree is complete and before the server starts
+		void			indexNodes();
 		//--------------------------------------------------------------------------
 		bool			processMessage( const Message* msg, std::vector<Message*>& outMsg );
 		virtual bool	accept( const Message* msg, std::vector<Message*>& outMsg );
@@ -806,10 +806,12 @@ instantiate(const LV2_Descriptor*     descriptor,
     return 0;
   }
   plugin->rate = rate;
+  // Only the first voice is initialized, the others are copies of it.
+  plugin->dsp[0] = new mydsp();
+  plugin->dsp[0]->init(plugin->rate);
   for (int i = 0; i < NVOICES; i++) {
-    plugin->dsp[i] = new mydsp();
+    if (i > 0) plugin->dsp[i] = new mydsp(*plugin->dsp[0]);
     plugin->ui[i] = new LV2UI();
-    plugin->dsp[i]->init(plugin->rate);
     plugin->dsp[i]->buildUserInterface(plugin->ui[i]);
   }
   // The LV2 ports are numbered as follows: 0..k-1 are the control ports, then
@@ -1369,8 +1371,9 @@ static void
 activate(LV2_Handle instance)
 {
   LV2SynthPlugin* plugin = (LV2SynthPlugin*)instance;
-  for (int i = 0; i < NVOICES; i++)
-    plugin->dsp[i]->init(plugin->rate);
+  plugin->dsp[0]->init(plugin->rate);
+  for (int i = 1; i < NVOICES; i++)
+    *plugin->dsp[i] = *plugin->dsp[0];
   for (int i = 0, j = 0; i < plugin->ui[0]->nelems; i++) {
     int p = plugin->ui[0]->elems[i].port;
     if (p >= 0) {
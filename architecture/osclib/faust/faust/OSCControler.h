@@ -99,6 +99,8 @@ class OSCControler
 		static const char* versionstr();	// the Faust OSC library version number as a string
 		static bool	gXmit;				// a static variable to control the transmission of values
 										// i.e. the use of the interface as a controler
+		static int	gBundlePeriod;		// when not null, the transmitted values are collected and
+										// sent in OSC bundles every gBundlePeriod milliseconds
 };
 
 }
@@ -63,17 +63,26 @@ template <typename C> struct mapping
 template <typename C> class FaustNode : public MessageDriven, public uiItem
 {
 	mapping<C>	fMapping;
+	std::string	fAddress;		///< the node OSC address
+	FAUSTFLOAT	fSent;			///< the last value sent in a bundle, only used by the feedback thread
 	
-	bool	store (C val)			{ *fZone = fMapping.clip(val); return true; }
-	void	sendOSC () const;
+	// with a queue, the zone is written by the audio thread (see GUI::setQueue)
+	bool	store (C val)
+	{
+		FAUSTFLOAT v = FAUSTFLOAT(fMapping.clip(val));
+		if (!fGUI->pushZone(fZone, v)) *fZone = v;
+		return true;
+	}
+	void	sendOSC ();
 
 
 	protected:
 		FaustNode(const char *name, C* zone, C init, C min, C max, const char* prefix, GUI* ui, bool initZone) 
-			: MessageDriven (name, prefix), uiItem (ui, zone), fMapping(min, max)
+			: MessageDriven (name, prefix), uiItem (ui, zone), fMapping(min, max), fAddress(getOSCAddress())
 			{ 
                 if(initZone)
                     *zone = init; 
+                fSent = *zone;
             }
 			
 		virtual ~FaustNode() {}
@@ -103,6 +112,7 @@ template <typename C> class FaustNode : public MessageDriven, public uiItem
 		}
 
 		virtual void	get (unsigned long ipdest) const;		///< handler for the 'get' message
+		virtual void	sendChanges (OSCStream& out);			///< sends the value when it has changed
 		virtual void 	reflectZone()			{ sendOSC (); fCache = *fZone;}
 };
 
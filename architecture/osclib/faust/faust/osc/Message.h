@@ -93,6 +93,7 @@ template <typename T> class MsgParam : public baseparam
 		virtual ~MsgParam() {}
 		
 		T	getValue() const { return fParam; }
+		void	setValue(T val)	 { fParam = val; }
 		
 		virtual SMARTP<baseparam> copy() const { return new MsgParam<T>(fParam); }
 };
@@ -167,6 +168,26 @@ class Message
 	*/
 	void	add( argPtr val )				{ fArguments.push_back( val ); }
 
+	/*!
+		\brief sets the parameter i (0 <= i <= size()) of the message
+		\param i the parameter index, size() to add a parameter
+		\param val the parameter value
+		\note the current parameter is reused when it has the same type and is not shared,
+		which allows to reuse a message without memory allocation
+	*/
+	template <typename T> void set(int i, T val)
+	{
+		MsgParam<T>* p = (i < size()) ? dynamic_cast<MsgParam<T>*>((baseparam*)fArguments[i]) : 0;
+		if (p && (p->refs() == 1))	p->setValue(val);
+		else if (i < size())		fArguments[i] = new MsgParam<T>(val);
+		else						add<T>(val);
+	}
+	/*!
+		\brief keeps the n first parameters of the message
+		\param n the new parameters count (n <= size())
+	*/
+	void	resize(int n)					{ fArguments.resize(n); }
+
 	/*!
 		\brief sets the message address
 		\param addr the address
@@ -178,6 +199,11 @@ class Message
 		\param addr the address
 	*/
 	void				setAddress(const std::string& addr)		{ fAddress = addr; }
+	/*!
+		\brief sets the message address
+		\param addr the address
+	*/
+	void				setAddress(const char* addr)			{ fAddress = addr; }
 	/*!
 		\brief print the message
 		\param out the output stream
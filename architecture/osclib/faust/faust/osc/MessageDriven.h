@@ -36,6 +36,7 @@ namespace oscfaust
 
 class Message;
 class OSCRegexp;
+class OSCStream;
 class MessageDriven;
 typedef class SMARTP<MessageDriven>	SMessageDriven;
 
@@ -120,6 +121,15 @@ class MessageDriven : public MessageProcessor, public smartable
 		*/
 		virtual void	get (unsigned long ipdest, const std::string & what) const {}
 
+		/*!
+			\brief sends the values changed since the last call
+			\param out the OSC output stream
+
+			The call is propagated to the subnodes until it reaches terminal nodes.
+			It is used to send the feedback of the values in OSC bundles.
+		*/
+		virtual void	sendChanges (OSCStream& out);
+
 		void			add ( SMessageDriven node )	{ fSubNodes.push_back (node); }
 		const char*		getName() const				{ return fName.c_str(); }
 		std::string		getOSCAddress() const;
@@ -24,6 +24,7 @@
 */
 
 #include <stdlib.h>
+#include <limits.h>
 #include <iostream>
 
 #include "faust/OSCControler.h"
@@ -39,17 +40,19 @@ using namespace std;
 namespace oscfaust
 {
 
-#define kVersion	 0.94f
-#define kVersionStr	"0.94"
+#define kVersion	 0.95f
+#define kVersionStr	"0.95"
 
 static const char* kUDPPortOpt	= "-port";
 static const char* kUDPOutOpt	= "-outport";
 static const char* kUDPErrOpt	= "-errport";
 static const char* kUDPDestOpt	= "-desthost";
 static const char* kXmitOpt		= "-xmit";
+static const char* kBundleOpt	= "-bundle";
 
 bool OSCControler::gXmit = false;		// a static variable to control the transmission of values
 										// i.e. the use of the interface as a controler
+int OSCControler::gBundlePeriod = 0;	// the transmitted values are sent in bundles when not null
 
 //--------------------------------------------------------------------------
 // utilities for command line arguments 
@@ -65,6 +68,19 @@ static int getPortOption (int argc, char *argv[], const std::string& option, int
 	return defaultValue;
 }
 
+// the period of the bundles in milliseconds, not a port : any positive number
+static int getBundleOption (int argc, char *argv[], const std::string& option, int defaultValue)
+{
+	for (int i=0; i < argc-1; i++) {
+		if (option == argv[i]) {
+			char* end;
+			long val = strtol( argv[i+1], &end, 10);
+			return (*end == 0 && val > 0 && val <= INT_MAX) ? int(val) : defaultValue;
+		}
+	}
+	return defaultValue;
+}
+
 static const char* getDestOption (int argc, char *argv[], const std::string& option, const char* defaultValue)
 {
 	for (int i=0; i < argc-1; i++) {
@@ -95,6 +111,7 @@ OSCControler::OSCControler (int argc, char *argv[], GUI* ui, OSCIO* io, ErrorCal
 	fUPDErr  = getPortOption (argc, argv, kUDPErrOpt, fUPDErr);
 	fDestAddress = getDestOption (argc, argv, kUDPDestOpt, "localhost");
 	gXmit = getXmitOption (argc, argv, kXmitOpt, false);
+	gBundlePeriod = getBundleOption (argc, argv, kBundleOpt, 0);
 
 	fFactory = new FaustFactory(ui, io);
 	fOsc	= new OSCSetup(errCallback, arg);
@@ -127,9 +144,13 @@ void OSCControler::run ()
 	if (rootnode) {
 		// informs the root node of the udp ports numbers (required to handle the 'hello' message
 		rootnode->setPorts (&fUDPPort, &fUDPOut, &fUPDErr);
+		// the hierarchy is complete : index it before the listener thread uses it
+		rootnode->buildIndex ();
 		// starts the network services
         
 		fOsc->start (rootnode, fUDPPort, fUDPOut, fUPDErr, getDestAddress());
+		// the transmitted values are sent by a separate thread in bundles
+		if (gBundlePeriod > 0) fOsc->startFeedback (rootnode, gBundlePeriod);
 
 		// and outputs a message on the osc output port
 		oscout << OSCStart("Faust OSC version") << versionstr() << "-"
@@ -30,11 +30,31 @@ namespace oscfaust
 {
 
 //--------------------------------------------------------------------------
-template<> void FaustNode<float>::sendOSC () const {
-		if (OSCControler::gXmit) oscout << OSCStart(getOSCAddress().c_str()) << 	float(*fZone) << OSCEnd();
+// with a bundle period, the feedback thread sends the value with sendChanges,
+// comparing it to the last value it sent : no flag is shared with this thread
+template<> void FaustNode<float>::sendOSC () {
+	if (OSCControler::gXmit && OSCControler::gBundlePeriod <= 0)
+		oscout << OSCStart(fAddress.c_str()) << 	float(*fZone) << OSCEnd();
 }
-template<> void FaustNode<double>::sendOSC () const {
-		if (OSCControler::gXmit) oscout << OSCStart(getOSCAddress().c_str()) << 	float(*fZone) << OSCEnd();
+template<> void FaustNode<double>::sendOSC () {
+	if (OSCControler::gXmit && OSCControler::gBundlePeriod <= 0)
+		oscout << OSCStart(fAddress.c_str()) << 	float(*fZone) << OSCEnd();
+}
+
+//--------------------------------------------------------------------------
+template<> void FaustNode<float>::sendChanges (OSCStream& out) {
+	FAUSTFLOAT v = *fZone;
+	if (OSCControler::gXmit && v != fSent) {
+		fSent = v;
+		out << OSCStart(fAddress.c_str()) << 	float(v) << OSCEnd();
+	}
+}
+template<> void FaustNode<double>::sendChanges (OSCStream& out) {
+	FAUSTFLOAT v = *fZone;
+	if (OSCControler::gXmit && v != fSent) {
+		fSent = v;
+		out << OSCStart(fAddress.c_str()) << 	float(v) << OSCEnd();
+	}
 }
 
 //--------------------------------------------------------------------------
@@ -66,6 +66,14 @@ void MessageDriven::get (unsigned long ipdest) const
 		(*i)->get (ipdest);
 }
 
+//--------------------------------------------------------------------------
+// terminal nodes should override the sendChanges method
+void MessageDriven::sendChanges (OSCStream& out)
+{
+	for (vector<SMessageDriven>::const_iterator i = fSubNodes.begin(); i != fSubNodes.end(); i++)
+		(*i)->sendChanges (out);
+}
+
 //--------------------------------------------------------------------------
 bool MessageDriven::accept( const Message* msg )
 {
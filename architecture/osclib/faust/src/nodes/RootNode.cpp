@@ -147,12 +147,49 @@ void RootNode::get (unsigned long ipdest) const		///< handler for the 'get' mess
 //--------------------------------------------------------------------------
 void RootNode::processAlias (const string& address, float val)
 {
-	vector<aliastarget> targets = fAliases[address];	// retrieve the addess aliases
+	std::map<std::string, std::vector<aliastarget> >::const_iterator a = fAliases.find(address);
+	if (a == fAliases.end()) return;					// the address is not an alias
+	const vector<aliastarget>& targets = a->second;		// retrieve the addess aliases
 	size_t n = targets.size();							// no that could point to an arbitraty number of targets
 	for (size_t i = 0; i < n; i++) {					// for each target
 		Message m(targets[i].fTarget);					// create a new message with the target address
 		m.add (targets[i].scale(val));					// add the scaled value of the value
-		MessageDriven::processMessage (&m);				// and do a regular processing of the message
+		dispatch (&m);									// and do a regular processing of the message
+	}
+}
+
+//--------------------------------------------------------------------------
+// dispatching messages
+//--------------------------------------------------------------------------
+void RootNode::indexNodes (MessageDriven* node)
+{
+	fAddresses[node->getOSCAddress()].push_back(node);
+	for (int i = 0; i < node->size(); i++)
+		indexNodes (node->subnode(i));
+}
+
+// called before the listener thread starts : the index is then only read
+void RootNode::buildIndex ()
+{
+	fAddresses.clear();
+	indexNodes (this);
+}
+
+//--------------------------------------------------------------------------
+// an exact address is sent directly to its destination nodes, the addresses
+// including OSC patterns (or regular expression characters) are matched
+// at each level of the hierarchy
+void RootNode::dispatch (const Message* msg)
+{
+	const string& addr = msg->address();
+	if (addr.find_first_of("*?[]{}.()+|^$\\") != string::npos) {
+		MessageDriven::processMessage (msg);
+		return;
+	}
+	std::map<std::string, std::vector<MessageDriven*> >::const_iterator i = fAddresses.find(addr);
+	if (i != fAddresses.end()) {
+		for (size_t n = 0; n < i->second.size(); n++)
+			i->second[n]->accept (msg);
 	}
 }
 
@@ -163,6 +200,10 @@ void RootNode::processMessage( const Message* msg )
 {
 	const string& addr = msg->address();
 	float v; int iv;
+	if (fAliases.empty()) {				// there is no alias to check
+		dispatch (msg);
+		return;
+	}
 	if (msg->size() == 1) {				// there is a single parameter
 		if (msg->param(0, v))			// check the parameter float value
 			processAlias (addr, v);		// and try to process as an alias
@@ -180,7 +221,7 @@ void RootNode::processMessage( const Message* msg )
 		}
 	}
 	// do also a regular processing of the message
-	MessageDriven::processMessage (msg);
+	dispatch (msg);
 }
 
 //--------------------------------------------------------------------------
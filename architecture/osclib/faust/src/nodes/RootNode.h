@@ -89,8 +89,11 @@ class RootNode : public MessageDriven
 	int *fUPDIn, *fUDPOut, *fUDPErr;	// the osc port numbers (required by the hello method)
 	OSCIO * fIO;						// an OSC IO controler
 	std::map<std::string, std::vector<aliastarget> >	fAliases;
+	std::map<std::string, std::vector<MessageDriven*> >	fAddresses;	// the nodes by OSC address
 
 	void processAlias (const std::string& address, float val);
+	void indexNodes (MessageDriven* node);
+	void dispatch (const Message* msg);
 	
 	protected:
 				 RootNode(const char *name, OSCIO* io=0) : MessageDriven (name, ""), fUPDIn(0), fUDPOut(0), fUDPErr(0), fIO(io) {}
@@ -108,6 +111,7 @@ class RootNode : public MessageDriven
 				bool	acceptSignal( const Message* msg );				///< handler for signal data
 				void	hello (unsigned long ipdest) const;				///< handler for the 'hello' message
 				void	setPorts (int* in, int* out, int* err);
+				void	buildIndex ();		///< indexes the nodes by address, once the hierarchy is complete
 };
 
 } // end namespoace
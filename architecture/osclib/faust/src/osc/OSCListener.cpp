@@ -74,28 +74,29 @@ void OSCListener::run()
 //--------------------------------------------------------------------------
 void OSCListener::ProcessMessage( const osc::ReceivedMessage& m, const IpEndpointName& src )
 {
-	Message* msg = new Message(m.AddressPattern());
-	msg->setSrcIP (src.address);
+	fMsg.setAddress (m.AddressPattern());
+	fMsg.setSrcIP (src.address);
 	if (fSetDest && (src.address != kLocalhost))
 	{
 		oscout.setAddress(src.address);
 		fSetDest = false;
 	}
+	int n = 0;
 	ReceivedMessageArgumentIterator i = m.ArgumentsBegin();
 	while (i != m.ArgumentsEnd()) {
 		if (i->IsString()) {
-			msg->add<string>(i->AsStringUnchecked());			
+			fMsg.set<string>(n++, i->AsStringUnchecked());
 		}
 		else if (i->IsInt32()) {
-			msg->add<int>(i->AsInt32Unchecked());			
+			fMsg.set<int>(n++, i->AsInt32Unchecked());
 		}
 		else if (i->IsFloat()) {
-			msg->add<float>(i->AsFloatUnchecked());			
+			fMsg.set<float>(n++, i->AsFloatUnchecked());
 		}
 		i++;
 	}
-	fMsgHandler->processMessage (msg);
-	delete msg;
+	fMsg.resize (n);
+	fMsgHandler->processMessage (&fMsg);
 }
 
 } // end namespoace
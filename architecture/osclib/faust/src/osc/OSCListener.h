@@ -27,6 +27,7 @@
 
 #include "faust/osc/smartpointer.h"
 #include "faust/osc/MessageProcessor.h"
+#include "faust/osc/Message.h"
 
 // oscpack include files
 #include "ip/UdpSocket.h"
@@ -49,6 +50,7 @@ class OSCListener : public osc::OscPacketListener, public smartable
 {
 	UdpListeningReceiveSocket *fSocket;	///< the udp socket listener
 	MessageProcessor * fMsgHandler;
+	Message	fMsg;						///< the incoming messages, reused to avoid memory allocations
 	bool	fRunning;
 	bool	fSetDest;
 	int		fPort;
@@ -24,6 +24,13 @@
 #include <iostream>
 #include <stdexcept>
 
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+#include "faust/OSCControler.h"
+#include "faust/osc/MessageDriven.h"
+
 #include "OSCSetup.h"
 #include "TThreads.h"
 #include "OSCListener.h"
@@ -72,6 +79,43 @@ class OscThread : public TThreads
 		SOSCListener&	listener()		{ return fListener; }
 };
 
+//--------------------------------------------------------------------------
+/*!
+	\brief a specific thread to send the changed values in bundles
+
+	The changed values are collected every period, the values changed
+	several times during a period are sent once.
+*/
+class FeedbackThread : public TThreads
+{
+	MessageDriven*	fRoot;
+	int				fPeriod;		// in milliseconds
+	UdpSocket		fSocket;		// its own socket : oscout is used by the other threads
+	OSCStream		fStream;		// sends on fSocket
+
+	public:
+				 FeedbackThread(MessageDriven* root, int period)
+					: fRoot(root), fPeriod(period), fStream(&fSocket) {}
+		virtual ~FeedbackThread() { quit(); }
+
+		void run ()
+		{
+			while (true) {
+#ifdef WIN32
+				Sleep (fPeriod);
+#else
+				usleep (fPeriod * 1000);
+#endif
+				if (!OSCControler::gXmit) continue;
+				fStream.setAddress (oscout.getAddress());	// follows the oscout destination
+				fStream.setPort (oscout.getPort());
+				fStream.beginBundle();
+				fRoot->sendChanges (fStream);
+				fStream.endBundle();
+			}
+		}
+};
+
 //--------------------------------------------------------------------------
 OSCSetup::~OSCSetup()			{ stop(); }
 bool OSCSetup::running() const	{ return fOSCThread ? fOSCThread->isRunning() : false; }
@@ -104,9 +148,23 @@ bool OSCSetup::start(MessageProcessor* mp, int& inPort, int outPort, int errPort
 	return true;
 }
 
+//--------------------------------------------------------------------------
+void OSCSetup::startFeedback(MessageDriven* root, int period)
+{
+	if (fOSCThread && !fFeedbackThread) {
+		fFeedbackThread = new FeedbackThread (root, period);
+		fFeedbackThread->start();
+	}
+}
+
 //--------------------------------------------------------------------------
 void OSCSetup::stop()
 {
+	if (fFeedbackThread) {
+		fFeedbackThread->quit();
+		delete fFeedbackThread;
+		fFeedbackThread = 0;
+	}
 	if (fOSCThread) {
 		fOSCThread->stop();
 		OSCStream::stop();
@@ -37,7 +37,9 @@ namespace oscfaust
 {
 
 class OscThread;
+class FeedbackThread;
 class MessageProcessor;
+class MessageDriven;
 //--------------------------------------------------------------------------
 /*!
 	\brief network management utility
@@ -45,14 +47,16 @@ class MessageProcessor;
 class OSCSetup
 {
 	OscThread*	fOSCThread;		// a thread that is listening to the osc in socket
+	FeedbackThread*	fFeedbackThread;	// a thread that sends the changed values in bundles
     ErrorCallback fErrCallback;
     void*       fArg;
     
 	public:
-                OSCSetup(ErrorCallback errCallback = NULL, void* arg = NULL) : fOSCThread(0), fErrCallback(errCallback), fArg(arg) {}
+                OSCSetup(ErrorCallback errCallback = NULL, void* arg = NULL) : fOSCThread(0), fFeedbackThread(0), fErrCallback(errCallback), fArg(arg) {}
 		virtual ~OSCSetup();
 
 		bool start(MessageProcessor* mp, int& inPort, int outPort, int errPort, const char* address);
+		void startFeedback(MessageDriven* root, int period);
 
 		void stop();
 		bool running() const;
@@ -20,6 +20,7 @@
 */
 
 #include <iostream>
+#include <string.h>
 #include "OSCStream.h"
 
 using namespace std;
@@ -35,7 +36,7 @@ static UdpSocket* _socket = 0;		// a shared transmit socket
 
 //--------------------------------------------------------------------------
 OSCStream::OSCStream ()
-	: fState(kIdle), fPort(1024), fAddress(kLocalhost), fOutStream(fBuffer, kOutBufferSize), fSocket(_socket)
+	: fState(kIdle), fBundle(false), fBundleSize(0), fPort(1024), fAddress(kLocalhost), fOutStream(fBuffer, kOutBufferSize), fSocket(_socket)
 {
 	if (!fSocket) cerr << "warning: incorrect OSCStream, _socket not initialized" << endl;
 }
@@ -74,8 +75,17 @@ void OSCStream::setAddress (const string& address)
 //--------------------------------------------------------------------------
 OSCStream& OSCStream::start(const char * address)
 { 
-	stream().Clear();
-	if (!stream().IsReady()) cerr << "OSCStream OutboundPacketStream not ready" << endl;
+	if (fBundle) {
+		// sends the current bundle when the message may not fit in the buffer
+		if (stream().Size() + strlen(address) + kMessageMargin > kOutBufferSize) {
+			endBundle();
+			beginBundle();
+		}
+	}
+	else {
+		stream().Clear();
+		if (!stream().IsReady()) cerr << "OSCStream OutboundPacketStream not ready" << endl;
+	}
 	stream() << osc::BeginMessage( address ) ; 
 	fState = kInProgress;
 	return *this;
@@ -84,7 +94,36 @@ OSCStream& OSCStream::start(const char * address)
 //--------------------------------------------------------------------------
 OSCStream& OSCStream::end()
 {
-	send (fAddress, fPort);
+	if (fBundle) {
+		if (state() == kInProgress) {
+			stream() << osc::EndMessage;
+			fBundleSize++;
+			fState = kIdle;
+		}
+	}
+	else send (fAddress, fPort);
+	return *this;
+}
+
+//--------------------------------------------------------------------------
+OSCStream& OSCStream::beginBundle()
+{
+	stream().Clear();
+	stream() << osc::BeginBundleImmediate;
+	fBundle = true;
+	fBundleSize = 0;
+	return *this;
+}
+
+//--------------------------------------------------------------------------
+OSCStream& OSCStream::endBundle()
+{
+	if (fBundle) {
+		stream() << osc::EndBundle;
+		if (fSocket && fBundleSize)
+			fSocket->SendTo (IpEndpointName (fAddress, fPort), stream().Data(), stream().Size() );
+		fBundle = false;
+	}
 	return *this;
 }
 
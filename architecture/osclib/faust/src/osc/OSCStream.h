@@ -56,10 +56,12 @@ typedef struct OSCEnd {} OSCEnd;
 */
 class OSCStream 
 {
-	enum		{ kOutBufferSize = 16384 };
+	enum		{ kOutBufferSize = 16384, kMessageMargin = 64 };
 	enum state	{ kIdle, kInProgress };
 	
 	state		fState;
+	bool		fBundle;			// true when the messages are collected in a bundle
+	int			fBundleSize;		// the number of messages of the current bundle
 	int			fPort;				// the destination UDP port
 	unsigned long fAddress;			// the destination IP address
 	char		fBuffer[kOutBufferSize];
@@ -75,7 +77,7 @@ class OSCStream
 
 				 OSCStream();
 				 OSCStream(UdpSocket* socket) 
-					: fState(kIdle), fPort(1024), fAddress(kLocalhost), fOutStream(fBuffer, kOutBufferSize), fSocket(socket) {} 
+					: fState(kIdle), fBundle(false), fBundleSize(0), fPort(1024), fAddress(kLocalhost), fOutStream(fBuffer, kOutBufferSize), fSocket(socket) {} 
 		virtual ~OSCStream() {}
 		
 		osc::OutboundPacketStream& stream()				{ return fOutStream; }
@@ -88,6 +90,11 @@ class OSCStream
 		OSCStream&			end();
 		void				send(unsigned long ipdest, int port);
 
+		// the messages between beginBundle and endBundle are sent in OSC bundles,
+		// a bundle is sent when the buffer is full
+		OSCStream&			beginBundle();
+		OSCStream&			endBundle();
+
 		void setPort (int port)							{ fPort = port; }
 		void setAddress (unsigned long address)			{ fAddress = address; }
 		void setAddress (const std::string& address);
@@ -49,6 +49,11 @@ typedef unsigned long long uint64;
 
 
 
+// long is 64 bits wide on the LP64 platforms
+#if (defined(__x86_64__) || defined(__LP64__)) && !defined(x86_64)
+#define x86_64
+#endif
+
 #ifdef x86_64
 
 typedef signed int int32;
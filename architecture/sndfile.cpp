@@ -42,8 +42,12 @@
 #include <math.h>
 #include <errno.h>
 #include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
 #include <sndfile.h>
 #include <vector>
+#include <deque>
 #include <stack>
 #include <string>
 #include <map>
@@ -81,110 +85,166 @@
 
   /*******************BEGIN ARCHITECTURE SECTION (part 2/2)***************/
 
-mydsp	DSP;
+/******************************************************************************
+*******************************************************************************
 
-class Separator
-{
-  int		fNumFrames;
-  int		fNumInputs;
-  int		fNumOutputs;
+								OFFLINE RENDERING
 
-  FAUSTFLOAT*	fInput;
-  FAUSTFLOAT*	fOutputs[256];
+	Each pair of input and output files is rendered by a worker owning its
+	own dsp instance. A reader thread, the worker and a writer thread are
+	chained by a bounded ring of blocks, so that file I/O and format
+	conversions overlap the computations of the dsp :
 
-public:
+		reader : free -> full		(sf_readf_float)
+		worker : full -> done		(deinterleave, compute, interleave)
+		writer : done -> free		(sf_writef_float)
 
-  Separator(int numFrames, int numInputs, int numOutputs)
-  {
-    fNumFrames 	= numFrames;
-    fNumInputs 	= numInputs;
-    fNumOutputs = max(numInputs, numOutputs);
+	Several files are rendered concurrently with the -j option, by groups
+	of files of the same sample rate : the static tables of the class are
+	computed for the rate of a group (classInit) before its workers start,
+	and are not changed while they run.
+
+*******************************************************************************
+*******************************************************************************/
+
+#define kFrames 4096		// default number of frames per block
+#define kBlocks 4			// number of blocks in the ring of a pipeline
 
-    // allocate interleaved input channel
-    fInput = (FAUSTFLOAT*) calloc(fNumFrames * fNumInputs, sizeof(FAUSTFLOAT));
+// -- (de)interleaving, with SSE versions for the stereo files
 
-    // allocate separate output channels
-    for (int i = 0; i < fNumOutputs; i++) {
-      fOutputs[i] = (FAUSTFLOAT*) calloc (fNumFrames, sizeof(FAUSTFLOAT));
+template <typename T>
+void deinterleave(const float* input, int chans, T** outputs, int frames)
+{
+  for (int c = 0; c < chans; c++) {
+    T* out = outputs[c];
+    for (int s = 0; s < frames; s++) {
+      out[s] = T(input[c + s*chans]);
     }
   }
+}
 
-  ~Separator()
-  {
-    // free interleaved input channel
-    free(fInput);
-
-    // free separate output channels
-    for (int i = 0; i < fNumOutputs; i++) {
-      free(fOutputs[i]);
+template <typename T>
+void interleave(T** inputs, int chans, float* output, int frames)
+{
+  for (int c = 0; c < chans; c++) {
+    T* in = inputs[c];
+    for (int s = 0; s < frames; s++) {
+      output[c + s*chans] = float(in[s]);
     }
   }
+}
 
-  FAUSTFLOAT*	input()		{ return fInput; }
+#ifdef __SSE__
+#include <xmmintrin.h>
 
-  FAUSTFLOAT** outputs()	{ return fOutputs; }
+void deinterleave(const float* input, int chans, float** outputs, int frames)
+{
+  int s = 0;
+  if (chans == 1) {
+    memcpy(outputs[0], input, frames * sizeof(float));
+    return;
+  } else if (chans == 2) {
+    float* left = outputs[0];
+    float* right = outputs[1];
+    for (; s+4 <= frames; s += 4) {
+      __m128 a = _mm_loadu_ps(input + 2*s);
+      __m128 b = _mm_loadu_ps(input + 2*s + 4);
+      _mm_storeu_ps(left + s, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)));
+      _mm_storeu_ps(right + s, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+    }
+  }
+  for (int c = 0; c < chans; c++) {
+    for (int k = s; k < frames; k++) {
+      outputs[c][k] = input[c + k*chans];
+    }
+  }
+}
 
-  void 	separate()
-  {
-    for (int s = 0; s < fNumFrames; s++) {
-      for (int c = 0; c < fNumInputs; c++) {
-	fOutputs[c][s] = fInput[c + s*fNumInputs];
-      }
+void interleave(float** inputs, int chans, float* output, int frames)
+{
+  int s = 0;
+  if (chans == 1) {
+    memcpy(output, inputs[0], frames * sizeof(float));
+    return;
+  } else if (chans == 2) {
+    float* left = inputs[0];
+    float* right = inputs[1];
+    for (; s+4 <= frames; s += 4) {
+      __m128 l = _mm_loadu_ps(left + s);
+      __m128 r = _mm_loadu_ps(right + s);
+      _mm_storeu_ps(output + 2*s, _mm_unpacklo_ps(l, r));
+      _mm_storeu_ps(output + 2*s + 4, _mm_unpackhi_ps(l, r));
     }
   }
-};
+  for (int c = 0; c < chans; c++) {
+    for (int k = s; k < frames; k++) {
+      output[c + k*chans] = inputs[c][k];
+    }
+  }
+}
+#endif
+
+// -- blocks and the queues linking the stages of a pipeline
 
-class Interleaver
+struct block
 {
-  int		fNumFrames;
-  int		fNumChans;
+  int       fCount;         // number of frames, 0 marks the end of the file
+  float*    fInput;         // interleaved frames read from the input file
+  float*    fOutput;        // interleaved frames to write in the output file
+};
 
-  FAUSTFLOAT*	fInputs[256];
-  FAUSTFLOAT*	fOutput;
+class blockqueue
+{
+  std::deque<block*>    fBlocks;
+  pthread_mutex_t       fMutex;
+  pthread_cond_t        fCond;
 
 public:
 
-  Interleaver(int numFrames, int numChans)
+  blockqueue()
   {
-    fNumFrames = numFrames;
-    fNumChans  = numChans;
-
-    // allocate separate input channels
-    for (int i = 0; i < fNumChans; i++) {
-      fInputs[i] = (FAUSTFLOAT*) calloc (fNumFrames, sizeof(FAUSTFLOAT));
-    }
-
-    // allocate interleaved output channel
-    fOutput = (FAUSTFLOAT*) calloc(fNumFrames * fNumChans, sizeof(FAUSTFLOAT));
-
+    pthread_mutex_init(&fMutex, NULL);
+    pthread_cond_init(&fCond, NULL);
   }
 
-  ~Interleaver()
+  ~blockqueue()
   {
-    // free separate input channels
-    for (int i = 0; i < fNumChans; i++) {
-      free(fInputs[i]);
-    }
-
-    // free interleaved output channel
-    free(fOutput);
+    pthread_cond_destroy(&fCond);
+    pthread_mutex_destroy(&fMutex);
   }
 
-  FAUSTFLOAT**	inputs()		{ return fInputs; }
-
-  FAUSTFLOAT* 	output()		{ return fOutput; }
+  void put(block* b)
+  {
+    pthread_mutex_lock(&fMutex);
+    fBlocks.push_back(b);
+    pthread_cond_signal(&fCond);
+    pthread_mutex_unlock(&fMutex);
+  }
 
-  void 	interleave()
+  block* get()
   {
-    for (int s = 0; s < fNumFrames; s++) {
-      for (int c = 0; c < fNumChans; c++) {
-	fOutput[c + s*fNumChans] = fInputs[c][s];
-      }
-    }
+    pthread_mutex_lock(&fMutex);
+    while (fBlocks.empty()) pthread_cond_wait(&fCond, &fMutex);
+    block* b = fBlocks.front();
+    fBlocks.pop_front();
+    pthread_mutex_unlock(&fMutex);
+    return b;
   }
 };
 
-#define kFrames 512
+// -- command line
+
+int             gArgc;
+char**          gArgv;
+int             gFrames;        // frames per block
+int             gAppend;        // number of frames to append beyond the input files
+std::vector<const char*> gFiles;    // input and output files, by pairs
+std::vector<int> gJobs;         // the pairs of the group being rendered
+
+unsigned int    gNextJob = 0;
+long long       gTotalFrames = 0;
+double          gTotalSeconds = 0;  // duration of the rendered sound
+pthread_mutex_t gMutex = PTHREAD_MUTEX_INITIALIZER;
 
 // loptrm : Scan command-line arguments and remove and return long int value when found
 long loptrm (int *argcP, char *argv[], const char* longname, const char* shortname, long def)
@@ -203,78 +263,250 @@ long loptrm (int *argcP, char *argv[], const char* longname, const char* shortna
   return def;
 }
 
-int main(int argc, char *argv[] )
+double now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+// -- rendering of one input file into one output file
+
+class pipeline
+{
+  SNDFILE*      fInFile;
+  SNDFILE*      fOutFile;
+  int           fInChans;
+  int           fOutChans;
+  block         fBlocks[kBlocks];
+  blockqueue    fFree;
+  blockqueue    fFull;
+  blockqueue    fDone;
+
+  static void* reader(void* arg)
+  {
+    pipeline* p = (pipeline*)arg;
+    int append = gAppend;
+    bool eof = false;
+    block* b;
+    do {
+      b = p->fFree.get();
+      b->fCount = 0;
+      if (!eof) {
+        b->fCount = READ_SAMPLE(p->fInFile, b->fInput, gFrames);
+        eof = (b->fCount < gFrames);
+      }
+      if (b->fCount == 0 && append > 0) {
+        // the tail is computed from silent inputs
+        b->fCount = min(append, gFrames);
+        memset(b->fInput, 0, b->fCount * p->fInChans * sizeof(float));
+        append -= b->fCount;
+      }
+      p->fFull.put(b);
+    } while (b->fCount > 0);
+    return NULL;
+  }
+
+  static void* writer(void* arg)
+  {
+    pipeline* p = (pipeline*)arg;
+    block* b;
+    while ((b = p->fDone.get())->fCount > 0) {
+      sf_writef_float(p->fOutFile, b->fOutput, b->fCount);
+      p->fFree.put(b);
+    }
+    return NULL;
+  }
+
+public:
+
+  pipeline(SNDFILE* in, int inchans, SNDFILE* out, int outchans)
+    : fInFile(in), fOutFile(out), fInChans(inchans), fOutChans(outchans)
+  {
+    for (int i = 0; i < kBlocks; i++) {
+      fBlocks[i].fCount = 0;
+      fBlocks[i].fInput = (float*) calloc(gFrames * fInChans, sizeof(float));
+      fBlocks[i].fOutput = (float*) calloc(gFrames * fOutChans, sizeof(float));
+      fFree.put(&fBlocks[i]);
+    }
+  }
+
+  ~pipeline()
+  {
+    for (int i = 0; i < kBlocks; i++) {
+      free(fBlocks[i].fInput);
+      free(fBlocks[i].fOutput);
+    }
+  }
+
+  // compute all the blocks with DSP, returns the number of frames written
+  long long run(dsp* DSP)
+  {
+    // like the file, DSP has at least fInChans input channels, the extra ones are silent
+    int         nins = max(fInChans, DSP->getNumInputs());
+    FAUSTFLOAT* inputs[256];
+    FAUSTFLOAT* outputs[256];
+    for (int i = 0; i < nins; i++) inputs[i] = (FAUSTFLOAT*) calloc(gFrames, sizeof(FAUSTFLOAT));
+    for (int i = 0; i < fOutChans; i++) outputs[i] = (FAUSTFLOAT*) calloc(gFrames, sizeof(FAUSTFLOAT));
+
+    pthread_t rthread, wthread;
+    pthread_create(&rthread, NULL, reader, this);
+    pthread_create(&wthread, NULL, writer, this);
+
+    long long frames = 0;
+    block* b;
+    while ((b = fFull.get())->fCount > 0) {
+      deinterleave(b->fInput, fInChans, inputs, b->fCount);
+      DSP->compute(b->fCount, inputs, outputs);
+      interleave(outputs, fOutChans, b->fOutput, b->fCount);
+      frames += b->fCount;
+      fDone.put(b);
+    }
+    fDone.put(b);   // the end mark stops the writer
+
+    pthread_join(rthread, NULL);
+    pthread_join(wthread, NULL);
+
+    for (int i = 0; i < nins; i++) free(inputs[i]);
+    for (int i = 0; i < fOutChans; i++) free(outputs[i]);
+    return frames;
+  }
+};
+
+void render(const char* infile, const char* outfile)
 {
   SNDFILE*		in_sf;
   SNDFILE*		out_sf;
   SF_INFO			in_info;
   SF_INFO			out_info;
-  unsigned int		nAppend = 0; // number of frames to append beyond input file
-
-  if (argc < 3) {
-    fprintf(stderr,"*** USAGE: %s input_soundfile output_soundfile\n",argv[0]);
-    exit(1);
-  }
 
-  nAppend = loptrm(&argc, argv, "--continue", "-c", 0);
-    
-  CMDUI* interface = new CMDUI(argc, argv);
-  DSP.buildUserInterface(interface);
+  mydsp* DSP = new mydsp();
+  CMDUI* interface = new CMDUI(gArgc, gArgv);
+  DSP->buildUserInterface(interface);
   interface->process_command();
 
   // open input file
   in_info.format = 0;
-  in_sf = sf_open (interface->input_file(), SFM_READ, &in_info);
+  in_sf = sf_open (infile, SFM_READ, &in_info);
   if (in_sf == NULL) {
-    fprintf(stderr,"*** Input file not found.\n");
-    sf_perror(in_sf); 
-    exit(1); 
+    fprintf(stderr,"*** Input file %s not found.\n", infile);
+    sf_perror(in_sf);
+    exit(1);
   }
 
   // open output file
   out_info = in_info;
   out_info.format = in_info.format;
-  out_info.channels = DSP.getNumOutputs();
-  out_sf = sf_open(interface->output_file(), SFM_WRITE, &out_info);
-  if (out_sf == NULL) { 
-    fprintf(stderr,"*** Cannot write output file.\n");
-    sf_perror(out_sf); 
-    exit(1); 
+  out_info.channels = DSP->getNumOutputs();
+  out_sf = sf_open(outfile, SFM_WRITE, &out_info);
+  if (out_sf == NULL) {
+    fprintf(stderr,"*** Cannot write output file %s.\n", outfile);
+    sf_perror(out_sf);
+    exit(1);
   }
 
-  // create separator and interleaver
-  Separator   sep (kFrames, in_info.channels, DSP.getNumInputs());
-  Interleaver ilv (kFrames, DSP.getNumOutputs());
-
-  // init signal processor
-  DSP.init(in_info.samplerate);
-  //DSP.buildUserInterface(interface);
+  // init signal processor, the static tables are computed for the group (see main)
+  DSP->instanceInit(in_info.samplerate);
   interface->process_init();
 
-  // process all samples
-  int nbf;
-  do {
-    nbf = READ_SAMPLE(in_sf, sep.input(), kFrames);
-    sep.separate();
-    DSP.compute(nbf, sep.outputs(), ilv.inputs());
-    ilv.interleave();
-    sf_writef_float(out_sf, ilv.output(), nbf);
-    //sf_write_raw(out_sf, ilv.output(), nbf);
-  } while (nbf == kFrames);
+  pipeline p(in_sf, in_info.channels, out_sf, out_info.channels);
+  long long frames = p.run(DSP);
 
   sf_close(in_sf);
+  sf_close(out_sf);
+  delete interface;
+  delete DSP;
 
-  // compute tail, if any
-  if (nAppend>0) {
-    FAUSTFLOAT *input = (FAUSTFLOAT*) calloc(nAppend * DSP.getNumInputs(), sizeof(FAUSTFLOAT));
-    FAUSTFLOAT *inputs[1] = { input };
-    Interleaver ailv(nAppend, DSP.getNumOutputs());
-    DSP.compute(nAppend, inputs, ailv.inputs());
-    ailv.interleave();
-    sf_writef_float(out_sf, ailv.output(), nAppend);
+  pthread_mutex_lock(&gMutex);
+  gTotalFrames += frames;
+  gTotalSeconds += double(frames) / in_info.samplerate;
+  pthread_mutex_unlock(&gMutex);
+}
+
+// workers render the pairs of files of the group in turn
+void* worker(void* arg)
+{
+  while (true) {
+    pthread_mutex_lock(&gMutex);
+    unsigned int next = gNextJob++;
+    pthread_mutex_unlock(&gMutex);
+    if (next >= gJobs.size()) return NULL;
+    render(gFiles[2*gJobs[next]], gFiles[2*gJobs[next]+1]);
   }
+}
 
-  sf_close(out_sf);
+// sample rate of an input file
+int samplerate(const char* infile)
+{
+  SF_INFO info;
+  info.format = 0;
+  SNDFILE* sf = sf_open(infile, SFM_READ, &info);
+  if (sf == NULL) {
+    fprintf(stderr,"*** Input file %s not found.\n", infile);
+    sf_perror(sf);
+    exit(1);
+  }
+  sf_close(sf);
+  return info.samplerate;
+}
+
+int main(int argc, char *argv[] )
+{
+  if (argc < 3) {
+    fprintf(stderr,"*** USAGE: %s [-b frames] [-j workers] [-c frames] input_soundfile output_soundfile [input_soundfile output_soundfile ...]\n",argv[0]);
+    exit(1);
+  }
+
+  gAppend = loptrm(&argc, argv, "--continue", "-c", 0);
+  gFrames = loptrm(&argc, argv, "--block", "-b", kFrames);
+  int nworkers = loptrm(&argc, argv, "--jobs", "-j", 0);
+  gArgc = argc;
+  gArgv = argv;
+
+  // check the dsp options, and collect the files
+  mydsp DSP;
+  CMDUI* interface = new CMDUI(argc, argv);
+  DSP.buildUserInterface(interface);
+  interface->process_command();
+  for (int i = 0; i < interface->files(); i++) gFiles.push_back(interface->file(i));
+  delete interface;
+
+  if (gFiles.size() < 2 || gFiles.size() % 2 != 0) {
+    fprintf(stderr,"*** Input and output files must be given by pairs.\n");
+    exit(1);
+  }
+  if (gFrames < 1) {
+    fprintf(stderr,"*** The block size must be positive.\n");
+    exit(1);
+  }
+  int njobs = gFiles.size() / 2;
+  if (nworkers < 1) nworkers = sysconf(_SC_NPROCESSORS_ONLN);
+  nworkers = max(1, min(nworkers, njobs));
+
+  // the pairs grouped by sample rate
+  std::map<int, std::vector<int> > groups;
+  for (int job = 0; job < njobs; job++) groups[samplerate(gFiles[2*job])].push_back(job);
+
+  double start = now();
+  for (std::map<int, std::vector<int> >::iterator g = groups.begin(); g != groups.end(); g++) {
+    mydsp::classInit(g->first);
+    gJobs = g->second;
+    gNextJob = 0;
+    int n = min(nworkers, int(gJobs.size()));
+    if (n == 1) {
+      worker(NULL);
+    } else {
+      std::vector<pthread_t> threads(n);
+      for (int i = 0; i < n; i++) pthread_create(&threads[i], NULL, worker, NULL);
+      for (int i = 0; i < n; i++) pthread_join(threads[i], NULL);
+    }
+  }
+  double elapsed = max(now() - start, 1e-9);
+
+  // throughput report, the frames of all the files (and so of the concurrent workers) are summed
+  fprintf(stderr, "%d file(s), %lld frames in %.3f s : %.0f frames/s summed over all files, %.1f x realtime\n",
+          njobs, gTotalFrames, elapsed, gTotalFrames / elapsed, gTotalSeconds / elapsed);
+  return 0;
 }
 
 /********************END ARCHITECTURE SECTION (part 2/2)****************/
@@ -32,21 +32,17 @@
 #include <ostream>
 #include "xtended.hh"
 #include "boxcomplexity.h"
+#include "exception.hh"
+#include "global.hh"
 
 using namespace std;
 
-/**
- * property Key used to store box complexity
- */
-Tree 	BCOMPLEXITY 	= tree ("BCOMPLEXITY");
-
 static int computeBoxComplexity (Tree box);
 
 /**
- * Return the complexity propety of a box expression tree.
- * Return the complexity propety of a box expression tree. If no 
- * complexity property exist, it is created an computeBoxComplexity
- * is called do to the job.
+ * Return the complexity of a box expression tree.
+ * The complexity is kept in the annotations of the box (see getBoxInfo),
+ * computeBoxComplexity is called the first time to do the job.
  *
  * @param box an evaluated box expression tree
  * @return the complexity of box
@@ -55,16 +51,15 @@ static int computeBoxComplexity (Tree box);
  */
 int boxComplexity (Tree box)
 {
-	Tree prop = box->getProperty(BCOMPLEXITY);
-	
-	if (prop) {
-		return tree2int(prop);
-		
-	} else {
+	BoxInfo info = getBoxInfo(box);
+
+	if (info.fComplexity < 0) {
 		int v = computeBoxComplexity(box);
-		box->setProperty(BCOMPLEXITY,tree(v));
-		return v;
+		info = getBoxInfo(box);
+		info.fComplexity = v;
+		setBoxInfo(box, info);
 	}
+	return info.fComplexity;
 }
 
 /**
@@ -151,8 +146,8 @@ int computeBoxComplexity (Tree box)
 	//a completer
 	else {
 		//fout << tree2str(box);
-		cerr << "ERROR in boxComplexity : not an evaluated box [[  " << *box << " ]]";
-		exit(-1);
+		gGlobal->gErrors << "ERROR in boxComplexity : not an evaluated box [[  " << *box << " ]]";
+		throw faustexception(-1);
 	}
 
 	return -1;
@@ -47,6 +47,8 @@
 #include "ppbox.hh"
 #include "prim2.hh"
 #include "xtended.hh"
+#include "exception.hh"
+#include "global.hh"
 
 
 /*****************************************************************************
@@ -226,7 +228,7 @@ Tree buildBoxAppl 	(Tree fun, Tree revarglist)
 #else
 Tree buildBoxAppl 	(Tree fun, Tree revarglist)
 {
-	if (isNil (revarglist)) exit(1); // a revoir !!!!!!
+	if (isNil (revarglist)) throw faustexception(); // a revoir !!!!!!
 	return  boxAppl(fun, revarglist);
 }
 #endif
@@ -594,8 +596,8 @@ static Tree preparePattern(Tree box)
 
         // None of the previous tests succeded, then it is not a valid box
         else {
-            cerr << "Error in preparePattern() : " << *box << " is not a valid box" << endl;
-            exit(1);
+            gGlobal->gErrors << "Error in preparePattern() : " << *box << " is not a valid box" << endl;
+            throw faustexception();
         }
 
 
@@ -343,5 +343,19 @@ bool isBoxPatternVar(Tree s, Tree& id);
 // return the number of input
 bool getBoxType (Tree box, int* inum, int* onum);
 
+// annotations cached for each box, filled on demand by getBoxType and boxComplexity
+struct BoxInfo
+{
+    int     fTyped;         ///< 1 : typed, -1 : no type, 0 : type not computed yet
+    int     fInputs;
+    int     fOutputs;
+    int     fComplexity;    ///< -1 : not computed yet
+
+    BoxInfo() : fTyped(0), fInputs(0), fOutputs(0), fComplexity(-1) {}
+};
+
+BoxInfo getBoxInfo (Tree box);
+void    setBoxInfo (Tree box, const BoxInfo& info);
+
 
 #endif
@@ -45,11 +45,27 @@
 #include "ppbox.hh"
 #include "prim2.hh"
 #include "xtended.hh"
+#include "property.hh"
+#include "exception.hh"
+#include "global.hh"
 
 
-Tree BOXTYPEPROP = tree(symbol("boxTypeProp"));
 static bool infereBoxType (Tree box, int* inum, int* onum);
 
+// shared by getBoxType and boxComplexity, the boxes are never modified
+
+BoxInfo getBoxInfo (Tree box)
+{
+	BoxInfo info;
+	gGlobal->gBoxInfo.get(box, info);
+	return info;
+}
+
+void setBoxInfo (Tree box, const BoxInfo& info)
+{
+	gGlobal->gBoxInfo.set(box, info);
+}
+
 
 
 /**
@@ -62,26 +78,24 @@ static bool infereBoxType (Tree box, int* inum, int* onum);
 
 bool getBoxType (Tree box, int* inum, int* onum)
 {
-	Tree t;
-	if (getProperty(box, BOXTYPEPROP, t)) {
-		
-		if (isNil(t)) {
-			return false;
-		} else {
-			*inum = hd(t)->node().getInt();
-			*onum = tl(t)->node().getInt();
-			return true;
-		}
-		
+	BoxInfo info = getBoxInfo(box);
+
+	if (info.fTyped == 0) {
+		// the subboxes are annotated by the inference, reread the record after
+		bool typed = infereBoxType(box, &info.fInputs, &info.fOutputs);
+		BoxInfo current = getBoxInfo(box);
+		current.fTyped = typed ? 1 : -1;
+		current.fInputs = info.fInputs;
+		current.fOutputs = info.fOutputs;
+		setBoxInfo(box, current);
+		info = current;
+	}
+	if (info.fTyped > 0) {
+		*inum = info.fInputs;
+		*onum = info.fOutputs;
+		return true;
 	} else {
-	
-		if (infereBoxType(box, inum, onum)) {
-			setProperty(box, BOXTYPEPROP, cons(tree(*inum), tree(*onum)));
-			return true;
-		} else {
-			setProperty(box, BOXTYPEPROP, nil);
-			return false;
-		}
+		return false;
 	}
 }
 
@@ -149,10 +163,10 @@ static bool infereBoxType (Tree t, int* inum, int* onum)
 		if (!getBoxType(b, &x, &y)) return false;
 
 		if (v != x) {
-            cerr    << "Error in sequential composition (A:B)" << endl
+            gGlobal->gErrors    << "Error in sequential composition (A:B)" << endl
                     << "The number of outputs (" << v << ") of A = " << boxpp(a) << endl
                     << "must be equal to the number of inputs (" << x << ") of B : " << boxpp(b) << endl;
-            exit(1);
+            throw faustexception();
 		} else {
 			*inum = u; *onum = y;
 		}
@@ -172,23 +186,23 @@ static bool infereBoxType (Tree t, int* inum, int* onum)
 		if (!getBoxType(b, &x, &y)) return false;
 
         if (v == 0) {
-            cerr    << "Connection error in : " << boxpp(t) << endl
+            gGlobal->gErrors    << "Connection error in : " << boxpp(t) << endl
                     << "The first expression : " << boxpp(a) << " has no outputs" << endl;
-            exit(1);
+            throw faustexception();
         }
         
         if (x == 0) {
-            cerr    << "Connection error in : " << boxpp(t) << endl
+            gGlobal->gErrors    << "Connection error in : " << boxpp(t) << endl
                     << "The second expression : " << boxpp(b) << " has no inputs" << endl;
-            exit(1);
+            throw faustexception();
         }
 		 
 		if (x % v != 0) {
-			cerr 	<< "Connection error in : " << boxpp(t) << endl
+			gGlobal->gErrors 	<< "Connection error in : " << boxpp(t) << endl
 					<< "The number of outputs " << v
 					<< " of the first expression should be a divisor of the number of inputs " << x
 					<< " of the second expression" << endl;
-			exit(1);
+			throw faustexception();
 		}
 		
 		*inum = u; *onum = y;
@@ -200,23 +214,23 @@ static bool infereBoxType (Tree t, int* inum, int* onum)
 		if (!getBoxType(b, &x, &y)) return false;
 
         if (v == 0) {
-            cerr    << "Connection error in : " << boxpp(t) << endl
+            gGlobal->gErrors    << "Connection error in : " << boxpp(t) << endl
                     << "The first expression : " << boxpp(a) << " has no outputs" << endl;
-            exit(1);
+            throw faustexception();
         }
         
         if (x == 0) {
-            cerr    << "Connection error in : " << boxpp(t) << endl
+            gGlobal->gErrors    << "Connection error in : " << boxpp(t) << endl
                     << "The second expression : " << boxpp(b) << " has no inputs" << endl;
-            exit(1);
+            throw faustexception();
         }
         
 		if (v % x != 0) { 
-			cerr 	<< "Connection error in : " << boxpp(t) << endl
+			gGlobal->gErrors 	<< "Connection error in : " << boxpp(t) << endl
 					<< "The number of outputs " << v
 					<< " of the first expression should be a multiple of the number of inputs " << x
 					<< " of the second expression" << endl;
-			exit(1);
+			throw faustexception();
 		}
 
 		*inum = u; *onum = y;
@@ -227,23 +241,23 @@ static bool infereBoxType (Tree t, int* inum, int* onum)
 		if (!getBoxType(a, &u, &v)) return false;
 		if (!getBoxType(b, &x, &y)) return false;
 		if ( (x > v) | (y > u) ) { 
-			cerr 	<< "Connection error in : " << boxpp(t) << endl;
-			if (x > v) cerr << "The number of outputs " << v 
+			gGlobal->gErrors 	<< "Connection error in : " << boxpp(t) << endl;
+			if (x > v) gGlobal->gErrors << "The number of outputs " << v 
 							<< " of the first expression should be greater or equal \n  to the number of inputs " << x 
 							<< " of the second expression" << endl;
-			if (y > u) cerr	<< "The number of inputs " << u
+			if (y > u) gGlobal->gErrors	<< "The number of inputs " << u
 							<< " of the first expression should be greater or equal \n  to the number of outputs " << y
 							<< " of the second expression" << endl;
-			exit(1);
+			throw faustexception();
 		}
 		*inum = max(0,u-y); *onum = v;
 		
     } else if (isBoxEnvironment(t)) {
-        cerr << "Connection error : an environment is not a block-diagram : " << boxpp(t) << endl;
-        exit(1);
+        gGlobal->gErrors << "Connection error : an environment is not a block-diagram : " << boxpp(t) << endl;
+        throw faustexception();
     } else {
-        cerr << "boxType() internal error : unrecognized box expression " << boxpp(t) << endl;
-        exit(1);
+        gGlobal->gErrors << "boxType() internal error : unrecognized box expression " << boxpp(t) << endl;
+        throw faustexception();
 	}
 	return true;
 }	
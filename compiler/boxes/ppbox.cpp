@@ -28,8 +28,8 @@
 #include "prim2.hh"
 #include "xtended.hh"
 #include "Text.hh"
-
-extern int gFloatSize;
+#include "exception.hh"
+#include "global.hh"
 
 const char * prim0name(CTree *(*ptr) ())
 {
@@ -184,7 +184,7 @@ ostream& boxpp::print (ostream& fout) const
         fout << "ffunction(" << type2str(ffrestype(ff));
         Tree namelist = nth(ffsignature(ff),1);
         char sep = ' ';
-        for (int i = 0; i < gFloatSize; i++) {
+        for (int i = 0; i < gGlobal->gFloatSize; i++) {
             fout << sep << tree2str(nth(namelist,i));
             sep = '|';
         }
@@ -372,8 +372,8 @@ ostream& boxpp::print (ostream& fout) const
    
     // None of the previous tests succeded, then it is not a valid box
     else {
-        cerr << "Error in box::print() : " << *box << " is not a valid box" << endl;
-        exit(1);
+        gGlobal->gErrors << "Error in box::print() : " << *box << " is not a valid box" << endl;
+        throw faustexception();
     }
 
     return fout;
@@ -10,6 +10,7 @@ OBJECTS_DIR = binaries
 QT -= core gui
 
 QMAKE_CXXFLAGS_WARN_ON += -Wno-parentheses -Wno-unused-parameter
+unix:LIBS += -lpthread
 
 INCLUDEPATH += . \
                tlib \
@@ -45,6 +46,7 @@ HEADERS += boxes/boxcomplexity.h \
            draw/drawschema.hh \
            draw/sigToGraph.hh \
            errors/errormsg.hh \
+           errors/exception.hh \
            errors/timing.hh \
            evaluate/environment.hh \
            evaluate/eval.hh \
@@ -61,7 +63,10 @@ HEADERS += boxes/boxcomplexity.h \
            generator/occurences.hh \
            generator/Text.hh \
            generator/uitree.hh \
+           global.hh \
+           libfaust.hh \
            normalize/aterm.hh \
+           normalize/firrecognition.hh \
            normalize/mterm.hh \
            normalize/normalize.hh \
            normalize/privatise.hh \
@@ -69,6 +74,7 @@ HEADERS += boxes/boxcomplexity.h \
            parallelize/colorize.h \
            parallelize/graphSorting.hh \
            parallelize/loop.hh \
+           parser/astcache.hh \
            parser/enrobage.hh \
            parser/faustparser.hpp \
            parser/sourcefetcher.hh \
@@ -81,6 +87,9 @@ HEADERS += boxes/boxcomplexity.h \
            signals/ppsig.hh \
            signals/prim2.hh \
            signals/recursivness.hh \
+           signals/sigdag.hh \
+           signals/sigeval.hh \
+           signals/sigprecision.hh \
            signals/signals.hh \
            signals/sigorderrules.hh \
            signals/sigprint.hh \
@@ -171,7 +180,9 @@ SOURCES += main.cpp \
            generator/sharing.cpp \
            generator/Text.cpp \
            generator/uitree.cpp \
+           global.cpp \
            normalize/aterm.cpp \
+           normalize/firrecognition.cpp \
            normalize/mterm.cpp \
            normalize/normalize.cpp \
            normalize/privatise.cpp \
@@ -179,6 +190,7 @@ SOURCES += main.cpp \
            parallelize/colorize.cpp \
            parallelize/graphSorting.cpp \
            parallelize/loop.cpp \
+           parser/astcache.cpp \
            parser/enrobage.cpp \
            parser/faustlexer.cpp \
            parser/faustparser.cpp \
@@ -191,6 +203,9 @@ SOURCES += main.cpp \
            signals/ppsig.cpp \
            signals/prim2.cpp \
            signals/recursivness.cpp \
+           signals/sigdag.cpp \
+           signals/sigeval.cpp \
+           signals/sigprecision.cpp \
            signals/signals.cpp \
            signals/sigorderrules.cpp \
            signals/sigprint.cpp \
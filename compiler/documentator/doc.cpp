@@ -78,6 +78,8 @@
 #include "doc_autodoc.hh"
 #include "compatibility.hh"
 #include "files.hh"
+#include "exception.hh"
+#include "global.hh"
 
 
 #define MAXIDCHARS 5				///< max numbers (characters) to represent ids (e.g. for directories).
@@ -89,33 +91,20 @@ using namespace std ;
 						Globals and prototyping
  *****************************************************************************/
 
-extern Tree						gExpandedDefList;
-extern map<Tree, set<Tree> > 	gMetaDataSet;
-extern map<string, string>		gDocMetadatasStringMap;
-extern map<string, string>		gDocMathStringMap;
-extern bool            			gDetailsSwitch;
-extern bool            			gStripDocSwitch;
-extern string					gFaustDirectory;
-extern string					gFaustSuperDirectory;
-extern string					gFaustSuperSuperDirectory;
-extern string					gMasterDocument;
-extern string					gMasterName;
-extern SourceReader				gReader;
-
-extern string 					gDocName;				///< Contains the filename for out documentation.
-static const char* 				gDocDevSuffix;			///< ".tex" (or .??? - used to choose output device).
 static const string				gLatexheaderfilename = "latexheader.tex";
 
-vector<Tree> 					gDocVector;				///< Contains <mdoc> parsed trees: DOCTXT, DOCEQN, DOCDGM.
+enum { langEN, langFR, langIT };
 
-static struct tm				gCompilationDate;
+/** A prepared doc <equation> : its signals, and its LaTeX formulas once compiled. */
+struct DocEqn
+{
+	Tree	fSigs;
+	int		fInputs;
+	int		fOutputs;
+	Lateq*	fLateq;
 
-bool							gLstDependenciesSwitch	= true; ///< mdoc listing management.
-bool							gLstMdocTagsSwitch		= true; ///< mdoc listing management.
-bool							gLstDistributedSwitch	= true; ///< mdoc listing management.
-
-enum { langEN, langFR, langIT };
-string				gDocLang;
+	DocEqn(Tree sigs, int inputs, int outputs) : fSigs(sigs), fInputs(inputs), fOutputs(outputs), fLateq(0) {}
+};
 
 /* Printing functions */
 static void		printlatexheader(istream& latexheader, const string& faustversion, ostream& docout);
@@ -124,12 +113,12 @@ static void		printfaustlisting(string& path, ostream& docout);
 static void		printlatexfooter(ostream& docout);
 static void		printdoccontent(const char* svgTopDir, const vector<Tree>& docVector, const string& faustversion, ostream& docout);
 static void		printfaustdocstamp(const string& faustversion, ostream& docout);
-static void		printDocEqn(Lateq* ltq, ostream& docout);
+static void		printDocEqn(DocCompiler* DC, vector<DocEqn>& docEqnsVector, unsigned int i, ostream& docout);
 static void		printDocDgm(const Tree expr, const char* svgTopDir, ostream& docout, int i);
 static void		printDocMetadata(const Tree expr, ostream& docout);
 
 /* Primary sub-functions for <equation> handling */
-static void	prepareDocEqns( const vector<Tree>& docBoxes, vector<Lateq*>& docCompiledEqnsVector );		///< Caller function.
+static DocCompiler* prepareDocEqns( const vector<Tree>& docBoxes, vector<DocEqn>& docEqnsVector );		///< Caller function.
 static void	collectDocEqns( const vector<Tree>& docBoxes, vector<Tree>& eqBoxes );						///< step 0. Feed a vector.
 static void	mapEvalDocEqn( const vector<Tree>& eqBoxes, const Tree& env, vector<Tree>& evalEqBoxes );	///< step 1. Evaluate boxes.
 static void	mapGetEqName( const vector<Tree>& evalEqBoxes, vector<string>& eqNames );					///< step 2. Get boxes name.
@@ -139,7 +128,7 @@ static void	mapSetSigNickname( const vector<string>& eqNicknames, const vector<i
 static void	collectEqSigs( const vector<Tree>& eqSigs, Tree& superEqList );								///< step 7. Collect all signals in a superlist.
 static void	annotateSuperList( DocCompiler* DC, Tree superEqList );								///< step 8. Annotate superlist.
 //static void	calcAndSetLtqNames( Tree superEqList );		///< step 9. 
-static void	mapCompileDocEqnSigs( const vector<Tree>& eqSigs, const vector<int>& eqInputs, const vector<int>& eqOutputs, DocCompiler* DC, vector<Lateq*>& docCompiledEqnsVector );	///< step 10. Compile equations.
+static void	compileDocEqn( DocCompiler* DC, DocEqn& eqn );											///< step 10. Compile an equation.
 
 /* Secondary sub-functions for <equation> handling */
 static string	calcNumberedName(const char* base, int i);
@@ -152,7 +141,6 @@ static struct tm* getCompilationDate();
 
 /* Files functions */
 static istream* openArchFile (const string& filename);
-static char*	legalFileName(const Tree t, int n, char* dst);
 static string	rmExternalDoubleQuotes(const string& s);
 static void		copyFaustSources(const char* projname, const vector<string>& pathnames);
 vector<string>& docCodeSlicer(const string& faustfile, vector<string>& codeSlices);
@@ -223,7 +211,7 @@ bool isDocMtd(Tree t, Tree& x) 		{ return isTree(t, DOCMTD, x); 	}
  */
 void printDoc(const char* projname, const char* docdev, const char* faustversion)
 {
-	gDocDevSuffix = docdev;
+	gGlobal->gDocDevSuffix = docdev;
 	
 	/** File stuff : create doc directories and a tex file. */
 	//cerr << "Documentator : printDoc : gFaustDirectory = '" << gFaustDirectory << "'" << endl;
@@ -243,27 +231,26 @@ void printDoc(const char* projname, const char* docdev, const char* faustversion
 	makedir(pdfdir.c_str());	// create a pdf directory.
 	
 	/* Copy all Faust source files into an 'src' sub-directory. */
-	vector<string> pathnames = gReader.listSrcFiles();
+	vector<string> pathnames = gGlobal->gReader.listSrcFiles();
 	copyFaustSources(projname, pathnames);
 	
 	string texdir = subst("$0/tex", projname);
-	mkchdir(texdir.c_str()); 	// create a directory and move into.
+	makedir(texdir.c_str()); 	// create a tex directory.
 
 	 /** Create THE mathdoc tex file. */
-	ofstream docout(subst("$0.$1", gDocName, docdev).c_str());
-	cholddir();					// return to current directory
+	ofstream docout(subst("$0/$1.$2", texdir, gGlobal->gDocName, docdev).c_str());
 	
 	/** Init and load translation file. */
-	loadTranslationFile(gDocLang);
+	loadTranslationFile(gGlobal->gDocLang);
 	
 	/** Simulate a default doc if no <mdoc> tag detected. */
-	if (gDocVector.empty()) { declareAutoDoc(); } 	
+	if (gGlobal->gDocVector.empty()) { declareAutoDoc(); } 	
 	
 	/** Printing stuff : in the '.tex' ouptut file, eventually including SVG files. */
 	printfaustdocstamp(faustversion, docout);						///< Faust version and compilation date (comment).
 	istream* latexheader = openArchFile(gLatexheaderfilename);
 	printlatexheader(*latexheader, faustversion, docout);						///< Static LaTeX header (packages and setup).
-	printdoccontent(svgTopDir.c_str(), gDocVector, faustversion, docout);		///< Generate math contents (main stuff!).
+	printdoccontent(svgTopDir.c_str(), gGlobal->gDocVector, faustversion, docout);		///< Generate math contents (main stuff!).
 	printlatexfooter(docout);										///< Static LaTeX footer.
 }
 
@@ -286,9 +273,9 @@ static void printlatexheader(istream& latexheader, const string& faustversion, o
 	while(getline(latexheader, s)) docout << s << endl;
 	
 	/** Specific LaTeX macros for Faust */
-	docout << "\\newcommand{\\faustfilename}{" << gMasterDocument << "}" << endl;
-	docout << "\\newcommand{\\faustdocdir}{" << gMasterName << "-mdoc}" << endl;
-	docout << "\\newcommand{\\faustprogname}{" << gMasterName << "}" << endl;
+	docout << "\\newcommand{\\faustfilename}{" << gGlobal->gMasterDocument << "}" << endl;
+	docout << "\\newcommand{\\faustdocdir}{" << gGlobal->gMasterName << "-mdoc}" << endl;
+	docout << "\\newcommand{\\faustprogname}{" << gGlobal->gMasterName << "}" << endl;
 	docout << "\\newcommand{\\faustversion}{" << faustversion << "}" << endl;
 	char datebuf [150];
 	strftime (datebuf, 150, "%B %d, %Y", getCompilationDate());
@@ -310,9 +297,9 @@ static void printlatexheader(istream& latexheader, const string& faustversion, o
  */
 static void printDocMetadata(const Tree expr, ostream& docout)
 {
-	if (gMetaDataSet.count(expr)) {
+	if (gGlobal->gMetaDataSet.count(expr)) {
 		string sep = "";
-		set<Tree> mset = gMetaDataSet[expr];
+		set<Tree> mset = gGlobal->gMetaDataSet[expr];
 		
 		for (set<Tree>::iterator j = mset.begin(); j != mset.end(); j++) {
 			docout << sep << rmExternalDoubleQuotes(tree2str(*j));
@@ -330,13 +317,13 @@ static void printDocMetadata(const Tree expr, ostream& docout)
  */
 static void printfaustlistings(ostream& docout)
 {	
-	if (gLstDependenciesSwitch) {
-		vector<string> pathnames = gReader.listSrcFiles();
+	if (gGlobal->gLstDependenciesSwitch) {
+		vector<string> pathnames = gGlobal->gReader.listSrcFiles();
 		for (unsigned int i=0; i< pathnames.size(); i++) {
 			printfaustlisting(pathnames[i], docout);
 		}
 	} else {
-		printfaustlisting(gMasterDocument, docout);
+		printfaustlisting(gGlobal->gMasterDocument, docout);
 	}
 }
 
@@ -364,17 +351,17 @@ static void printfaustlisting(string& faustfile, ostream& docout)
 	if (faustfile != "" && src.good()) {
 		while(getline(src, s)) { /** We suppose there's only one <mdoc> tag per line. */
 			size_t foundopendoc  = s.find("<mdoc>");
-			if (foundopendoc != string::npos && gStripDocSwitch) isInsideDoc = true;
+			if (foundopendoc != string::npos && gGlobal->gStripDocSwitch) isInsideDoc = true;
 			
 			if (isInsideDoc == false)
 				docout << s << endl;
 			
 			size_t foundclosedoc = s.find("</mdoc>");
-			if (foundclosedoc != string::npos && gStripDocSwitch) isInsideDoc = false;
+			if (foundclosedoc != string::npos && gGlobal->gStripDocSwitch) isInsideDoc = false;
 		}
 	} else {
-		cerr << "ERROR : can't open faust source file " << faustfile << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR : can't open faust source file " << faustfile << endl;
+		throw faustexception();
 	}
 	
 	docout << "\\end{lstlisting}" << endl << endl;
@@ -426,7 +413,9 @@ static void printfaustdocstamp(const string& faustversion, ostream& docout)
  * - DOCTXT expressions printing is trivial.
  * - DOCDGM expressions printing calls 'printDocDgm' to generate SVG files and print LaTeX "figure" code.
  * - DOCEQN expressions printing calls 'printDocEqn' after an important preparing work 
- *   has been done by 'prepareDocEqns'.
+ *   has been done by 'prepareDocEqns'. Each equation is compiled when its turn comes,
+ *   printed and forgotten, so that the LaTeX formulas of the whole document are never
+ *   kept in memory.
  *
  * @param[in]	projname		Basename of the new doc directory ("*-math").
  * @param[in]	docVector		Contains all <mdoc> parsed content (as boxes).
@@ -437,21 +426,21 @@ static void printdoccontent(const char* svgTopDir, const vector<Tree>& docVector
 {
 	//cerr << endl << "Documentator : printdoccontent : " << docVector.size() << " <mdoc> tags read." << endl;
 	
-	/** Equations need to be prepared (named and compiled) before printing. */
-	vector<Lateq*>  docCompiledEqnsVector;
-	prepareDocEqns( docVector, docCompiledEqnsVector ); ///< Quite a lot of stuff there.
-	vector<Lateq*>::iterator eqn_it = docCompiledEqnsVector.begin();
+	/** Equations need to be prepared (named and annotated) before printing. */
+	vector<DocEqn>  docEqnsVector;
+	DocCompiler*	DC = prepareDocEqns( docVector, docEqnsVector ); ///< Quite a lot of stuff there.
+	unsigned int	eqnIndex = 0;
 	
 	int dgmIndex = 1;			///< For diagram directories numbering.
 
 	vector<string> docMasterCodeMap;
-	docMasterCodeMap = docCodeSlicer(gMasterDocument, docMasterCodeMap);
+	docMasterCodeMap = docCodeSlicer(gGlobal->gMasterDocument, docMasterCodeMap);
 	
 	vector<Tree>::const_iterator doc;
 	vector<string>::const_iterator code;
 	code = docMasterCodeMap.begin();
 	
-	if(doesFileBeginWithCode(gMasterDocument) && (! docMasterCodeMap.empty()) && gLstDistributedSwitch ) {
+	if(doesFileBeginWithCode(gGlobal->gMasterDocument) && (! docMasterCodeMap.empty()) && gGlobal->gLstDistributedSwitch ) {
 		printdocCodeSlices(*code, docout);
 		code++;
 	}
@@ -466,7 +455,7 @@ static void printdoccontent(const char* svgTopDir, const vector<Tree>& docVector
 		while (isList(L)) {
 			Tree expr;
 			if ( isDocEqn(hd(L), expr) ) { ///< After equations are well prepared and named.
-				printDocEqn(*eqn_it++, docout);
+				printDocEqn(DC, docEqnsVector, eqnIndex++, docout);
 			}
 			else if ( isDocDgm(hd(L), expr) ) { 
 				printDocDgm(expr, svgTopDir, docout, dgmIndex++);
@@ -478,19 +467,21 @@ static void printdoccontent(const char* svgTopDir, const vector<Tree>& docVector
 				docout << *hd(L)->branch(0); // Directly print registered doc text.
 			}
 			else if ( isDocNtc(hd(L)) ) { 
+				/** The notice depends on what the compilation of all the equations has met. */
+				for (unsigned int i = eqnIndex; i < docEqnsVector.size(); i++) compileDocEqn(DC, docEqnsVector[i]);
 				printDocNotice(faustversion, docout);
 			}
 			else if ( isDocLst(hd(L)) ) { 
 				printfaustlistings(docout);
 			}
 			else { 
-				cerr << "ERROR : " << *hd(L) << " is not a valid documentation type." << endl; 
+				gGlobal->gErrors << "ERROR : " << *hd(L) << " is not a valid documentation type." << endl; 
 			}
 			L = tl(L);
 		}
 		//cerr << " ...end of <mdoc> parsing." << endl; 
 		
-		if ( code != docMasterCodeMap.end() && gLstDistributedSwitch ) {
+		if ( code != docMasterCodeMap.end() && gGlobal->gLstDistributedSwitch ) {
 			printdocCodeSlices(*code, docout);
 		}
 	}
@@ -509,15 +500,17 @@ static void printdoccontent(const char* svgTopDir, const vector<Tree>& docVector
  * in a "source / destination" manner, 
  * the "destination" being declared before the function call. 
  *
- * @param[in]	docBoxes				The <mdoc> boxes to collect and prepare.
- * @param[out]	docCompiledEqnsVector	The place to store compiled equations.
+ * @param[in]	docBoxes		The <mdoc> boxes to collect and prepare.
+ * @param[out]	docEqnsVector	The place to store prepared equations.
+ * @return		The compiler of the equations, 0 if there is none.
  */
-static void prepareDocEqns(const vector<Tree>& docBoxes, vector<Lateq*>& docCompiledEqnsVector)
+static DocCompiler* prepareDocEqns(const vector<Tree>& docBoxes, vector<DocEqn>& docEqnsVector)
 {	
+	DocCompiler*	DC = 0;
 	vector<Tree>	eqBoxes;		collectDocEqns( docBoxes, eqBoxes );		///< step 0. Feed a vector.
 	
 	if(! eqBoxes.empty() ) {
-		vector<Tree>	evalEqBoxes;	mapEvalDocEqn( eqBoxes, gExpandedDefList, evalEqBoxes );	///< step 1. Evaluate boxes.
+		vector<Tree>	evalEqBoxes;	mapEvalDocEqn( eqBoxes, gGlobal->gExpandedDefList, evalEqBoxes );	///< step 1. Evaluate boxes.
 		vector<string>	eqNames;		mapGetEqName( evalEqBoxes, eqNames );		///< step 2. Get boxes name.
 		vector<string>	eqNicknames;	calcEqnsNicknames( eqNames, eqNicknames );	///< step 3. Calculate nicknames.
 		
@@ -527,11 +520,14 @@ static void prepareDocEqns(const vector<Tree>& docBoxes, vector<Lateq*>& docComp
 		mapSetSigNickname( eqNicknames, eqInputs, eqSigs );									///< step 6. Set signals nicknames.
 		Tree			superEqList;	collectEqSigs( eqSigs, superEqList );		///< step 7. Collect all signals in a superlist.
 		
-		DocCompiler* DC = new DocCompiler(0, 0);
+		DC = new DocCompiler(0, 0);
 		annotateSuperList( DC, superEqList );										///< step 8. Annotate superEqList.
 		//calcAndSetLtqNames( superEqList );										///< step 9. (directly in 10.)
-		mapCompileDocEqnSigs( eqSigs, eqInputs, eqOutputs, DC, docCompiledEqnsVector );		///< step 10. Compile every signal.
+		for( unsigned int i=0; i < eqSigs.size(); i++ ) {							///< step 10. (when printed)
+			docEqnsVector.push_back( DocEqn(eqSigs[i], eqInputs[i], eqOutputs[i]) );
+		}
 	}
+	return DC;
 }
 
 
@@ -746,23 +742,18 @@ static void	annotateSuperList(DocCompiler* DC, Tree superEqList)
 
 
 /**
- * #10. Name and compile prepared doc <equation> signals.
+ * #10. Name and compile a prepared doc <equation>, unless it is already compiled.
+ * The equations are compiled in the order of the document, which determines
+ * the names of the signals.
  *
- * @param[in]	eqSigs					Contains well-prepared and nicknamed signals.
- * @param[in]	DC						The signals compiler.
- * @param[out]	docCompiledEqnsVector	The place to store each compiled Lateq* object.
+ * @param[in]	DC		The signals compiler.
+ * @param[out]	eqn		The equation, to store its compiled Lateq* object.
  */
-static void mapCompileDocEqnSigs(const vector<Tree>& eqSigs, const vector<int>& eqInputs, const vector<int>& eqOutputs, DocCompiler* DC, vector<Lateq*>& docCompiledEqnsVector)
+static void compileDocEqn(DocCompiler* DC, DocEqn& eqn)
 {
-	//cerr << "###\n# Documentator : mapCompileDocEqnSigs" << endl;
-	
-	for( unsigned int i=0; i < eqSigs.size(); i++ ) {
-		
-		//		docCompiledEqnsVector.push_back( DC->compileMultiSignal(*it, 0) );
-		docCompiledEqnsVector.push_back( DC->compileLateq(eqSigs[i], new Lateq(eqInputs[i], eqOutputs[i])) );
+	if (eqn.fLateq == 0) {
+		eqn.fLateq = DC->compileLateq(eqn.fSigs, new Lateq(eqn.fInputs, eqn.fOutputs));
 	}
-	
-	//cerr << "Documentator : end of mapCompileDocEqnSigs\n---" << endl;
 }
 
 
@@ -803,23 +794,31 @@ static string calcDocEqnInitial(const string s)
 static void getBoxInputsAndOutputs(const Tree t, int& numInputs, int& numOutputs)
 {
 	if (!getBoxType(t, &numInputs, &numOutputs)) {
-		cerr << "ERROR during the evaluation of t : " << boxpp(t) << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR during the evaluation of t : " << boxpp(t) << endl;
+		throw faustexception();
 	}
 	//cerr << "Documentator : " << numInputs <<" inputs and " << numOutputs <<" outputs for box : " << boxpp(t) << endl;
 }
 
 
 /**
- * Print doc equations, following the Lateq::println method.
+ * Compile and print a doc equation, following the Lateq::println method,
+ * then free its LaTeX code.
  *
- * @param[in]	ltq		The object containing compiled LaTeX code of equations.
- * @param[out]	docout	The output file to print into.
+ * @param[in]	DC				The signals compiler.
+ * @param[in]	docEqnsVector	The prepared equations.
+ * @param[in]	i				The number of the equation to print.
+ * @param[out]	docout			The output file to print into.
  */
-static void printDocEqn(Lateq* ltq, ostream& docout) 
+static void printDocEqn(DocCompiler* DC, vector<DocEqn>& docEqnsVector, unsigned int i, ostream& docout) 
 {
-	ltq->println(docout);
-	//cerr << "Documentator : printDocEqn : "; ltq->println(cerr); cerr << endl;
+	DocEqn& eqn = docEqnsVector[i];
+	compileDocEqn(DC, eqn);
+	eqn.fLateq->println(docout);
+	//cerr << "Documentator : printDocEqn : "; eqn.fLateq->println(cerr); cerr << endl;
+	delete eqn.fLateq;
+	eqn.fLateq = 0;
+	eqn.fSigs = nil;
 }
 
 
@@ -842,10 +841,10 @@ static void printDocEqn(Lateq* ltq, ostream& docout)
 static void printDocDgm(const Tree expr, const char* svgTopDir, ostream& docout, int i)
 {
 	/** 1. Evaluate expression. */
-	Tree docdgm = evaldocexpr(expr, gExpandedDefList);
-	if (gErrorCount > 0) {
-		cerr << "Total of " << gErrorCount << " errors during evaluation of : diagram docdgm = " << boxpp(docdgm) << ";\n";
-		exit(1);
+	Tree docdgm = evaldocexpr(expr, gGlobal->gExpandedDefList);
+	if (gGlobal->gErrorCount > 0) {
+		gGlobal->gErrors << "Total of " << gGlobal->gErrorCount << " errors during evaluation of : diagram docdgm = " << boxpp(docdgm) << ";\n";
+		throw faustexception();
 	}
 	
 	/**
@@ -860,19 +859,18 @@ static void printDocDgm(const Tree expr, const char* svgTopDir, ostream& docout,
 	drawSchema( docdgm, thisdgmdir.c_str(), "svg" );
 	
 	/** 3. Print LaTeX figure code. */
-	char temp[1024];
-	const string dgmfilename = legalFileName(docdgm, 1024, temp);
+	const string dgmfilename = drawSchemaName(docdgm);
 	//docout << "figure \\ref{figure" << i << "}";
 	docout << "\\begin{figure}[ht!]" << endl;
 	docout << "\t\\centering" << endl;
 	docout << "\t\\includegraphics[width=\\textwidth]{" << subst("../svg/svg-$0/", dgmid) << dgmfilename << "}" << endl;
-	docout << "\t\\caption{" << gDocMathStringMap["dgmcaption"] << " \\texttt{" << dgmfilename << "}}" << endl;
+	docout << "\t\\caption{" << gGlobal->gDocMathStringMap["dgmcaption"] << " \\texttt{" << dgmfilename << "}}" << endl;
 	docout << "\t\\label{figure" << i << "}" << endl;
 	docout << "\\end{figure}" << endl << endl;
 	
 	/** 4. Warn about naming interferences (in the notice). */
-	gDocNoticeFlagMap["nameconflicts"] = true;
-	gDocNoticeFlagMap["svgdir"] = true;
+	gGlobal->gDocNoticeFlagMap["nameconflicts"] = true;
+	gGlobal->gDocNoticeFlagMap["svgdir"] = true;
 }
 
 
@@ -918,8 +916,8 @@ vector<string>& docCodeSlicer(const string& faustfile, vector<string>& codeSlice
 			if (foundclosedoc != string::npos) isInsideDoc = false;
 		}
 	} else {
-		cerr << "ERROR : can't open faust source file " << faustfile << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR : can't open faust source file " << faustfile << endl;
+		throw faustexception();
 	}
 	return codeSlices;
 }
@@ -961,8 +959,8 @@ static bool doesFileBeginWithCode(const string& faustfile)
 			return true;
 		}
 	} else {
-		cerr << "ERROR : can't open faust source file " << faustfile << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR : can't open faust source file " << faustfile << endl;
+		throw faustexception();
 	}
 }	
 
@@ -977,43 +975,17 @@ static bool doesFileBeginWithCode(const string& faustfile)
 static istream* openArchFile (const string& filename)
 {
 	istream* file;
-	getCurrentDir();	// Save the current directory.
 	//cerr << "Documentator : openArchFile : Opening input file  '" << filename << "'" << endl;
 	if ( (file = open_arch_stream(filename.c_str())) ) {
 		//cerr << "Documentator : openArchFile : Opening '" << filename << "'" << endl;
 	} else {
-		cerr << "ERROR : can't open architecture file " << filename << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR : can't open architecture file " << filename << endl;
+		throw faustexception();
 	}
-	cholddir();			// Return to current directory.
 	return file;
 }
 
 
-/**
- * Transform the definition name property of tree <t> into a
- * legal file name.  The resulting file name is stored in
- * <dst> a table of at least <n> chars. Returns the <dst> pointer
- * for convenience.
- */
-static char* legalFileName(const Tree t, int n, char* dst)
-{
-	Tree	id;
-	int 	i=0;
-	if (getDefNameProperty(t, id)) {
-		const char* 	src = tree2str(id);
-		for (i=0; isalnum(src[i]) && i<16; i++) {
-			dst[i] = src[i];
-		}
-	}
-	dst[i] = 0;
-	if (strcmp(dst, "process") != 0) { 
-		// if it is not process add the hex address to make the name unique
-		snprintf(&dst[i], n-i, "-%p", t);
-	}
-	return dst;
-}
-
 /**
  * Simply concat a string with a number in a "%03d" format.
  * The number has MAXIDCHARS characters. 
@@ -1077,12 +1049,12 @@ static void initCompilationDate()
 	time_t now;
 	
 	time(&now);
-	gCompilationDate = *localtime(&now);
+	gGlobal->gCompilationDate = *localtime(&now);
 }
 
 static struct tm* getCompilationDate()
 {
 	initCompilationDate();
-	return &gCompilationDate;
+	return &gGlobal->gCompilationDate;
 }
 
@@ -51,12 +51,10 @@
 #include "doc.hh"
 #include "tlib.hh"
 #include "doc_notice.hh"
+#include "exception.hh"
+#include "global.hh"
 
 
-extern bool		gLessTempSwitch;
-extern int		gMaxCopyDelay;
-extern map<string, string>		gDocMathStringMap;
-
 extern bool		getSigListNickName(Tree t, Tree& id);
 
 
@@ -64,15 +62,13 @@ extern bool		getSigListNickName(Tree t, Tree& id);
 						getFreshID
 *****************************************************************************/
 
-map<string, int>	DocCompiler::fIDCounters;
-
 string DocCompiler::getFreshID(const string& prefix)
 {
-	if (fIDCounters.find(prefix) == fIDCounters.end()) {
-		fIDCounters[prefix] = 1;
+	if (gGlobal->gDocIDCounters.find(prefix) == gGlobal->gDocIDCounters.end()) {
+		gGlobal->gDocIDCounters[prefix] = 1;
 	}
-	int n = fIDCounters[prefix];
-	fIDCounters[prefix] = n+1;
+	int n = gGlobal->gDocIDCounters[prefix];
+	gGlobal->gDocIDCounters[prefix] = n+1;
 	
 	return subst("$0_{$1}", prefix, docT(n));
 }
@@ -113,10 +109,10 @@ Lateq* DocCompiler::compileLateq (Tree L, Lateq* compiledEqn)
 			//cerr << "Documentator : compileLateq : NO NICKNAMEPROPERTY" << endl;
 			if (fLateq->outputs() == 1) {
 				fLateq->addOutputSigFormula(subst("y(t) = $0", CS(sig, priority)));	
-				gDocNoticeFlagMap["outputsig"] = true;
+				gGlobal->gDocNoticeFlagMap["outputsig"] = true;
 			} else {
 				fLateq->addOutputSigFormula(subst("$0(t) = $1", getFreshID("y"), CS(sig, priority)));	
-				gDocNoticeFlagMap["outputsigs"] = true;
+				gGlobal->gDocNoticeFlagMap["outputsigs"] = true;
 			}
 		}
 	}
@@ -234,8 +230,8 @@ string	DocCompiler::generateCode (Tree sig, int priority)
 	else if ( isSigAttach(sig, x, y) )				{ printGCCall(sig,"generateAttach");	return generateAttach	(sig, x, y, priority); }
 	
 	else {
-        cerr << "Error in d signal, unrecognized signal : " << *sig << endl;
-        exit(1);
+        gGlobal->gErrors << "Error in d signal, unrecognized signal : " << *sig << endl;
+        throw faustexception();
 	}
     assert(0);
 	return "error in generate code";
@@ -254,11 +250,11 @@ void DocCompiler::printGCCall(Tree sig, const string& calledFunction)
 	bool maskSigs	= false;
 	
 	if(printCalls) {
-		cerr << "  -> generateCode calls " << calledFunction;
+		gGlobal->gErrors << "  -> generateCode calls " << calledFunction;
 		if(maskSigs) {
-			cerr << endl;
+			gGlobal->gErrors << endl;
 		} else {
-			cerr << " on " << ppsig(sig) << endl;
+			gGlobal->gErrors << " on " << ppsig(sig) << endl;
 		}
 	}
 }
@@ -277,7 +273,7 @@ string DocCompiler::generateNumber (Tree sig, const string& exp)
 	// check for number occuring in delays
 	if (o->getMaxDelay()>0) {
 		getTypedNames(getCertifiedSigType(sig), "r", ctype, vname);
-		gDocNoticeFlagMap["recursigs"] = true;
+		gGlobal->gDocNoticeFlagMap["recursigs"] = true;
 		//cerr << "- r : generateNumber : \"" << vname << "\"" << endl;            
 		generateDelayVec(sig, exp, ctype, vname, o->getMaxDelay());
 	}
@@ -296,7 +292,7 @@ string DocCompiler::generateFConst (Tree sig, const string& file, const string&
 
     if (o->getMaxDelay()>0) {
         getTypedNames(getCertifiedSigType(sig), "r", ctype, vname);
-		gDocNoticeFlagMap["recursigs"] = true;
+		gGlobal->gDocNoticeFlagMap["recursigs"] = true;
 		//cerr << "- r : generateFConst : \"" << vname << "\"" << endl;            
         generateDelayVec(sig, exp, ctype, vname, o->getMaxDelay());
     }
@@ -321,7 +317,7 @@ string DocCompiler::generateFVar (Tree sig, const string& file, const string& ex
 
     if (o->getMaxDelay()>0) {
         getTypedNames(getCertifiedSigType(sig), "r", ctype, vname);
-		gDocNoticeFlagMap["recursigs"] = true;
+		gGlobal->gDocNoticeFlagMap["recursigs"] = true;
 		//cerr << "- r : generateFVar : \"" << vname << "\"" << endl;            
 		setVectorNameProperty(sig, vname);
         generateDelayVec(sig, exp, ctype, vname, o->getMaxDelay());
@@ -340,12 +336,12 @@ string DocCompiler::generateInput (Tree sig, const string& idx)
 	if (fLateq->inputs() == 1) {
 		setVectorNameProperty(sig, "x");
 		fLateq->addInputSigFormula("x(t)");	
-		gDocNoticeFlagMap["inputsig"] = true;
+		gGlobal->gDocNoticeFlagMap["inputsig"] = true;
 		return generateCacheCode(sig, "x(t)");
 	} else {
 		setVectorNameProperty(sig, subst("x_{$0}", idx));
 		fLateq->addInputSigFormula(subst("x_{$0}(t)", idx));
-		gDocNoticeFlagMap["inputsigs"] = true;
+		gGlobal->gDocNoticeFlagMap["inputsigs"] = true;
 		return generateCacheCode(sig, subst("x_{$0}(t)", idx));
 	}
 }
@@ -358,10 +354,10 @@ string DocCompiler::generateOutput (Tree sig, const string& idx, const string& a
 	
 	if (fLateq->outputs() == 1) {
 		dst = subst("y(t)", idx);
-		gDocNoticeFlagMap["outputsig"] = true;
+		gGlobal->gDocNoticeFlagMap["outputsig"] = true;
 	} else {
 		dst = subst("y_{$0}(t)", idx);
-		gDocNoticeFlagMap["outputsigs"] = true;
+		gGlobal->gDocNoticeFlagMap["outputsigs"] = true;
 	}
 	
 	fLateq->addOutputSigFormula(subst("$0 = $1", dst, arg));
@@ -427,20 +423,20 @@ string DocCompiler::generateBinOp(Tree sig, int opcode, Tree arg1, Tree arg2, in
 		switch (opcode) {
 			case kAdd:
 				op = "\\oplus";
-				gDocNoticeFlagMap["intplus"] = true;
+				gGlobal->gDocNoticeFlagMap["intplus"] = true;
 				break;
 			case kSub:
 				op = "\\ominus";
-				gDocNoticeFlagMap["intminus"] = true;
+				gGlobal->gDocNoticeFlagMap["intminus"] = true;
 				break;
 			case kMul:
 				op = "\\odot";
-				gDocNoticeFlagMap["intmult"] = true;
+				gGlobal->gDocNoticeFlagMap["intmult"] = true;
 				break;
 			case kDiv:
 				op = "\\oslash";
-				gDocNoticeFlagMap["intdiv"] = true;
-				gDocNoticeFlagMap["intcast"] = true; // "$normalize(int(i/j))$" in the notice.
+				gGlobal->gDocNoticeFlagMap["intdiv"] = true;
+				gGlobal->gDocNoticeFlagMap["intcast"] = true; // "$normalize(int(i/j))$" in the notice.
 				break;
 			default:
 				op = gBinOpLateqTable[opcode]->fName;
@@ -479,7 +475,7 @@ string DocCompiler::generateFFun(Tree sig, Tree ff, Tree largs, int priority)
     }
     code += ')';
 	
-	gDocNoticeFlagMap["foreignfun"] = true;
+	gGlobal->gDocNoticeFlagMap["foreignfun"] = true;
 
     return "\\mathrm{ff"+code+"}";
 }
@@ -545,7 +541,7 @@ string DocCompiler::generateCacheCode(Tree sig, const string& exp)
 			return exp;
 		}
         getTypedNames(getCertifiedSigType(sig), "r", ctype, vname);
-		gDocNoticeFlagMap["recursigs"] = true;
+		gGlobal->gDocNoticeFlagMap["recursigs"] = true;
 		//cerr << "- r : generateCacheCode : vame=\"" << vname << "\", for sig=\"" << ppsig(sig) << "\"" << endl;
         if (sharing>1) {
 			//cerr << "      generateCacheCode calls generateDelayVec(generateVariableStore) on vame=\"" << vname << "\"" << endl;            
@@ -564,8 +560,8 @@ string DocCompiler::generateCacheCode(Tree sig, const string& exp)
         return generateVariableStore(sig, exp);
 	} 
 	else {
-        cerr << "Error in sharing count (" << sharing << ") for " << *sig << endl;
-		exit(1);
+        gGlobal->gErrors << "Error in sharing count (" << sharing << ") for " << *sig << endl;
+		throw faustexception();
 	}
 	
 	return "Error in generateCacheCode";
@@ -582,13 +578,13 @@ string DocCompiler::generateVariableStore(Tree sig, const string& exp)
         case kKonst :
             getTypedNames(t, "k", ctype, vname); ///< "k" for constants.
             fLateq->addConstSigFormula(subst("$0 = $1", vname, exp));
-			gDocNoticeFlagMap["constsigs"] = true;
+			gGlobal->gDocNoticeFlagMap["constsigs"] = true;
 			return vname;
 			
         case kBlock :
             getTypedNames(t, "p", ctype, vname); ///< "p" for "parameter".
             fLateq->addParamSigFormula(subst("$0(t) = $1", vname, exp));
-			gDocNoticeFlagMap["paramsigs"] = true;
+			gGlobal->gDocNoticeFlagMap["paramsigs"] = true;
 			setVectorNameProperty(sig, vname);
 			return subst("$0(t)", vname);
 			
@@ -599,7 +595,7 @@ string DocCompiler::generateVariableStore(Tree sig, const string& exp)
 				getTypedNames(t, "s", ctype, vname);
 				//cerr << "- generateVariableStore : \"" << subst("$0(t) = $1", vname, exp) << "\"" << endl;
 				fLateq->addStoreSigFormula(subst("$0(t) = $1", vname, exp));
-				gDocNoticeFlagMap["storedsigs"] = true;
+				gGlobal->gDocNoticeFlagMap["storedsigs"] = true;
 				setVectorNameProperty(sig, vname);
 				return subst("$0(t)", vname);
 			}
@@ -618,7 +614,7 @@ string DocCompiler::generateVariableStore(Tree sig, const string& exp)
 
 string DocCompiler::generateIntCast(Tree sig, Tree x, int priority)
 {
-	gDocNoticeFlagMap["intcast"] = true;
+	gGlobal->gDocNoticeFlagMap["intcast"] = true;
 			 
 	return generateCacheCode(sig, subst("\\mathrm{int}\\left($0\\right)", CS(x, 0)));
 }
@@ -646,7 +642,7 @@ string DocCompiler::generateButton(Tree sig, Tree path)
 	string vname = getFreshID("{u_b}");
 	string varname = vname + "(t)";
 	fLateq->addUISigFormula(getUIDir(path), prepareBinaryUI(varname, path));
-	gDocNoticeFlagMap["buttonsigs"] = true;
+	gGlobal->gDocNoticeFlagMap["buttonsigs"] = true;
 	return generateCacheCode(sig, varname);
 }
 
@@ -655,7 +651,7 @@ string DocCompiler::generateCheckbox(Tree sig, Tree path)
 	string vname = getFreshID("{u_c}");
 	string varname = vname + "(t)";
 	fLateq->addUISigFormula(getUIDir(path), prepareBinaryUI(varname, path));
-	gDocNoticeFlagMap["checkboxsigs"] = true;
+	gGlobal->gDocNoticeFlagMap["checkboxsigs"] = true;
 	return generateCacheCode(sig, varname);
 }
 
@@ -663,7 +659,7 @@ string DocCompiler::generateVSlider(Tree sig, Tree path, Tree cur, Tree min, Tre
 {
 	string varname = getFreshID("{u_s}") + "(t)";
 	fLateq->addUISigFormula(getUIDir(path), prepareIntervallicUI(varname, path, cur, min, max));
-	gDocNoticeFlagMap["slidersigs"] = true;
+	gGlobal->gDocNoticeFlagMap["slidersigs"] = true;
 	return generateCacheCode(sig, varname);
 }
 
@@ -671,7 +667,7 @@ string DocCompiler::generateHSlider(Tree sig, Tree path, Tree cur, Tree min, Tre
 {
 	string varname = getFreshID("{u_s}") + "(t)";
 	fLateq->addUISigFormula(getUIDir(path), prepareIntervallicUI(varname, path, cur, min, max));
-	gDocNoticeFlagMap["slidersigs"] = true;
+	gGlobal->gDocNoticeFlagMap["slidersigs"] = true;
 	return generateCacheCode(sig, varname);
 }
 
@@ -679,7 +675,7 @@ string DocCompiler::generateNumEntry(Tree sig, Tree path, Tree cur, Tree min, Tr
 {
 	string varname = getFreshID("{u_n}") + "(t)";		
 	fLateq->addUISigFormula(getUIDir(path), prepareIntervallicUI(varname, path, cur, min, max));
-	gDocNoticeFlagMap["nentrysigs"] = true;
+	gGlobal->gDocNoticeFlagMap["nentrysigs"] = true;
 	return generateCacheCode(sig, varname);
 }
 
@@ -759,7 +755,7 @@ string DocCompiler::generateDocConstantTbl (Tree /*tbl*/, Tree size, Tree isig)
 
     int     n;
     if (!isSigInt(size, &n)) {
-        cerr << "error in DocCompiler::generateDocConstantTbl() : "
+        gGlobal->gErrors << "error in DocCompiler::generateDocConstantTbl() : "
              << *size
              << " is not an integer expression and can't be used as a table size' "
              << endl;
@@ -769,7 +765,7 @@ string DocCompiler::generateDocConstantTbl (Tree /*tbl*/, Tree size, Tree isig)
     getTypedNames(getCertifiedSigType(isig), "v", ctype, vname);
 	
     // add a comment on tables in the notice
-		gDocNoticeFlagMap["tablesigs"] = true;
+		gGlobal->gDocNoticeFlagMap["tablesigs"] = true;
 	
     // add equation v[t] = isig(t)
         fLateq->addRDTblSigFormula(subst("$0[t] = $1 \\condition{when $$t \\in [0,$2]$$} ", vname, init, T(n-1)));
@@ -823,7 +819,7 @@ string DocCompiler::generateDocWriteTbl (Tree /*tbl*/, Tree size, Tree isig, Tre
     string 	init = CS(isig,0);
     int     n;
     if (!isSigInt(size, &n)) {
-        cerr << "error in DocCompiler::generateDocWriteTbl() : "
+        gGlobal->gErrors << "error in DocCompiler::generateDocWriteTbl() : "
              << *size
              << " is not an integer expression and can't be used as a table size' "
              << endl;
@@ -834,7 +830,7 @@ string DocCompiler::generateDocWriteTbl (Tree /*tbl*/, Tree size, Tree isig, Tre
     getTypedNames(getCertifiedSigType(isig), "w", ctype, vname);
 
     // add a comment on tables in the notice
-    gDocNoticeFlagMap["tablesigs"] = true;
+    gGlobal->gDocNoticeFlagMap["tablesigs"] = true;
 
     // describe the table equation
     string ltqRWTableDef;
@@ -922,7 +918,7 @@ void DocCompiler::generateRec(Tree sig, Tree var, Tree le, int priority)
             used[i] = true;
 			//cerr << "generateRec : used[" << i << "] = true" << endl;            
             getTypedNames(getCertifiedSigType(e), "r", ctype[i],  vname[i]);
-			gDocNoticeFlagMap["recursigs"] = true;
+			gGlobal->gDocNoticeFlagMap["recursigs"] = true;
 			//cerr << "- r : generateRec setVectorNameProperty : \"" << vname[i] << "\"" << endl;
 			setVectorNameProperty(e, vname[i]);
             delay[i] = fOccMarkup.retrieve(e)->getMaxDelay();
@@ -965,7 +961,7 @@ string DocCompiler::generatePrefix (Tree sig, Tree x, Tree e, int priority)
 	string vecname;
 
 	if (! getVectorNameProperty(e, vecname)) {
-		cerr << "No vector name for : " << ppsig(e) << endl;
+		gGlobal->gErrors << "No vector name for : " << ppsig(e) << endl;
 		assert(0);
 	}
 	
@@ -977,7 +973,7 @@ string DocCompiler::generatePrefix (Tree sig, Tree x, Tree e, int priority)
 	ltqPrefixDef += "\\end{array}\\right.";
 	
 	fLateq->addPrefixSigFormula(ltqPrefixDef);
-	gDocNoticeFlagMap["prefixsigs"] = true;
+	gGlobal->gDocNoticeFlagMap["prefixsigs"] = true;
 	
 	return generateCacheCode(sig, subst("$0(t)", var));
 }
@@ -993,7 +989,7 @@ string DocCompiler::generatePrefix (Tree sig, Tree x, Tree e, int priority)
 string DocCompiler::generateIota (Tree sig, Tree n)
 {
 	int size;
-	if (!isSigInt(n, &size)) { fprintf(stderr, "error in generateIota\n"); exit(1); }
+	if (!isSigInt(n, &size)) { gGlobal->gErrors << "error in generateIota" << endl; throw faustexception(); }
 	//cout << "iota !" << endl;
 	return subst(" t \\bmod{$0} ", docT(size));
 }
@@ -1021,7 +1017,7 @@ string DocCompiler::generateSelect2  (Tree sig, Tree sel, Tree s1, Tree s2, int
 	ltqSelDef += "\\end{array}\\right.";
 	
 	fLateq->addSelectSigFormula(ltqSelDef);
-	gDocNoticeFlagMap["selectionsigs"] = true;
+	gGlobal->gDocNoticeFlagMap["selectionsigs"] = true;
 	
     //return generateCacheCode(sig, subst("$0(t)", var));
     setVectorNameProperty(sig, var);
@@ -1049,7 +1045,7 @@ string DocCompiler::generateSelect3  (Tree sig, Tree sel, Tree s1, Tree s2, Tree
 	ltqSelDef += "\\end{array}\\right.";
 	
 	fLateq->addSelectSigFormula(ltqSelDef);
-	gDocNoticeFlagMap["selectionsigs"] = true;
+	gGlobal->gDocNoticeFlagMap["selectionsigs"] = true;
 	
     //return generateCacheCode(sig, subst("$0(t)", var));
     setVectorNameProperty(sig, var);
@@ -1154,7 +1150,7 @@ string DocCompiler::generateFixDelay (Tree sig, Tree exp, Tree delay, int priori
 	CS(exp, 0); // ensure exp is compiled to have a vector name
 	
 	if (! getVectorNameProperty(exp, vecname)) {
-		cerr << "No vector name for : " << ppsig(exp) << endl;
+		gGlobal->gErrors << "No vector name for : " << ppsig(exp) << endl;
 		assert(0);
 	}
 	
@@ -1276,7 +1272,7 @@ string DocCompiler::prepareBinaryUI(const string& name, Tree path)
 	s += label + unit;
 	s += " & $" + name + "$";
 	s += " $\\in$ $\\left\\{\\,0, 1\\,\\right\\}$";
-	s += " & $(\\mbox{" + gDocMathStringMap["defaultvalue"] + "} = 0)$\\\\";
+	s += " & $(\\mbox{" + gGlobal->gDocMathStringMap["defaultvalue"] + "} = 0)$\\\\";
 	return s;
 }
 
@@ -1310,7 +1306,7 @@ string DocCompiler::prepareIntervallicUI(const string& name, Tree path, Tree tcu
 	s += label + unit;
 	s += " & $" + name + "$";
 	s += " $\\in$ $\\left[\\," + min + ", " + max + "\\,\\right]$";
-	s += " & $(\\mbox{" + gDocMathStringMap["defaultvalue"] + "} = " + cur + ")$\\\\";
+	s += " & $(\\mbox{" + gGlobal->gDocMathStringMap["defaultvalue"] + "} = " + cur + ")$\\\\";
 	return s;
 }
 
@@ -55,7 +55,6 @@ class DocCompiler
 	Lateq*			fLateq;
 	Description*	fDescription;
 
-	static map<string, int>		fIDCounters;
 	Tree                      	fSharingKey;
 	OccMarkup					fOccMarkup;
 	int							fPriority;	///< math priority context
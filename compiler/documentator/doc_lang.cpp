@@ -35,21 +35,11 @@
 #include "lateq.hh"
 #include "enrobage.hh"
 #include "compatibility.hh"
+#include "exception.hh"
+#include "global.hh"
 
 
 
-extern map<string, string>	gDocNoticeStringMap;
-extern set<string>			gDocNoticeKeySet;
-
-extern map<string, string>	gDocAutodocStringMap;
-extern set<string>			gDocAutodocKeySet;
-
-extern map<string, string>	gDocMathStringMap;
-extern set<string>			gDocMathKeySet;
-
-extern map<string, string>	gDocMetadatasStringMap;
-extern set<string>			gDocMetadatasKeySet;
-
 static const string			gDocTextsDefaultFile = "mathdoctexts-default.txt";
 
 static void			importDocStrings(const string& filename);
@@ -60,10 +50,6 @@ static void			storePair(const string& key, const string& text);
 static void			printStringMapContent(map<string,string>& map, const string& name);
 
 static istream*		openArchFile (const string& filename);
-static void			getCurrentDir();
-static int			cholddir();
-
-static string 		gCurrentDir;	///< Room to save current directory name.
 
 
 
@@ -135,10 +121,10 @@ static void importDocStrings(const string& filename)
 		getText(s, pt1, text);
 		storePair(key, text);
 	}
-	printStringMapContent(gDocNoticeStringMap, "gDocNoticeStringMap");
-	printStringMapContent(gDocAutodocStringMap, "gDocAutodocStringMap");
-	printStringMapContent(gDocMathStringMap, "gDocMathStringMap");
-	printStringMapContent(gDocMetadatasStringMap, "gDocMetadatasStringMap");
+	printStringMapContent(gGlobal->gDocNoticeStringMap, "gDocNoticeStringMap");
+	printStringMapContent(gGlobal->gDocAutodocStringMap, "gDocAutodocStringMap");
+	printStringMapContent(gGlobal->gDocMathStringMap, "gDocMathStringMap");
+	printStringMapContent(gGlobal->gDocMetadatasStringMap, "gDocMetadatasStringMap");
 }
 
 
@@ -178,20 +164,20 @@ static void storePair(const string& key, const string& text)
 	/* Store the current pair. */
 	if(!key.empty() && !text.empty()) {
 		
-		if (gDocNoticeKeySet.find(key) != gDocNoticeKeySet.end()) {
-			gDocNoticeStringMap[key] = text;
+		if (gGlobal->gDocNoticeKeySet.find(key) != gGlobal->gDocNoticeKeySet.end()) {
+			gGlobal->gDocNoticeStringMap[key] = text;
 		} 
-		else if (gDocAutodocKeySet.find(key) != gDocAutodocKeySet.end()) {
-			gDocAutodocStringMap[key] = text;
+		else if (gGlobal->gDocAutodocKeySet.find(key) != gGlobal->gDocAutodocKeySet.end()) {
+			gGlobal->gDocAutodocStringMap[key] = text;
 		}
-		else if (gDocMathKeySet.find(key) != gDocMathKeySet.end()) {
-			gDocMathStringMap[key] = text;
+		else if (gGlobal->gDocMathKeySet.find(key) != gGlobal->gDocMathKeySet.end()) {
+			gGlobal->gDocMathStringMap[key] = text;
 		}
-		else if (gDocMetadatasKeySet.find(key) != gDocMetadatasKeySet.end()) {
-			gDocMetadatasStringMap[key] = text;
+		else if (gGlobal->gDocMetadatasKeySet.find(key) != gGlobal->gDocMetadatasKeySet.end()) {
+			gGlobal->gDocMetadatasStringMap[key] = text;
 		}
 		else {
-			cerr << "Documentator : importDocStings : " << "warning : unknown key \"" << key << "\"" << endl;
+			gGlobal->gErrors << "Documentator : importDocStings : " << "warning : unknown key \"" << key << "\"" << endl;
 		}
 		//cerr << "gDocNoticeStringMap[\"" << key << "\"] = \"" << gDocNoticeStringMap[key] << "\"" << endl;
 	}
@@ -224,39 +210,13 @@ static void printStringMapContent(map<string,string>& m, const string& name) {
 static istream* openArchFile (const string& filename)
 {
 	istream* file;
-	getCurrentDir();	// Save the current directory.
 	if ( (file = open_arch_stream(filename.c_str())) ) {
 		//cerr << "Documentator : openArchFile : Opening '" << filename << "'" << endl;
 	} else {
-		cerr << "ERROR : can't open architecture file " << filename << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR : can't open architecture file " << filename << endl;
+		throw faustexception();
 	}
-	cholddir();			// Return to current directory.
 	return file;
 }
 
 
-/**
- * Switch back to the previously stored current directory
- */
-static int cholddir ()
-{
-	if (chdir(gCurrentDir.c_str()) == 0) {
-		return 0;
-	} else {
-		perror("cholddir");
-		exit(errno);
-	}
-}
-
-
-/**
- * Get current directory and store it in gCurrentDir.
- */
-static void getCurrentDir ()
-{
-	char	buffer[FAUST_PATH_MAX];
-    gCurrentDir = getcwd (buffer, FAUST_PATH_MAX);
-}
-
-
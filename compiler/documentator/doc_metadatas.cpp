@@ -28,13 +28,9 @@
 
 #include "doc_metadatas.hh"
 #include "doc.hh"
+#include "global.hh"
 
 
-extern SourceReader		gReader;
-
-map<string, string>		gDocMetadatasStringMap;
-set<string>				gDocMetadatasKeySet;
-
 static void				initDocMetadatasKeySet();
 
 
@@ -65,11 +61,11 @@ void initDocMetadatas()
  */
 static void initDocMetadatasKeySet() {
 	
-	gDocMetadatasKeySet.insert("name");
-	gDocMetadatasKeySet.insert("author");
-	gDocMetadatasKeySet.insert("copyright");
-	gDocMetadatasKeySet.insert("license");
-	gDocMetadatasKeySet.insert("version");
+	gGlobal->gDocMetadatasKeySet.insert("name");
+	gGlobal->gDocMetadatasKeySet.insert("author");
+	gGlobal->gDocMetadatasKeySet.insert("copyright");
+	gGlobal->gDocMetadatasKeySet.insert("license");
+	gGlobal->gDocMetadatasKeySet.insert("version");
 }
 
 
@@ -34,13 +34,6 @@ using namespace std;
 
 
 
-/** 
- * gDocNoticeFlagMap is public to let others 
- * turn to "true" flags that one want to print. 
- */
-extern map<string, bool> gDocNoticeFlagMap;
-
-
 void initDocNotice();
 void printDocNotice(const string& faustversion, ostream& docout);
 
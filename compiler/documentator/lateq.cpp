@@ -46,11 +46,10 @@
 
 #include "lateq.hh"
 #include "Text.hh"
+#include "exception.hh"
+#include "global.hh"
 
 
-map<string, string>		gDocMathStringMap;
-set<string>				gDocMathKeySet;
-
 static int	getLateqIndex(const string& s);
 static bool compLateqIndexes(const string& s1, const string& s2);
 static void initDocMathKeySet();
@@ -83,7 +82,7 @@ inline std::string to_string (const T& t)
 void Lateq::println(ostream& docout)
 {	
 	/* 1. Make titles of sub-sets of formulas. */
-	string suchthat		= gDocMathStringMap["suchthat"];
+	string suchthat		= gGlobal->gDocMathStringMap["suchthat"];
 	
 	string sInputs		= makeItemTitle((const unsigned int)fInputSigsFormulas.size(), "inputsigtitle") + makeSignamesList(fInputSigsFormulas, "");
 	string sOutputs		= makeItemTitle((const unsigned int)fOutputSigsFormulas.size(), "outputsigtitle") + makeSignamesList(fOutputSigsFormulas, suchthat);
@@ -107,12 +106,12 @@ void Lateq::println(ostream& docout)
 	
 	/* 2. Successively print each Lateq field containing LaTeX formulas, with a title. */
 	
-	docout << endl << gDocMathStringMap["lateqcomment"] << endl;
+	docout << endl << gGlobal->gDocMathStringMap["lateqcomment"] << endl;
 	docout << "\\begin{enumerate}" << endl << endl;
 	
 	printDGroup		(sOutputs, fOutputSigsFormulas, docout);
 	printOneLine	(sInputs, docout);
-	const string outputsTitle = "\\item " + sOutputs + "\\ $y_i$\\ " + gDocMathStringMap["for"] + " $i \\in [1," + to_string(fOutputSigsFormulas.size()) + "]$: ";
+	const string outputsTitle = "\\item " + sOutputs + "\\ $y_i$\\ " + gGlobal->gDocMathStringMap["for"] + " $i \\in [1," + to_string(fOutputSigsFormulas.size()) + "]$: ";
 	printHierarchy	(sUIElements, fUISigsFormulas, docout);
 	
 	/* The "Internal signals" item gather several fields, like a "super-item"... */
@@ -145,7 +144,7 @@ string Lateq::makeItemTitle(const unsigned int formulasListSize, const string& t
 	string item		= "\\item ";
 	
 	/* Plural handling for titles of sub-sets of formulas. */
-	string title	= formulasListSize > 1 ? gDocMathStringMap[titleName + "2"] : gDocMathStringMap[titleName + "1"];
+	string title	= formulasListSize > 1 ? gGlobal->gDocMathStringMap[titleName + "2"] : gGlobal->gDocMathStringMap[titleName + "1"];
 	
 	return item + title;
 }
@@ -161,7 +160,7 @@ string Lateq::makeSigDomain(const list<string>& formulasList)
 		signame = getSigName(firstEq);
 		
 		if(formulasList.size() > 1) {
-			sigDomain = " $" + signame + "_i$ " + gDocMathStringMap["for"] + " $i \\in [1," + to_string(formulasList.size()) + "]$";
+			sigDomain = " $" + signame + "_i$ " + gGlobal->gDocMathStringMap["for"] + " $i \\in [1," + to_string(formulasList.size()) + "]$";
 		} else {
 			if(signame == "x" || signame == "y") {
 				sigDomain = " $" + signame + "$"; ///< No indices for single input neither single output.
@@ -170,7 +169,7 @@ string Lateq::makeSigDomain(const list<string>& formulasList)
 			}
 		}
 	} else {
-		sigDomain = gDocMathStringMap["emptyformulafield"];
+		sigDomain = gGlobal->gDocMathStringMap["emptyformulafield"];
 	}
 	return sigDomain;
 }
@@ -181,7 +180,7 @@ string Lateq::makeSignamesList(const list<string>& formulasList, const string& e
 	if (formulasList.size() > 0) {
 		return makeSigDomain(formulasList) + " " + ending;
 	} else {
-		return " (" + gDocMathStringMap["emptyformulafield"] + ")";
+		return " (" + gGlobal->gDocMathStringMap["emptyformulafield"] + ")";
 	}
 }
 
@@ -194,11 +193,11 @@ string Lateq::makeSignamesList(const vector<list<string> >& formulasListsVector,
 		string sep = " ";
 		for (it = formulasListsVector.begin(); it != formulasListsVector.end(); ++it) {
 			signames += sep + makeSigDomain(*it);
-			(it != (formulasListsVector.end() - 2)) ? sep = ", " : sep = " " + gDocMathStringMap["and"] + " ";
+			(it != (formulasListsVector.end() - 2)) ? sep = ", " : sep = " " + gGlobal->gDocMathStringMap["and"] + " ";
 		}
 		return signames + " " + ending;
 	} else {
-		return " (" + gDocMathStringMap["emptyformulafield"] + ")";
+		return " (" + gGlobal->gDocMathStringMap["emptyformulafield"] + ")";
 	}
 }
 
@@ -389,7 +388,7 @@ void Lateq::printHierarchy(const string& section, multimap<string,string>& field
 					if (it->first != "") {
 						tab(n+0,docout); docout << "\\item \\textsf{" << it->first << "}" << endl;
 					} else { 
-						tab(n+0,docout); docout << "\\item \\emph{" << gDocMathStringMap["rootlevel"] << "}" << endl;
+						tab(n+0,docout); docout << "\\item \\emph{" << gGlobal->gDocMathStringMap["rootlevel"] << "}" << endl;
 					}
 				}
 				tab(n+1,docout); docout << "\\begin{center}" << endl;
@@ -501,14 +500,14 @@ static int getLateqIndex(const string& s)
 		
 	p1 = s.find("_{"); 
 	if (p1==string::npos) {
-		cerr << "Error : getLateqIndex found no \"{_\" substring.\n";
-		exit(1); }
+		gGlobal->gErrors << "Error : getLateqIndex found no \"{_\" substring.\n";
+		throw faustexception(); }
 	p1 += 2;
 	
 	p2 = s.find("}", p1); 
 	if (p2==string::npos) {
-		cerr << "Error : getLateqIndex found no \"}\" substring\n.";
-		exit(1); }
+		gGlobal->gErrors << "Error : getLateqIndex found no \"}\" substring\n.";
+		throw faustexception(); }
 	p2 -= 3;
 	
 	sIndex = s.substr (p1, p2);
@@ -522,25 +521,25 @@ static int getLateqIndex(const string& s)
  */
 static void initDocMathKeySet()
 {
-	gDocMathKeySet.insert("inputsigtitle1");
-	gDocMathKeySet.insert("inputsigtitle2");
-	gDocMathKeySet.insert("outputsigtitle1");
-	gDocMathKeySet.insert("outputsigtitle2");
-	gDocMathKeySet.insert("constsigtitle1");
-	gDocMathKeySet.insert("constsigtitle2");
-	gDocMathKeySet.insert("uisigtitle1");
-	gDocMathKeySet.insert("uisigtitle2");
-	gDocMathKeySet.insert("intermedsigtitle1");
-	gDocMathKeySet.insert("intermedsigtitle2");
-	gDocMathKeySet.insert("lateqcomment");
-	gDocMathKeySet.insert("emptyformulafield");
-	gDocMathKeySet.insert("defaultvalue");
-	gDocMathKeySet.insert("suchthat");
-	gDocMathKeySet.insert("and");
-	gDocMathKeySet.insert("for");
-	gDocMathKeySet.insert("rootlevel");
-
-	gDocMathKeySet.insert("dgmcaption");
+	gGlobal->gDocMathKeySet.insert("inputsigtitle1");
+	gGlobal->gDocMathKeySet.insert("inputsigtitle2");
+	gGlobal->gDocMathKeySet.insert("outputsigtitle1");
+	gGlobal->gDocMathKeySet.insert("outputsigtitle2");
+	gGlobal->gDocMathKeySet.insert("constsigtitle1");
+	gGlobal->gDocMathKeySet.insert("constsigtitle2");
+	gGlobal->gDocMathKeySet.insert("uisigtitle1");
+	gGlobal->gDocMathKeySet.insert("uisigtitle2");
+	gGlobal->gDocMathKeySet.insert("intermedsigtitle1");
+	gGlobal->gDocMathKeySet.insert("intermedsigtitle2");
+	gGlobal->gDocMathKeySet.insert("lateqcomment");
+	gGlobal->gDocMathKeySet.insert("emptyformulafield");
+	gGlobal->gDocMathKeySet.insert("defaultvalue");
+	gGlobal->gDocMathKeySet.insert("suchthat");
+	gGlobal->gDocMathKeySet.insert("and");
+	gGlobal->gDocMathKeySet.insert("for");
+	gGlobal->gDocMathKeySet.insert("rootlevel");
+
+	gGlobal->gDocMathKeySet.insert("dgmcaption");
 }
 
 
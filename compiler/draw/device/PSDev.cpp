@@ -24,30 +24,28 @@
 #include <string.h>
 #include <math.h>
 #include <iostream>
+#include <string>
 
 #include "compatibility.hh"
 #include "PSDev.h"
+#include "global.hh"
 
 using namespace std;
 
-static int gFileNum = 0;
-
 static char * addFileNum(const char* fname)
 {
-	char 	f[256];
-	char 	s[256]; 
-	int 	i;
+	string	f(fname);
+	char 	s[32]; 
 
- 	// remove suffixes (.xxx.yyy)
-	for (i=0; (fname[i] != 0) && (fname[i] != '.'); i++) {
-		f[i] = fname[i];
-	}
-	f[i] = 0;
+ 	// remove suffixes (.xxx.yyy) of the file name, not of its directories
+	size_t	base = f.rfind('/');
+	size_t	dot = f.find('.', (base == string::npos) ? 0 : base + 1);
+	if (dot != string::npos) f.erase(dot);
 
 	// add number and .ps suffix
-	snprintf(s, 255, "%s-%d.ps", f, ++gFileNum);
+	snprintf(s, 31, "-%d.ps", ++gGlobal->gFileNum);
 	//cerr << "file name " << s << endl;
-	return strdup(s);
+	return strdup((f + s).c_str());
 }
 
 PSDev::PSDev(const char* ficName, double largeur, double hauteur)
@@ -34,11 +34,17 @@
 #include <errno.h>
 #include <string.h>
 
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 #include <ostream>
 #include <sstream>
 #include <set>
 #include <utility>
 #include <map>
+#include <queue>
 #include <stack>
 #include <string>
 
@@ -50,7 +56,6 @@
 #include "devLib.h"
 #include "ppbox.hh"
 #include "xtended.hh"
-#include "occurrences.hh"
 #include "boxcomplexity.h"
 
 #include "schema.h"
@@ -60,6 +65,8 @@
 #include "description.hh"
 #include "property.hh"
 #include "files.hh"
+#include "exception.hh"
+#include "global.hh"
 
 #if 0
 #define linkcolor "#b3d1dc"
@@ -121,21 +128,16 @@
 
 using namespace std;
 
-// external parameters
-extern int gFoldThreshold;				// max diagram complexity before folding
-
-
-// internal state during drawing
-static Occurrences* 	gOccurrences;
-static bool				sFoldingFlag;		// true with complex block-diagrams
-static stack<Tree>		gPendingExp;		// Expressions that need to be drawn
-static set<Tree>		gDrawnExp;			// Expressions drawn or scheduled so far
-static const char* 		gDevSuffix;			// .svg or .ps used to choose output device
-static string			gSchemaFileName;	// name of schema file beeing generated
-static map<Tree,string>	gBackLink;			// link to enclosing file for sub schema
+// the internal state during drawing is in gGlobal (see global.hh) : the
+// schemas are generated by the compiling thread (the trees are not thread
+// safe) and written by a pool of workers
 
 // prototypes of internal functions
 static void 	writeSchemaFile(Tree bd);
+static void 	scheduleWriting(const drawing& d);
+static void 	writeDrawing(const drawing& d);
+static void* 	writeDrawings(void* arg);
+static bool 	sameFileContent(const string& f1, const string& f2);
 static schema* 	generateDiagramSchema (Tree bd);
 static schema* 	generateInsideSchema(Tree t);
 static void 	scheduleDrawing(Tree t);
@@ -145,7 +147,8 @@ static schema* 	generateOutputSlotSchema(Tree a);
 static schema* 	generateInputSlotSchema(Tree a);
 static schema* 	generateBargraphSchema(Tree t);
 static schema* 	generateUserInterfaceSchema(Tree t);
-static char* 	legalFileName(Tree t, int n, char* dst);
+static string 	legalFileName(Tree t);
+static unsigned int diagramHash(Tree t);
 
 static schema*  addSchemaInputs(int ins, schema* x);
 static schema*  addSchemaOutputs(int outs, schema* x);
@@ -160,18 +163,64 @@ static schema*  addSchemaOutputs(int outs, schema* x);
  */
 void drawSchema(Tree bd, const char* projname, const char* dev)
 {
-	gDevSuffix 		= dev;
-	sFoldingFlag 	= boxComplexity(bd) > gFoldThreshold;
-
-	mkchdir(projname); 			// create a directory to store files
+	gGlobal->gDevSuffix 		= dev;
+	gGlobal->sFoldingFlag 	= boxComplexity(bd) > gGlobal->gFoldThreshold;
+	gGlobal->gWriteDone		= false;
+	gGlobal->gDrawnExp.clear();			// every drawSchema() call draws the whole diagram
+	gGlobal->gBackLink.clear();
+	while (!gGlobal->gPendingExp.empty()) gGlobal->gPendingExp.pop();
+
+	makedir(projname); 			// create a directory to store files
+	gGlobal->gSchemaDir		= projname;
+
+	// start the writers, the postscript files are numbered in order and written directly
+	int nworkers = 0;
+#ifndef _WIN32
+	pthread_t workers[16];
+	if (strcmp(gGlobal->gDevSuffix, "svg") == 0) {
+		long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+		nworkers = (ncpu > 16) ? 16 : (ncpu > 1) ? int(ncpu) : 0;
+		for (int i = 0; i < nworkers; i++) {
+			if (pthread_create(&workers[i], 0, writeDrawings, gGlobal) != 0) { nworkers = i; break; }
+		}
+	}
+#endif
 
-	scheduleDrawing(bd);		// schedule the initial drawing
+	try {
+		scheduleDrawing(bd);	// schedule the initial drawing
 
-	Tree t; while (pendingDrawing(t)) {
-		writeSchemaFile(t);		// generate all the pending drawing
+		Tree t; while (pendingDrawing(t)) {
+			writeSchemaFile(t);	// generate all the pending drawing
+		}
+	} catch (faustexception&) {
+		// stop the writers and leave the directory before reporting the error
+#ifndef _WIN32
+		pthread_mutex_lock(&gGlobal->gWriteMutex);
+		gGlobal->gWriteDone = true;
+		while (!gGlobal->gWriteQueue.empty()) gGlobal->gWriteQueue.pop();
+		pthread_cond_broadcast(&gGlobal->gWriteCond);
+		pthread_mutex_unlock(&gGlobal->gWriteMutex);
+		for (int i = 0; i < nworkers; i++) pthread_join(workers[i], 0);
+#endif
+		throw;
 	}
 
-	cholddir();					// return to current directory
+#ifndef _WIN32
+	pthread_mutex_lock(&gGlobal->gWriteMutex);
+	gGlobal->gWriteDone = true;
+	pthread_cond_broadcast(&gGlobal->gWriteCond);
+	pthread_mutex_unlock(&gGlobal->gWriteMutex);
+	for (int i = 0; i < nworkers; i++) pthread_join(workers[i], 0);
+#endif
+	writeDrawings(gGlobal);		// the remaining ones when there are no workers
+}
+
+/**
+ * The base name of the file where a block diagram is drawn
+ */
+string drawSchemaName(Tree bd)
+{
+	return legalFileName(bd);
 }
 
 
@@ -189,10 +238,10 @@ void drawSchema(Tree bd, const char* projname, const char* dev)
  */
 static void scheduleDrawing(Tree t)
 {
-	if (gDrawnExp.find(t) == gDrawnExp.end()) {
-		gDrawnExp.insert(t);
-		gBackLink.insert(make_pair(t,gSchemaFileName));	// remember the enclosing filename
-		gPendingExp.push(t);
+	if (gGlobal->gDrawnExp.find(t) == gGlobal->gDrawnExp.end()) {
+		gGlobal->gDrawnExp.insert(t);
+		gGlobal->gBackLink.insert(make_pair(t,gGlobal->gSchemaFileName));	// remember the enclosing filename
+		gGlobal->gPendingExp.push(t);
 	}
 }
 
@@ -201,9 +250,9 @@ static void scheduleDrawing(Tree t)
  */
 static bool pendingDrawing(Tree& t)
 {
-	if (gPendingExp.empty()) return false;
-	t = gPendingExp.top();
-	gPendingExp.pop();
+	if (gGlobal->gPendingExp.empty()) return false;
+	t = gGlobal->gPendingExp.top();
+	gGlobal->gPendingExp.pop();
 	return true;
 }
 
@@ -212,7 +261,7 @@ static bool pendingDrawing(Tree& t)
 //------------------------ dealing with files -------------------------
 
 /**
- * Write a top level diagram. A top level diagram
+ * Generate a top level diagram. A top level diagram
  * is decorated with its definition name property
  * and is drawn in an individual file
  */
@@ -222,9 +271,6 @@ static void writeSchemaFile(Tree bd)
 	schema* 		ts;
     int             ins, outs;
 
-	char 			temp[1024];
-
-	gOccurrences = new Occurrences(bd);
     getBoxType (bd, &ins, &outs);
 
 	bool hasname = getDefNameProperty(bd, id); 
@@ -236,21 +282,92 @@ static void writeSchemaFile(Tree bd)
 	}
 
 	// generate legal file name for the schema
-	stringstream s1; s1 << legalFileName(bd, 1024, temp) << "." << gDevSuffix;
-	gSchemaFileName = s1.str();
+	stringstream s1; s1 << legalFileName(bd) << "." << gGlobal->gDevSuffix;
+	gGlobal->gSchemaFileName = s1.str();
 
 	// generate the label of the schema
 	stringstream s2; s2 << tree2str(id);
-	string link = gBackLink[bd];
+	string link = gGlobal->gBackLink[bd];
     ts = makeTopSchema(addSchemaOutputs(outs, addSchemaInputs(ins, generateInsideSchema(bd))), 20, s2.str(), link);
+
+	drawing d;
+	d.fFileName = gGlobal->gSchemaDir + "/" + gGlobal->gSchemaFileName;	// the links between the files stay relative
+	d.fSchema = ts;
+	if (strcmp(gGlobal->gDevSuffix, "svg") == 0) {
+		scheduleWriting(d);
+	} else {
+		writeDrawing(d);
+	}
+}
+
+
+//------------------------ writing the files -------------------------
+
+/**
+ * Give a generated schema to the writers
+ */
+static void scheduleWriting(const drawing& d)
+{
+#ifndef _WIN32
+	pthread_mutex_lock(&gGlobal->gWriteMutex);
+	gGlobal->gWriteQueue.push(d);
+	pthread_cond_signal(&gGlobal->gWriteCond);
+	pthread_mutex_unlock(&gGlobal->gWriteMutex);
+#else
+	gGlobal->gWriteQueue.push(d);
+#endif
+}
+
+/**
+ * Writer loop : write the generated schemas until all of them are
+ * generated and written. Only reads the schemas, never the trees. The
+ * argument is the compilation drawing them.
+ */
+static void* writeDrawings(void* arg)
+{
+	drawing d;
+	gGlobal = (global*)arg;		// the devices read its options
+	while (true) {
+#ifndef _WIN32
+		pthread_mutex_lock(&gGlobal->gWriteMutex);
+		while (gGlobal->gWriteQueue.empty() && !gGlobal->gWriteDone) pthread_cond_wait(&gGlobal->gWriteCond, &gGlobal->gWriteMutex);
+		bool empty = gGlobal->gWriteQueue.empty();
+		if (!empty) { d = gGlobal->gWriteQueue.front(); gGlobal->gWriteQueue.pop(); }
+		pthread_mutex_unlock(&gGlobal->gWriteMutex);
+#else
+		bool empty = gGlobal->gWriteQueue.empty();
+		if (!empty) { d = gGlobal->gWriteQueue.front(); gGlobal->gWriteQueue.pop(); }
+#endif
+		if (empty) return 0;
+		writeDrawing(d);
+	}
+}
+
+/**
+ * Place a top level schema and draw it in its file. A svg file
+ * is left untouched when its content doesn't change.
+ */
+static void writeDrawing(const drawing& d)
+{
+	schema* ts = d.fSchema;
+
 	// draw to the device defined by gDevSuffix
-	if (strcmp(gDevSuffix, "svg") == 0) {
-		SVGDev dev(s1.str().c_str(), ts->width(), ts->height());
-		ts->place(0,0, kLeftRight);
-		ts->draw(dev);
-        { collector c; ts->collectTraits(c); c.draw(dev); }
+	if (strcmp(gGlobal->gDevSuffix, "svg") == 0) {
+		string temp = d.fFileName + ".tmp";
+		{
+			SVGDev dev(temp.c_str(), ts->width(), ts->height());
+			ts->place(0,0, kLeftRight);
+			ts->draw(dev);
+			{ collector c; ts->collectTraits(c); c.draw(dev); }
+		}
+		if (sameFileContent(temp, d.fFileName)) {
+			remove(temp.c_str());
+		} else {
+			remove(d.fFileName.c_str());	// needed on windows
+			rename(temp.c_str(), d.fFileName.c_str());
+		}
 	} else {
-		PSDev dev(s1.str().c_str(), ts->width(), ts->height());
+		PSDev dev(d.fFileName.c_str(), ts->width(), ts->height());
 		ts->place(0,0, kLeftRight);
 		ts->draw(dev);
         {
@@ -261,29 +378,115 @@ static void writeSchemaFile(Tree bd)
 	}
 }
 
+/**
+ * True if the two files exist and have the same content
+ */
+static bool sameFileContent(const string& f1, const string& f2)
+{
+	FILE* a = fopen(f1.c_str(), "rb");
+	FILE* b = fopen(f2.c_str(), "rb");
+	bool same = (a != 0) && (b != 0);
+	char ba[4096], bb[4096];
+	while (same) {
+		size_t na = fread(ba, 1, sizeof(ba), a);
+		size_t nb = fread(bb, 1, sizeof(bb), b);
+		same = (na == nb) && (memcmp(ba, bb, na) == 0);
+		if (na < sizeof(ba)) break;
+	}
+	if (a) fclose(a);
+	if (b) fclose(b);
+	return same;
+}
+
 
 /**
  * Transform the definition name property of tree <t> into a
- * legal file name.  The resulting file name is stored in
- * <dst> a table of at least <n> chars. Returns the <dst> pointer
- * for convenience.
+ * legal file name. Other than process, the names are made unique
+ * with a hash of the diagram, so they don't change from one
+ * compilation to the next and unchanged files can be kept.
  */
-static char* legalFileName(Tree t, int n, char* dst)
+static property<string> gFileNameProperty;
+
+static string legalFileName(Tree t)
 {
+	string	name;
 	Tree	id;
-	int 	i=0;
+
+	if (gFileNameProperty.get(t, name)) return name;
+
 	if (getDefNameProperty(t, id)) {
 		const char* 	src = tree2str(id);
-		for (i=0; isalnum(src[i]) && i<16; i++) {
-			dst[i] = src[i];
+		for (int i=0; isalnum(src[i]) && i<16; i++) {
+			name += src[i];
 		}
 	}
-	dst[i] = 0;
-	if (strcmp(dst, "process") != 0) { 
-		// if it is not process add the hex address to make the name unique
-		snprintf(&dst[i], n-i, "-%p", t);
+	if (name != "process") { 
+		// if it is not process add the hash of the diagram to make the name unique
+		unsigned int h = diagramHash(t);
+		char suffix[16];
+		do {
+			snprintf(suffix, sizeof(suffix), "-%08x", h++);
+		} while (gGlobal->gFileNames.count(name + suffix) && (gGlobal->gFileNames[name + suffix] != t));
+		name += suffix;
 	}
-	return dst;
+	gGlobal->gFileNames[name] = t;
+	gFileNameProperty.set(t, name);
+	return name;
+}
+
+/**
+ * A hash of a block diagram that only depends on its content, and not on the
+ * memory addresses of its nodes like the hash keys of the trees
+ */
+static property<unsigned int> gDiagramHashProperty;
+
+static unsigned int stringHash(const char* s, unsigned int h)
+{
+	while (*s) h = (h ^ (unsigned char)(*s++)) * 16777619u;
+	return h;
+}
+
+static unsigned int diagramHash(Tree t)
+{
+	unsigned int	h;
+	Tree			id;
+	prim0	p0;
+	prim1	p1;
+	prim2	p2;
+	prim3	p3;
+	prim4	p4;
+	prim5	p5;
+
+	if (gDiagramHashProperty.get(t, h)) return h;
+
+	// the primitives are pointers to functions, hashed by name
+		 if (isBoxPrim0(t, &p0))	h = stringHash(prim0name(p0), 2166136261u);
+	else if (isBoxPrim1(t, &p1))	h = stringHash(prim1name(p1), 2166136261u);
+	else if (isBoxPrim2(t, &p2))	h = stringHash(prim2name(p2), 2166136261u);
+	else if (isBoxPrim3(t, &p3))	h = stringHash(prim3name(p3), 2166136261u);
+	else if (isBoxPrim4(t, &p4))	h = stringHash(prim4name(p4), 2166136261u);
+	else if (isBoxPrim5(t, &p5))	h = stringHash(prim5name(p5), 2166136261u);
+	else {
+		const Node& n = t->node();
+		h = 2166136261u ^ n.type();
+		if (n.type() == kIntNode) {
+			h = (h ^ (unsigned int)n.getInt()) * 16777619u;
+		} else if (n.type() == kDoubleNode) {
+			stringstream s; s << n.getDouble();
+			h = stringHash(s.str().c_str(), h);
+		} else if (n.type() == kSymNode) {
+			h = stringHash(name(n.getSym()), h);
+		}
+		for (int i = 0; i < t->arity(); i++) {
+			h = (h ^ diagramHash(t->branch(i))) * 16777619u;
+		}
+	}
+	// the definition names are drawn
+	if (getDefNameProperty(t, id)) {
+		h = stringHash(tree2str(id), h * 16777619u);
+	}
+	gDiagramHashProperty.set(t, h);
+	return h;
 }
 
 
@@ -367,13 +570,12 @@ static schema* generateDiagramSchema(Tree t)
 		//cerr << t << "\tNAMED : " << s.str() << endl;
 	}
 
-	if ( sFoldingFlag && /*(gOccurrences->getCount(t) > 0) &&*/
+	if ( gGlobal->sFoldingFlag && /*(gOccurrences->getCount(t) > 0) &&*/
 			(boxComplexity(t) > 2) && getDefNameProperty(t, id)) {
-		char 	temp[1024];
 		getBoxType(t, &ins, &outs);
 		stringstream s, l;
 		s << tree2str(id);
-		l << legalFileName(t,1024,temp) << "." << gDevSuffix;
+		l << legalFileName(t) << "." << gGlobal->gDevSuffix;
 		scheduleDrawing(t);
 		return makeBlockSchema(ins, outs, s.str(), linkcolor, l.str());
 
@@ -468,8 +670,8 @@ static schema* generateInsideSchema(Tree t)
 
 	else {
 
-		fprintf(stderr, "Internal Error, box expression not recognized : "); print(t, stderr); fprintf(stderr, "\n");
-		exit(1);
+		gGlobal->gErrors << "Internal Error, box expression not recognized : "; print(t, gGlobal->gErrors); gGlobal->gErrors << endl;
+		throw faustexception();
 
 	}
 }
@@ -530,20 +732,36 @@ static void UserInterfaceDescription(Tree box, string& d)
              << boxpp(step)<< ')';
     }
     else {
-        cerr << "INTERNAL ERROR : unknow user interface element " << endl;
-        exit(0);
+        gGlobal->gErrors << "INTERNAL ERROR : unknow user interface element " << endl;
+        throw faustexception();
     }
     d = fout.str();
 }
 
 
+/**
+ * The textual representations of the user interface elements are kept,
+ * widgets are usually drawn several times
+ */
+static property<string> gUIDescriptionProperty;
+
+static string UserInterfaceLabel(Tree t)
+{
+    string s;
+    if (!gUIDescriptionProperty.get(t, s)) {
+        UserInterfaceDescription(t, s);
+        gUIDescriptionProperty.set(t, s);
+    }
+    return s;
+}
+
+
 /**
  * Generate a 0->1 block schema for a user interface element
  */
 static schema* 	generateUserInterfaceSchema(Tree t)
 {
-    string s; UserInterfaceDescription(t,s);
-    return makeBlockSchema(0, 1, s, uicolor, "");
+    return makeBlockSchema(0, 1, UserInterfaceLabel(t), uicolor, "");
 }
 
 
@@ -552,8 +770,7 @@ static schema* 	generateUserInterfaceSchema(Tree t)
  */
 static schema* generateBargraphSchema(Tree t)
 {
-    string s; UserInterfaceDescription(t,s);
-    return makeBlockSchema(1, 1, s, uicolor, "");
+    return makeBlockSchema(1, 1, UserInterfaceLabel(t), uicolor, "");
 }
 
 
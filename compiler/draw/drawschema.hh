@@ -22,8 +22,20 @@
 #ifndef __DRAWSCHEMA__
 #define __DRAWSCHEMA__
  
+#include <string>
 #include "boxes.hh"
 
+class schema;
+
+// a top level schema, generated and waiting to be written in its file
+struct drawing
+{
+	std::string		fFileName;
+	schema*			fSchema;
+};
+
 void drawSchema(Tree bd, const char* projname, const char* dev);
 
+std::string drawSchemaName(Tree bd);	///< the base name of the file where bd is drawn
+
 #endif
@@ -24,6 +24,7 @@
 #include <iostream>
 #include <assert.h>
 #include <cstdlib>
+#include "exception.hh"
 
 using namespace std;
 
@@ -72,7 +73,7 @@ point topSchema::inputPoint(unsigned int i) const
 {
 	assert (placed());
 	assert (i < inputs());
-	exit(1);
+	throw faustexception();
 }
 
 /**
@@ -82,7 +83,7 @@ point topSchema::outputPoint(unsigned int i) const
 {
 	assert (placed());
 	assert (i < outputs());
-	exit(1);
+	throw faustexception();
 }
 
 /**
@@ -35,6 +35,8 @@
 #include "xtended.hh"
 
 #include "sigToGraph.hh"
+#include "exception.hh"
+#include "global.hh"
 
 using namespace std;
 
@@ -201,6 +203,7 @@ static string sigLabel(Tree sig)
 
     else if ( isSigDelay1(sig, x) )                 { fout << "mem";		}
     else if ( isSigFixDelay(sig, x, y) )            { fout << "@";          }
+    else if ( isSigFIR(sig, x) )                    { fout << "fir";        }
     else if ( isSigPrefix(sig, x, y) )              { fout << "prefix";		}
     else if ( isSigIota(sig, x) )                   { fout << "iota";       }
     else if ( isSigBinOp(sig, &i, x, y) )           { fout << binopname[i]; }
@@ -246,8 +249,8 @@ static string sigLabel(Tree sig)
     else if ( isSigAttach(sig, x, y) )              { fout << "attach";		}
 
     else {
-        cerr << "ERROR, unrecognized signal : " << *sig << endl;
-        exit(1);
+        gGlobal->gErrors << "ERROR, unrecognized signal : " << *sig << endl;
+        throw faustexception();
     }
 
     return fout.str();
@@ -24,48 +24,56 @@
 #include "errormsg.hh"
 #include "boxes.hh"
 #include "ppbox.hh"
+#include "exception.hh"
+#include "global.hh"
 #include <iostream>
 using namespace std;
 
-const char* yyfilename = "????";
-int 		gErrorCount = 0;
 Tree 		DEFLINEPROP = tree(symbol("DefLineProp"));
 
 void yyerror(const char* msg) 
 { 
-	fprintf(stderr, "%s:%d:%s\n", yyfilename, yylineno, msg); 
-	gErrorCount++;
+	gGlobal->gErrors << gGlobal->yyfilename << ':' << yylineno << ':' << msg << endl;
+	gGlobal->gErrorCount++;
 }
 
 void evalerror(const char* filename, int linenum, const char* msg, Tree exp)
 {
-    fprintf(stderr, "%s:%d: ERROR: %s ", filename, linenum, msg); 
-    print(exp,stderr); fprintf(stderr, "\n");
-    gErrorCount++;
+    gGlobal->gErrors << filename << ':' << linenum << ": ERROR: " << msg << ' ';
+    print(exp, gGlobal->gErrors); gGlobal->gErrors << endl;
+    gGlobal->gErrorCount++;
 }
 
 void evalerrorbox(const char* filename, int linenum, const char* msg, Tree exp)
 {
-    cerr << filename << ':' << linenum << ": ERROR: " << msg << " : " << boxpp(exp) << endl;
-    gErrorCount++;
+    gGlobal->gErrors << filename << ':' << linenum << ": ERROR: " << msg << " : " << boxpp(exp) << endl;
+    gGlobal->gErrorCount++;
 }
 
 void evalwarning(const char* filename, int linenum, const char* msg, Tree exp)
 {
-	fprintf(stderr, "%s:%d: WARNING: %s ", filename, linenum, msg); 
-	print(exp,stderr); fprintf(stderr, "\n");
+	gGlobal->gErrors << filename << ':' << linenum << ": WARNING: " << msg << ' ';
+	print(exp, gGlobal->gErrors); gGlobal->gErrors << endl;
 }
 
 void evalremark(const char* filename, int linenum, const char* msg, Tree exp)
 {
-	fprintf(stderr, "%s:%d: REMARK: %s ", filename, linenum, msg); 
-	print(exp,stderr); fprintf(stderr, "\n");
+	gGlobal->gErrors << filename << ':' << linenum << ": REMARK: " << msg << ' ';
+	print(exp, gGlobal->gErrors); gGlobal->gErrors << endl;
 }
 
 
+static vector<pair<Tree,int> >* gDefLineRecord = 0;		///< where setDefProp() also records the definitions, if any
+
 void setDefProp(Tree sym, const char* filename, int lineno)
 {
 	setProperty(sym, DEFLINEPROP, cons(tree(filename), tree(lineno)));
+	if (gDefLineRecord) gDefLineRecord->push_back(make_pair(sym, lineno));
+}
+
+void recordDefProps(vector<pair<Tree,int> >* record)
+{
+	gDefLineRecord = record;
 }
 
 
@@ -24,17 +24,18 @@
 #ifndef _ERRORMSG_
 #define _ERRORMSG_
 
+#include <vector>
+#include <utility>
 #include "tlib.hh"
 
 
 extern int 			yylineno;
-extern const char * yyfilename;
-extern int 			gErrorCount;
 
 // associate and retrieve file and line properties to a symbol
 void 		setDefProp(Tree sym, const char* filename, int lineno);
 const char* getDefFileProp(Tree sym);
 int 		getDefLineProp(Tree sym);
+void		recordDefProps(vector<pair<Tree,int> >* record);	// also collect the (sym, lineno) of setDefProp, 0 to stop
 
 // Parsing error
 void 		yyerror(const char* msg);
@@ -0,0 +1,46 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+#ifndef _FAUSTEXCEPTION_
+#define _FAUSTEXCEPTION_
+
+#include <stdexcept>
+#include <string>
+#include <ostream>
+
+/**
+ * Raised instead of exiting when the compilation can't go on. The
+ * diagnostic is written on gGlobal->gErrors before, the exception only carries the
+ * exit status. Caught by main() and by the library entry point
+ * compileFaust() (see libfaust.hh).
+ */
+class faustexception : public std::runtime_error
+{
+    int fStatus;
+
+ public:
+    faustexception(int status = 1, const std::string& msg = "compilation aborted")
+        : std::runtime_error(msg), fStatus(status) {}
+
+    int status() const { return fStatus; }
+};
+
+#endif
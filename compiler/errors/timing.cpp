@@ -5,11 +5,11 @@
 #endif
 #include "compatibility.hh"
 #include "timing.hh"
+#include "exception.hh"
+#include "global.hh"
 
 using namespace std;
 
-extern bool gTimingSwitch;
-
 #if 1
 double mysecond()
 {
@@ -20,10 +20,6 @@ double mysecond()
         return ( (double) tp.tv_sec + (double) tp.tv_usec * 1.e-6 );
 }
 
-int		lIndex=0;
-double 	lStartTime[1024];
-double 	lEndTime[1024];
-
 static void tab (int n, ostream& fout)
 {
         fout << '\n';
@@ -32,19 +28,19 @@ static void tab (int n, ostream& fout)
 
 void startTiming (const char* msg)
 {
-    if (gTimingSwitch) {
-        assert(lIndex < 1023);
-        tab(lIndex, cerr); cerr << "start " << msg << endl;
-        lStartTime[lIndex++] = mysecond();
+    if (gGlobal->gTimingSwitch) {
+        assert(gGlobal->lIndex < 1023);
+        tab(gGlobal->lIndex, gGlobal->gErrors); gGlobal->gErrors << "start " << msg << endl;
+        gGlobal->lStartTime[gGlobal->lIndex++] = mysecond();
     }
 }
 
 void endTiming (const char* msg)
 {
-    if (gTimingSwitch) {
-        assert(lIndex>0);
-        lEndTime[--lIndex] = mysecond();
-        tab(lIndex, cerr); cerr << "end " << msg << " (duration : " << lEndTime[lIndex] - lStartTime[lIndex] << ")" << endl;
+    if (gGlobal->gTimingSwitch) {
+        assert(gGlobal->lIndex>0);
+        gGlobal->lEndTime[--gGlobal->lIndex] = mysecond();
+        tab(gGlobal->lIndex, gGlobal->gErrors); gGlobal->gErrors << "end " << msg << " (duration : " << gGlobal->lEndTime[gGlobal->lIndex] - gGlobal->lStartTime[gGlobal->lIndex] << ")" << endl;
     }
 }
 
@@ -3,6 +3,8 @@
 #include "boxes.hh"
 #include "ppbox.hh"
 #include "names.hh"
+#include "exception.hh"
+#include "global.hh"
 
 
 //-----------------------new environment management----------------------------
@@ -74,10 +76,10 @@ static void addLayerDef(Tree id, Tree def, Tree lenv)
         if (def == olddef) {
             evalwarning(getDefFileProp(id), getDefLineProp(id), "equivalent re-definitions of", id);
         } else {
-            fprintf(stderr, "%s:%d: ERROR: redefinition of symbols are not allowed : ", getDefFileProp(id), getDefLineProp(id));
-            print(id,stderr);
-            fprintf(stderr, " is already defined in file \"%s\" line %d \n", getDefFileProp(id), getDefLineProp(id));
-            gErrorCount++;
+            gGlobal->gErrors << getDefFileProp(id) << ':' << getDefLineProp(id) << ": ERROR: redefinition of symbols are not allowed : ";
+            print(id, gGlobal->gErrors);
+            gGlobal->gErrors << " is already defined in file \"" << getDefFileProp(id) << "\" line " << getDefLineProp(id) << " " << endl;
+            gGlobal->gErrorCount++;
         }
     }
     setProperty(lenv, id, def);
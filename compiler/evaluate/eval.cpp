@@ -43,11 +43,9 @@
 #include "names.hh"
 #include "compatibility.hh"
 #include <assert.h>
+#include "exception.hh"
+#include "global.hh"
 
-extern SourceReader	gReader;
-extern int  gMaxNameSize;
-extern bool	gSimpleNames;
-extern bool gSimplifyDiagrams;
 // History
 // 23/05/2005 : New environment management
 
@@ -97,11 +95,29 @@ static Tree     boxSimplification(Tree box);
  * @param eqlist a list of faust defintions forming the the global environment
  * @return the process block diagram in normal form
  */
+/**
+ * The global environment of a list of definitions. It is built once, so that
+ * the evaluations of the process and of the documentation expressions share
+ * their memoized results.
+ */
+static property<Tree> gGlobalEnvProperty;
+
+static Tree globalEnv (Tree eqlist)
+{
+    Tree env;
+
+    if (!gGlobalEnvProperty.get(eqlist, env)) {
+        env = pushMultiClosureDefs(eqlist, nil, nil);
+        gGlobalEnvProperty.set(eqlist, env);
+    }
+    return env;
+}
+
 Tree evalprocess (Tree eqlist)
 {
-    Tree b = a2sb(eval(boxIdent("process"), nil, pushMultiClosureDefs(eqlist, nil, nil)));
+    Tree b = a2sb(eval(boxIdent("process"), nil, globalEnv(eqlist)));
 
-    if (gSimplifyDiagrams) {
+    if (gGlobal->gSimplifyDiagrams) {
         b = boxSimplification(b);
     }
 
@@ -113,7 +129,7 @@ Tree evalprocess (Tree eqlist)
 
 Tree evaldocexpr (Tree docexpr, Tree eqlist)
 {
-	return a2sb(eval(docexpr, nil, pushMultiClosureDefs(eqlist, nil, nil)));
+	return a2sb(eval(docexpr, nil, globalEnv(eqlist)));
 }
 
 
@@ -149,8 +165,6 @@ static Tree a2sb(Tree exp)
 	return result;
 }
 
-static int	gBoxSlotNumber = 0;		///< counter for unique slot number
-
 static Tree real_a2sb(Tree exp)
 {
 	Tree abstr, visited, unusedEnv, localValEnv, var, name, body;
@@ -169,7 +183,7 @@ static Tree real_a2sb(Tree exp)
 			// Here we have remaining abstraction that we will try to 
 			// transform in a symbolic box by applying it to a slot
 
-			Tree slot = boxSlot(++gBoxSlotNumber); 
+			Tree slot = boxSlot(++gGlobal->gBoxSlotNumber); 
 			stringstream s; s << boxpp(var);
 			setDefNameProperty(slot, s.str() ); // ajout YO
 			
@@ -184,16 +198,16 @@ static Tree real_a2sb(Tree exp)
             return abstr;
 	
 		} else {
-			evalerror(yyfilename, -1, " a2sb : internal error : not an abstraction inside closure ", exp);
-			exit(1);
+			evalerror(gGlobal->yyfilename, -1, " a2sb : internal error : not an abstraction inside closure ", exp);
+			throw faustexception();
 		}
 		
 	} else if (isBoxPatternMatcher(exp)) {
 		// Here we have remaining PM rules that we will try to 
 		// transform in a symbolic box by applying it to a slot
 		
-		Tree slot = boxSlot(++gBoxSlotNumber); 			
-		stringstream s; s << "PM" << gBoxSlotNumber;
+		Tree slot = boxSlot(++gGlobal->gBoxSlotNumber); 			
+		stringstream s; s << "PM" << gGlobal->gBoxSlotNumber;
 		setDefNameProperty(slot, s.str() ); 
 		
 		// apply the PM rules to the slot and transfoms the result in a symbolic box
@@ -247,7 +261,6 @@ bool getArgName(Tree t, Tree& id)
  * @param localValEnv the local environment
  * @return a block diagram in normal form
  */
-static loopDetector LD(1024, 512);
 
 
 static Node EVALPROPERTY(symbol("EvalProperty"));
@@ -283,7 +296,7 @@ static Tree eval (Tree exp, Tree visited, Tree localValEnv)
 	Tree 	result;
 	
     if (!getEvalProperty(exp, localValEnv, result)) {
-        LD.detect(cons(exp,localValEnv));
+        gGlobal->LD.detect(cons(exp,localValEnv));
         //cerr << "ENTER eval("<< *exp << ") with env " << *localValEnv << endl;
 		result = realeval(exp, visited, localValEnv);
 		setEvalProperty(exp, localValEnv, result);
@@ -364,7 +377,7 @@ static Tree realeval (Tree exp, Tree visited, Tree localValEnv)
             return eval(closure(var,notused,visited2,lenv2), visited, localValEnv);
         } else {
             evalerror(getDefFileProp(exp), getDefLineProp(exp), "No environment to access ", exp);
-            exit(1);
+            throw faustexception();
         }
 
 //////////////////////en chantier////////////////////////////
@@ -380,14 +393,14 @@ static Tree realeval (Tree exp, Tree visited, Tree localValEnv)
 
             evalerror(getDefFileProp(exp), getDefLineProp(exp), "not a closure ", val);
             evalerror(getDefFileProp(exp), getDefLineProp(exp), "No environment to access ", exp);
-            exit(1);
+            throw faustexception();
         }
 
 ///////////////////////////////////////////////////////////////////
 
     } else if (isBoxComponent(exp, label)) {
         string  fname   = tree2str(label);
-        Tree    eqlst   = gReader.expandlist(gReader.getlist(fname));
+        Tree    eqlst   = gGlobal->gReader.expandlist(gGlobal->gReader.getlist(fname));
         Tree    res     = closure(boxIdent("process"), nil, nil, pushMultiClosureDefs(eqlst, nil, nil));
         setDefNameProperty(res, label);
         //cerr << "component is " << boxpp(res) << endl;
@@ -395,7 +408,7 @@ static Tree realeval (Tree exp, Tree visited, Tree localValEnv)
 
     } else if (isBoxLibrary(exp, label)) {
         string  fname   = tree2str(label);
-        Tree    eqlst   = gReader.expandlist(gReader.getlist(fname));
+        Tree    eqlst   = gGlobal->gReader.expandlist(gGlobal->gReader.getlist(fname));
         Tree    res     = closure(boxEnvironment(), nil, nil, pushMultiClosureDefs(eqlst, nil, nil));
         setDefNameProperty(res, label);
         //cerr << "component is " << boxpp(res) << endl;
@@ -533,7 +546,7 @@ static Tree realeval (Tree exp, Tree visited, Tree localValEnv)
         if (getBoxType (b, &ins, &outs)) {
             return boxInt(ins);
         } else {
-            cerr << "ERROR : can't evaluate ' : " << *exp << endl;
+            gGlobal->gErrors << "ERROR : can't evaluate ' : " << *exp << endl;
             assert(false);
         }
 
@@ -543,7 +556,7 @@ static Tree realeval (Tree exp, Tree visited, Tree localValEnv)
         if (getBoxType (b, &ins, &outs)) {
             return boxInt(outs);
         } else {
-            cerr << "ERROR : can't evaluate ' : " << *exp << endl;
+            gGlobal->gErrors << "ERROR : can't evaluate ' : " << *exp << endl;
             assert(false);
         }
 
@@ -570,7 +583,7 @@ static Tree realeval (Tree exp, Tree visited, Tree localValEnv)
 		return exp;
 
 	} else {
-		cerr << "ERROR : EVAL don't intercept : " << *exp << endl;
+		gGlobal->gErrors << "ERROR : EVAL don't intercept : " << *exp << endl;
 		assert(false);
 	}
 	return NULL;
@@ -694,7 +707,7 @@ static double eval2double (Tree exp, Tree visited, Tree localValEnv)
 	int numInputs, numOutputs;
 	getBoxType(diagram, &numInputs, &numOutputs);
 	if ( (numInputs > 0) || (numOutputs != 1) ) {
-		evalerror (yyfilename, yylineno, "not a constant expression of type : (0->1)", exp);
+		evalerror (gGlobal->yyfilename, -1, "not a constant expression of type : (0->1)", exp);
 		return 1;
 	} else {
 		Tree lsignals = boxPropagateSig(nil, diagram , makeSigInputList(numInputs) );
@@ -723,7 +736,7 @@ static int eval2int (Tree exp, Tree visited, Tree localValEnv)
 	int numInputs, numOutputs;
 	getBoxType(diagram, &numInputs, &numOutputs);
 	if ( (numInputs > 0) || (numOutputs != 1) ) {
-		evalerror (yyfilename, yylineno, "not a constant expression of type : (0->1)", exp);
+		evalerror (gGlobal->yyfilename, -1, "not a constant expression of type : (0->1)", exp);
 		return 1;
 	} else {
 		Tree lsignals = boxPropagateSig(nil, diagram , makeSigInputList(numInputs) );
@@ -819,8 +832,8 @@ static const char * evalLabel (const char* src, Tree visited, Tree localValEnv)
 
         } else {
 
-            std::cerr << "internal error in evallabel : undefined state " << state << std::endl;
-            exit(1);
+            gGlobal->gErrors << "internal error in evallabel : undefined state " << state << std::endl;
+            throw faustexception();
         }
     }
 
@@ -1043,9 +1056,9 @@ static Tree applyList (Tree fun, Tree larg)
 						boxPatternMatcher(automat, state2, vec2list(envVect), originalRules, cons(hd(larg),revParamList)),
 						tl(larg) );
 		} else if (state2 < 0) {
-			cerr << "ERROR : pattern matching failed, no rule of " << boxpp(boxCase(originalRules)) 
+			gGlobal->gErrors << "ERROR : pattern matching failed, no rule of " << boxpp(boxCase(originalRules)) 
 				 << " matches argument list " << boxpp(reverse(cons(hd(larg), revParamList))) << endl;
-			exit(1);
+			throw faustexception();
 		} else {
 			// Pattern Matching was succesful
 			// the result is a closure that we need to evaluate.
@@ -1054,7 +1067,7 @@ static Tree applyList (Tree fun, Tree larg)
 				//return eval(body, nil, localValEnv);
 				return applyList(eval(body, nil, localValEnv), tl(larg));
 			} else {
-				cerr << "wrong result from pattern matching (not a closure) : " << boxpp(result) << endl;
+				gGlobal->gErrors << "wrong result from pattern matching (not a closure) : " << boxpp(result) << endl;
 				return boxError();
 			}
 		}			
@@ -1081,8 +1094,8 @@ static Tree applyList (Tree fun, Tree larg)
          }
 		
 		if (outs > ins) {
-			cerr << "too much arguments : " << outs << ", instead of : " << ins << endl;
-            cerr << "when applying : " << boxpp(fun) << endl
+			gGlobal->gErrors << "too much arguments : " << outs << ", instead of : " << ins << endl;
+            gGlobal->gErrors << "when applying : " << boxpp(fun) << endl
                  << "           to : " << boxpp(larg) << endl;
 			assert(false);
 		}
@@ -1103,13 +1116,13 @@ static Tree applyList (Tree fun, Tree larg)
 	}
 
     if (isBoxEnvironment(abstr)) {
-        evalerrorbox(yyfilename, -1, "an environment can't be used as a function", fun);
-        exit(1);
+        evalerrorbox(gGlobal->yyfilename, -1, "an environment can't be used as a function", fun);
+        throw faustexception();
     }
 
     if (!isBoxAbstr(abstr, id, body)) {
-        evalerror(yyfilename, -1, "(internal) not an abstraction inside closure", fun);
-        exit(1);
+        evalerror(gGlobal->yyfilename, -1, "(internal) not an abstraction inside closure", fun);
+        throw faustexception();
     }
 
 	// try to synthetise a  name from the function name and the argument name
@@ -1120,7 +1133,7 @@ static Tree applyList (Tree fun, Tree larg)
 
 		Tree	fname;
 		if (getDefNameProperty(fun, fname)) {
-			stringstream s; s << tree2str(fname); if (!gSimpleNames) s << "(" << boxpp(arg) << ")";
+			stringstream s; s << tree2str(fname); if (!gGlobal->gSimpleNames) s << "(" << boxpp(arg) << ")";
 			setDefNameProperty(f, s.str());
 		}
 		return applyList(f, tl(larg));
@@ -1165,8 +1178,8 @@ static Tree revEvalList (Tree lexp, Tree visited, Tree localValEnv)
 static Tree larg2par (Tree larg)
 {
 	if (isNil(larg)) {
-		evalerror(yyfilename, -1, "empty list of arguments", larg);
-		exit(1);
+		evalerror(gGlobal->yyfilename, -1, "empty list of arguments", larg);
+		throw faustexception();
 	}
 	if (isNil(tl(larg))) {
 		return hd(larg);
@@ -1198,9 +1211,9 @@ static Tree evalIdDef(Tree id, Tree visited, Tree lenv)
 
 	// check that the definition exists
 	if (isNil(lenv)) {
-        cerr << "undefined symbol " << *id << endl;
+        gGlobal->gErrors << "undefined symbol " << *id << endl;
 		evalerror(getDefFileProp(id), getDefLineProp(id), "undefined symbol ", id);
-		exit(1);
+		throw faustexception();
 	}
 
     //cerr << "Id definition is " << *def << endl;
@@ -1380,7 +1393,7 @@ Tree numericBoxSimplification(Tree box)
 
     if ( ! getBoxType(box, &ins, &outs)) {
         cout << "ERROR in file " << __FILE__ << ':' << __LINE__ << ", Can't compute the box type of : " << *box << endl;
-        exit(1);
+        throw faustexception();
     }
 
     if (ins==0 && outs==1) {
@@ -1579,6 +1592,6 @@ Tree insideBoxSimplification (Tree box)
     }
 
     cout << "ERROR in file " << __FILE__ << ':' << __LINE__ << ", unrecognised box expression : " << *box << endl;
-    exit(1);
+    throw faustexception();
     return 0;
 }
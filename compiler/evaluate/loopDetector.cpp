@@ -1,5 +1,7 @@
 #include "loopDetector.hh"
 #include "ppbox.hh"
+#include "exception.hh"
+#include "global.hh"
 
 bool loopDetector::detect(Tree t)
 {
@@ -14,13 +16,13 @@ bool loopDetector::detect(Tree t)
             assert(r<fBuffersize);
             assert(r != w);
             if (fBuffer[r] == t) {
-                cerr 	<< "ERROR : after "
+                gGlobal->gErrors 	<< "ERROR : after "
                         << fPhase
                         << " evaluation steps, the compiler has detected an endless evaluation cycle of "
                         << i
                         << " steps"
                         << endl;
-                exit(1);
+                throw faustexception();
             }
         }
     }
@@ -42,6 +42,9 @@ class CosPrim : public xtended
 		assert (args.size() == arity());
 		assert (types.size() == arity());
 		
+        if (useFastMath(types)) {
+            return fastMathCall(klass, string("cos") + trigVariant(types[0]), args);
+        }
         return subst("cos$1($0)", args[0], isuffix());
 	}
 	
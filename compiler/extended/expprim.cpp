@@ -44,6 +44,10 @@ class ExpPrim : public xtended
 		assert (args.size() == arity());
 		assert (types.size() == arity());
         
+        if (useFastMath(types)) {
+            // no saturation needed when the argument is in the single precision range
+            return fastMathCall(klass, isInInterval(types[0], -87, 88) ? "exp_b" : "exp", args);
+        }
 		return subst("exp$1($0)", args[0], isuffix());
 	}
 	
@@ -50,6 +50,9 @@ class Log10Prim : public xtended
 		assert (args.size() == arity());
 		assert (types.size() == arity());
         
+        if (useFastMath(types)) {
+            return fastMathCall(klass, "log10", args);
+        }
 		return subst("log10$1($0)", args[0], isuffix());
 	}
 	
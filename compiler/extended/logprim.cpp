@@ -49,6 +49,9 @@ class LogPrim : public xtended
 		assert (args.size() == arity());
 		assert (types.size() == arity());
         
+        if (useFastMath(types)) {
+            return fastMathCall(klass, "log", args);
+        }
 		return subst("log$1($0)", args[0], isuffix());
 	}
 	
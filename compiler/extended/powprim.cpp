@@ -1,6 +1,7 @@
 #include "xtended.hh"
 #include "Text.hh"
 #include <math.h>
+#include <float.h>
 
 #include "floats.hh"
 
@@ -53,6 +54,9 @@ class PowPrim : public xtended
         if ((types[1]->nature() == kInt) && (types[1]->variability() == kKonst) && (types[1]->computability() == kComp)) {
             klass->rememberNeedPowerDef();
             return subst("faustpower<$1>($0)", args[0], args[1]);
+        } else if (useFastMath(types) && isInInterval(types[0], FLT_MIN, HUGE_VAL)) {
+            // exp(y*log(x)), only valid for positive normal numbers
+            return fastMathCall(klass, "pow", args);
         } else {
             return subst("pow$2($0,$1)", args[0], args[1], isuffix());
         }
@@ -42,6 +42,9 @@ class SinPrim : public xtended
 		assert (args.size() == arity());
 		assert (types.size() == arity());
 		
+        if (useFastMath(types)) {
+            return fastMathCall(klass, string("sin") + trigVariant(types[0]), args);
+        }
         return subst("sin$1($0)", args[0], isuffix());
 	}
 	
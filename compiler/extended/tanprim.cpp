@@ -42,6 +42,9 @@ class TanPrim : public xtended
 		assert (args.size() == arity());
 		assert (types.size() == arity());
 		
+        if (useFastMath(types)) {
+            return fastMathCall(klass, string("tan") + trigVariant(types[0]), args);
+        }
         return subst("tan$1($0)", args[0], isuffix());
 	}
 	
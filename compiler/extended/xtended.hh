@@ -7,7 +7,11 @@
 #include "klass.hh"
 #include "sigvisitor.hh"
 #include <vector>
+#include <math.h>
 #include "lateq.hh"
+#include "Text.hh"
+#include "floats.hh"
+#include "global.hh"
 
 class xtended 
 {
@@ -42,6 +46,51 @@ class xtended
     virtual bool    isSpecialInfix()    { return false; }   ///< generaly false, but true for binary op # such that #(x) == _#x
 };
 
+// -- Fast approximations of the mathematical functions (-fm option), see faust/audio/fastmath.h
+
+/**
+ * The approximations are only used for the computations done at the sample
+ * rate : the block-rate and init-time ones are cheap with the math.h
+ * functions, and their results are often rounded to integers (delay lengths)
+ */
+inline bool useFastMath(const vector<Type>& types)
+{
+    if (gGlobal->gFastMath == 0 || gGlobal->gFloatSize == 3) return false;
+    for (unsigned int i = 0; i < types.size(); i++) {
+        if (types[i]->variability() == kSamp) return true;
+    }
+    return false;
+}
+
+/**
+ * True if the values of a signal of type t are known to be in [lo, hi]
+ */
+inline bool isInInterval(const Type& t, double lo, double hi)
+{
+    interval i = t->getInterval();
+    return i.valid && i.lo >= lo && i.hi <= hi;
+}
+
+/**
+ * The variant of sin, cos and tan that the interval of the argument allows :
+ * no range reduction, integer range reduction, or floor range reduction
+ */
+inline const char* trigVariant(const Type& t)
+{
+    return isInInterval(t, -M_PI/4, M_PI/4) ? "_s" : (isInInterval(t, -1e9, 1e9) ? "_b" : "");
+}
+
+inline string fastMathCall(Klass* klass, const string& fun, const vector<string>& args)
+{
+    klass->addIncludeFile("\"faust/audio/fastmath.h\"");
+    string call = subst("faustfast$0<$1,$2>(", fun, T(gGlobal->gFastMath), ifloat());
+    for (unsigned int i = 0; i < args.size(); i++) {
+        if (i > 0) call += ", ";
+        call += args[i];
+    }
+    return call + ")";
+}
+
 // -- Trigonometric Functions
 
 extern xtended* gAcosPrim;
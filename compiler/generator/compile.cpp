@@ -47,6 +47,8 @@ Compile a list of FAUST signals into a C++ class .
 #include "sigtyperules.hh"
 #include "simplify.hh"
 #include "privatise.hh"
+#include "exception.hh"
+#include "global.hh"
 
 /*****************************************************************************
 ******************************************************************************
@@ -56,10 +58,6 @@ Compile a list of FAUST signals into a C++ class .
 ******************************************************************************
 *****************************************************************************/
 
-extern int 		gDetailsSwitch;
-extern string 	gMasterName;
-extern map<Tree, set<Tree> > gMetaDataSet;
-
 /*****************************************************************************
 ******************************************************************************
 
@@ -138,7 +136,7 @@ static string wdel(const string& s)
 void Compiler::generateMetaData()
 {
     // Add global metadata
-    for (map<Tree, set<Tree> >::iterator i = gMetaDataSet.begin(); i != gMetaDataSet.end(); i++) {
+    for (map<Tree, set<Tree> >::iterator i = gGlobal->gMetaDataSet.begin(); i != gGlobal->gMetaDataSet.end(); i++) {
         if (i->first != tree("author")) {
             stringstream str1, str2;
             str1 << *(i->first);
@@ -198,8 +196,8 @@ void Compiler::generateUserInterfaceTree(Tree t)
 			case 1 : model = "interface->openHorizontalBox(\"$0\");"; fJSON.openHorizontalBox(checkNullLabel(t, simplifiedLabel).c_str()); break;
 			case 2 : model = "interface->openTabBox(\"$0\");"; fJSON.openTabBox(checkNullLabel(t, simplifiedLabel).c_str()); break;
 			default :
-                fprintf(stderr, "error in user interface generation 1\n");
-				exit(1);
+                gGlobal->gErrors << "error in user interface generation 1" << endl;
+				throw faustexception();
 		}
         fClass->addUICode(subst(model, checkNullLabel(t, simplifiedLabel)));
 		generateUserInterfaceElements(elements);
@@ -212,8 +210,8 @@ void Compiler::generateUserInterfaceTree(Tree t)
 
 	} else {
 
-		fprintf(stderr, "error in user interface generation 2\n");
-		exit(1);
+		gGlobal->gErrors << "error in user interface generation 2" << endl;
+		throw faustexception();
 
 	}
 }
@@ -313,8 +311,8 @@ void Compiler::generateWidgetCode(Tree fulllabel, Tree varname, Tree sig)
         fJSON.addHorizontalBargraph(checkNullLabel(varname, label).c_str(), NULL, tree2float(x), tree2float(y));
         
 	} else {
-		fprintf(stderr, "Error in generating widget code\n");
-		exit(1);
+		gGlobal->gErrors << "Error in generating widget code" << endl;
+		throw faustexception();
 	}
 }
 
@@ -341,8 +339,8 @@ void Compiler::generateMacroInterfaceTree(const string& pathname, Tree t)
 
 	} else {
 
-		fprintf(stderr, "error in user interface macro generation 2\n");
-		exit(1);
+		gGlobal->gErrors << "error in user interface macro generation 2" << endl;
+		throw faustexception();
 
 	}
 }
@@ -422,7 +420,7 @@ void Compiler::generateWidgetMacro(const string& pathname, Tree fulllabel, Tree
 				T(tree2float(y))));
 
 	} else {
-		fprintf(stderr, "Error in generating widget code\n");
-		exit(1);
+		gGlobal->gErrors << "Error in generating widget code" << endl;
+		throw faustexception();
 	}
 }
@@ -37,6 +37,7 @@
 #include <sstream>
 #include <vector>
 #include <math.h>
+#include <string.h>
 
 #include "floats.hh"
 #include "sigprint.hh"
@@ -44,23 +45,20 @@
 #include "recursivness.hh"
 #include "simplify.hh"
 #include "privatise.hh"
+#include "firrecognition.hh"
+#include "sigeval.hh"
+#include "sigprecision.hh"
 #include "prim2.hh"
 #include "xtended.hh"
 
 #include "compatibility.hh"
 #include "ppsig.hh"
 #include "sigToGraph.hh"
+#include "exception.hh"
+#include "global.hh"
 
 using namespace std;
 
-extern bool     gInPlace;
-extern bool     gDrawSignals;
-extern bool     gPrintJSONSwitch;
-extern bool     gDrawSignals;
-extern int      gMaxCopyDelay;
-extern string   gClassName;
-extern string   gMasterDocument;
-
 string makeDrawPath();
 
 static Klass* signal2klass (Klass* parent, const string& name, Tree sig)
@@ -86,15 +84,13 @@ static Klass* signal2klass (Klass* parent, const string& name, Tree sig)
 						getFreshID
 *****************************************************************************/
 
-map<string, int>	ScalarCompiler::fIDCounters;
-
 string ScalarCompiler::getFreshID(const string& prefix)
 {
-	if (fIDCounters.find(prefix) == fIDCounters.end()) {
-		fIDCounters[prefix]=0;
+	if (gGlobal->gIDCounters.find(prefix) == gGlobal->gIDCounters.end()) {
+		gGlobal->gIDCounters[prefix]=0;
 	}
-	int n = fIDCounters[prefix];
-	fIDCounters[prefix] = n+1;
+	int n = gGlobal->gIDCounters[prefix];
+	gGlobal->gIDCounters[prefix] = n+1;
 	return subst("$0$1", prefix, T(n));
 }
 
@@ -103,8 +99,6 @@ string ScalarCompiler::getFreshID(const string& prefix)
 						    prepare
 *****************************************************************************/
 
-extern bool gDumpNorm;
-
 Tree ScalarCompiler::prepare(Tree LS)
 {
 startTiming("ScalarCompiler::prepare");
@@ -114,10 +108,14 @@ startTiming("ScalarCompiler::prepare");
 	Tree L2 = simplify(L1);			// simplify by executing every computable operation
 	Tree L3 = privatise(L2);		// Un-share tables with multiple writers
 
+	if (gGlobal->gFIRMinTaps > 0) {
+		L3 = firRecognition(L3, gGlobal->gFIRMinTaps);	// Compile long constant-coefficient sums as FIR filters
+	}
+
 	// dump normal form
-	if (gDumpNorm) {
+	if (gGlobal->gDumpNorm) {
 		cout << ppsig(L3) << endl;
-		exit(0);
+		throw faustexception(0);
 	}
 
 	recursivnessAnnotation(L3);		// Annotate L3 with recursivness information
@@ -126,12 +124,11 @@ startTiming("ScalarCompiler::prepare");
         typeAnnotation(L3);				// Annotate L3 with type information
     endTiming("typeAnnotation");
 
-    sharingAnalysis(L3);			// annotate L3 with sharing count
-  	fOccMarkup.mark(L3);			// annotate L3 with occurences analysis
-    //annotationStatistics();
+    sharingAnalysis(L3);			// annotate L3 with sharing count and occurences analysis
+    if (gGlobal->gTimingSwitch) annotationStatistics();
 endTiming("ScalarCompiler::prepare");
 
-    if (gDrawSignals) {
+    if (gGlobal->gDrawSignals) {
         ofstream dotfile(subst("$0-sig.dot", makeDrawPath()).c_str());
         sigToGraph(L3, dotfile);
     }
@@ -144,8 +141,7 @@ Tree ScalarCompiler::prepare2(Tree L0)
 startTiming("ScalarCompiler::prepare2");
 	recursivnessAnnotation(L0);		// Annotate L0 with recursivness information
 	typeAnnotation(L0);				// Annotate L0 with type information
-	sharingAnalysis(L0);			// annotate L0 with sharing count
- 	fOccMarkup.mark(L0);			// annotate L0 with occurences analysis
+	sharingAnalysis(L0);			// annotate L0 with sharing count and occurences analysis
 endTiming("ScalarCompiler::prepare2");
 
   	return L0;
@@ -162,7 +158,7 @@ void ScalarCompiler::compileMultiSignal (Tree L)
 
     for (int i = 0; i < fClass->inputs(); i++) {
         fClass->addZone3(subst("$1* input$0 = input[$0];", T(i), xfloat()));
-        if (gInPlace) {
+        if (gGlobal->gInPlace) {
         	CS(sigInput(i));
         }
     }
@@ -182,7 +178,7 @@ void ScalarCompiler::compileMultiSignal (Tree L)
 		fDescription->ui(prepareUserInterfaceTree(fUIRoot));
 	}
     
-    if (gPrintJSONSwitch) {
+    if (gGlobal->gPrintJSONSwitch) {
         ofstream xout(subst("$0.json", makeDrawPath()).c_str());
         xout << fJSON.JSON();
     } 
@@ -231,8 +227,8 @@ string ScalarCompiler::setCompiledExpression(Tree sig, const string& cexp)
 {
     //cerr << "ScalarCompiler::setCompiledExpression : " << cexp << " ==> " << ppsig(sig) << endl;
     string old; if (fCompileProperty.get(sig, old) && (old != cexp)) {
-        cerr << "ERROR already a compiled expression attached : " << old << " replaced by " << cexp << endl;
-        exit(1);
+        gGlobal->gErrors << "ERROR already a compiled expression attached : " << old << " replaced by " << cexp << endl;
+        throw faustexception();
     }
     fCompileProperty.set(sig, cexp);
 	return cexp;
@@ -290,6 +286,7 @@ string	ScalarCompiler::generateCode (Tree sig)
 	else if ( isSigOutput(sig, &i, x) ) 			{ return generateOutput 	(sig, T(i), CS(x));}
 
 	else if ( isSigFixDelay(sig, x, y) ) 			{ return generateFixDelay 	(sig, x, y); 			}
+	else if ( isSigFIR(sig, x) ) 					{ return generateFIR 		(sig, x); 				}
 	else if ( isSigPrefix(sig, x, y) ) 				{ return generatePrefix 	(sig, x, y); 			}
 	else if ( isSigIota(sig, x) ) 					{ return generateIota 		(sig, x); 				}
 
@@ -326,7 +323,7 @@ string	ScalarCompiler::generateCode (Tree sig)
 		printf("Error in compiling signal, unrecognized signal : ");
 		print(sig);
 		printf("\n");
-		exit(1);
+		throw faustexception();
 	}
 	return "error in generate code";
 }
@@ -389,7 +386,7 @@ string ScalarCompiler::generateFVar (Tree sig, const string& file, const string&
 
 string ScalarCompiler::generateInput (Tree sig, const string& idx)
 {
-    if (gInPlace) {
+    if (gGlobal->gInPlace) {
         // inputs must be cached for in-place transformations
         return forceCacheCode(sig, subst("$1input$0[i]", idx, icast()));
     } else {
@@ -410,6 +407,23 @@ string ScalarCompiler::generateOutput (Tree sig, const string& idx, const string
 							   BINARY OPERATION
 *****************************************************************************/
 
+/**
+ * The code of an operand of sig. With -mp, the real constants of the
+ * computations in double precision are written in double precision.
+ */
+string ScalarCompiler::CSOperand(Tree sig, Tree arg)
+{
+    double r;
+    if (isSigReal(arg, &r) && isDoublePrecision(sig)) {
+        int floatSize = gGlobal->gFloatSize;
+        gGlobal->gFloatSize = 2;
+        string code = T(r);
+        gGlobal->gFloatSize = floatSize;
+        return code;
+    }
+    return CS(arg);
+}
+
 string ScalarCompiler::generateBinOp(Tree sig, int opcode, Tree arg1, Tree arg2)
 {
     if (opcode == kDiv) {
@@ -418,16 +432,16 @@ string ScalarCompiler::generateBinOp(Tree sig, int opcode, Tree arg1, Tree arg2)
         Type        t2 = getCertifiedSigType(arg2);
 
         if (t1->nature()==kInt && t2->nature()==kInt ) {
-            return generateCacheCode(sig, subst("($3($0) $1 $3($2))", CS(arg1), gBinOpTable[opcode]->fName, CS(arg2), ifloat()));
+            return generateCacheCode(sig, subst("($3($0) $1 $3($2))", CSOperand(sig, arg1), gBinOpTable[opcode]->fName, CSOperand(sig, arg2), ifloat()));
         } else if (t1->nature()==kInt && t2->nature()==kReal ) {
-            return generateCacheCode(sig, subst("($3($0) $1 $2)", CS(arg1), gBinOpTable[opcode]->fName, CS(arg2), ifloat()));
+            return generateCacheCode(sig, subst("($3($0) $1 $2)", CSOperand(sig, arg1), gBinOpTable[opcode]->fName, CSOperand(sig, arg2), ifloat()));
         } else if (t1->nature()==kReal && t2->nature()==kInt ) {
-            return generateCacheCode(sig, subst("($0 $1 $3($2))", CS(arg1), gBinOpTable[opcode]->fName, CS(arg2), ifloat()));
+            return generateCacheCode(sig, subst("($0 $1 $3($2))", CSOperand(sig, arg1), gBinOpTable[opcode]->fName, CSOperand(sig, arg2), ifloat()));
         } else  {
-            return generateCacheCode(sig, subst("($0 $1 $2)", CS(arg1), gBinOpTable[opcode]->fName, CS(arg2), ifloat()));
+            return generateCacheCode(sig, subst("($0 $1 $2)", CSOperand(sig, arg1), gBinOpTable[opcode]->fName, CSOperand(sig, arg2), ifloat()));
         }
     } else {
-        return generateCacheCode(sig, subst("($0 $1 $2)", CS(arg1), gBinOpTable[opcode]->fName, CS(arg2)));
+        return generateCacheCode(sig, subst("($0 $1 $2)", CSOperand(sig, arg1), gBinOpTable[opcode]->fName, CSOperand(sig, arg2)));
     }
 }
 
@@ -497,8 +511,8 @@ string ScalarCompiler::generateCacheCode(Tree sig, const string& exp)
         return generateVariableStore(sig, exp);
 
 	} else {
-        cerr << "Error in sharing count (" << sharing << ") for " << *sig << endl;
-		exit(1);
+        gGlobal->gErrors << "Error in sharing count (" << sharing << ") for " << *sig << endl;
+		throw faustexception();
 	}
 
 	return "Error in generateCacheCode";
@@ -539,6 +553,7 @@ string ScalarCompiler::generateVariableStore(Tree sig, const string& exp)
         case kKonst :
 
             getTypedNames(t, "Const", ctype, vname);
+            if (isDoublePrecision(sig)) ctype = "double";
             fClass->addDeclCode(subst("$0 \t$1;", ctype, vname));
             fClass->addInitCode(subst("$0 = $1;", vname, exp));
             break;
@@ -546,6 +561,7 @@ string ScalarCompiler::generateVariableStore(Tree sig, const string& exp)
         case kBlock :
 
             getTypedNames(t, "Slow", ctype, vname);
+            if (isDoublePrecision(sig)) ctype = "double";
             fClass->addFirstPrivateDecl(vname);
             fClass->addZone2(subst("$0 \t$1 = $2;", ctype, vname, exp));
             break;
@@ -553,6 +569,7 @@ string ScalarCompiler::generateVariableStore(Tree sig, const string& exp)
         case kSamp :
 
             getTypedNames(t, "Temp", ctype, vname);
+            if (isDoublePrecision(sig)) ctype = "double";
             fClass->addExecCode(subst("$0 $1 = $2;", ctype, vname, exp));
             break;
     }
@@ -572,7 +589,7 @@ string ScalarCompiler::generateIntCast(Tree sig, Tree x)
 
 string ScalarCompiler::generateFloatCast (Tree sig, Tree x)
 {
-	return generateCacheCode(sig, subst("$1($0)", CS(x), ifloat()));
+	return generateCacheCode(sig, subst("$1($0)", CS(x), isDoublePrecision(sig) ? "double" : ifloat()));
 }
 
 /*****************************************************************************
@@ -708,7 +725,7 @@ string ScalarCompiler::generateSigGen(Tree sig, Tree content)
 	string signame = getFreshID("sig");
 
     fClass->addSubKlass(signal2klass(fClass, klassname, content));
-	fClass->addInitCode(subst("$0 $1;", klassname, signame));
+	fClass->addStateInitCode(subst("$0 $1;", klassname, signame));
     fInstanceInitProperty.set(content, pair<string,string>(klassname,signame));
 
 	return signame;
@@ -733,30 +750,44 @@ string ScalarCompiler::generateStaticSigGen(Tree sig, Tree content)
 
 string ScalarCompiler::generateTable(Tree sig, Tree tsize, Tree content)
 {
-	string 		generator(CS(content));
     Tree		g;
     string 		cexp;
     string		ctype, vname;
 	int 		size;
+	string		data;
+
+    assert ( isSigGen(content, g) );
+
+	// content computed at compile time : the table is initialized by copy
+	if (isSigInt(tsize, &size) && getConstTableData(content, size, data)) {
+		generateTableName(content, ctype, vname);
+		string dname = subst("$0Init", vname);
+		fClass->addDeclCode(subst("$0 \t$1[$2];", ctype, vname, T(size)));
+		fClass->addDeclCode(subst("static const $0 \t$1[$2];", ctype, dname, T(size)));
+		fClass->getTopParentKlass()->addStaticFields(subst("const $0 \t$1::$2[$3] = $4;", ctype, fClass->getFullClassName(), dname, T(size), data));
+		fClass->addStateInitCode(subst("for (int i=0; i<$0; i++) $1[i] = $2[i];", T(size), vname, dname));
+		return vname;
+	}
+
+	string 		generator(CS(content));
 
     // already compiled but check if we need to add declarations
 
-    assert ( isSigGen(content, g) );
     pair<string,string> kvnames;
     if ( ! fInstanceInitProperty.get(g, kvnames)) {
         // not declared here, we add a declaration
         bool b = fStaticInitProperty.get(g, kvnames);
         assert(b);
-        fClass->addInitCode(subst("$0 $1;", kvnames.first, kvnames.second));
+        fClass->addStateInitCode(subst("$0 $1;", kvnames.first, kvnames.second));
     }
 
 	if (!isSigInt(tsize, &size)) {
 		//fprintf(stderr, "error in ScalarCompiler::generateTable()\n"); exit(1);
-		cerr << "error in ScalarCompiler::generateTable() : "
+		gGlobal->gErrors << "error in ScalarCompiler::generateTable() : "
 			 << *tsize
              << " is not a constant integer table size expression "
 			 << endl;
-        exit(1);
+        throw faustexception();
 	}
 	// definition du nom et du type de la table
 	// A REVOIR !!!!!!!!!
@@ -774,8 +805,9 @@ string ScalarCompiler::generateTable(Tree sig, Tree tsize, Tree content)
 
 	// initialisation du generateur de contenu
 	fClass->addInitCode(subst("$0.init(samplingFreq);", generator));
+	fClass->addResetCode(subst("$0.init(fSamplingFreq);", generator));
 	// remplissage de la table
-	fClass->addInitCode(subst("$0.fill($1,$2);", generator, T(size), vname));
+	fClass->addStateInitCode(subst("$0.fill($1,$2);", generator, T(size), vname));
 
 	// on retourne le nom de la table
 	return vname;
@@ -788,9 +820,18 @@ string ScalarCompiler::generateStaticTable(Tree sig, Tree tsize, Tree content)
 	string 		cexp;
 	string		ctype, vname;
 	int 		size;
+	string		data;
 
 	assert ( isSigGen(content, g) );
 
+	// content computed at compile time : the table is literal data
+	if (isSigInt(tsize, &size) && getConstTableData(content, size, data)) {
+		generateTableName(content, ctype, vname);
+		fClass->addDeclCode(subst("static const $0 \t$1[$2];", ctype, vname, T(size)));
+		fClass->getTopParentKlass()->addStaticFields(subst("const $0 \t$1::$2[$3] = $4;", ctype, fClass->getFullClassName(), vname, T(size), data));
+		return vname;
+	}
+
 	if (!getCompiledExpression(content, cexp)) {
 		cexp = setCompiledExpression(content, generateStaticSigGen(content, g));
     } else {
@@ -806,11 +847,11 @@ string ScalarCompiler::generateStaticTable(Tree sig, Tree tsize, Tree content)
 
     if (!isSigInt(tsize, &size)) {
 		//fprintf(stderr, "error in ScalarCompiler::generateTable()\n"); exit(1);
-		cerr << "error in ScalarCompiler::generateTable() : "
+		gGlobal->gErrors << "error in ScalarCompiler::generateTable() : "
 			 << *tsize
              << " is not a constant integer table size expression "
 			 << endl;
-        exit(1);
+        throw faustexception();
 	}
 	// definition du nom et du type de la table
 	// A REVOIR !!!!!!!!!
@@ -837,6 +878,70 @@ string ScalarCompiler::generateStaticTable(Tree sig, Tree tsize, Tree content)
 }
 
 
+/*----------------------------------------------------------------------------
+				constant tables computed at compile time
+----------------------------------------------------------------------------*/
+
+static string tableValue(double v);
+
+/**
+ * The C type and a fresh name for a table of the given content
+ */
+void ScalarCompiler::generateTableName(Tree content, string& ctype, string& vname)
+{
+	if (getCertifiedSigType(content)->nature() == kInt) {
+		vname = getFreshID("itbl");
+		ctype = "int";
+	} else {
+		vname = getFreshID("ftbl");
+		ctype = ifloat();
+	}
+}
+
+/**
+ * The initializer of a table of the given size, when -ct is used and the
+ * content can be computed at compile time (it doesn't depend on the inputs,
+ * the user interface or the sampling rate)
+ */
+bool ScalarCompiler::getConstTableData(Tree content, int size, string& data)
+{
+	Tree			g;
+	vector<double>	values;
+
+	if (size <= 0 || size > gGlobal->gConstTableSize
+		|| !isSigGen(content, g) || !evalSignal(g, size, values)) {
+		return false;
+	}
+
+	bool isint = getCertifiedSigType(content)->nature() == kInt;
+	data = "{\n\t";
+	for (int i = 0; i < size; i++) {
+		if (i > 0) data += (i % 8 == 0) ? ",\n\t" : ", ";
+		data += (isint) ? T(int(values[i])) : tableValue(values[i]);
+	}
+	data += "}";
+	return true;
+}
+
+/**
+ * Like T(double) but only as precise as the floats of the generated code,
+ * as the values of large tables are mostly not exact in a few digits
+ */
+static string tableValue(double v)
+{
+	char	c[512];
+	int		p = (gGlobal->gFloatSize == 1) ? 6 : 15;
+
+	if (gGlobal->gFloatSize == 1) {
+		do { snprintf(c, sizeof(c), "%.*g", p++, v); } while (float(atof(c)) != float(v));
+	} else {
+		do { snprintf(c, sizeof(c), "%.*g", p++, v); } while (atof(c) != v);
+	}
+	if (!strpbrk(c, ".e")) strcat(c, ".0");
+	return string(c) + inumix();
+}
+
+
 /*----------------------------------------------------------------------------
 						sigWRTable : table assignement
 ----------------------------------------------------------------------------*/
@@ -909,6 +1014,7 @@ void ScalarCompiler::generateRec(Tree sig, Tree var, Tree le)
     vector<int>     delay(N);
     vector<string>  vname(N);
     vector<string>  ctype(N);
+    vector<bool>    promoted(N, false);
 
     // prepare each element of a recursive definition
     for (int i=0; i<N; i++) {
@@ -926,12 +1032,45 @@ void ScalarCompiler::generateRec(Tree sig, Tree var, Tree le)
         }
     }
 
+    // with -mp, the short state of the recursions whose feedback gain may be
+    // close to 1 is kept in double precision, as the computations depending on it
+    int     npromoted = 0;
+    double  g = 0;
+    if (gGlobal->gMixedPrecision && (g = recFeedbackGain(sig)) >= 0.99) {
+        for (int i=0; i<N; i++) {
+            if (used[i] && ctype[i] != "int" && delay[i] < gGlobal->gMaxCopyDelay) {
+                ctype[i] = "double";
+                promoted[i] = true;
+                npromoted++;
+            }
+        }
+    }
+    if (npromoted > 0) {
+        fDoubleRecs.insert(sig);
+        fDoubleRecursions++;
+        for (int i=0; i<N; i++) {
+            if (used[i]) markDoubleCoefs(nth(le,i));
+        }
+    }
+
     // generate delayline for each element of a recursive definition
     for (int i=0; i<N; i++) {
         if (used[i]) {
-            generateDelayLine(ctype[i], vname[i], delay[i], CS(nth(le,i)));
+            string exp = CS(nth(le,i));
+            if (promoted[i]) {
+                char gain[64];
+                if (g < HUGE_VAL) {
+                    snprintf(gain, sizeof(gain), "feedback gain up to %.4g", g);
+                } else {
+                    snprintf(gain, sizeof(gain), "nonlinear or unbounded feedback");
+                }
+                fClass->addExecCode(subst("// $0 in double precision : $1", vname[i], gain));
+            }
+            generateDelayLine(ctype[i], vname[i], delay[i], exp);
         }
     }
+
+    if (npromoted > 0) fDoubleRecursions--;
 }
 
 
@@ -949,7 +1088,7 @@ string ScalarCompiler::generatePrefix (Tree sig, Tree x, Tree e)
 	string type = cType(te);
 
 	fClass->addDeclCode(subst("$0 \t$1;", type, vperm));
-	fClass->addInitCode(subst("$0 = $1;", vperm, CS(x)));
+	fClass->addStateInitCode(subst("$0 = $1;", vperm, CS(x)));
 
 	fClass->addExecCode(subst("$0 $1 = $2;", type, vtemp, vperm));
 	fClass->addExecCode(subst("$0 = $1;", vperm, CS(e)));
@@ -968,12 +1107,12 @@ static bool isPowerOf2(int n)
 string ScalarCompiler::generateIota (Tree sig, Tree n)
 {
 	int size;
-	if (!isSigInt(n, &size)) { fprintf(stderr, "error in generateIota\n"); exit(1); }
+	if (!isSigInt(n, &size)) { gGlobal->gErrors << "error in generateIota" << endl; throw faustexception(); }
 
 	string vperm = getFreshID("iota");
 
 	fClass->addDeclCode(subst("int \t$0;",  vperm));
-	fClass->addInitCode(subst("$0 = 0;", vperm));
+	fClass->addStateInitCode(subst("$0 = 0;", vperm));
 
 	if (isPowerOf2(size)) {
 		fClass->addExecCode(subst("$0 = ($0+1)&$1;", vperm, T(size-1)));
@@ -1094,13 +1233,86 @@ string ScalarCompiler::generateXtended 	(Tree sig)
 		types.push_back(getCertifiedSigType(sig->branch(i)));
 	}
 
+	string code;
+	if (isDoublePrecision(sig)) {
+		// the double versions of the primitives, with arguments of the same type
+		for (unsigned int i=0; i<args.size(); i++) {
+			if (types[i]->nature() == kReal) args[i] = subst("double($0)", args[i]);
+		}
+		int floatSize = gGlobal->gFloatSize;
+		gGlobal->gFloatSize = 2;
+		code = p->generateCode(fClass, args, types);
+		gGlobal->gFloatSize = floatSize;
+	} else {
+		// the single versions, also for the arguments depending on double recursions
+		for (unsigned int i=0; i<args.size(); i++) {
+			if (types[i]->nature() == kReal && dependsOnDouble(sig->branch(i))) args[i] = subst("float($0)", args[i]);
+		}
+		code = p->generateCode(fClass, args, types);
+	}
+
 	if (p->needCache()) {
-		return generateCacheCode(sig, p->generateCode(fClass, args, types));
+		return generateCacheCode(sig, code);
 	} else {
-		return p->generateCode(fClass, args, types);
+		return code;
 	}
 }
 
+/**
+ * With -mp, the real signals computed in the sensitive recursions being
+ * compiled, and the constants and block values they use, are computed in
+ * double precision
+ */
+bool ScalarCompiler::isDoublePrecision(Tree sig)
+{
+	if (!gGlobal->gMixedPrecision || getCertifiedSigType(sig)->nature() != kReal) return false;
+	return (fDoubleRecursions > 0 && getRecursivness(sig) > 0) || fDoubleCoefs.count(sig) > 0;
+}
+
+/**
+ * Marks the constants and block values used by the recursive computations
+ * of a recursion in double precision, unless already compiled
+ */
+void ScalarCompiler::markDoubleCoefs(Tree sig)
+{
+	string	code;
+	int		i;
+	Tree	r;
+	if (fDoubleCoefsVisited.count(sig)) return;
+	fDoubleCoefsVisited.insert(sig);
+
+	Type t = getCertifiedSigType(sig);
+	if (t->variability() < kSamp) {
+		if (t->nature() == kReal && !getCompiledExpression(sig, code)) fDoubleCoefs.insert(sig);
+	} else if (getRecursivness(sig) == 0 || isProj(sig, &i, r)) {
+		return;		// non recursive computations and other recursions are left as they are
+	}
+	vector<Tree> subsigs;
+	int n = getSubSignals(sig, subsigs, false);
+	for (int k = 0; k < n; k++) markDoubleCoefs(subsigs[k]);
+}
+
+/**
+ * True if the code of the compiled signal sig may be of type double : it
+ * uses a value computed in double precision
+ */
+bool ScalarCompiler::dependsOnDouble(Tree sig)
+{
+	map<Tree, bool>::iterator p = fDependsOnDouble.find(sig);
+	if (p != fDependsOnDouble.end()) return p->second;
+
+	int		i;
+	Tree	r;
+	bool	d = fDoubleCoefs.count(sig) > 0 || (isProj(sig, &i, r) && fDoubleRecs.count(r) > 0);
+	if (!d && !isProj(sig, &i, r)) {
+		vector<Tree> subsigs;
+		int n = getSubSignals(sig, subsigs, false);
+		for (int k = 0; k < n && !d; k++) d = dependsOnDouble(subsigs[k]);
+	}
+	fDependsOnDouble[sig] = d;
+	return d;
+}
+
 
 
 //------------------------------------------------------------------------------------------------
@@ -1192,7 +1404,7 @@ string ScalarCompiler::generateFixDelay (Tree sig, Tree exp, Tree delay)
             //cerr << "it is a pure zero delay : " << code << endl;
             return code;
         } else {
-            cerr << "No vector name for : " << ppsig(exp) << endl;
+            gGlobal->gErrors << "No vector name for : " << ppsig(exp) << endl;
             assert(0);
         }
     }
@@ -1201,7 +1413,7 @@ string ScalarCompiler::generateFixDelay (Tree sig, Tree exp, Tree delay)
         // not a real vector name but a scalar name
         return vecname;
 
-	} else if (mxd < gMaxCopyDelay) {
+	} else if (mxd < gGlobal->gMaxCopyDelay) {
 		if (isSigInt(delay, &d)) {
 			return subst("$0[$1]", vecname, CS(delay));
 		} else {
@@ -1242,11 +1454,11 @@ string ScalarCompiler::generateDelayVecNoTemp(Tree sig, const string& exp, const
 
     //bool odocc = fOccMarkup.retrieve(sig)->hasOutDelayOccurences();
 
-    if (mxd < gMaxCopyDelay) {
+    if (mxd < gGlobal->gMaxCopyDelay) {
 
         // short delay : we copy
         fClass->addDeclCode(subst("$0 \t$1[$2];", ctype, vname, T(mxd+1)));
-        fClass->addInitCode(subst("for (int i=0; i<$1; i++) $0[i] = 0;", vname, T(mxd+1)));
+        fClass->addStateInitCode(subst("for (int i=0; i<$1; i++) $0[i] = 0;", vname, T(mxd+1)));
         fClass->addExecCode(subst("$0[0] = $1;", vname, exp));
 
         // generate post processing copy code to update delay values
@@ -1271,7 +1483,7 @@ string ScalarCompiler::generateDelayVecNoTemp(Tree sig, const string& exp, const
 
         // declare and init
         fClass->addDeclCode(subst("$0 \t$1[$2];", ctype, vname, T(N)));
-        fClass->addInitCode(subst("for (int i=0; i<$1; i++) $0[i] = 0;", vname, T(N)));
+        fClass->addStateInitCode(subst("for (int i=0; i<$1; i++) $0[i] = 0;", vname, T(N)));
 
         // execute
         fClass->addExecCode(subst("$0[IOTA&$1] = $2;", vname, T(N-1), exp));
@@ -1293,12 +1505,12 @@ void ScalarCompiler::generateDelayLine(const string& ctype, const string& vname,
         fClass->addExecCode(subst("$0 \t$1 = $2;", ctype, vname, exp));
 
 
-    } else if (mxd < gMaxCopyDelay) {
+    } else if (mxd < gGlobal->gMaxCopyDelay) {
         // cerr << "small delay : " << vname << "[" << mxd << "]" << endl;
 
         // short delay : we copy
         fClass->addDeclCode(subst("$0 \t$1[$2];", ctype, vname, T(mxd+1)));
-        fClass->addInitCode(subst("for (int i=0; i<$1; i++) $0[i] = 0;", vname, T(mxd+1)));
+        fClass->addStateInitCode(subst("for (int i=0; i<$1; i++) $0[i] = 0;", vname, T(mxd+1)));
         fClass->addExecCode(subst("$0[0] = $1;", vname, exp));
 
         // generate post processing copy code to update delay values
@@ -1320,7 +1532,7 @@ void ScalarCompiler::generateDelayLine(const string& ctype, const string& vname,
 
         // declare and init
         fClass->addDeclCode(subst("$0 \t$1[$2];", ctype, vname, T(N)));
-        fClass->addInitCode(subst("for (int i=0; i<$1; i++) $0[i] = 0;", vname, T(N)));
+        fClass->addStateInitCode(subst("for (int i=0; i<$1; i++) $0[i] = 0;", vname, T(N)));
 
         // execute
         fClass->addExecCode(subst("$0[IOTA&$1] = $2;", vname, T(N-1), exp));
@@ -1336,7 +1548,7 @@ void ScalarCompiler::ensureIotaCode()
     if (!fHasIota) {
         fHasIota = true;
         fClass->addDeclCode("int \tIOTA;");
-        fClass->addInitCode("IOTA = 0;");
+        fClass->addStateInitCode("IOTA = 0;");
         fClass->addPostCode("IOTA = IOTA+1;");
     }
 }
@@ -1366,12 +1578,48 @@ void ScalarCompiler::declareWaveform(Tree sig, string& vname, int& size)
     // Declares the Waveform
     fClass->addDeclCode(subst("static $0 \t$1[$2];", ctype, vname, T(size)));
     fClass->addDeclCode(subst("int \tidx$0;", vname));
-    fClass->addInitCode(subst("idx$0 = 0;", vname));
+    fClass->addStateInitCode(subst("idx$0 = 0;", vname));
     fClass->getTopParentKlass()->addStaticFields(
                 subst("$0 \t$1::$2[$3] = ", ctype, fClass->getFullClassName(), vname, T(size) )
                 + content.str() + ";");
 }
 
+/**
+ * Generate code for a FIR filter. The coefficients are declared as a static
+ * field and the filter state is kept in a faustfir object (see faust/audio/fir.h)
+ * that uses a direct form or a partitioned FFT convolution depending on the
+ * number of taps. The filter must be ticked exactly once per sample, hence
+ * its output is always cached.
+ */
+string ScalarCompiler::generateFIR(Tree sig, Tree x)
+{
+    string  ctype, vname;
+    int     size = sig->arity()-1;
+
+    getTypedNames(getCertifiedSigType(sig), "FIR", ctype, vname);
+
+    // Converts coefficients into a string : "{a,b,c,...}"
+    stringstream content;
+
+    char sep = '{';
+    for (int i = 1; i <= size; i++) {
+        content << sep << ppsig(sig->branch(i));
+        sep = ',';
+    }
+    content << '}';
+
+    addIncludeFile("\"faust/audio/fir.h\"");
+    fClass->addDeclCode(subst("static $0 \t$1Coefs[$2];", ctype, vname, T(size)));
+    fClass->addDeclCode(subst("faustfir<$0> \t$1;", ctype, vname));
+    fClass->addInitCode(subst("$0.init($0Coefs, $1);", vname, T(size)));
+    fClass->addResetCode(subst("$0.reset();", vname));
+    fClass->getTopParentKlass()->addStaticFields(
+                subst("$0 \t$1::$2Coefs[$3] = ", ctype, fClass->getFullClassName(), vname, T(size))
+                + content.str() + ";");
+
+    return forceCacheCode(sig, subst("$0.tick($1)", vname, CS(x)));
+}
+
 string ScalarCompiler::generateWaveform(Tree sig)
 {
     string  vname;
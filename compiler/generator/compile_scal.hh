@@ -45,22 +45,26 @@ class ScalarCompiler : public Compiler
     property<pair<string,string> >  fStaticInitProperty;        // property added to solve 20101208 kjetil bug
     property<pair<string,string> >  fInstanceInitProperty;      // property added to solve 20101208 kjetil bug
 
-	static map<string, int>		fIDCounters;
 	Tree                      	fSharingKey;
 	OccMarkup					fOccMarkup;
     bool						fHasIota;
+    int                         fDoubleRecursions;      ///< number of recursions in double precision being compiled (-mp)
+    set<Tree>                   fDoubleRecs;            ///< the recursions computed in double precision (-mp)
+    set<Tree>                   fDoubleCoefs;           ///< the constants and block values they use (-mp)
+    set<Tree>                   fDoubleCoefsVisited;
+    map<Tree, bool>             fDependsOnDouble;
 
 
   public:
 
 	ScalarCompiler ( const string& name, const string& super, int numInputs, int numOutputs) :
 		Compiler(name,super,numInputs,numOutputs,false),
-        fHasIota(false)
+        fHasIota(false), fDoubleRecursions(0)
 	{}
 	
 	ScalarCompiler ( Klass* k) : 
 		Compiler(k),
-        fHasIota(false)
+        fHasIota(false), fDoubleRecursions(0)
 	{}
 	
 	virtual void 		compileMultiSignal  (Tree lsig);
@@ -92,13 +96,17 @@ class ScalarCompiler : public Compiler
 	int 		getSharingCount(Tree t);
 	void 		setSharingCount(Tree t, int count);
 	void 		sharingAnalysis(Tree t);
-	void 		sharingAnnotation(int vctxt, Tree t);
 	
 	
 	// generation du code
 	
     string          generateXtended		(Tree sig);
+    bool            isDoublePrecision	(Tree sig);
+    bool            dependsOnDouble		(Tree sig);
+    void            markDoubleCoefs		(Tree sig);
+    string          CSOperand			(Tree sig, Tree arg);
 	virtual string 		generateFixDelay	(Tree sig, Tree arg, Tree size);
+    string          generateFIR 		(Tree sig, Tree x);
     string          generatePrefix 		(Tree sig, Tree x, Tree e);
     string          generateIota		(Tree sig, Tree arg);
     string          generateBinOp 		(Tree sig, int opcode, Tree arg1, Tree arg2);
@@ -115,12 +123,14 @@ class ScalarCompiler : public Compiler
     string          generateRDTbl 		(Tree sig, Tree tbl, Tree idx);
     string          generateSigGen		(Tree sig, Tree content);
     string          generateStaticSigGen(Tree sig, Tree content);
+    void            generateTableName	(Tree content, string& ctype, string& vname);
+    bool            getConstTableData	(Tree content, int size, string& data);
 	
     string          generateSelect2 	(Tree sig, Tree sel, Tree s1, Tree s2);
     string          generateSelect3 	(Tree sig, Tree sel, Tree s1, Tree s2, Tree s3);
 	
     string          generateRecProj 	(Tree sig, Tree exp, int i);
-    void            generateRec         (Tree sig, Tree var, Tree le);
+    virtual void    generateRec         (Tree sig, Tree var, Tree le);
 	
     string          generateIntCast   	(Tree sig, Tree x);
     string          generateFloatCast 	(Tree sig, Tree x);
@@ -24,8 +24,7 @@
 #include "compile_sched.hh"
 #include "floats.hh"
 #include "ppsig.hh"
-
-extern int gVecSize;
+#include "global.hh"
 
 void SchedulerCompiler::compileMultiSignal (Tree L)
 {
@@ -76,7 +75,7 @@ void  SchedulerCompiler::vectorLoop (const string& tname, const string& vecname,
     fClass->addSharedDecl(vecname);
     
     // -- variables moved as class fields...
-    fClass->addDeclCode(subst("$0 \t$1[$2];", tname, vecname, T(gVecSize)));
+    fClass->addDeclCode(subst("$0 \t$1[$2];", tname, vecname, T(gGlobal->gVecSize)));
     
     // -- compute the new samples
     fClass->addExecCode(subst("$0[i] = $1;", vecname, cexp));
@@ -94,7 +93,7 @@ void  SchedulerCompiler::vectorLoop (const string& tname, const string& vecname,
  */
 void  SchedulerCompiler::dlineLoop (const string& tname, const string& dlname, int delay, const string& cexp) 
 {
-    if (delay < gMaxCopyDelay) {
+    if (delay < gGlobal->gMaxCopyDelay) {
         
         // Implementation of a copy based delayline
         
@@ -110,7 +109,7 @@ void  SchedulerCompiler::dlineLoop (const string& tname, const string& dlname, i
         fClass->addDeclCode(subst("$0 \t$1[$2];", tname, pmem, dsize));
         
         // init permanent memory
-        fClass->addInitCode(subst("for (int i=0; i<$1; i++) $0[i]=0;", pmem, dsize)); 
+        fClass->addStateInitCode(subst("for (int i=0; i<$1; i++) $0[i]=0;", pmem, dsize)); 
         
         // compute method
         
@@ -118,7 +117,7 @@ void  SchedulerCompiler::dlineLoop (const string& tname, const string& dlname, i
         fClass->addSharedDecl(buf);
         
         // -- variables moved as class fields...
-        fClass->addDeclCode(subst("$0 \t$1[$2+$3];", tname, buf, T(gVecSize), dsize));
+        fClass->addDeclCode(subst("$0 \t$1[$2+$3];", tname, buf, T(gGlobal->gVecSize), dsize));
         
         fClass->addFirstPrivateDecl(dlname);
         fClass->addZone2(subst("$0* \t$1 = &$2[$3];", tname, dlname, buf, dsize));
@@ -137,7 +136,7 @@ void  SchedulerCompiler::dlineLoop (const string& tname, const string& dlname, i
         // Implementation of a ring-buffer delayline
         
         // the size should be large enough and aligned on a power of two
-        delay   = pow2limit(delay + gVecSize);
+        delay   = pow2limit(delay + gGlobal->gVecSize);
         string  dsize   = T(delay);
         string  mask    = T(delay-1);
         
@@ -151,9 +150,9 @@ void  SchedulerCompiler::dlineLoop (const string& tname, const string& dlname, i
         fClass->addDeclCode(subst("int \t$0;", idx_save));
         
         // init permanent memory
-        fClass->addInitCode(subst("for (int i=0; i<$1; i++) $0[i]=0;", dlname, dsize)); 
-        fClass->addInitCode(subst("$0 = 0;", idx));
-        fClass->addInitCode(subst("$0 = 0;", idx_save));
+        fClass->addStateInitCode(subst("for (int i=0; i<$1; i++) $0[i]=0;", dlname, dsize)); 
+        fClass->addStateInitCode(subst("$0 = 0;", idx));
+        fClass->addStateInitCode(subst("$0 = 0;", idx_save));
         
         // -- update index
         fClass->addPreCode(subst("$0 = ($0+$1)&$2;", idx, idx_save, mask));
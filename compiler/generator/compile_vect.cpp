@@ -26,9 +26,10 @@
 #include "compile_vect.hh"
 #include "floats.hh"
 #include "ppsig.hh"
+#include "recursivness.hh"
+#include "global.hh"
 
-extern int gVecSize;
-extern bool gPrintJSONSwitch;
+string vecSizeName();
 
 string makeDrawPath();
 
@@ -62,7 +63,7 @@ void VectorCompiler::compileMultiSignal (Tree L)
         fDescription->ui(prepareUserInterfaceTree(fUIRoot));
     }
     
-    if (gPrintJSONSwitch) {
+    if (gGlobal->gPrintJSONSwitch) {
         ofstream xout(subst("$0.json", makeDrawPath()).c_str());
         xout << fJSON.JSON();
     }
@@ -193,6 +194,12 @@ string VectorCompiler::generateLoopCode (Tree sig)
                 fClass->closeLoop(sig);
                 return c;
             }
+        } else if (isSigFIR(sig, x)) {
+            // the state of a FIR filter makes its loop sequential
+            fClass->openLoop(sig, "count");
+            string c = ScalarCompiler::generateCode(sig);
+            fClass->closeLoop(sig);
+            return c;
         } else {
             fClass->openLoop("count");
             string c = ScalarCompiler::generateCode(sig);
@@ -254,11 +261,11 @@ string VectorCompiler::generateCacheCode(Tree sig, const string& exp)
             if (verySimple(sig)) {
                 return exp;
             } else {
-                if (d < gMaxCopyDelay) {
+                if (d < gGlobal->gMaxCopyDelay) {
                     return subst("$0[i]", vname);
                 } else {
                     // we use a ring buffer
-                    string mask = T(pow2limit(d + gVecSize)-1);
+                    string mask = T(pow2limit(d + gGlobal->gVecSize)-1);
                     return subst("$0[($0_idx+i) & $1]", vname, mask);
                 }
             }
@@ -302,6 +309,8 @@ bool VectorCompiler::needSeparateLoop(Tree sig)
         b = false;      // non sample computation never require a loop
     } else if (isSigFixDelay(sig, x, y)) {
         b = false;      //
+    } else if (isSigFIR(sig, x)) {
+        b = true;       // FIR filters are stateful, they require their own loop
     } else if (isProj(sig, &i ,x)) {
         //cerr << "REC "; // recursive expressions require a separate loop
         b = true;
@@ -314,9 +323,9 @@ bool VectorCompiler::needSeparateLoop(Tree sig)
         b = false;
     }
 /*    if (b) {
-        cerr << "Separate Loop for " << ppsig(sig) << endl;
+        gErrors << "Separate Loop for " << ppsig(sig) << endl;
     } else {
-        cerr << "Same Loop for " << ppsig(sig) << endl;
+        gErrors << "Same Loop for " << ppsig(sig) << endl;
     }*/
     return b;
 }
@@ -366,7 +375,7 @@ string VectorCompiler::generateFixDelay (Tree sig, Tree exp, Tree delay)
             //cerr << "it is a pure zero delay : " << code << endl;
             return code;
         } else {
-            cerr << "No vector name for : " << ppsig(exp) << endl;
+            gGlobal->gErrors << "No vector name for : " << ppsig(exp) << endl;
             assert(0);
         }
     }
@@ -375,7 +384,7 @@ string VectorCompiler::generateFixDelay (Tree sig, Tree exp, Tree delay)
         // not a real vector name but a scalar name
         return subst("$0[i]", vecname);
 
-    } else if (mxd < gMaxCopyDelay){
+    } else if (mxd < gGlobal->gMaxCopyDelay){
         if (isSigInt(delay, &d)) {
             if (d == 0) {
                 return subst("$0[i]", vecname);
@@ -389,7 +398,7 @@ string VectorCompiler::generateFixDelay (Tree sig, Tree exp, Tree delay)
     } else {
 
         // long delay : we use a ring buffer of size 2^x
-        int     N   = pow2limit( mxd+gVecSize );
+        int     N   = pow2limit( mxd+gGlobal->gVecSize );
 
         if (isSigInt(delay, &d)) {
             if (d == 0) {
@@ -446,7 +455,7 @@ void  VectorCompiler::vectorLoop (const string& tname, const string& vecname, co
     fClass->addSharedDecl(vecname);
 
     // -- variables moved as class fields...
-    fClass->addZone1(subst("$0 \t$1[$2];", tname, vecname, T(gVecSize)));
+    fClass->addZone1(subst("$0 \t$1[$2];", tname, vecname, vecSizeName()));
 
     // -- compute the new samples
     fClass->addExecCode(subst("$0[i] = $1;", vecname, cexp));
@@ -464,7 +473,7 @@ void  VectorCompiler::vectorLoop (const string& tname, const string& vecname, co
  */
 void  VectorCompiler::dlineLoop (const string& tname, const string& dlname, int delay, const string& cexp)
 {
-    if (delay < gMaxCopyDelay) {
+    if (delay < gGlobal->gMaxCopyDelay) {
 
         // Implementation of a copy based delayline
 
@@ -480,7 +489,7 @@ void  VectorCompiler::dlineLoop (const string& tname, const string& dlname, int
         fClass->addDeclCode(subst("$0 \t$1[$2];", tname, pmem, dsize));
 
         // init permanent memory
-        fClass->addInitCode(subst("for (int i=0; i<$1; i++) $0[i]=0;", pmem, dsize));
+        fClass->addStateInitCode(subst("for (int i=0; i<$1; i++) $0[i]=0;", pmem, dsize));
 
         // compute method
 
@@ -488,7 +497,7 @@ void  VectorCompiler::dlineLoop (const string& tname, const string& dlname, int
         fClass->addSharedDecl(buf);
 
         // -- variables moved as class fields...
-        fClass->addZone1(subst("$0 \t$1[$2+$3];", tname, buf, T(gVecSize), dsize));
+        fClass->addZone1(subst("$0 \t$1[$2+$3];", tname, buf, vecSizeName(), dsize));
 
         fClass->addFirstPrivateDecl(dlname);
         fClass->addZone2(subst("$0* \t$1 = &$2[$3];", tname, dlname, buf, dsize));
@@ -507,7 +516,7 @@ void  VectorCompiler::dlineLoop (const string& tname, const string& dlname, int
         // Implementation of a ring-buffer delayline
 
         // the size should be large enough and aligned on a power of two
-        delay   = pow2limit(delay + gVecSize);
+        delay   = pow2limit(delay + gGlobal->gVecSize);
         string  dsize   = T(delay);
         string  mask    = T(delay-1);
 
@@ -521,9 +530,9 @@ void  VectorCompiler::dlineLoop (const string& tname, const string& dlname, int
         fClass->addDeclCode(subst("int \t$0;", idx_save));
 
         // init permanent memory
-        fClass->addInitCode(subst("for (int i=0; i<$1; i++) $0[i]=0;", dlname, dsize));
-        fClass->addInitCode(subst("$0 = 0;", idx));
-        fClass->addInitCode(subst("$0 = 0;", idx_save));
+        fClass->addStateInitCode(subst("for (int i=0; i<$1; i++) $0[i]=0;", dlname, dsize));
+        fClass->addStateInitCode(subst("$0 = 0;", idx));
+        fClass->addStateInitCode(subst("$0 = 0;", idx_save));
 
         // -- update index
         fClass->addPreCode(subst("$0 = ($0+$1)&$2;", idx, idx_save, mask));
@@ -546,3 +555,171 @@ string VectorCompiler::generateWaveform(Tree sig)
     fClass->addPostCode(subst("idx$0 = (idx$0 + count) % $1;", vname, T(size)) );
     return generateCacheCode(sig, subst("$0[(idx$0+i)%$1]", vname, T(size)));
 }
+
+
+/*****************************************************************************
+							LINEAR RECURSIONS
+*****************************************************************************/
+
+/**
+ * A term of the linear form of a recursive definition : the product of
+ * block-constant factors and either a non recursive expression (delay 0)
+ * or the recursive signal delayed by delay > 0
+ */
+struct linterm
+{
+    vector<Tree>    fFactors;
+    bool            fNeg;
+    Tree            fExp;
+    int             fDelay;
+
+    linterm(const vector<Tree>& factors, bool neg, Tree exp, int delay)
+        : fFactors(factors), fNeg(neg), fExp(exp), fDelay(delay) {}
+};
+
+static bool dependsOn(Tree e, Tree rec)
+{
+    return isElement(rec, symlist(e));
+}
+
+static bool isBlockConstant(Tree e, Tree rec)
+{
+    return !dependsOn(e, rec) && (getCertifiedSigType(e)->variability() < kSamp);
+}
+
+/**
+ * Decompose e as a sum of terms linear in the delayed values of the
+ * first projection of rec. Returns false if e is not linear.
+ */
+static bool linearForm(Tree e, Tree rec, vector<Tree>& factors, bool neg, vector<linterm>& terms)
+{
+    int     op, d, i;
+    Tree    x, y, r;
+
+    if (!dependsOn(e, rec)) {
+        if (!isZero(e)) terms.push_back(linterm(factors, neg, e, 0));
+        return true;
+
+    } else if (isSigFixDelay(e, x, y) && isSigInt(y, &d) && (d > 0) && isProj(x, &i, r) && (r == rec) && (i == 0)) {
+        terms.push_back(linterm(factors, neg, e, d));
+        return true;
+
+    } else if (isSigBinOp(e, &op, x, y) && (op == kAdd)) {
+        return linearForm(x, rec, factors, neg, terms) && linearForm(y, rec, factors, neg, terms);
+
+    } else if (isSigBinOp(e, &op, x, y) && (op == kSub)) {
+        return linearForm(x, rec, factors, neg, terms) && linearForm(y, rec, factors, !neg, terms);
+
+    } else if (isSigBinOp(e, &op, x, y) && (op == kMul)) {
+        if (isBlockConstant(y, rec)) std::swap(x, y);
+        if (isBlockConstant(x, rec)) {
+            factors.push_back(x);
+            bool b = linearForm(y, rec, factors, neg, terms);
+            factors.pop_back();
+            return b;
+        }
+    }
+    return false;
+}
+
+/**
+ * Generate the code of the sum of the terms of a linear form having
+ * a given delay : the coefficient of y[i-delay], or the non recursive
+ * part u[i] of the recursion when delay is 0
+ */
+string VectorCompiler::generateLinearCode(const vector<linterm>& terms, int delay)
+{
+    string code;
+
+    for (unsigned int i = 0; i < terms.size(); i++) {
+        if (terms[i].fDelay != delay) continue;
+
+        string p = (delay == 0) ? CS(terms[i].fExp) : "";
+        for (unsigned int j = 0; j < terms[i].fFactors.size(); j++) {
+            string f = CS(terms[i].fFactors[j]);
+            p = (p.empty()) ? f : subst("($0 * $1)", f, p);
+        }
+        if (p.empty()) p = "1";
+
+        if (code.empty()) {
+            code = (terms[i].fNeg) ? subst("(0 - $0)", p) : p;
+        } else {
+            code = subst((terms[i].fNeg) ? "($0 - $1)" : "($0 + $1)", code, p);
+        }
+    }
+    return (code.empty()) ? "0" : code;
+}
+
+/**
+ * Generate code for a group of mutually recursive definitions, using
+ * block-parallel evaluation for linear recursions when requested
+ */
+void VectorCompiler::generateRec(Tree sig, Tree var, Tree le)
+{
+    if (!(gGlobal->gLinearRecSwitch && generateLinearRec(sig, var, le))) {
+        ScalarCompiler::generateRec(sig, var, le);
+    }
+}
+
+/**
+ * Generate code for a first or second order linear recursion
+ * y[i] = u[i] + a1*y[i-1] + a2*y[i-2] with block-constant coefficients.
+ * The non recursive part u is computed in a vectorizable loop directly
+ * into the delay line, then the recursion is computed in place by blocks
+ * of four samples (see faust/audio/linrec.h).
+ * @return false if the recursion is not of this form
+ */
+bool VectorCompiler::generateLinearRec(Tree sig, Tree var, Tree le)
+{
+    if (len(le) != 1) return false;
+
+    Tree        e = sigProj(0, sig);
+    Occurences* o = fOccMarkup.retrieve(e);
+    if (!o) return false;
+
+    // the recursion must be real and stored in a copy delay line
+    int     delay = o->getMaxDelay();
+    Type    t = getCertifiedSigType(e);
+    if ((t->nature() != kReal) || (delay >= gGlobal->gMaxCopyDelay)) return false;
+
+    // the loop of the recursion must not be absorbed in an enclosing loop
+    Loop*   l = fClass->topLoop();
+    if (!l->fIsRecursive || !isElement(sig, l->fRecSymbolSet)) return false;
+    if (l->fEnclosingLoop && l->fEnclosingLoop->hasRecDependencyIn(symlist(sig))) return false;
+
+    vector<Tree>    factors;
+    vector<linterm> terms;
+    if (!linearForm(nth(le, 0), sig, factors, false, terms)) return false;
+
+    int order = 0;
+    for (unsigned int i = 0; i < terms.size(); i++) {
+        order = max(order, terms[i].fDelay);
+    }
+    if ((order < 1) || (order > 2)) return false;
+
+    string ctype, vname;
+    getTypedNames(t, "Rec", ctype, vname);
+    setVectorNameProperty(e, vname);
+
+    // compile the delayed references in this loop, as the loop of the
+    // recursion must be found by the expressions using them
+    for (unsigned int i = 0; i < terms.size(); i++) {
+        if (terms[i].fDelay > 0) CS(terms[i].fExp);
+    }
+
+    // coefficients of the recursion, computed once per block
+    for (int k = 1; k <= order; k++) {
+        fClass->addPreCode(subst("$0 \t$1_a$2 = $3;", ctype, vname, T(k), generateLinearCode(terms, k)));
+    }
+
+    // u[i] computed in the delay line, then the recursion in place
+    dlineLoop(ctype, vname, delay, generateLinearCode(terms, 0));
+
+    addIncludeFile("\"faust/audio/linrec.h\"");
+    if (order == 1) {
+        fClass->addPostCode(subst("faustlinrec1<$0>(count, $1_a1, $1);", ctype, vname));
+    } else {
+        fClass->addPostCode(subst("faustlinrec2<$0>(count, $1_a1, $1_a2, $1);", ctype, vname));
+    }
+    return true;
+}
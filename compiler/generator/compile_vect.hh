@@ -27,8 +27,6 @@
 #include "compile_scal.hh"
 #include "loop.hh"
 
-extern int      gMaxCopyDelay;
-
 
 ////////////////////////////////////////////////////////////////////////
 /**
@@ -65,8 +63,11 @@ protected:
     virtual void        vectorLoop (const string& tname, const string& dlname, const string& cexp);
     virtual void        dlineLoop ( const string& tname, const string& dlname, int delay, const string& cexp);
     virtual string      generateWaveform(Tree sig);
+    virtual void        generateRec(Tree sig, Tree var, Tree le);
 
     bool    needSeparateLoop(Tree sig);
+    bool    generateLinearRec(Tree sig, Tree var, Tree le);
+    string  generateLinearCode(const vector<struct linterm>& terms, int delay);
     
 };
 
@@ -7,6 +7,8 @@
 
 #include "description.hh"
 #include "Text.hh"
+#include "exception.hh"
+#include "global.hh"
 
 /**
  * Extracts metdata from a label : 'vol [unit: dB]' -> 'vol' + metadata
@@ -99,7 +101,7 @@ void extractMetadata(const string& fulllabel, string& label, map<string, set<str
                 break;
 
             default :
-                cerr << "ERROR unrecognized state " << state << endl;
+                gGlobal->gErrors << "ERROR unrecognized state " << state << endl;
         }
     }
     label = rmWhiteSpaces(label);
@@ -227,8 +229,8 @@ void Description::addGroup(int level, Tree t)
 
 	} else {
 
-		fprintf(stderr, "error in user interface generation 2\n");
-		exit(1);
+		gGlobal->gErrors << "error in user interface generation 2" << endl;
+		throw faustexception();
 
 	}
 }
@@ -328,8 +330,8 @@ int Description::addWidget(Tree label, Tree varname, Tree sig)
 		addPassiveLine("</widget>");
 
 	} else {
-		fprintf(stderr, "Error describing widget : unrecognized expression\n");
-		exit(1);
+		gGlobal->gErrors << "Error describing widget : unrecognized expression" << endl;
+		throw faustexception();
 	}
 
 	return fWidgetID;
@@ -20,6 +20,7 @@
  ************************************************************************/
 
 #include "floats.hh"
+#include "global.hh"
 
 #define FLOATMACRO "FAUSTFLOAT"
 #define FLOATCAST "(" FLOATMACRO ")"
@@ -32,19 +33,17 @@
 //          2: double precision float
 //          3: long double precision float
 
-extern int  gFloatSize;
-
 
 const char* mathsuffix[] = {"", "f", "", "l"};                                  // suffix for math functions
 const char* numsuffix[]  = {"", "f", "", "L"};                                   // suffix for numeric constants
 const char* floatname[]  = {FLOATMACRO, "float", "double", "quad"};      // float types
 const char* castname[]   = {FLOATCAST, "(float)", "(double)", "(quad)"}; // float castings
 
-const char* isuffix() { return mathsuffix[gFloatSize]; } ///< suffix for math functions
-const char* inumix()  { return numsuffix [gFloatSize]; } ///< suffix for numeric constants
+const char* isuffix() { return mathsuffix[gGlobal->gFloatSize]; } ///< suffix for math functions
+const char* inumix()  { return numsuffix [gGlobal->gFloatSize]; } ///< suffix for numeric constants
 
-const char* ifloat() { return floatname[gFloatSize]; }
-const char* icast()  { return castname[gFloatSize]; }
+const char* ifloat() { return floatname[gGlobal->gFloatSize]; }
+const char* icast()  { return castname[gGlobal->gFloatSize]; }
 
 const char* xfloat() { return floatname[0]; }
 const char* xcast()  { return castname[0]; }
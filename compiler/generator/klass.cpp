@@ -35,6 +35,7 @@
 ***********************************************************************/
 
 #include <stdio.h>
+#include <ctype.h>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -49,21 +50,8 @@
 #include "signals.hh"
 #include "ppsig.hh"
 #include "recursivness.hh"
-
-
-extern int  gFloatSize;
-extern bool gVectorSwitch;
-extern bool gDeepFirstSwitch;
-extern bool gOpenMPSwitch;
-extern bool gOpenMPLoop;
-extern bool gSchedulerSwitch;
-extern int  gVecSize;
-extern bool gUIMacroSwitch;
-extern int  gVectorLoopVariant;
-extern bool	gGroupTaskSwitch;
-
-extern map<Tree, set<Tree> > gMetaDataSet;
-static int gTaskCount = 0;
+#include "exception.hh"
+#include "global.hh"
 
 void tab (int n, ostream& fout)
 {
@@ -71,8 +59,6 @@ void tab (int n, ostream& fout)
 	while (n--)	fout << '\t';
 }
 
-bool Klass::fNeedPowerDef = false;
-
 /**
  * Store the loop used to compute a signal
  */
@@ -124,6 +110,9 @@ void Klass::closeLoop(Tree sig)
     //l->println(4, cerr);
     //cerr << endl;
 
+    Tree id;
+    if (gGlobal->gProfSwitch && getDefinitionName(sig, id)) l->fNames.insert(tree2str(id));
+
     Tree S = symlist(sig);
     //cerr << "CLOSE LOOP :" << l << " with symbols " << *S  << endl;
     if (l->isEmpty() || fTopLoop->hasRecDependencyIn(S)) {
@@ -158,6 +147,92 @@ void printlines(int n, list<string>& lines, ostream& fout)
     }
 }
 
+/**
+ * Size in bytes of a field declaration "type \tname[size];", or 0 for the
+ * static fields, the pointers and the objects. The sizes of the arrays
+ * can be sums (like [32+1024] in vector mode).
+ */
+static int fieldSize(const string& decl, bool& isControl)
+{
+    size_t  e = decl.find_last_of(" \t");
+    if (e == string::npos) return 0;
+    string  type = decl.substr(0, decl.find_first_of(" \t"));
+    string  name = decl.substr(e+1);
+    int     size;
+
+    isControl = false;
+    if (decl.find_first_not_of(" \t", type.size()) != e+1) {
+        return 0;   // static, volatile, pointers...
+    } else if (type == "int" || type == "float") {
+        size = 4;
+    } else if (type == "double") {
+        size = 8;
+    } else if (type == "quad") {
+        size = 16;
+    } else if (type == "FAUSTFLOAT") {
+        size = 4;
+        isControl = (name.find('[') == string::npos);
+    } else {
+        return 0;
+    }
+    for (size_t i = name.find('['); i != string::npos; i = name.find('[', i+1)) {
+        char*   p = (char*)name.c_str() + i;
+        int     n = 0;
+        do { n += strtol(p+1, &p, 10); } while (*p == '+');
+        size *= n;
+    }
+    return size;
+}
+
+/**
+ * Print the fields of the class. With -cl, the fields are grouped by usage
+ * and the groups start on a new cache line : the controls written by the
+ * user interface, the small state of each loop (so that the threads of the
+ * parallel modes don't share lines), the large buffers and the other
+ * fields. Otherwise the fields are printed in the order of declaration.
+ */
+void Klass::printDeclarations(int n, ostream& fout)
+{
+    if (gGlobal->gCacheLine <= 0) {
+        printlines(n, fDeclCode, fout);
+        return;
+    }
+
+    list<string>    statics, controls, bulk, others;
+    vector<Loop*>   loops;
+    map<Loop*, list<string> > hot;
+
+    list<Loop*>::iterator l = fDeclLoops.begin();
+    for (list<string>::iterator s = fDeclCode.begin(); s != fDeclCode.end(); s++, l++) {
+        bool isControl;
+        int  size = fieldSize(*s, isControl);
+        if (s->compare(0, 7, "static ") == 0) {
+            statics.push_back(*s);
+        } else if (size == 0) {
+            others.push_back(*s);
+        } else if (isControl) {
+            controls.push_back(*s);
+        } else if (size > gGlobal->gCacheLine) {
+            bulk.push_back("FAUSTALIGN " + *s);
+        } else {
+            if (hot.find(*l) == hot.end()) loops.push_back(*l);
+            hot[*l].push_back(*s);
+        }
+    }
+    if (!controls.empty()) controls.front() = "FAUSTALIGN " + controls.front();
+    if (!others.empty()) others.front() = "FAUSTALIGN " + others.front();
+
+    printlines(n, statics, fout);
+    printlines(n, controls, fout);
+    for (unsigned int i = 0; i < loops.size(); i++) {
+        list<string>& L = hot[loops[i]];
+        L.front() = "FAUSTALIGN " + L.front();
+        printlines(n, L, fout);
+    }
+    printlines(n, bulk, fout);
+    printlines(n, others, fout);
+}
+
 /**
  * Print a list of elements (e1, e2,...)
  */
@@ -201,7 +276,7 @@ void Klass::printIncludeFile(ostream& fout)
     set<string> S;
     set<string>::iterator f;
 
-    if (gOpenMPSwitch) {
+    if (gGlobal->gOpenMPSwitch) {
         fout << "#include <omp.h>" << "\n";
     }
 
@@ -216,14 +291,14 @@ void Klass::printIncludeFile(ostream& fout)
  */
 void Klass::printAdditionalCode(ostream& fout)
 {
-    if (fNeedPowerDef) {
+    if (gGlobal->gNeedPowerDef) {
         // Add faustpower definition to C++ code
         fout << "#ifndef FAUSTPOWER" << endl;
         fout << "#define FAUSTPOWER" << endl;
         fout << "#include <cmath>" << endl;
         fout << "template <int N> inline float faustpower(float x)          { return powf(x,N); } " << endl;
         fout << "template <int N> inline double faustpower(double x)        { return pow(x,N); }"  << endl;
-        if (gFloatSize == 3) fout << "template <int N> inline long double faustpower(long double x) 	{ return powl(x,N); }"  << endl;
+        if (gGlobal->gFloatSize == 3) fout << "template <int N> inline long double faustpower(long double x) 	{ return powl(x,N); }"  << endl;
         fout << "template <int N> inline int faustpower(int x)              { return faustpower<N/2>(x) * faustpower<N-N/2>(x); } " << endl;
         fout << "template <> 	 inline int faustpower<0>(int x)            { return 1; }" << endl;
         fout << "template <> 	 inline int faustpower<1>(int x)            { return x; }" << endl;
@@ -239,7 +314,7 @@ void Klass::printMetadata(int n, const map<Tree, set<Tree> >& S, ostream& fout)
 {
     tab(n,fout); fout   << "static void metadata(Meta* m) \t{ ";
 
-    for (map<Tree, set<Tree> >::iterator i = gMetaDataSet.begin(); i != gMetaDataSet.end(); i++) {
+    for (map<Tree, set<Tree> >::iterator i = gGlobal->gMetaDataSet.begin(); i != gGlobal->gMetaDataSet.end(); i++) {
         if (i->first != tree("author")) {
             tab(n+1,fout); fout << "m->declare(\"" << *(i->first) << "\", " << **(i->second.begin()) << ");";
         } else {
@@ -279,7 +354,9 @@ void Klass::printLoopDeepFirst(int n, ostream& fout, Loop* l, set<Loop*>& visite
     // the print the loop itself
     tab(n, fout);
     tab(n, fout); fout << "// LOOP " << l << ", ORDER " << l->fOrder << endl;
+    int e = printProfileStart(n+1, l, fout);
     l->println(n+1, fout);
+    printProfileStop(n+1, e, fout);
 }
 
 /**
@@ -329,7 +406,7 @@ void Klass::buildTasksList()
 {
     lgraph G;
 
-    if (gGroupTaskSwitch) {
+    if (gGlobal->gGroupTaskSwitch) {
         computeUseCount(fTopLoop);
         groupSeqLoops(fTopLoop);
     }
@@ -427,9 +504,9 @@ void Klass::buildTasksList()
     for (int l=(int)G.size()-1; l>=0; l--) {
         for (lset::const_iterator p =G[l].begin(); p!=G[l].end(); p++) {
             if ((*p)->fBackwardLoopDependencies.size() > 1)  { // Only initialize taks with more than 1 input, since taks with one input are "directly" activated.
-                addZone2c(subst("fGraph.InitTask($0,$1);", T(START_TASK_INDEX + gTaskCount++), T((int)(*p)->fBackwardLoopDependencies.size())));
+                addZone2c(subst("fGraph.InitTask($0,$1);", T(START_TASK_INDEX + gGlobal->gTaskCount++), T((int)(*p)->fBackwardLoopDependencies.size())));
             } else {
-                gTaskCount++;
+                gGlobal->gTaskCount++;
             }
         }
     }
@@ -439,7 +516,7 @@ void Klass::buildTasksList()
     addInitCode("fThreadPool = DSPThreadPool::Init();");
     addInitCode("fThreadPool->StartAll(fStaticNumThreads - 1, false);");
 
-    gTaskCount = 0;
+    gGlobal->gTaskCount = 0;
 }
 
 /**
@@ -447,7 +524,7 @@ void Klass::buildTasksList()
  */
 void Klass::printLoopGraphVector(int n, ostream& fout)
 {
-    if (gGroupTaskSwitch) {
+    if (gGlobal->gGroupTaskSwitch) {
         computeUseCount(fTopLoop);
         groupSeqLoops(fTopLoop);
     }
@@ -457,7 +534,7 @@ void Klass::printLoopGraphVector(int n, ostream& fout)
 
 #if 1
     // EXPERIMENTAL
-    if (gVectorSwitch && gDeepFirstSwitch) {
+    if (gGlobal->gVectorSwitch && gGlobal->gDeepFirstSwitch) {
         set<Loop*> visited;
         printLoopDeepFirst(n, fout, fTopLoop, visited);
         return;
@@ -466,9 +543,56 @@ void Klass::printLoopGraphVector(int n, ostream& fout)
 
     // normal mode
     for (int l=(int)G.size()-1; l>=0; l--) {
-        if (gVectorSwitch) { tab(n, fout); fout << "// SECTION : " << G.size() - l; }
-        for (lset::const_iterator p =G[l].begin(); p!=G[l].end(); p++) {
+        if (gGlobal->gVectorSwitch) { tab(n, fout); fout << "// SECTION : " << G.size() - l; }
+        if (gGlobal->gVectorSwitch && gGlobal->gSIMDLanes > 1) {
+            printLanesSection(n, fout, G[l]);
+        } else {
+            for (lset::const_iterator p =G[l].begin(); p!=G[l].end(); p++) {
+                int e = printProfileStart(n, *p, fout);
+                (*p)->println(n, fout);
+                printProfileStop(n, e, fout);
+            }
+        }
+    }
+}
+
+/**
+ * Print a section of the loop graph, computing together up to gSIMDLanes
+ * isomorphic recursive loops. The loops of a section are independent,
+ * therefore their lines of code can be interleaved.
+ */
+void Klass::printLanesSection(int n, ostream& fout, const lset& section)
+{
+    map<string, vector<Loop*> > groups;
+    map<Loop*, string>          signatures;
+
+    for (lset::const_iterator p = section.begin(); p != section.end(); p++) {
+        if ((*p)->fIsRecursive && (*p)->fExtraLoops.empty()) {
+            string s = (*p)->signature();
+            signatures[*p] = s;
+            groups[s].push_back(*p);
+        }
+    }
+
+    for (lset::const_iterator p = section.begin(); p != section.end(); p++) {
+        if (signatures.find(*p) == signatures.end()) {
+            int e = printProfileStart(n, *p, fout);
             (*p)->println(n, fout);
+            printProfileStop(n, e, fout);
+            continue;
+        }
+        vector<Loop*>& g = groups[signatures[*p]];
+        if (g.empty() || g[0] != *p) continue;  // printed with the first loop of its group
+
+        for (unsigned int k = 0; k < g.size(); k += gGlobal->gSIMDLanes) {
+            vector<Loop*> lanes(g.begin() + k, g.begin() + min(g.size(), size_t(k + gGlobal->gSIMDLanes)));
+            int e = printProfileStart(n, lanes, fout);
+            if (lanes.size() > 1) {
+                printLanesln(n, lanes, fout);
+            } else {
+                lanes[0]->println(n, fout);
+            }
+            printProfileStop(n, e, fout);
         }
     }
 }
@@ -478,7 +602,7 @@ void Klass::printLoopGraphVector(int n, ostream& fout)
  */
 void Klass::printLoopGraphOpenMP(int n, ostream& fout)
 {
-    if (gGroupTaskSwitch) {
+    if (gGlobal->gGroupTaskSwitch) {
         computeUseCount(fTopLoop);
         groupSeqLoops(fTopLoop);
     }
@@ -498,7 +622,7 @@ void Klass::printLoopGraphOpenMP(int n, ostream& fout)
  */
 void Klass::printLoopGraphScheduler(int n, ostream& fout)
 {
-    if (gGroupTaskSwitch) {
+    if (gGlobal->gGroupTaskSwitch) {
         computeUseCount(fTopLoop);
         groupSeqLoops(fTopLoop);
     }
@@ -555,7 +679,7 @@ void Klass::printLoopGraphInternal(int n, ostream& fout)
 
     // normal mode
     for (int l=(int)G.size()-1; l>=0; l--) {
-        if (gVectorSwitch) { tab(n, fout); fout << "// SECTION : " << G.size() - l; }
+        if (gGlobal->gVectorSwitch) { tab(n, fout); fout << "// SECTION : " << G.size() - l; }
         for (lset::const_iterator p =G[l].begin(); p!=G[l].end(); p++) {
             (*p)->printoneln(n, fout);
         }
@@ -567,7 +691,9 @@ void Klass::printLoopGraphInternal(int n, ostream& fout)
  */
 void Klass::printLoopGraphScalar(int n, ostream& fout)
 {
+    int e = printProfileStart(n, fTopLoop, fout);
     fTopLoop->printoneln(n, fout);
+    printProfileStop(n, e, fout);
 }
 
 /**
@@ -590,12 +716,17 @@ void Klass::printLoopLevelOpenMP(int n, int lnum, const lset& L, ostream& fout)
     if (nonRecursiveLevel(L) && L.size()==1) {
         for (lset::const_iterator p =L.begin(); p!=L.end(); p++) {
             if ((*p)->isEmpty() == false) {
-                if (gOpenMPLoop) {
+                if (gGlobal->gOpenMPLoop) {
+                    // all the threads share the loop, the master measures it up to the final barrier
+                    int e = printProfileStart(n, *p, fout);
                     (*p)->printParLoopln(n, fout);
+                    printProfileStop(n, e, fout, true);
                 } else {
                     tab(n, fout); fout << "#pragma omp single ";
                     tab(n, fout); fout << "{ ";
+                    int e = printProfileStart(n+1, *p, fout);
                     (*p)->println(n+1, fout);
+                    printProfileStop(n+1, e, fout);
                     tab(n, fout); fout << "} ";
                 }
             }
@@ -607,7 +738,9 @@ void Klass::printLoopLevelOpenMP(int n, int lnum, const lset& L, ostream& fout)
         for (lset::const_iterator p =L.begin(); p!=L.end(); p++) {
             tab(n+1, fout); fout << "#pragma omp section ";
             tab(n+1, fout); fout << "{";
+            int e = printProfileStart(n+2, *p, fout);
             (*p)->println(n+2, fout);
+            printProfileStop(n+2, e, fout);
             tab(n+1, fout); fout << "} ";
         }
         tab(n, fout); fout << "} ";
@@ -615,7 +748,9 @@ void Klass::printLoopLevelOpenMP(int n, int lnum, const lset& L, ostream& fout)
         tab(n, fout); fout << "#pragma omp single ";
         tab(n, fout); fout << "{ ";
             for (lset::const_iterator p =L.begin(); p!=L.end(); p++) {
+                int e = printProfileStart(n+1, *p, fout);
                 (*p)->println(n+1, fout);
+                printProfileStop(n+1, e, fout);
             }
         tab(n, fout); fout << "} ";
     }
@@ -630,8 +765,10 @@ void Klass::printLastLoopLevelScheduler(int n, int lnum, const lset& L, ostream&
     if (nonRecursiveLevel(L) && L.size() == 1 && !(*L.begin())->isEmpty()) {
 
         lset::const_iterator p =L.begin();
-        tab(n, fout); fout << "case " << gTaskCount++ << ": { ";
+        tab(n, fout); fout << "case " << gGlobal->gTaskCount++ << ": { ";
+        int e = printProfileStart(n+1, *p, fout);
         (*p)->println(n+1, fout);
+        printProfileStop(n+1, e, fout);
         tab(n+1, fout); fout << "tasknum = LAST_TASK_INDEX;";
         tab(n+1, fout); fout << "break;";
         tab(n, fout); fout << "} ";
@@ -639,8 +776,10 @@ void Klass::printLastLoopLevelScheduler(int n, int lnum, const lset& L, ostream&
     } else if (L.size() > 1) {
 
         for (lset::const_iterator p =L.begin(); p!=L.end(); p++) {
-            tab(n, fout); fout << "case " << gTaskCount++ << ": { ";
+            tab(n, fout); fout << "case " << gGlobal->gTaskCount++ << ": { ";
+            int e = printProfileStart(n+1, *p, fout);
             (*p)->println(n+1, fout);
+            printProfileStop(n+1, e, fout);
             tab(n+1, fout); fout << "fGraph.ActivateOneOutputTask(taskqueue, LAST_TASK_INDEX, tasknum);";
             tab(n+1, fout); fout << "break;";
             tab(n, fout); fout << "} ";
@@ -649,8 +788,10 @@ void Klass::printLastLoopLevelScheduler(int n, int lnum, const lset& L, ostream&
     } else if (L.size() == 1 && !(*L.begin())->isEmpty()) {
 
         lset::const_iterator p =L.begin();
-        tab(n, fout); fout << "case " << gTaskCount++ << ": { ";
+        tab(n, fout); fout << "case " << gGlobal->gTaskCount++ << ": { ";
+        int e = printProfileStart(n+1, *p, fout);
         (*p)->println(n+1, fout);
+        printProfileStop(n+1, e, fout);
         tab(n+1, fout); fout << "tasknum = LAST_TASK_INDEX;";
         tab(n+1, fout); fout << "break;";
         tab(n, fout); fout << "} ";
@@ -660,8 +801,10 @@ void Klass::printLastLoopLevelScheduler(int n, int lnum, const lset& L, ostream&
 
 void Klass::printOneLoopScheduler(lset::const_iterator p, int n, ostream& fout)
 {
-    tab(n, fout); fout << "case " << gTaskCount++ << ": { ";
+    tab(n, fout); fout << "case " << gGlobal->gTaskCount++ << ": { ";
+    int e = printProfileStart(n+1, *p, fout);
     (*p)->println(n+1, fout);
+    printProfileStop(n+1, e, fout);
 
     // One output only
     if ((*p)->fForwardLoopDependencies.size() == 1) {
@@ -731,6 +874,113 @@ void Klass::printLoopLevelScheduler(int n, int lnum, const lset& L, ostream& fou
     }
 }
 
+/**
+ * The definitions computed by a loop (-prof) : the ones of its signals, of
+ * its recursive groups and of its extra loops
+ */
+static void collectLoopNames(Loop* l, set<string>& names)
+{
+    Tree id;
+    names.insert(l->fNames.begin(), l->fNames.end());
+    for (Tree S = l->fRecSymbolSet; !isNil(S); S = tl(S)) {
+        if (getDefinitionName(hd(S), id)) names.insert(tree2str(id));
+    }
+    for (list<Loop*>::const_iterator p = l->fExtraLoops.begin(); p != l->fExtraLoops.end(); p++) {
+        collectLoopNames(*p, names);
+    }
+}
+
+/**
+ * Print the start of the measure of a loop, or of lanes printed as a single
+ * loop (-prof). The entry of the profile is created on the first print of the
+ * loop and named after the definitions it computes.
+ * @return the entry of the profile, -1 if the loop is not measured
+ */
+int Klass::printProfileStart(int n, const vector<Loop*>& loops, ostream& fout)
+{
+    if (!gGlobal->gProfSwitch || loops[0]->isEmpty()) return -1;
+
+    map<Loop*, int>::iterator p = fProfileIndex.find(loops[0]);
+    int e;
+    if (p != fProfileIndex.end()) {
+        e = p->second;
+    } else {
+        set<string> names;
+        for (unsigned int k = 0; k < loops.size(); k++) collectLoopNames(loops[k], names);
+        string name;
+        for (set<string>::iterator s = names.begin(); s != names.end(); s++) {
+            name += (name.empty() ? "" : ", ") + *s;
+        }
+        if (name.empty()) name = (loops[0] == fTopLoop) ? "compute" : subst("loop$0", T(int(fProfileNames.size())));
+        e = fProfileIndex[loops[0]] = int(fProfileNames.size());
+        fProfileNames.push_back(name);
+    }
+    tab(n, fout); fout << "unsigned long long profstart" << e << " = FAUSTPROFCYCLES();";
+    return e;
+}
+
+/**
+ * Print the end of the measure of a loop (-prof). With master, only the
+ * master thread of an OpenMP team records the measure.
+ */
+void Klass::printProfileStop(int n, int entry, ostream& fout, bool master)
+{
+    if (entry < 0) return;
+
+    if (master) {
+        tab(n, fout); fout << "#pragma omp master";
+        tab(n, fout); fout << "{";
+        n++;
+    }
+    tab(n, fout); fout << "fProfile[" << entry << "].fCycles += FAUSTPROFCYCLES() - profstart" << entry << ";";
+    tab(n, fout); fout << "fProfile[" << entry << "].fSamples += count;";
+    if (master) {
+        tab(n-1, fout); fout << "}";
+    }
+}
+
+/**
+ * The loops computing the same definitions (the voices of a par, the
+ * lanes ...) have the same name : an index is added to these names,
+ * "name #1", "name #2" ..., in the order of the entries (-prof)
+ */
+void Klass::uniqueProfileNames()
+{
+    map<string, int> count, index;
+    for (unsigned int i = 0; i < fProfileNames.size(); i++) count[fProfileNames[i]]++;
+    for (unsigned int i = 0; i < fProfileNames.size(); i++) {
+        string& name = fProfileNames[i];
+        if (count[name] > 1) name = subst("$0 #$1", name, T(++index[name]));
+    }
+}
+
+/**
+ * Print the methods reading and clearing the profile (-prof)
+ */
+void Klass::printProfileMethods(int n, ostream& fout)
+{
+    int size = int(fProfileNames.size());
+
+    tab(n,fout); fout << "// cycles spent in each loop of compute() since the last resetProfile()";
+    tab(n,fout); fout << "int getProfile(const FaustProfile** profile) \t{ *profile = fProfile; return " << size << "; }";
+    tab(n,fout); fout << "void resetProfile() {";
+        tab(n+1,fout); fout << "for (int i=0; i<" << size << "; i++) { fProfile[i].fCycles = 0; fProfile[i].fSamples = 0; }";
+    tab(n,fout); fout << "}";
+}
+
+/**
+ * A C string literal
+ */
+static string cString(const string& s)
+{
+    string r = "\"";
+    for (unsigned int i = 0; i < s.size(); i++) {
+        if (s[i] == '"' || s[i] == '\\') r += '\\';
+        r += s[i];
+    }
+    return r + "\"";
+}
+
 /**
  * Print a full C++ class corresponding to a Faust dsp
  */
@@ -742,13 +992,60 @@ void Klass::println(int n, ostream& fout)
     fout << "#define FAUSTCLASS "<< fKlassName << endl;
     fout << "#endif" << endl;
 
-    if (gSchedulerSwitch) {
+    if (gGlobal->gCacheLine > 0) {
+        fout << "#ifndef FAUSTALIGN" << endl;
+        fout << "#ifdef _MSC_VER" << endl;
+        fout << "#define FAUSTALIGN __declspec(align(" << gGlobal->gCacheLine << "))" << endl;
+        fout << "#else" << endl;
+        fout << "#define FAUSTALIGN __attribute__((aligned(" << gGlobal->gCacheLine << ")))" << endl;
+        fout << "#endif" << endl;
+        fout << "#endif" << endl;
+    }
+
+    // the compute method is printed first : it numbers the entries of the profile
+    stringstream compute;
+    printComputeMethod(n, compute);
+
+    if (gGlobal->gProfSwitch) {
+        // the cycle counter of the processor, or a clock in nanoseconds where there is none
+        fout << "#ifndef FAUSTPROFILE" << endl;
+        fout << "#define FAUSTPROFILE" << endl;
+        fout << "#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))" << endl;
+        fout << "#include <intrin.h>" << endl;
+        fout << "#define FAUSTPROFCYCLES() __rdtsc()" << endl;
+        fout << "#elif defined(__i386__) || defined(__x86_64__)" << endl;
+        fout << "#include <x86intrin.h>" << endl;
+        fout << "#define FAUSTPROFCYCLES() __rdtsc()" << endl;
+        fout << "#else" << endl;
+        fout << "#include <time.h>" << endl;
+        fout << "static inline unsigned long long faustProfClock() {" << endl;
+        fout << "\tstruct timespec t; clock_gettime(CLOCK_MONOTONIC, &t);" << endl;
+        fout << "\treturn t.tv_sec * 1000000000ULL + t.tv_nsec;" << endl;
+        fout << "}" << endl;
+        fout << "#define FAUSTPROFCYCLES() faustProfClock()" << endl;
+        fout << "#endif" << endl;
+        fout << "struct FaustProfile {" << endl;
+        fout << "\tconst char*\t\t\tfName;\t\t// the Faust definitions computed by the loop" << endl;
+        fout << "\tunsigned long long\tfCycles;" << endl;
+        fout << "\tunsigned long long\tfSamples;" << endl;
+        fout << "};" << endl;
+        fout << "#endif" << endl;
+
+        addDeclCode(subst("FaustProfile \tfProfile[$0];", T(max(1, int(fProfileNames.size())))));
+        uniqueProfileNames();
+        for (unsigned int i = 0; i < fProfileNames.size(); i++) {
+            addInitCode(subst("fProfile[$0].fName = $1;", T(int(i)), cString(fProfileNames[i])));
+        }
+        addInitCode("resetProfile();");
+    }
+
+    if (gGlobal->gSchedulerSwitch) {
         tab(n,fout); fout << "class " << fKlassName << " : public " << fSuperKlassName << ", public Runnable {";
     } else {
         tab(n,fout); fout << "class " << fKlassName << " : public " << fSuperKlassName << " {";
     }
 
-    if (gUIMacroSwitch) {
+    if (gGlobal->gUIMacroSwitch) {
         tab(n,fout); fout << "  public:";
     } else {
 	    tab(n,fout); fout << "  private:";
@@ -756,13 +1053,19 @@ void Klass::println(int n, ostream& fout)
 
     for (k = fSubClassList.begin(); k != fSubClassList.end(); k++) 	(*k)->println(n+1, fout);
 
-    printlines(n+1, fDeclCode, fout);
+    printDeclarations(n+1, fout);
 
 	tab(n,fout); fout << "  public:";
 
-    printMetadata(n+1, gMetaDataSet, fout);
+    printMetadata(n+1, gGlobal->gMetaDataSet, fout);
 
-    if (gSchedulerSwitch) {
+    if (gGlobal->gSchedulerSwitch) {
+        // the thread pool is shared and reference counted : a copy takes its own reference,
+        // released by the destructor as the one taken by init()
+        tab(n+1,fout); fout << fKlassName << "() {}";
+        tab(n+1,fout); fout << fKlassName << "(const " << fKlassName << "& d) \t{ "
+                            << "*this = d; fThreadPool = DSPThreadPool::Init()"
+                            << "; }";
         tab(n+1,fout); fout << "virtual ~" << fKlassName << "() \t{ "
                             << "DSPThreadPool::Destroy()"
                             << "; }";
@@ -776,7 +1079,17 @@ void Klass::println(int n, ostream& fout)
                     << "; }";
 
     tab(n+1,fout); fout << "static void classInit(int samplingFreq) {";
+    if (fStaticInitCode.size() > 0) {
+        // the static tables are shared by all the instances : only fill them when the sampling rate changes.
+        // This is not a lock, classInit (and so init) must not run concurrently with another classInit,
+        // nor with the compute of an instance at another rate (see sndfile.cpp)
+        tab(n+2,fout); fout << "static int fClassInitRate = 0;";
+        tab(n+2,fout); fout << "if (samplingFreq == fClassInitRate) return;";
+    }
         printlines (n+2, fStaticInitCode, fout);
+    if (fStaticInitCode.size() > 0) {
+        tab(n+2,fout); fout << "fClassInitRate = samplingFreq;";
+    }
     tab(n+1,fout); fout << "}";
 
     tab(n+1,fout); fout << "virtual void instanceInit(int samplingFreq) {";
@@ -789,19 +1102,31 @@ void Klass::println(int n, ostream& fout)
          tab(n+2,fout); fout << "instanceInit(samplingFreq);";
     tab(n+1,fout); fout << "}";
 
+    // clear the state (delay lines, recursions, writable tables) without recomputing the constants
+    tab(n+1,fout); fout << "virtual void reset() {";
+        printlines (n+2, fClearCode, fout);
+    tab(n+1,fout); fout << "}";
+
+    // a copy of an initialized instance is ready to compute, without init()
+    tab(n+1,fout); fout << "virtual " << fKlassName << "* clone() \t{ return new " << fKlassName << "(*this); }";
+
 
     tab(n+1,fout); fout << "virtual void buildUserInterface(UI* interface) {";
         printlines (n+2, fUICode, fout);
     tab(n+1,fout); fout << "}";
 
-    printComputeMethod(n, fout);
+    if (gGlobal->gProfSwitch) printProfileMethods(n+1, fout);
+
+    fout << compute.str();
+
+    if (gGlobal->gBatchInstances > 0) printBatchClass(n+1, fout);
 
 	tab(n,fout); fout << "};\n" << endl;
 
 	printlines(n, fStaticFields, fout);
 
 	// generate user interface macros if needed
-	if (gUIMacroSwitch) {
+	if (gGlobal->gUIMacroSwitch) {
 		tab(n, fout); fout << "#ifdef FAUST_UIMACROS";
             tab(n+1,fout); fout << "#define FAUST_INPUTS " << fNumInputs;
             tab(n+1,fout); fout << "#define FAUST_OUTPUTS " << fNumOutputs;
@@ -819,15 +1144,15 @@ void Klass::println(int n, ostream& fout)
  */
 void Klass::printComputeMethod(int n, ostream& fout)
 {
-    if (gSchedulerSwitch) {
+    if (gGlobal->gSchedulerSwitch) {
         printComputeMethodScheduler (n, fout);
-    } else if (gOpenMPSwitch) {
+    } else if (gGlobal->gOpenMPSwitch) {
         printComputeMethodOpenMP (n, fout);
-    } else if (gVectorSwitch) {
-        switch (gVectorLoopVariant) {
+    } else if (gGlobal->gVectorSwitch) {
+        switch (gGlobal->gVectorLoopVariant) {
             case 0 : printComputeMethodVectorFaster(n, fout); break;
             case 1 : printComputeMethodVectorSimple(n, fout); break;
-            default : cerr << "unknown loop variant " << gVectorLoopVariant << endl; exit(1);
+            default : gGlobal->gErrors << "unknown loop variant " << gGlobal->gVectorLoopVariant << endl; throw faustexception();
         }
    } else {
         printComputeMethodScalar(n, fout);
@@ -845,6 +1170,220 @@ void Klass::printComputeMethodScalar(int n, ostream& fout)
     tab(n+1,fout); fout << "}";
 }
 
+/**
+ * Rewrites a line of code of the class for the instance k of the batch class.
+ * The fields become arrays indexed by k after their own indexes, the block
+ * variables and the buffer pointers (locals) become arrays indexed by k.
+ */
+static string batchCode(const string& code, const set<string>& fields, const set<string>& locals)
+{
+    string  r;
+    size_t  i = 0, n = code.size();
+
+    while (i < n) {
+        char c = code[i];
+        if (code.compare(i, 2, "//") == 0) {
+            r += code.substr(i); i = n;
+        } else if (c == '"' || c == '\'') {
+            size_t j = i+1;
+            while (j < n && code[j] != c) j += (code[j] == '\\') ? 2 : 1;
+            j = min(j+1, n);
+            r += code.substr(i, j-i); i = j;
+        } else if (isdigit(c)) {
+            size_t j = i;
+            while (j < n && (isalnum(code[j]) || code[j] == '.' || code[j] == '_')) j++;
+            r += code.substr(i, j-i); i = j;
+        } else if (isalpha(c) || c == '_') {
+            size_t j = i;
+            while (j < n && (isalnum(code[j]) || code[j] == '_')) j++;
+            string id = code.substr(i, j-i);
+            bool member = (i > 0 && code[i-1] == '.') || (i > 1 && code.compare(i-2, 2, "->") == 0);
+            r += id; i = j;
+            if (member) {
+                // a member of an object
+            } else if (locals.count(id)) {
+                r += "[k]";
+            } else if (fields.count(id)) {
+                while (i < n && code[i] == '[') {
+                    int     depth = 0;
+                    size_t  e = i;
+                    do { depth += (code[e] == '[') - (code[e] == ']'); e++; } while (e < n && depth > 0);
+                    r += "[" + batchCode(code.substr(i+1, e-i-2), fields, locals) + "]";
+                    i = e;
+                }
+                r += "[k]";
+            }
+        } else {
+            r += c; i++;
+        }
+    }
+    return r;
+}
+
+/**
+ * Splits the declaration of a field, "type \tname[dims];", in its name and
+ * its dimensions. Returns false for the static fields.
+ */
+static bool splitField(const string& decl, string& name, vector<string>& dims)
+{
+    if (decl.compare(0, 7, "static ") == 0) return false;
+    size_t e = decl.find('[');
+    if (e == string::npos) e = decl.size()-1;
+    size_t b = decl.find_last_of(" \t*", e) + 1;
+    name = decl.substr(b, e-b);
+    dims.clear();
+    while (decl[e] == '[') {
+        size_t f = decl.find(']', e);
+        dims.push_back(decl.substr(e+1, f-e-1));
+        e = f+1;
+    }
+    return true;
+}
+
+/**
+ * Prints the nested batch class of the -bi option : gBatchInstances instances
+ * of the class whose fields are interleaved, each field being an array with
+ * one element per instance. compute_batch() computes each sample of all the
+ * instances in an inner loop, so that the recursions of the instances, being
+ * independent, are vectorized, and a host of many instances of the same dsp
+ * doesn't have to call the compute() method of each one. The instances
+ * beyond gBatchInstances are ignored.
+ */
+void Klass::printBatchClass(int n, ostream& fout)
+{
+    string          N = T(gGlobal->gBatchInstances);
+    set<string>     fields, locals;
+    list<string>    decls, copy, zoneDecls, zoneCode;
+    string          name;
+    vector<string>  dims;
+
+    // the fields, with their copy from an instance of the class
+    for (list<string>::iterator s = fDeclCode.begin(); s != fDeclCode.end(); s++) {
+        if (!splitField(*s, name, dims)) continue;
+        fields.insert(name);
+        decls.push_back(s->substr(0, s->size()-1) + "[" + N + "];");
+        string loops, index;
+        for (unsigned int j = 0; j < dims.size(); j++) {
+            string v = subst("j$0", T(int(j)));
+            loops += subst("for (int $0=0; $0<$1; $0++) ", v, dims[j]);
+            index += "[" + v + "]";
+        }
+        copy.push_back(subst("$0$1$2[k] = d.$1$2;", loops, name, index));
+    }
+
+    // the block code : the local declarations become arrays of the instances
+    locals.insert("input");
+    locals.insert("output");
+    list<string> zones;
+    zones.insert(zones.end(), fZone1Code.begin(), fZone1Code.end());
+    zones.insert(zones.end(), fZone2Code.begin(), fZone2Code.end());
+    zones.insert(zones.end(), fZone2bCode.begin(), fZone2bCode.end());
+    zones.insert(zones.end(), fZone3Code.begin(), fZone3Code.end());
+    for (list<string>::iterator s = zones.begin(); s != zones.end(); s++) {
+        size_t eq  = s->find(" = ");
+        string lhs = s->substr(0, (eq == string::npos) ? s->size()-1 : eq);
+        size_t b   = lhs.find_last_of(" \t*");
+        if (b == string::npos || lhs.find('(') != string::npos) {
+            zoneCode.push_back(*s);
+        } else {
+            size_t e = lhs.find('[', b);
+            if (e == string::npos) e = lhs.size();
+            name = lhs.substr(b+1, e-b-1);
+            locals.insert(name);
+            zoneDecls.push_back(lhs.substr(0, e) + "[" + N + "]" + lhs.substr(e) + ";");
+            if (eq != string::npos) zoneCode.push_back(name + s->substr(eq));
+        }
+    }
+
+    tab(n,fout); fout << "class batch {";
+    tab(n,fout); fout << "  private:";
+        printlines(n+1, decls, fout);
+    tab(n,fout); fout << "  public:";
+
+    tab(n+1,fout); fout << "void init(int samplingFreq) {";
+        tab(n+2,fout); fout << fKlassName << "* d = new " << fKlassName << "();";
+        tab(n+2,fout); fout << "d->init(samplingFreq);";
+        tab(n+2,fout); fout << "for (int k=0; k<" << N << "; k++) setInstance(k, *d);";
+        tab(n+2,fout); fout << "delete d;";
+    tab(n+1,fout); fout << "}";
+
+    // the state and the controls of the instance k are copied from d
+    tab(n+1,fout); fout << "void setInstance(int k, const " << fKlassName << "& d) {";
+        printlines(n+2, copy, fout);
+    tab(n+1,fout); fout << "}";
+
+    tab(n+1,fout); fout << "void buildUserInterface(int k, UI* interface) {";
+    for (list<string>::iterator s = fUICode.begin(); s != fUICode.end(); s++) {
+        tab(n+2,fout); fout << batchCode(*s, fields, locals);
+    }
+    tab(n+1,fout); fout << "}";
+
+    // input[k] and output[k] are the buffers of the instance k, at most N instances are computed
+    tab(n+1,fout); fout << subst("void compute_batch(int count, int instances, $0*** input, $0*** output) {", xfloat());
+        tab(n+2,fout); fout << "if (instances > " << N << ") instances = " << N << ";";
+        printlines(n+2, zoneDecls, fout);
+        tab(n+2,fout); fout << "for (int k=0; k<instances; k++) {";
+        for (list<string>::iterator s = zoneCode.begin(); s != zoneCode.end(); s++) {
+            tab(n+3,fout); fout << batchCode(*s, fields, locals);
+        }
+        tab(n+2,fout); fout << "}";
+        tab(n+2,fout); fout << "for (int i=0; i<count; i++) {";
+            tab(n+3,fout); fout << "for (int k=0; k<instances; k++) {";
+            list<string>* code[] = { &fTopLoop->fPreCode, &fTopLoop->fExecCode, &fTopLoop->fPostCode };
+            for (int c = 0; c < 3; c++) {
+                for (list<string>::iterator s = code[c]->begin(); s != code[c]->end(); s++) {
+                    tab(n+4,fout); fout << batchCode(*s, fields, locals);
+                }
+            }
+            tab(n+3,fout); fout << "}";
+        tab(n+2,fout); fout << "}";
+    tab(n+1,fout); fout << "}";
+
+    tab(n,fout); fout << "};";
+}
+
+/**
+ * The vector size in the code of the compute method : a template parameter
+ * when several vector sizes are compiled (-avs), the constant gVecSize otherwise
+ */
+string vecSizeName()
+{
+    return (gGlobal->gMinVecSize > 0 && gGlobal->gMinVecSize <= gGlobal->gVecSize/2 && !gGlobal->gSchedulerSwitch) ? "vsize" : T(gGlobal->gVecSize);
+}
+
+/**
+ * The vector compute method, or with several vector sizes, the compute
+ * method template instantiated by printComputeDispatch
+ */
+void Klass::printComputeHeader(int n, ostream& fout)
+{
+    if (vecSizeName() == "vsize") {
+        tab(n+1,fout); fout << "template <int vsize>";
+        tab(n+1,fout); fout << subst("void computeBlocks (int fullcount, $0** input, $0** output) {", xfloat());
+    } else {
+        tab(n+1,fout); fout << subst("virtual void compute (int fullcount, $0** input, $0** output) {", xfloat());
+    }
+}
+
+/**
+ * Compute the buffer with the largest vector size not larger than the buffer.
+ * The sizes are gVecSize, gVecSize/2 ... down to gMinVecSize. The delay lines
+ * are sized for gVecSize, the state doesn't depend on the vector size.
+ */
+void Klass::printComputeDispatch(int n, ostream& fout)
+{
+    if (vecSizeName() != "vsize") return;
+
+    tab(n+1,fout); fout << subst("virtual void compute (int fullcount, $0** input, $0** output) {", xfloat());
+    int vs = gGlobal->gVecSize;
+    for (; vs/2 >= gGlobal->gMinVecSize; vs /= 2) {
+        tab(n+2,fout); fout << ((vs == gGlobal->gVecSize) ? "if" : "else if") << " (fullcount >= " << vs << ") "
+                            << "computeBlocks<" << vs << ">(fullcount, input, output);";
+    }
+    tab(n+2,fout); fout << "else computeBlocks<" << vs << ">(fullcount, input, output);";
+    tab(n+1,fout); fout << "}";
+}
+
 /**
  * Uses loops of constant gVecSize boundary in order to provide the
  * C compiler with more optimisation opportunities. Improves performances
@@ -852,17 +1391,19 @@ void Klass::printComputeMethodScalar(int n, ostream& fout)
  */
 void Klass::printComputeMethodVectorFaster(int n, ostream& fout)
 {
+    string vs = vecSizeName();
+
     // in vector mode we need to split loops in smaller pieces not larger
     // than gVecSize
-    tab(n+1,fout); fout << subst("virtual void compute (int fullcount, $0** input, $0** output) {", xfloat());
+    printComputeHeader(n, fout);
         printlines(n+2, fZone1Code, fout);
         printlines(n+2, fZone2Code, fout);
         printlines(n+2, fZone2bCode, fout);
 
         tab(n+2,fout); fout << "int index;";
-        tab(n+2,fout); fout << "for (index = 0; index <= fullcount - " << gVecSize << "; index += " << gVecSize << ") {";
-            tab(n+3,fout); fout << "// compute by blocks of " << gVecSize << " samples";
-            tab(n+3,fout); fout << "const int count = " << gVecSize << ";";
+        tab(n+2,fout); fout << "for (index = 0; index <= fullcount - " << vs << "; index += " << vs << ") {";
+            tab(n+3,fout); fout << "// compute by blocks of " << vs << " samples";
+            tab(n+3,fout); fout << "const int count = " << vs << ";";
             printlines (n+3, fZone3Code, fout);
             printLoopGraphVector(n+3,fout);
         tab(n+2,fout); fout << "}";
@@ -874,6 +1415,7 @@ void Klass::printComputeMethodVectorFaster(int n, ostream& fout)
              printLoopGraphVector(n+3,fout);
         tab(n+2,fout); fout << "}";
     tab(n+1,fout); fout << "}";
+    printComputeDispatch(n, fout);
 }
 
 /**
@@ -881,18 +1423,21 @@ void Klass::printComputeMethodVectorFaster(int n, ostream& fout)
  */
 void Klass::printComputeMethodVectorSimple(int n, ostream& fout)
 {
+    string vs = vecSizeName();
+
     // in vector mode we need to split loops in smaller pieces not larger
     // than gVecSize
-    tab(n+1,fout); fout << subst("virtual void compute (int fullcount, $0** input, $0** output) {", xfloat());
+    printComputeHeader(n, fout);
         printlines(n+2, fZone1Code, fout);
         printlines(n+2, fZone2Code, fout);
         printlines(n+2, fZone2bCode, fout);
-        tab(n+2,fout); fout << "for (int index = 0; index < fullcount; index += " << gVecSize << ") {";
-            tab(n+3,fout); fout << "int count = min("<< gVecSize << ", fullcount-index);";
+        tab(n+2,fout); fout << "for (int index = 0; index < fullcount; index += " << vs << ") {";
+            tab(n+3,fout); fout << "int count = min("<< vs << ", fullcount-index);";
             printlines (n+3, fZone3Code, fout);
             printLoopGraphVector(n+3,fout);
         tab(n+2,fout); fout << "}";
     tab(n+1,fout); fout << "}";
+    printComputeDispatch(n, fout);
 }
 
 /*
@@ -952,9 +1497,11 @@ void Klass::printComputeMethodVectorFix1 (int n, ostream& fout)
 
 void Klass::printComputeMethodOpenMP(int n, ostream& fout)
 {
+    string vs = vecSizeName();
+
     // in openMP mode we need to split loops in smaller pieces not larger
     // than gVecSize and add OpenMP pragmas
-    tab(n+1,fout); fout << subst("virtual void compute (int fullcount, $0** input, $0** output) {", xfloat());
+    printComputeHeader(n, fout);
         printlines(n+2, fZone1Code, fout);
         printlines(n+2, fZone2Code, fout);
         tab(n+2,fout); fout << "#pragma omp parallel";
@@ -968,8 +1515,8 @@ void Klass::printComputeMethodOpenMP(int n, ostream& fout)
                 tab(n+3,fout); fout << "}";
             }
 
-            tab(n+3,fout); fout << "for (int index = 0; index < fullcount; index += " << gVecSize << ") {";
-            tab(n+4,fout); fout << "int count = min ("<< gVecSize << ", fullcount-index);";
+            tab(n+3,fout); fout << "for (int index = 0; index < fullcount; index += " << vs << ") {";
+            tab(n+4,fout); fout << "int count = min ("<< vs << ", fullcount-index);";
 
             printlines (n+4, fZone3Code, fout);
             printLoopGraphOpenMP (n+4,fout);
@@ -978,6 +1525,7 @@ void Klass::printComputeMethodOpenMP(int n, ostream& fout)
 
         tab(n+2,fout); fout << "}";
     tab(n+1,fout); fout << "}";
+    printComputeDispatch(n, fout);
 }
 
 /*
@@ -1064,9 +1612,9 @@ void Klass::printComputeMethodScheduler (int n, ostream& fout)
 
         tab(n+2,fout); fout << "StartMeasure();";
 
-        tab(n+2,fout); fout << "for (fIndex = 0; fIndex < fullcount; fIndex += " << gVecSize << ") {";
+        tab(n+2,fout); fout << "for (fIndex = 0; fIndex < fullcount; fIndex += " << gGlobal->gVecSize << ") {";
 
-        tab(n+3,fout); fout << "fFullCount = min ("<< gVecSize << ", fullcount-fIndex);";
+        tab(n+3,fout); fout << "fFullCount = min ("<< gGlobal->gVecSize << ", fullcount-fIndex);";
         tab(n+3,fout); fout << "TaskQueue::Init();";
         printlines (n+3, fZone2cCode, fout);
 
@@ -1111,7 +1659,7 @@ void Klass::printComputeMethodScheduler (int n, ostream& fout)
                         tab(n+6, fout); fout << "break;";
                     tab(n+5, fout); fout << "} ";
 
-                    gTaskCount = START_TASK_INDEX;
+                    gGlobal->gTaskCount = START_TASK_INDEX;
 
                     // DSP tasks
                     printLoopGraphScheduler (n+5,fout);
@@ -41,6 +41,7 @@ using namespace std;
 #include <list>
 #include <set>
 #include <map>
+#include <vector>
 #include "sigtype.hh"
 #include "smartpointer.hh"
 #include "tlib.hh"
@@ -51,16 +52,11 @@ using namespace std;
 
 #include "loop.hh"
 #include "graphSorting.hh"
+#include "global.hh"
 
 class Klass //: public Target
 {
 
-protected:
-    // we make it global because several classes may need
-    // power def but we want the code to be generated only once
-    static bool     fNeedPowerDef;              ///< true when faustpower definition is needed
-
-
  protected:
     
     Klass*			fParentKlass;               ///< Klass in which this Klass is embedded, void if toplevel Klass
@@ -77,9 +73,11 @@ protected:
 	list<Klass* >		fSubClassList;
 
 	list<string>		fDeclCode;
+	list<Loop*>			fDeclLoops;				///< loops open when the fields were declared
 	list<string>		fStaticInitCode;		///< static init code for class constant tables
 	list<string>		fStaticFields;			///< static fields after class
 	list<string>		fInitCode;
+	list<string>		fClearCode;				///< state initialization code repeated by reset()
 	list<string>		fUICode;
 	list<string>		fUIMacro;
 
@@ -102,6 +100,9 @@ protected:
     Loop*               fTopLoop;               ///< active loops currently open
     property<Loop*>     fLoopProperty;          ///< loops used to compute some signals
 
+    map<Loop*, int>     fProfileIndex;          ///< entry of the profile of each printed loop (-prof)
+    vector<string>      fProfileNames;          ///< name of each entry of the profile (-prof)
+
     bool                fVec;
 
  public:
@@ -114,7 +115,7 @@ protected:
 
 	virtual ~Klass() 						{}
 
-    void    setParentKlass(Klass* parent)       { std::cerr << this << " setParentKlass(" << parent << ")" << std::endl;
+    void    setParentKlass(Klass* parent)       { gGlobal->gErrors << this << " setParentKlass(" << parent << ")" << std::endl;
                                                   fParentKlass=parent; }
     Klass*  getParentKlass()                    { return fParentKlass; }
     Klass*  getTopParentKlass()                 { return (fParentKlass != 0) ? fParentKlass->getTopParentKlass() : this; }
@@ -138,7 +139,9 @@ protected:
 
 	void addLibrary (const string& str) 	{ fLibrarySet.insert(str); }
 
-    void rememberNeedPowerDef ()            { fNeedPowerDef = true; }
+    // global to the compilation because several classes may need
+    // power def but we want the code to be generated only once
+    void rememberNeedPowerDef ()            { gGlobal->gNeedPowerDef = true; }
 
 	void collectIncludeFile(set<string>& S);
 
@@ -146,10 +149,14 @@ protected:
 
     void addSubKlass (Klass* son)			{ fSubClassList.push_back(son); }
 
-	void addDeclCode (const string& str) 	{ fDeclCode.push_back(str); }
+	void addDeclCode (const string& str) 	{ fDeclCode.push_back(str); fDeclLoops.push_back(fTopLoop); }
 
 	void addInitCode (const string& str)	{ fInitCode.push_back(str); }
 
+	void addStateInitCode (const string& str)	{ fInitCode.push_back(str); fClearCode.push_back(str); }
+
+	void addResetCode (const string& str)	{ fClearCode.push_back(str); }
+
     void addStaticInitCode (const string& str)	{ fStaticInitCode.push_back(str); }
 
 	void addStaticFields (const string& str)	{ fStaticFields.push_back(str); }
@@ -179,13 +186,17 @@ protected:
     
     virtual void printComputeMethod (int n, ostream& fout);
     virtual void printComputeMethodScalar (int n, ostream& fout);
+    virtual void printBatchClass (int n, ostream& fout);
     virtual void printComputeMethodVectorFaster (int n, ostream& fout);
     virtual void printComputeMethodVectorSimple (int n, ostream& fout);
     virtual void printComputeMethodOpenMP (int n, ostream& fout);
+    virtual void printComputeHeader (int n, ostream& fout);
+    virtual void printComputeDispatch (int n, ostream& fout);
     virtual void printComputeMethodScheduler (int n, ostream& fout);
 
     virtual void printLoopGraphScalar(int n, ostream& fout);
     virtual void printLoopGraphVector(int n, ostream& fout);
+    virtual void printLanesSection(int n, ostream& fout, const lset& section);
     virtual void printLoopGraphOpenMP(int n, ostream& fout);
     virtual void printLoopGraphScheduler(int n, ostream& fout);
     virtual void printLoopGraphInternal(int n, ostream& fout);
@@ -199,7 +210,14 @@ protected:
     virtual void printOneLoopScheduler(lset::const_iterator p, int n, ostream& fout);
     virtual void printLoopLevelOpenMP(int n, int lnum, const lset& L, ostream& fout);
 
+    virtual int  printProfileStart(int n, const vector<Loop*>& loops, ostream& fout);
+    virtual int  printProfileStart(int n, Loop* l, ostream& fout)    { return printProfileStart(n, vector<Loop*>(1, l), fout); }
+    virtual void printProfileStop(int n, int entry, ostream& fout, bool master = false);
+    virtual void printProfileMethods(int n, ostream& fout);
+    virtual void uniqueProfileNames();
+
     virtual void printMetadata(int n, const map<Tree, set<Tree> >& S, ostream& fout);
+    virtual void printDeclarations(int n, ostream& fout);
 
 	virtual void printIncludeFile(ostream& fout);
 
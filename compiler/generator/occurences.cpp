@@ -62,8 +62,7 @@ int Occurences::getMaxDelay() const
 
 void OccMarkup::mark(Tree root)
 {
-	fRootTree = root;
-	fPropKey = tree(unique("OCCURENCES"));
+	start(root);
 
 	if (isList(root)) {
 		while (isList(root)) {
@@ -78,6 +77,19 @@ void OccMarkup::mark(Tree root)
 	}
 }
 
+void OccMarkup::start(Tree root)
+{
+	fRootTree = root;
+	fPropKey = tree(unique("OCCURENCES"));
+}
+
+Occurences* OccMarkup::create(Tree t, int v, int r)
+{
+	Occurences* occ = new Occurences(v,r);
+	setOcc(t, occ);
+	return occ;
+}
+
 Occurences* OccMarkup::retrieve(Tree t)
 {
 	Occurences* p = getOcc(t);
@@ -40,6 +40,8 @@ class OccMarkup
 
  public:
  	void 		mark(Tree root);						///< start markup of root tree with new unique key
+ 	void 		start(Tree root);						///< start markup of root tree, the occurences being set with create()
+	Occurences* create(Tree t, int v, int r);			///< attach new occurences of variability v and recursivness r to t
 	Occurences* retrieve(Tree t);						///< occurences of subtree t within root tree
 };
 
@@ -38,12 +38,15 @@ Compile a list of FAUST signals into a C++ class .
 
 
 #include <stdio.h>
+#include <assert.h>
 
 #include "compile_vect.hh"
 #include "compile_scal.hh"
 #include "sigtype.hh"
 #include "sigtyperules.hh"
 #include "sigprint.hh"
+#include "sigdag.hh"
+#include "recursivness.hh"
 
 
 
@@ -81,67 +84,59 @@ void ScalarCompiler::setSharingCount(Tree sig, int count)
 
 
 //------------------------------------------------------------------------------
-// Create a specific property key for the sharing count of subtrees of t
+// Annotate the subtrees of t with their sharing count and their occurences
+// (fOccMarkup), in a single pass over the uses of the post-order array of t.
+// The sharing count is the number of uses, plus one when the first use in
+// depth first order is a faster context (time sharing occurence).
 //------------------------------------------------------------------------------
 
-
 void ScalarCompiler::sharingAnalysis(Tree t)
 {
-	fSharingKey = shprkey(t);
-	if (isList(t)) {
-		while (isList(t)) {
-			sharingAnnotation(kSamp, hd(t));
-			t = tl(t);
-		}
-	} else {
-		sharingAnnotation(kSamp, t);
-	}
-}
+	SigDAG	dag(t);
+	int		n = dag.size();
 
+	fSharingKey = shprkey(t);
+	fOccMarkup.start(t);
 
+	vector<int>			v(n), r(n), count(n, 0);
+	vector<Occurences*>	occ(n);
 
-//------------------------------------------------------------------------------
-// Create a specific property key for the sharing count of subtrees of t
-//------------------------------------------------------------------------------
-void ScalarCompiler::sharingAnnotation(int vctxt, Tree sig)
-{
-	Tree	c, x, y, z;
-
-	//cerr << "START sharing annotation of " << *sig << endl;
-	int count = getSharingCount(sig);
+	for (int i=0; i<n; i++) {
+		v[i] = getCertifiedSigType(dag.fNodes[i])->variability();
+		r[i] = getRecursivness(dag.fNodes[i]);
+		occ[i] = fOccMarkup.create(dag.fNodes[i], v[i], r[i]);
+	}
 
-	if (count > 0) {
-		// it is not our first visit
-		setSharingCount(sig, count+1);
+	for (unsigned int k=0; k<dag.fRoots.size(); k++) {
+		int j = dag.fRoots[k];
+		count[j] += 1;
+		occ[j]->incOccurences(kSamp, 0, 0);
+	}
 
-	} else {
-		// it is our first visit,
-		int v = getCertifiedSigType(sig)->variability();
-
-		// check "time sharing" cases
-		if (v < vctxt) {
-			setSharingCount(sig, 2); 	// time sharing occurence : slower expression in faster context
-		} else {
-			setSharingCount(sig, 1);	// regular occurence
+	for (int i=0; i<n; i++) {
+		Tree x, y;
+		Tree sig = dag.fNodes[i];
+		int  d0 = 0;				// delay of the uses of the first branch
+		int  d1 = 0;				// delay of the uses of the second branch
+
+		if (isSigFixDelay(sig, x, y)) {
+			d0 = checkDelayInterval(getCertifiedSigType(y));
+			assert(d0 >= 0);
+		} else if (isSigPrefix(sig, x, y)) {
+			d1 = 1;
 		}
-
-		if (isSigSelect3(sig,c,y,x,z)) {
-			// make a special case for select3 implemented with real if
-			// because the c expression will be used twice in the C++
-			// translation
-			sharingAnnotation(v, c);
-			sharingAnnotation(v, c);
-			sharingAnnotation(v, x);
-			sharingAnnotation(v, y);
-			sharingAnnotation(v, z);
-		} else {
-			// Annotate the sub signals
-			vector<Tree> subsig;
-			int n = getSubSignals(sig, subsig);
-			if (n>0 && ! isSigGen(sig)) {
-				for (int i=0; i<n; i++) sharingAnnotation(v, subsig[i]);
-			}
+		for (int e = dag.fFirstEdge[i]; e < dag.fFirstEdge[i+1]; e++) {
+			int b = dag.fEdgeBranch[e];
+			int j = dag.fEdgeTarget[e];
+			count[j] += 1;
+			occ[j]->incOccurences(v[i], r[i], (b == 0) ? d0 : (b == 1) ? d1 : 0);
 		}
 	}
-	//cerr << "END sharing annotation of " << *sig << endl;
+
+	for (int i=0; i<n; i++) {
+		int u = dag.fDiscoverer[i];
+		int vctxt = (u < 0) ? int(kSamp) : v[u];
+		if (v[i] < vctxt) count[i] += 1;	// time sharing occurence : slower expression in faster context
+		setSharingCount(dag.fNodes[i], count[i]);
+	}
 }
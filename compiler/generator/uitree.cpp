@@ -23,6 +23,8 @@
  
 #include <sstream>
 #include "uitree.hh"
+#include "exception.hh"
+#include "global.hh"
 
 
 
@@ -33,10 +35,10 @@ static Tree getFolder (Tree folder, Tree ilabel);
 
 static void error(const char * s, Tree t)
 {
-	fprintf(stderr, "ERROR : %s (%p)\n", s, t);
+	gGlobal->gErrors << "ERROR : " << s << " (" << (void*)t << ")" << endl;
 }
 
-#define ERROR(s,t) error(s,t); exit(1)
+#define ERROR(s,t) error(s,t); throw faustexception()
 
 
 //------------------------------------------------------------------------------
@@ -148,7 +150,7 @@ Tree putFolder(Tree folder, Tree item)
 {
     Tree    label, content;
     
-    if ( ! isUiFolder(folder, label, content)) { fprintf(stderr, "ERROR in addFolder : not a folder\n"); }
+    if ( ! isUiFolder(folder, label, content)) { gGlobal->gErrors << "ERROR in addFolder : not a folder" << endl; }
     return uiFolder(label, updateKey(content, uiLabel(item), item));
 }
 
@@ -157,7 +159,7 @@ Tree addToFolder(Tree folder, Tree item)
 {
     Tree    label, content;
     
-    if ( ! isUiFolder(folder, label, content)) { fprintf(stderr, "ERROR in addFolder : not a folder\n"); }
+    if ( ! isUiFolder(folder, label, content)) { gGlobal->gErrors << "ERROR in addFolder : not a folder" << endl; }
     return uiFolder(label, addKey(content, uiLabel(item), item));
 }
 
@@ -165,7 +167,7 @@ Tree addToFolder(Tree folder, Tree item)
 Tree getFolder (Tree folder, Tree ilabel)
 {
 	Tree	flabel, content, item;
-	if (!isUiFolder(folder, flabel, content)) 	{ fprintf(stderr, "ERROR in getFolder : not a folder\n"); }
+	if (!isUiFolder(folder, flabel, content)) 	{ gGlobal->gErrors << "ERROR in getFolder : not a folder" << endl; }
 	if (findKey(content, ilabel, item)) {
 		return item;
 	} else {
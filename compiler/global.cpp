@@ -0,0 +1,142 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+#include <iostream>
+#include <string.h>
+#include "global.hh"
+
+THREAD_LOCAL global* gGlobal = 0;
+
+global::global() :
+	gErrors(cerr.rdbuf()),
+	gErrorCount(0),
+	yyfilename("????"),
+
+	yyerr(0),
+	gResult(0),
+	gResult2(0),
+	gExpandedDefList(0),
+
+	gHelpSwitch(false),
+	gVersionSwitch(false),
+	gDetailsSwitch(false),
+	gTimingSwitch(false),
+	gDrawSignals(false),
+	gShadowBlur(false),
+	gGraphSwitch(false),
+	gDrawPSSwitch(false),
+	gDrawSVGSwitch(false),
+	gPrintXMLSwitch(false),
+	gPrintJSONSwitch(false),
+	gPrintDocSwitch(false),
+	gLatexDocSwitch(true),
+	gStripDocSwitch(false),
+	gBalancedSwitch(0),
+	gFoldThreshold(25),
+	gMaxNameSize(40),
+	gSimpleNames(false),
+	gSimplifyDiagrams(false),
+	gLessTempSwitch(false),
+	gMaxCopyDelay(16),
+	gFIRMinTaps(0),
+	gConstTableSize(0),
+	gLinearRecSwitch(false),
+	gSIMDLanes(0),
+	gCacheLine(0),
+	gBatchInstances(0),
+	gProfSwitch(false),
+	gMixedPrecision(false),
+	gFastMath(0),
+	gPatternEvalMode(false),
+	gVectorSwitch(false),
+	gDeepFirstSwitch(false),
+	gVecSize(32),
+	gMinVecSize(0),
+	gVectorLoopVariant(0),
+	gOpenMPSwitch(false),
+	gOpenMPLoop(false),
+	gSchedulerSwitch(false),
+	gGroupTaskSwitch(false),
+	gUIMacroSwitch(false),
+	gDumpNorm(false),
+	gTimeout(120),
+	gFloatSize(1),
+	gPrintFileListSwitch(false),
+	gInlineArchSwitch(false),
+	gClassName("mydsp"),
+	gExportDSP(false),
+	gInPlace(false),
+	gLibCacheSwitch(false),
+
+	lIndex(0),
+
+	gBoxSlotNumber(0),
+	LD(1024, 512),
+	gDummyInput(10000),
+
+	gCurrentRound(0),
+	countInferences(0),
+	countMaximal(0),
+	countRecInferences(0),
+	countRecLowerBound(0),
+	countGlobalRounds(0),
+
+	gNeedPowerDef(false),
+	gTaskCount(0),
+	gNextFreeColor(1),
+
+	sFoldingFlag(false),
+	gDevSuffix(0),
+	gWriteDone(false),
+	gFileNum(0),
+
+	gDocDevSuffix(0),
+
+	gLstDependenciesSwitch(true),
+	gLstMdocTagsSwitch(true),
+	gLstDistributedSwitch(true)
+{
+#ifndef _WIN32
+	pthread_mutex_init(&gWriteMutex, 0);
+	pthread_cond_init(&gWriteCond, 0);
+#endif
+	memset(&gCompilationDate, 0, sizeof(gCompilationDate));
+}
+
+global::~global()
+{
+#ifndef _WIN32
+	pthread_cond_destroy(&gWriteCond);
+	pthread_mutex_destroy(&gWriteMutex);
+#endif
+}
+
+globalscope::globalscope(global* g) : fPrevious(gGlobal)
+{
+	gGlobal = g;
+	CTree::setSpace(&g->gTreeSpace);
+}
+
+globalscope::~globalscope()
+{
+	gGlobal = fPrevious;
+	CTree::setSpace(fPrevious ? &fPrevious->gTreeSpace : 0);
+}
@@ -0,0 +1,231 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+#ifndef __GLOBAL__
+#define __GLOBAL__
+
+#include <time.h>
+#include <string>
+#include <list>
+#include <map>
+#include <set>
+#include <stack>
+#include <queue>
+#include <vector>
+#include <ostream>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include "tlib.hh"
+#include "property.hh"
+#include "boxes.hh"
+#include "sourcereader.hh"
+#include "loopDetector.hh"
+#include "drawschema.hh"
+
+using namespace std;
+
+/**
+ * The state of one compilation : the options, what has been parsed and
+ * declared, and what the passes compute and memoize, the trees included.
+ * main() and compileFaust() make a new one for each compilation and make
+ * it current in the thread doing it, the compiler code finds it in gGlobal.
+ * Several compilations can then run at the same time in different threads,
+ * nothing being shared but the symbols and the trees made at static
+ * initialization (see TreeSpace), and the parser (one file at a time).
+ */
+class global
+{
+ public:
+
+	//-- the trees of the compilation, deleted with it
+	TreeSpace				gTreeSpace;
+
+	//-- diagnostics
+	ostream					gErrors;			// the errors, warnings, timings, ... on std::cerr, or the errors of compileFaust() (see libfaust.hh)
+	int						gErrorCount;
+	const char*				yyfilename;			// the file being parsed
+
+	//-- parser
+	int						yyerr;
+	Tree					gResult;
+	Tree					gResult2;
+	SourceReader			gReader;
+	map<Tree, set<Tree> >	gMetaDataSet;
+	tvec					gWaveForm;
+
+	//-- files and directories
+	string					gFaustSuperSuperDirectory;
+	string					gFaustSuperDirectory;
+	string					gFaustDirectory;
+	string					gMasterDocument;
+	string					gMasterDirectory;
+	string					gMasterName;
+	string					gDocName;
+	Tree					gExpandedDefList;
+
+	//-- command line arguments
+	bool					gHelpSwitch;
+	bool					gVersionSwitch;
+	bool					gDetailsSwitch;
+	bool					gTimingSwitch;
+	bool					gDrawSignals;
+	bool					gShadowBlur;		// note: svg2pdf doesn't like the blur filter
+	bool					gGraphSwitch;
+	bool					gDrawPSSwitch;
+	bool					gDrawSVGSwitch;
+	bool					gPrintXMLSwitch;
+	bool					gPrintJSONSwitch;
+	bool					gPrintDocSwitch;
+	bool					gLatexDocSwitch;	// Only LaTeX outformat is handled for the moment.
+	bool					gStripDocSwitch;	// Strip <mdoc> content from doc listings.
+	int						gBalancedSwitch;
+	int						gFoldThreshold;		// max diagram complexity before folding
+	int						gMaxNameSize;
+	bool					gSimpleNames;
+	bool					gSimplifyDiagrams;
+	bool					gLessTempSwitch;
+	int						gMaxCopyDelay;
+	int						gFIRMinTaps;		// min number of taps to compile a sum as a FIR filter (0 = disabled)
+	int						gConstTableSize;	// max size of the constant tables computed at compile time (0 = disabled)
+	bool					gLinearRecSwitch;	// block-parallel evaluation of linear recursions (vector mode)
+	int						gSIMDLanes;			// max number of identical recursive loops computed together (vector mode)
+	int						gCacheLine;			// size of the cache lines used to group the fields of the class (0 = disabled)
+	int						gBatchInstances;	// number of instances of the nested batch class (0 = no batch class)
+	bool					gProfSwitch;		// count the cycles spent in each loop of the compute method
+	bool					gMixedPrecision;	// sensitive recursions in double precision, the rest in single precision
+	int						gFastMath;			// accuracy tier of the approximations of the math functions (0 = math.h functions)
+	string					gArchFile;
+	string					gOutputFile;
+	list<string>			gInputFiles;
+	bool					gPatternEvalMode;
+	bool					gVectorSwitch;
+	bool					gDeepFirstSwitch;
+	int						gVecSize;
+	int						gMinVecSize;		// with -avs, the smallest of the vector sizes compiled
+	int						gVectorLoopVariant;
+	bool					gOpenMPSwitch;
+	bool					gOpenMPLoop;
+	bool					gSchedulerSwitch;
+	bool					gGroupTaskSwitch;
+	bool					gUIMacroSwitch;
+	bool					gDumpNorm;
+	int						gTimeout;			// time out to abort compiler (in seconds)
+	int						gFloatSize;
+	bool					gPrintFileListSwitch;
+	bool					gInlineArchSwitch;
+	string					gClassName;
+	bool					gExportDSP;
+	list<string>			gImportDirList;		// dir list enrobage.cpp/fopensearch() searches for imports, etc.
+	string					gOutputDir;			// output directory for additionnal generated ressources : -SVG, XML...etc...
+	bool					gInPlace;			// add cache to input for correct in-place computations
+	bool					gLibCacheSwitch;	// load the parsed libraries from the cache (see astcache.hh)
+
+	//-- timing.cpp
+	int						lIndex;
+	double					lStartTime[1024];
+	double					lEndTime[1024];
+
+	//-- enrobage.cpp
+	set<string>				alreadyIncluded;	// the architecture files included so far
+
+	//-- boxtype.cpp, eval.cpp and propagate.cpp
+	denseproperty<BoxInfo>	gBoxInfo;			// shared by getBoxType and boxComplexity
+	int						gBoxSlotNumber;		// counter for unique slot number
+	loopDetector			LD;
+	int						gDummyInput;
+	vector<Tree>			gUnnamedRecs;		// recursions waiting for the name of their definition (-prof)
+
+	//-- sigtyperules.cpp
+	unsigned int				gCurrentRound;	// the current typing round, counted per compilation
+	denseproperty<unsigned int>	gTypingRound;	// the last round typing a tree
+	set<unsigned int>			gFinalRounds;	// the rounds whose types are final
+	int						countInferences;
+	int						countMaximal;
+	int						countRecInferences;	// recursive definitions typed by the component worklists
+	int						countRecLowerBound;	// what a global iteration would need at least
+	int						countGlobalRounds;
+
+	//-- generator
+	map<string, int>		gIDCounters;		// fresh names of the ScalarCompiler
+	bool					gNeedPowerDef;		// true when faustpower definition is needed
+	int						gTaskCount;
+	map<Tree, int>			gColorMap;			// colorize.cpp
+	int						gNextFreeColor;
+
+	//-- block-diagrams (drawschema.cpp and PSDev.cpp)
+	bool					sFoldingFlag;		// true with complex block-diagrams
+	stack<Tree>				gPendingExp;		// Expressions that need to be drawn
+	set<Tree>				gDrawnExp;			// Expressions drawn or scheduled so far
+	const char*				gDevSuffix;			// .svg or .ps used to choose output device
+	string					gSchemaDir;			// directory where the files are written
+	string					gSchemaFileName;	// name of schema file beeing generated
+	map<Tree, string>		gBackLink;			// link to enclosing file for sub schema
+	map<string, Tree>		gFileNames;			// diagrams of the file names given so far
+	queue<drawing>			gWriteQueue;		// generated schemas waiting to be written
+	bool					gWriteDone;			// true when all the schemas are generated
+#ifndef _WIN32
+	pthread_mutex_t			gWriteMutex;
+	pthread_cond_t			gWriteCond;
+#endif
+	int						gFileNum;
+
+	//-- documentator
+	vector<Tree>			gDocVector;			// Contains <mdoc> parsed trees: DOCTXT, DOCEQN, DOCDGM.
+	const char*				gDocDevSuffix;		// ".tex" (or .??? - used to choose output device).
+	string					gDocLang;
+	bool					gLstDependenciesSwitch;	// mdoc listing management.
+	bool					gLstMdocTagsSwitch;
+	bool					gLstDistributedSwitch;
+	struct tm				gCompilationDate;
+	map<string, string>		gDocAutodocStringMap;
+	set<string>				gDocAutodocKeySet;
+	map<string, string>		gDocMathStringMap;
+	set<string>				gDocMathKeySet;
+	map<string, string>		gDocMetadatasStringMap;
+	set<string>				gDocMetadatasKeySet;
+	map<string, bool>		gDocNoticeFlagMap;	// the others turn to "true" the flags they want to print
+	map<string, string>		gDocNoticeStringMap;
+	set<string>				gDocNoticeKeySet;
+	map<string, int>		gDocIDCounters;		// fresh names of the DocCompiler
+
+	global();							///< the default values of the options, the diagnostics to std::cerr
+	~global();
+};
+
+extern THREAD_LOCAL global* gGlobal;	///< the compilation running in the thread
+
+/**
+ * Makes a compilation current in the calling thread (and its trees go to
+ * its space), until the object is destroyed
+ */
+class globalscope
+{
+	global*		fPrevious;
+
+ public:
+	globalscope(global* g);
+	~globalscope();
+};
+
+#endif
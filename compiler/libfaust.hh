@@ -0,0 +1,58 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+#ifndef _LIBFAUST_
+#define _LIBFAUST_
+
+#include <string>
+#include <vector>
+
+/**
+ * Result of a compilation : the exit status the command line compiler
+ * would have, the C++ code (what it would print on the standard output)
+ * and the diagnostics (what it would print on the standard error).
+ */
+struct FaustResult
+{
+    int             fStatus;
+    std::string     fCode;
+    std::string     fErrors;
+};
+
+/**
+ * Compile a Faust program in the calling process, as "faust options name"
+ * would. When source is not empty, it is the text of the program (name is
+ * then only used in the messages and as the name of the main file),
+ * otherwise the files to compile are given in the options.
+ *
+ * Each call has its own compilation state (see global.hh) : nothing is
+ * kept from one compilation to the next, and several threads can compile
+ * at the same time. They only wait for each other to parse their files,
+ * one at a time. On Windows, where there is no such lock, the calls must
+ * not overlap.
+ *
+ * The process is otherwise left alone : the diagnostics go to fErrors,
+ * not to std::cerr, and the current directory is never changed (the
+ * files of -svg, -ps or -mdoc are written relative to it).
+ */
+FaustResult compileFaust(const std::string& name, const std::string& source, const std::vector<std::string>& options);
+
+#endif
@@ -52,6 +52,9 @@
 #include "description.hh"
 #include "floats.hh"
 #include "doc.hh"
+#include "doc_compile.hh"
+#include "exception.hh"
+#include "libfaust.hh"
 
 #include <map>
 #include <string>
@@ -69,6 +72,7 @@
 #include "schema.h"
 #include "drawschema.hh"
 #include "timing.hh"
+#include "global.hh"
 
 using namespace std ;
 
@@ -80,88 +84,16 @@ using namespace std ;
 
 int yyparse();
 
-int 			yyerr;
 extern int 	    yydebug;
 extern FILE*	yyin;
-Tree 			gResult;
-Tree 			gResult2;
-
-SourceReader	gReader;
-
-map<Tree, set<Tree> > gMetaDataSet;
-extern vector<Tree> gDocVector;
-extern string gDocLang;
-tvec gWaveForm;
 
 /****************************************************************
  				Command line tools and arguments
 *****************************************************************/
 
-//-- globals
-string          gFaustSuperSuperDirectory;
-string          gFaustSuperDirectory;
-string          gFaustDirectory;
-string          gMasterDocument;
-string          gMasterDirectory;
-string          gMasterName;
-string          gDocName;
-Tree			gExpandedDefList;
-
-//-- command line arguments
-
-bool			gHelpSwitch 	= false;
-bool			gVersionSwitch 	= false;
-bool            gDetailsSwitch  = false;
-bool            gTimingSwitch   = false;
-bool            gDrawSignals    = false;
-bool            gShadowBlur     = false;	// note: svg2pdf doesn't like the blur filter
-bool            gGraphSwitch 	= false;
-bool            gDrawPSSwitch 	= false;
-bool            gDrawSVGSwitch 	= false;
-bool            gPrintXMLSwitch = false;
-bool            gPrintJSONSwitch = false;
-bool            gPrintDocSwitch = false;
-bool            gLatexDocSwitch = true;		// Only LaTeX outformat is handled for the moment.
-bool			gStripDocSwitch = false;	// Strip <mdoc> content from doc listings.
-int            	gBalancedSwitch = 0;
-int            	gFoldThreshold 	= 25;
-int            	gMaxNameSize 	= 40;
-bool			gSimpleNames 	= false;
-bool            gSimplifyDiagrams = false;
-bool			gLessTempSwitch = false;
-int				gMaxCopyDelay	= 16;
-string			gArchFile;
-string			gOutputFile;
-list<string>	gInputFiles;
-
-bool            gPatternEvalMode = false;
-
-bool            gVectorSwitch   = false;
-bool            gDeepFirstSwitch= false;
-int             gVecSize        = 32;
-int             gVectorLoopVariant = 0;
-
-bool            gOpenMPSwitch   = false;
-bool            gOpenMPLoop     = false;
-bool            gSchedulerSwitch = false;
-bool			gGroupTaskSwitch = false;
-
-bool            gUIMacroSwitch  = false;
-bool            gDumpNorm       = false;
-
-int             gTimeout        = 120;          // time out to abort compiler (in seconds)
-
-int             gFloatSize      = 1;
-
-bool			gPrintFileListSwitch = false;
-bool			gInlineArchSwitch = false;
-
-string			gClassName		= "mydsp";
-bool            gExportDSP      = false;
-
-list<string>    gImportDirList;                 // dir list enrobage.cpp/fopensearch() searches for imports, etc.
-string          gOutputDir;                     // output directory for additionnal generated ressources : -SVG, XML...etc...
-bool            gInPlace        = false;        // add cache to input for correct in-place computations
+//-- the globals and the command line arguments are in gGlobal (see global.hh)
+
+string          gFaustVersion   = FAUSTVERSION; // part of the key of the cache entries (see astcache.hh)
 
 //-- command line tools
 
@@ -175,23 +107,35 @@ static bool isCmd(const char* cmd, const char* kw1, const char* kw2)
 	return 	(strcmp(cmd, kw1) == 0) || (strcmp(cmd, kw2) == 0);
 }
 
+/**
+ * The value of the option argv[i], an error when it is missing
+ */
+static const char* optionValue(int argc, char* argv[], int i)
+{
+	if (i+1 >= argc) {
+		gGlobal->gErrors << "ERROR : missing value for option " << argv[i] << endl;
+		throw faustexception(-1);
+	}
+	return argv[i+1];
+}
+
 string makeDrawPath()
 {
-    if (gOutputDir != "") {
-        return gOutputDir + "/" + gMasterName + ".dsp";
+    if (gGlobal->gOutputDir != "") {
+        return gGlobal->gOutputDir + "/" + gGlobal->gMasterName + ".dsp";
     } else {
-        return gMasterDocument;
+        return gGlobal->gMasterDocument;
     }
 }
 
 static string makeDrawPathNoExt()
 {
-    if (gOutputDir != "") {
-        return gOutputDir + "/" + gMasterName;
-    } else if (gMasterDocument.length() >= 4 && gMasterDocument.substr(gMasterDocument.length() - 4) == ".dsp") {
-        return gMasterDocument.substr(0, gMasterDocument.length() - 4);
+    if (gGlobal->gOutputDir != "") {
+        return gGlobal->gOutputDir + "/" + gGlobal->gMasterName;
+    } else if (gGlobal->gMasterDocument.length() >= 4 && gGlobal->gMasterDocument.substr(gGlobal->gMasterDocument.length() - 4) == ".dsp") {
+        return gGlobal->gMasterDocument.substr(0, gGlobal->gMasterDocument.length() - 4);
     } else {
-        return gMasterDocument;
+        return gGlobal->gMasterDocument;
     }
 }
 
@@ -209,227 +153,291 @@ bool process_cmdline(int argc, char* argv[])
 	while (i<argc) {
    
 		if (isCmd(argv[i], "-h", "--help")) {
-			gHelpSwitch = true;
+			gGlobal->gHelpSwitch = true;
 			i += 1;
 
 		} else if (isCmd(argv[i], "-v", "--version")) {
-			gVersionSwitch = true;
+			gGlobal->gVersionSwitch = true;
 			i += 1;
 
 		} else if (isCmd(argv[i], "-d", "--details")) {
-			gDetailsSwitch = true;
+			gGlobal->gDetailsSwitch = true;
 			i += 1;
 
 		} else if (isCmd(argv[i], "-a", "--architecture")) {
-			gArchFile = argv[i+1];
+			gGlobal->gArchFile = optionValue(argc, argv, i);
 			i += 2;
 
 		} else if (isCmd(argv[i], "-o")) {
-			gOutputFile = argv[i+1];
+			gGlobal->gOutputFile = optionValue(argc, argv, i);
 			i += 2;
 
 		} else if (isCmd(argv[i], "-ps", "--postscript")) {
-			gDrawPSSwitch = true;
+			gGlobal->gDrawPSSwitch = true;
 			i += 1;
 
         } else if (isCmd(argv[i], "-xml", "--xml")) {
-            gPrintXMLSwitch = true;
+            gGlobal->gPrintXMLSwitch = true;
             i += 1;
             
         } else if (isCmd(argv[i], "-json", "--json")) {
-            gPrintJSONSwitch = true;
+            gGlobal->gPrintJSONSwitch = true;
             i += 1;
 
         } else if (isCmd(argv[i], "-tg", "--task-graph")) {
-            gGraphSwitch = true;
+            gGlobal->gGraphSwitch = true;
             i += 1;
 
         } else if (isCmd(argv[i], "-sg", "--signal-graph")) {
-            gDrawSignals = true;
+            gGlobal->gDrawSignals = true;
             i += 1;
 
         } else if (isCmd(argv[i], "-blur", "--shadow-blur")) {
-            gShadowBlur = true;
+            gGlobal->gShadowBlur = true;
             i += 1;
 
 		} else if (isCmd(argv[i], "-svg", "--svg")) {
-			gDrawSVGSwitch = true;
+			gGlobal->gDrawSVGSwitch = true;
 			i += 1;
 
 		} else if (isCmd(argv[i], "-f", "--fold")) {
-			gFoldThreshold = atoi(argv[i+1]);
+			gGlobal->gFoldThreshold = atoi(optionValue(argc, argv, i));
 			i += 2;
 
 		} else if (isCmd(argv[i], "-mns", "--max-name-size")) {
-			gMaxNameSize = atoi(argv[i+1]);
+			gGlobal->gMaxNameSize = atoi(optionValue(argc, argv, i));
 			i += 2;
 
 		} else if (isCmd(argv[i], "-sn", "--simple-names")) {
-			gSimpleNames = true;
+			gGlobal->gSimpleNames = true;
 			i += 1;
 
 		} else if (isCmd(argv[i], "-lb", "--left-balanced")) {
-			gBalancedSwitch = 0;
+			gGlobal->gBalancedSwitch = 0;
 			i += 1;
 
 		} else if (isCmd(argv[i], "-mb", "--mid-balanced")) {
-			gBalancedSwitch = 1;
+			gGlobal->gBalancedSwitch = 1;
 			i += 1;
 
 		} else if (isCmd(argv[i], "-rb", "--right-balanced")) {
-			gBalancedSwitch = 2;
+			gGlobal->gBalancedSwitch = 2;
 			i += 1;
 
 		} else if (isCmd(argv[i], "-lt", "--less-temporaries")) {
-			gLessTempSwitch = true;
+			gGlobal->gLessTempSwitch = true;
 			i += 1;
 
 		} else if (isCmd(argv[i], "-mcd", "--max-copy-delay")) {
-			gMaxCopyDelay = atoi(argv[i+1]);
+			gGlobal->gMaxCopyDelay = atoi(optionValue(argc, argv, i));
+			i += 2;
+
+		} else if (isCmd(argv[i], "-fir", "--fir-min-taps")) {
+			gGlobal->gFIRMinTaps = atoi(optionValue(argc, argv, i));
+			i += 2;
+
+		} else if (isCmd(argv[i], "-ct", "--const-tables")) {
+			gGlobal->gConstTableSize = atoi(optionValue(argc, argv, i));
 			i += 2;
 
 		} else if (isCmd(argv[i], "-sd", "--simplify-diagrams")) {
-			gSimplifyDiagrams = true;
+			gGlobal->gSimplifyDiagrams = true;
 			i += 1;
 
         } else if (isCmd(argv[i], "-vec", "--vectorize")) {
-            gVectorSwitch = true;
+            gGlobal->gVectorSwitch = true;
+            i += 1;
+
+        } else if (isCmd(argv[i], "-lrec", "--linear-recursions")) {
+            gGlobal->gLinearRecSwitch = true;
+            i += 1;
+
+        } else if (isCmd(argv[i], "-lanes", "--simd-lanes")) {
+            gGlobal->gSIMDLanes = atoi(optionValue(argc, argv, i));
+            i += 2;
+
+        } else if (isCmd(argv[i], "-cl", "--cache-line")) {
+            gGlobal->gCacheLine = atoi(optionValue(argc, argv, i));
+            i += 2;
+
+        } else if (isCmd(argv[i], "-bi", "--batch-instances")) {
+            gGlobal->gBatchInstances = atoi(optionValue(argc, argv, i));
+            i += 2;
+
+        } else if (isCmd(argv[i], "-prof", "--profile")) {
+            gGlobal->gProfSwitch = true;
             i += 1;
 
         } else if (isCmd(argv[i], "-dfs", "--deepFirstScheduling")) {
-            gDeepFirstSwitch = true;
+            gGlobal->gDeepFirstSwitch = true;
             i += 1;
 
         } else if (isCmd(argv[i], "-vs", "--vec-size")) {
-            gVecSize = atoi(argv[i+1]);
+            gGlobal->gVecSize = atoi(optionValue(argc, argv, i));
+            i += 2;
+
+        } else if (isCmd(argv[i], "-avs", "--adaptive-vec-size")) {
+            gGlobal->gMinVecSize = atoi(optionValue(argc, argv, i));
             i += 2;
 
         } else if (isCmd(argv[i], "-lv", "--loop-variant")) {
-            gVectorLoopVariant = atoi(argv[i+1]);
+            gGlobal->gVectorLoopVariant = atoi(optionValue(argc, argv, i));
             i += 2;
 
         } else if (isCmd(argv[i], "-omp", "--openMP")) {
-            gOpenMPSwitch = true;
+            gGlobal->gOpenMPSwitch = true;
             i += 1;
 
         } else if (isCmd(argv[i], "-pl", "--par-loop")) {
-            gOpenMPLoop = true;
+            gGlobal->gOpenMPLoop = true;
             i += 1;
 
         } else if (isCmd(argv[i], "-sch", "--scheduler")) {
-			gSchedulerSwitch = true;
+			gGlobal->gSchedulerSwitch = true;
 			i += 1;
 
         } else if (isCmd(argv[i], "-g", "--groupTasks")) {
-			gGroupTaskSwitch = true;
+			gGlobal->gGroupTaskSwitch = true;
 			i += 1;
 
         } else if (isCmd(argv[i], "-uim", "--user-interface-macros")) {
-			gUIMacroSwitch = true;
+			gGlobal->gUIMacroSwitch = true;
 			i += 1;
 
         } else if (isCmd(argv[i], "-t", "--timeout")) {
-            gTimeout = atoi(argv[i+1]);
+            gGlobal->gTimeout = atoi(optionValue(argc, argv, i));
             i += 2;
             
         } else if (isCmd(argv[i], "-time", "--compilation-time")) {
-            gTimingSwitch = true;
+            gGlobal->gTimingSwitch = true;
             i += 1;
             
         // double float options
         } else if (isCmd(argv[i], "-single", "--single-precision-floats")) {
-            gFloatSize = 1;
+            gGlobal->gFloatSize = 1;
             i += 1;
 
         } else if (isCmd(argv[i], "-double", "--double-precision-floats")) {
-            gFloatSize = 2;
+            gGlobal->gFloatSize = 2;
             i += 1;
 
         } else if (isCmd(argv[i], "-quad", "--quad-precision-floats")) {
-            gFloatSize = 3;
+            gGlobal->gFloatSize = 3;
+            i += 1;
+
+        } else if (isCmd(argv[i], "-mp", "--mixed-precision")) {
+            gGlobal->gMixedPrecision = true;
             i += 1;
 			
+        } else if (isCmd(argv[i], "-fm", "--fast-math")) {
+            string mode = optionValue(argc, argv, i);
+            if (mode == "std") {
+                gGlobal->gFastMath = 0;
+            } else if (mode == "fast") {
+                gGlobal->gFastMath = 1;
+            } else if (mode == "faster") {
+                gGlobal->gFastMath = 2;
+            } else {
+                gGlobal->gErrors << "ERROR : unknown fast math mode '" << mode << "', use std, fast or faster" << endl;
+                throw faustexception(-1);
+            }
+            i += 2;
+
         } else if (isCmd(argv[i], "-mdoc", "--mathdoc")) {
-            gPrintDocSwitch = true;
+            gGlobal->gPrintDocSwitch = true;
             i += 1;
 			
         } else if (isCmd(argv[i], "-mdlang", "--mathdoc-lang")) {
-            gDocLang = argv[i+1];
+            gGlobal->gDocLang = optionValue(argc, argv, i);
             i += 2;
 			
         } else if (isCmd(argv[i], "-stripmdoc", "--strip-mdoc-tags")) {
-            gStripDocSwitch = true;
+            gGlobal->gStripDocSwitch = true;
             i += 1;
 			
         } else if (isCmd(argv[i], "-flist", "--file-list")) {
-            gPrintFileListSwitch = true;
+            gGlobal->gPrintFileListSwitch = true;
             i += 1;
 
         } else if (isCmd(argv[i], "-norm", "--normalized-form")) {
-            gDumpNorm = true;
+            gGlobal->gDumpNorm = true;
             i += 1;
 
 		} else if (isCmd(argv[i], "-cn", "--class-name")) {
-			gClassName = argv[i+1];
+			gGlobal->gClassName = optionValue(argc, argv, i);
 			i += 2;
 
         } else if (isCmd(argv[i], "-i", "--inline-architecture-files")) {
-            gInlineArchSwitch = true;
+            gGlobal->gInlineArchSwitch = true;
             i += 1;
             
         } else if (isCmd(argv[i], "-e", "--export-dsp")) {
-            gExportDSP = true;
+            gGlobal->gExportDSP = true;
             i += 1;
 
         } else if (isCmd(argv[i], "-I", "--import-dir")) {
 
             char temp[PATH_MAX+1];
-            char* path = realpath(argv[i+1], temp);
+            char* path = realpath(optionValue(argc, argv, i), temp);
             if (path == 0) {
-                std::cerr << "ERROR : invalid directory path " << argv[i+1] << std::endl;
-                exit(-1);
+                gGlobal->gErrors << "ERROR : invalid directory path " << argv[i+1] << std::endl;
+                throw faustexception(-1);
             } else {
-                gImportDirList.push_back(path);
+                gGlobal->gImportDirList.push_back(path);
                 i += 2;
             }
          } else if (isCmd(argv[i], "-O", "--output-dir")) {
         
             char temp[PATH_MAX+1];
-            char* path = realpath(argv[i+1], temp);
+            char* path = realpath(optionValue(argc, argv, i), temp);
              if (path == 0) {
-                std::cerr << "ERROR : invalid directory path " << argv[i+1] << std::endl;
-                exit(-1);
+                gGlobal->gErrors << "ERROR : invalid directory path " << argv[i+1] << std::endl;
+                throw faustexception(-1);
             } else {
-                gOutputDir = path;
+                gGlobal->gOutputDir = path;
                 i += 2;
             }
              
          } else if (isCmd(argv[i], "-inpl", "--in-place")) {
-             gInPlace = true;
+             gGlobal->gInPlace = true;
              i += 1;
 
+        } else if (isCmd(argv[i], "-lc", "--lib-cache")) {
+            gGlobal->gLibCacheSwitch = true;
+            i += 1;
+
         } else if (argv[i][0] != '-') {
             const char* url = argv[i];
             if (check_url(url)) {
-                gInputFiles.push_back(url);
+                gGlobal->gInputFiles.push_back(url);
             }
 			i++;
 
 		} else {
-			std::cerr << "faust: unrecognized option \"" << argv[i] <<"\"" << endl;
+			gGlobal->gErrors << "faust: unrecognized option \"" << argv[i] <<"\"" << endl;
 			i++;
 			err++;
 		}
 	}
 
     // adjust related options
-    if (gOpenMPSwitch || gSchedulerSwitch) gVectorSwitch = true;
+    if (gGlobal->gOpenMPSwitch || gGlobal->gSchedulerSwitch) gGlobal->gVectorSwitch = true;
     
-    if (gInPlace && gVectorSwitch) {
-        std::cerr << "ERROR : 'in-place' option can only be used in scalar mode" << endl;
-        exit(-1);
+    if (gGlobal->gInPlace && gGlobal->gVectorSwitch) {
+        gGlobal->gErrors << "ERROR : 'in-place' option can only be used in scalar mode" << endl;
+        throw faustexception(-1);
     }   
 
+    if (gGlobal->gMixedPrecision && (gGlobal->gVectorSwitch || gGlobal->gFloatSize != 1)) {
+        gGlobal->gErrors << "ERROR : 'mixed-precision' option can only be used in scalar mode and single precision" << endl;
+        throw faustexception(-1);
+    }
+
+    if (gGlobal->gBatchInstances > 0 && gGlobal->gVectorSwitch) {
+        gGlobal->gErrors << "ERROR : 'batch-instances' option can only be used in scalar mode" << endl;
+        throw faustexception(-1);
+    }
+
 	return err == 0;
 }
 
@@ -474,11 +482,16 @@ void printhelp()
     cout << "-xml \t\tgenerate an XML description file\n";
     cout << "-json \t\tgenerate a JSON description file\n";
     cout << "-blur \t\tadd a --shadow-blur to SVG boxes\n";
-	cout << "-lb \t\tgenerate --left-balanced expressions\n";
-	cout << "-mb \t\tgenerate --mid-balanced expressions (default)\n";
-	cout << "-rb \t\tgenerate --right-balanced expressions\n";
+	cout << "-lb \t\tgenerate --left-balanced sums (default)\n";
+	cout << "-mb \t\tgenerate --mid-balanced sums, independent additions\n";
+	cout << "-rb \t\tgenerate --right-balanced sums\n";
 	cout << "-lt \t\tgenerate --less-temporaries in compiling delays\n";
 	cout << "-mcd <n> \t--max-copy-delay <n> threshold between copy and ring buffer implementation (default 16 samples)\n";
+	cout << "-fir <n> \t--fir-min-taps <n> compile sums of at least <n> delayed copies of a signal as FIR filters (default 0: disabled)\n";
+	cout << "-ct <n> \t--const-tables <n> compute at compile time the constant tables of up to <n> elements (default 0: disabled)\n";
+	cout << "-cl <n> \t--cache-line <n> group the fields of the class by usage and align the groups on <n> bytes (default 0: declaration order)\n";
+	cout << "-bi <n> \t--batch-instances <n> add a nested batch class computing <n> instances together\n";
+	cout << "-prof \t\t--profile count the cycles spent in each loop of compute(), read with getProfile()\n";
 	cout << "-a <file> \tC++ architecture file\n";
 	cout << "-i \t\t--inline-architecture-files \n";
 	cout << "-cn <name> \t--class-name <name> specify the name of the dsp class to be used instead of mydsp \n";
@@ -487,7 +500,10 @@ void printhelp()
     cout << "-o <file> \tC++ output file\n";
     cout << "-vec    \t--vectorize generate easier to vectorize code\n";
     cout << "-vs <n> \t--vec-size <n> size of the vector (default 32 samples)\n";
+    cout << "-avs <n> \t--adaptive-vec-size <n> also compile the vector sizes -vs/2, -vs/4 ... down to <n>, the largest one not larger than the buffer is used\n";
     cout << "-lv <n> \t--loop-variant [0:fastest (default), 1:simple] \n";
+    cout << "-lrec   \t--linear-recursions compute first and second order linear recursions by blocks in --vectorize mode\n";
+    cout << "-lanes <n> \t--simd-lanes <n> compute up to <n> identical recursive loops together in --vectorize mode (default 0: disabled)\n";
     cout << "-omp    \t--openMP generate OpenMP pragmas, activates --vectorize option\n";
     cout << "-pl     \t--par-loop generate parallel loops in --openMP mode\n";
     cout << "-sch    \t--scheduler generate tasks and use a Work Stealing scheduler, activates --vectorize option\n";
@@ -497,12 +513,15 @@ void printhelp()
     cout << "-single \tuse --single-precision-floats for internal computations (default)\n";
     cout << "-double \tuse --double-precision-floats for internal computations\n";
     cout << "-quad \t\tuse --quad-precision-floats for internal computations\n";
+    cout << "-mp \t\tuse --mixed-precision : double precision for the recursions sensitive to rounding errors, single precision elsewhere\n";
+    cout << "-fm <mode> \t--fast-math <mode> approximations of sin, cos, tan, exp, log, log10 and pow in single or double precision : std (math.h functions, default), fast (about 1e-8) or faster (about 1e-4)\n";
     cout << "-flist \t\tuse --file-list used to eval process\n";
     cout << "-norm \t\t--normalized-form prints signals in normalized form and exits\n";
     cout << "-I <dir> \t--import-dir <dir> add the directory <dir> to the import search path\n";
     cout << "-O <dir> \t--output-dir <dir> specify the relative directory of the generated C++ output, and the output directory of additional generated files (SVG, XML...)\n";
     cout << "-e       \t--export-dsp export expanded DSP (all included libraries) \n";
     cout << "-inpl    \t--in-place generates code working when input and output buffers are the same (in scalar mode only) \n";
+    cout << "-lc      \t--lib-cache load the parsed libraries from a cache of parsed files (~/.cache/faust, 256 entries at most), the order of some declarations in the code may change\n";
   	cout << "\nexample :\n";
 	cout << "---------\n";
 
@@ -521,7 +540,7 @@ void printheader(ostream& dst)
     selectedKeys.insert(tree("version"));
 
     dst << "//-----------------------------------------------------" << endl;
-    for (map<Tree, set<Tree> >::iterator i = gMetaDataSet.begin(); i != gMetaDataSet.end(); i++) {
+    for (map<Tree, set<Tree> >::iterator i = gGlobal->gMetaDataSet.begin(); i != gGlobal->gMetaDataSet.end(); i++) {
         if (selectedKeys.count(i->first)) {
             dst << "// " << *(i->first);
             const char* sep = ": ";
@@ -574,40 +593,31 @@ static void initFaustDirectories()
     char s[1024];
     getFaustPathname(s, 1024);
 
-    gFaustDirectory = filedirname(s);
-    gFaustSuperDirectory = filedirname(gFaustDirectory);
-    gFaustSuperSuperDirectory = filedirname(gFaustSuperDirectory);
-    if (gInputFiles.empty()) {
-        gMasterDocument = "Unknown";
-        gMasterDirectory = ".";
-		gMasterName = "faustfx";
-		gDocName = "faustdoc";
+    gGlobal->gFaustDirectory = filedirname(s);
+    gGlobal->gFaustSuperDirectory = filedirname(gGlobal->gFaustDirectory);
+    gGlobal->gFaustSuperSuperDirectory = filedirname(gGlobal->gFaustSuperDirectory);
+    if (gGlobal->gInputFiles.empty()) {
+        gGlobal->gMasterDocument = "Unknown";
+        gGlobal->gMasterDirectory = ".";
+		gGlobal->gMasterName = "faustfx";
+		gGlobal->gDocName = "faustdoc";
     } else {
-        gMasterDocument = *gInputFiles.begin();
-        gMasterDirectory = filedirname(gMasterDocument);
-		gMasterName = fxname(gMasterDocument);
-		gDocName = fxname(gMasterDocument);
+        gGlobal->gMasterDocument = *gGlobal->gInputFiles.begin();
+        gGlobal->gMasterDirectory = filedirname(gGlobal->gMasterDocument);
+		gGlobal->gMasterName = fxname(gGlobal->gMasterDocument);
+		gGlobal->gDocName = fxname(gGlobal->gMasterDocument);
     }
 }
 
 
 
-int main (int argc, char* argv[])
+/**
+ * Compile the input files (steps 2 to 9), once the command line is
+ * processed. The C++ code goes to out, unless an output file is given.
+ * Raises a faustexception when the compilation fails.
+ */
+static void compileProcess(ostream& out)
 {
-
-	/****************************************************************
-	 1 - process command line
-	*****************************************************************/
-
-	process_cmdline(argc, argv);
-
-	if (gHelpSwitch) 		{ printhelp(); exit(0); }
-	if (gVersionSwitch) 	{ printversion(); exit(0); }
-
-    initFaustDirectories();
-    alarm(gTimeout);
-
-
 	/****************************************************************
 	 2 - parse source files
 	*****************************************************************/
@@ -615,23 +625,23 @@ int main (int argc, char* argv[])
 	startTiming("parser");
 
 	list<string>::iterator s;
-	gResult2 = nil;
-	yyerr = 0;
+	gGlobal->gResult2 = nil;
+	gGlobal->yyerr = 0;
 
-	if (gInputFiles.begin() == gInputFiles.end()) {
-		exit(1);
+	if (gGlobal->gInputFiles.begin() == gGlobal->gInputFiles.end()) {
+		throw faustexception();
 	}
-	for (s = gInputFiles.begin(); s != gInputFiles.end(); s++) {
-		if (s == gInputFiles.begin()) {
-            gMasterDocument = *s;
+	for (s = gGlobal->gInputFiles.begin(); s != gGlobal->gInputFiles.end(); s++) {
+		if (s == gGlobal->gInputFiles.begin()) {
+            gGlobal->gMasterDocument = *s;
         }
-		gResult2 = cons(importFile(tree(s->c_str())), gResult2);
+		gGlobal->gResult2 = cons(importFile(tree(s->c_str())), gGlobal->gResult2);
 	}
-	if (yyerr > 0) {
-		cerr << "ERROR : paorsing count = " <<  yyerr << endl;
-		exit(1);
+	if (gGlobal->yyerr > 0) {
+		gGlobal->gErrors << "ERROR : paorsing count = " <<  gGlobal->yyerr << endl;
+		throw faustexception();
 	}
-	gExpandedDefList = gReader.expandlist(gResult2);
+	gGlobal->gExpandedDefList = gGlobal->gReader.expandlist(gGlobal->gResult2);
 
 	endTiming("parser");
 	
@@ -642,51 +652,51 @@ int main (int argc, char* argv[])
 	startTiming("evaluation");
 
 
-    Tree process = evalprocess(gExpandedDefList);
+    Tree process = evalprocess(gGlobal->gExpandedDefList);
 
-	if (gErrorCount > 0) {
+	if (gGlobal->gErrorCount > 0) {
        // cerr << "Total of " << gErrorCount << " errors during evaluation of : process = " << boxpp(process) << ";\n";
-        cerr << "Total of " << gErrorCount << " errors during the compilation of  " << gMasterDocument << ";\n";
-		exit(1);
+        gGlobal->gErrors << "Total of " << gGlobal->gErrorCount << " errors during the compilation of  " << gGlobal->gMasterDocument << ";\n";
+		throw faustexception();
 	}
 
 
-	if (gDetailsSwitch) { cerr << "process = " << boxpp(process) << ";\n"; }
+	if (gGlobal->gDetailsSwitch) { gGlobal->gErrors << "process = " << boxpp(process) << ";\n"; }
 
-	if (gDrawPSSwitch || gDrawSVGSwitch) {
+	if (gGlobal->gDrawPSSwitch || gGlobal->gDrawSVGSwitch) {
 		string projname = makeDrawPathNoExt();
-     	if (gDrawPSSwitch) 	{ drawSchema( process, subst("$0-ps", projname).c_str(), "ps" ); }
-		if (gDrawSVGSwitch) { drawSchema( process, subst("$0-svg", projname).c_str(), "svg" ); }
+     	if (gGlobal->gDrawPSSwitch) 	{ drawSchema( process, subst("$0-ps", projname).c_str(), "ps" ); }
+		if (gGlobal->gDrawSVGSwitch) { drawSchema( process, subst("$0-svg", projname).c_str(), "svg" ); }
 	}
 
 	int numInputs, numOutputs;
 	if (!getBoxType(process, &numInputs, &numOutputs)) {
-		cerr << "ERROR during the evaluation of  process : "
+		gGlobal->gErrors << "ERROR during the evaluation of  process : "
 			 << boxpp(process) << endl;
-		exit(1);
+		throw faustexception();
 	}
 
-	if (gDetailsSwitch) {
-        cerr <<"process has " << numInputs <<" inputs, and " << numOutputs <<" outputs" << endl;
+	if (gGlobal->gDetailsSwitch) {
+        gGlobal->gErrors <<"process has " << numInputs <<" inputs, and " << numOutputs <<" outputs" << endl;
     }
 	
 	endTiming("evaluation");
     
-    if (gExportDSP) {
+    if (gGlobal->gExportDSP) {
         ofstream xout(subst("$0_exp.dsp", makeDrawPathNoExt()).c_str());
         xout << "process = " << boxpp(process) << ";" << endl;
-        return 0;
+        return;
     }
  
 	/****************************************************************
 	 3.5 - output file list is needed
 	*****************************************************************/
-	if (gPrintFileListSwitch) {
-		cout << "******* ";
+	if (gGlobal->gPrintFileListSwitch) {
+		out << "******* ";
 		// print the pathnames of the files used to evaluate process
-		vector<string> pathnames = gReader.listSrcFiles();
-		for (unsigned int i=0; i< pathnames.size(); i++) cout << pathnames[i] << ' ';
-		cout << endl;
+		vector<string> pathnames = gGlobal->gReader.listSrcFiles();
+		for (unsigned int i=0; i< pathnames.size(); i++) out << pathnames[i] << ' ';
+		out << endl;
 
 	}
 	
@@ -699,7 +709,7 @@ int main (int argc, char* argv[])
 
 
 	Tree lsignals = boxPropagateSig(nil, process , makeSigInputList(numInputs) );
-	if (gDetailsSwitch) { cerr << "output signals are : " << endl;  printSignal(lsignals, stderr); }
+	if (gGlobal->gDetailsSwitch) { gGlobal->gErrors << "output signals are : " << endl;  printSignal(lsignals, stderr); }
 
 	endTiming("propagation");
 
@@ -711,12 +721,12 @@ int main (int argc, char* argv[])
 	startTiming("compilation");
 
 	Compiler* C;
-	if (gSchedulerSwitch)   C = new SchedulerCompiler(gClassName, "dsp", numInputs, numOutputs);
-	else if (gVectorSwitch) C = new VectorCompiler(gClassName, "dsp", numInputs, numOutputs);
-	else                    C = new ScalarCompiler(gClassName, "dsp", numInputs, numOutputs);
+	if (gGlobal->gSchedulerSwitch)   C = new SchedulerCompiler(gGlobal->gClassName, "dsp", numInputs, numOutputs);
+	else if (gGlobal->gVectorSwitch) C = new VectorCompiler(gGlobal->gClassName, "dsp", numInputs, numOutputs);
+	else                    C = new ScalarCompiler(gGlobal->gClassName, "dsp", numInputs, numOutputs);
 
-	if (gPrintXMLSwitch) C->setDescription(new Description());
-	if (gPrintDocSwitch) C->setDescription(new Description());
+	if (gGlobal->gPrintXMLSwitch) C->setDescription(new Description());
+	if (gGlobal->gPrintDocSwitch) C->setDescription(new Description());
 
 	C->compileMultiSignal(lsignals);
 
@@ -726,17 +736,17 @@ int main (int argc, char* argv[])
 	 6 - generate XML description (if required)
 	*****************************************************************/
 
-	if (gPrintXMLSwitch) {
+	if (gGlobal->gPrintXMLSwitch) {
 		Description* 	D = C->getDescription(); assert(D);
 		ofstream 		xout(subst("$0.xml", makeDrawPath()).c_str());
 
-        if(gMetaDataSet.count(tree("name"))>0)          D->name(tree2str(*(gMetaDataSet[tree("name")].begin())));
-        if(gMetaDataSet.count(tree("author"))>0)        D->author(tree2str(*(gMetaDataSet[tree("author")].begin())));
-        if(gMetaDataSet.count(tree("copyright"))>0)     D->copyright(tree2str(*(gMetaDataSet[tree("copyright")].begin())));
-        if(gMetaDataSet.count(tree("license"))>0)       D->license(tree2str(*(gMetaDataSet[tree("license")].begin())));
-        if(gMetaDataSet.count(tree("version"))>0)       D->version(tree2str(*(gMetaDataSet[tree("version")].begin())));
+        if(gGlobal->gMetaDataSet.count(tree("name"))>0)          D->name(tree2str(*(gGlobal->gMetaDataSet[tree("name")].begin())));
+        if(gGlobal->gMetaDataSet.count(tree("author"))>0)        D->author(tree2str(*(gGlobal->gMetaDataSet[tree("author")].begin())));
+        if(gGlobal->gMetaDataSet.count(tree("copyright"))>0)     D->copyright(tree2str(*(gGlobal->gMetaDataSet[tree("copyright")].begin())));
+        if(gGlobal->gMetaDataSet.count(tree("license"))>0)       D->license(tree2str(*(gGlobal->gMetaDataSet[tree("license")].begin())));
+        if(gGlobal->gMetaDataSet.count(tree("version"))>0)       D->version(tree2str(*(gGlobal->gMetaDataSet[tree("version")].begin())));
 
-		D->className(gClassName);
+		D->className(gGlobal->gClassName);
 		D->inputs(C->getClass()->inputs());
 		D->outputs(C->getClass()->outputs());
 
@@ -749,9 +759,11 @@ int main (int argc, char* argv[])
 	*****************************************************************/
 
 
-	if (gPrintDocSwitch) {
-		if (gLatexDocSwitch) {
+	if (gGlobal->gPrintDocSwitch) {
+		if (gGlobal->gLatexDocSwitch) {
+		startTiming("documentation");
             printDoc(subst("$0-mdoc", makeDrawPathNoExt()).c_str(), "tex", FAUSTVERSION);
+		endTiming("documentation");
 		}
 	}
 
@@ -766,15 +778,15 @@ int main (int argc, char* argv[])
 	istream* enrobage;
 	//istream* intrinsic;
 
-	if (gOutputFile != "") {
-        string outpath = (gOutputDir != "") ? (gOutputDir + "/" + gOutputFile) : gOutputFile;
+	if (gGlobal->gOutputFile != "") {
+        string outpath = (gGlobal->gOutputDir != "") ? (gGlobal->gOutputDir + "/" + gGlobal->gOutputFile) : gGlobal->gOutputFile;
 		dst = new ofstream(outpath.c_str());
 	} else {
-		dst = &cout;
+		dst = &out;
 	}
 
-	if (gArchFile != "") {
-		if ( (enrobage = open_arch_stream(gArchFile.c_str())) ) {
+	if (gGlobal->gArchFile != "") {
+		if ( (enrobage = open_arch_stream(gGlobal->gArchFile.c_str())) ) {
             printheader(*dst);
 			C->getClass()->printLibrary(*dst);
 			C->getClass()->printIncludeFile(*dst);
@@ -786,13 +798,14 @@ int main (int argc, char* argv[])
 // 				streamCopyUntilEnd(*intrinsic, *dst);
 // 			}
             
-            if (gSchedulerSwitch) {
+            if (gGlobal->gSchedulerSwitch) {
                 istream* scheduler_include = open_arch_stream("scheduler.cpp");
                 if (scheduler_include) {
                     streamCopy(*scheduler_include, *dst);
                 } else {
-					cerr << "ERROR : can't include \"scheduler.cpp\", file not found" << endl;
-					exit(1);
+					gGlobal->gErrors << "ERROR : can't include \"scheduler.cpp\", file not found" << endl;
+					delete C;
+					throw faustexception();
 				}
             }
             
@@ -802,8 +815,9 @@ int main (int argc, char* argv[])
 			C->getClass()->println(0,*dst);
 			streamCopyUntilEnd(*enrobage, *dst);
 		} else {
-			cerr << "ERROR : can't open architecture file " << gArchFile << endl;
-			return 1;
+			gGlobal->gErrors << "ERROR : can't open architecture file " << gGlobal->gArchFile << endl;
+			delete C;
+			throw faustexception();
 		}
 	} else {
         printheader(*dst);
@@ -819,11 +833,88 @@ int main (int argc, char* argv[])
      9 - generate the task graph file in dot format
     *****************************************************************/
 
-    if (gGraphSwitch) {
+    if (gGlobal->gGraphSwitch) {
         ofstream dotfile(subst("$0.dot", makeDrawPath()).c_str());
         C->getClass()->printGraphDotFormat(dotfile);
     }
 	
+	if (dst != &out) delete dst;
 	delete C;
+}
+
+
+
+#ifndef FAUST_LIBRARY
+
+int main (int argc, char* argv[])
+{
+	global		g;		// the state of the compilation, the diagnostics go to std::cerr
+	globalscope	scope(&g);
+
+	try {
+
+		/****************************************************************
+		 1 - process command line
+		*****************************************************************/
+
+		process_cmdline(argc, argv);
+
+		if (gGlobal->gHelpSwitch) 		{ printhelp(); return 0; }
+		if (gGlobal->gVersionSwitch) 	{ printversion(); return 0; }
+
+		initFaustDirectories();
+		alarm(gGlobal->gTimeout);
+
+		compileProcess(cout);
+
+	} catch (faustexception& e) {
+		return e.status();
+	}
 	return 0;
 }
+
+#endif
+
+
+/****************************************************************
+ 					Library entry point (see libfaust.hh)
+*****************************************************************/
+
+FaustResult compileFaust(const string& name, const string& source, const vector<string>& options)
+{
+	FaustResult		res;
+	ostringstream	code;
+	ostringstream	errors;
+	global*			g = new global();		// the state of this compilation
+
+	g->gErrors.rdbuf(errors.rdbuf());		// its diagnostics, cerr is left alone
+
+	try {
+		globalscope	scope(g);
+
+		vector<char*> argv;
+		argv.push_back((char*)"faust");
+		for (unsigned int i = 0; i < options.size(); i++) argv.push_back((char*)options[i].c_str());
+		argv.push_back(0);		// terminated as the argv of main()
+		process_cmdline(int(argv.size()) - 1, &argv[0]);
+
+		if (source != "") {
+			gGlobal->gReader.setSource(name, source);
+			gGlobal->gInputFiles.push_front(name);
+		}
+		initFaustDirectories();
+		compileProcess(code);
+		res.fStatus = 0;
+
+	} catch (faustexception& e) {
+		res.fStatus = e.status();
+	} catch (...) {
+		delete g;
+		throw;
+	}
+
+	delete g;				// with the trees made by the compilation
+	res.fCode = code.str();
+	res.fErrors = errors.str();
+	return res;
+}
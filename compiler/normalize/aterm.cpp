@@ -1,5 +1,6 @@
 #include "aterm.hh"
 #include "ppsig.hh"
+#include "global.hh"
 //static void collectMulTerms (Tree& coef, map<Tree,int>& M, Tree t, bool invflag=false);
 
 #undef TRACE
@@ -18,11 +19,11 @@ aterm::aterm ()
 aterm::aterm (Tree t)
 {
 	#ifdef TRACE
-	cerr << "aterm::aterm (" << ppsig(t)<< ")" << endl;
+	gGlobal->gErrors << "aterm::aterm (" << ppsig(t)<< ")" << endl;
 	#endif
 	*this += t;
 	#ifdef TRACE
-    cerr << "aterm::aterm (" << ppsig(t)<< ") : -> " << *this << endl;
+    gGlobal->gErrors << "aterm::aterm (" << ppsig(t)<< ") : -> " << *this << endl;
 	#endif
 }
 	
@@ -52,6 +53,31 @@ static Tree simplifyingAdd(Tree t1, Tree t2)
 	}
 }
 
+/**
+ * Add a list of terms according to the -lb, -mb and -rb options : as a
+ * left-leaning chain ((a+b)+c)+d, a balanced tree (a+b)+(c+d) whose
+ * additions are independent, or a right-leaning chain a+(b+(c+d))
+ */
+static Tree balancedSum(const vector<Tree>& v, int lo, int hi)
+{
+	Tree s = tree(0);
+
+	if (hi - lo == 1) {
+		s = v[lo];
+
+	} else if (gGlobal->gBalancedSwitch == 1 && hi - lo > 1) {
+		int mid = (lo + hi) / 2;
+		s = simplifyingAdd(balancedSum(v, lo, mid), balancedSum(v, mid, hi));
+
+	} else if (gGlobal->gBalancedSwitch == 2) {
+		for (int i = hi-1; i >= lo; i--) s = simplifyingAdd(v[i], s);
+
+	} else {
+		for (int i = lo; i < hi; i++) s = simplifyingAdd(s, v[i]);
+	}
+	return s;
+}
+
 /**
  * return the corresponding normalized expression tree
  */
@@ -61,24 +87,26 @@ Tree aterm::normalizedTree() const
 	// store positive and negative tems by order and sign
 	// positive terms are stored in P[]
 	// negative terms are inverted (made positive) and stored in N[]
+	vector<Tree> PT[4], NT[4];
 	Tree P[4], N[4];
 	
-	// prepare
-	for (int order = 0; order < 4; order++) 	P[order] = N[order] = tree(0);
-	
-	// sum by order and sign
+	// collect by order and sign
 	for (SM::const_iterator p = fSig2MTerms.begin(); p != fSig2MTerms.end(); p++) {
 		const mterm& m = p->second;	
 		if (m.isNegative()) {
 			Tree t = m.normalizedTree(false, true);
-			int order = getSigOrder(t);
-			N[order] = simplifyingAdd(N[order],t);
+			NT[getSigOrder(t)].push_back(t);
 		} else {
 			Tree t = m.normalizedTree();
-			int order = getSigOrder(t);
-			P[order] = simplifyingAdd(P[order],t);
+			PT[getSigOrder(t)].push_back(t);
 		}
 	}
+
+	// sum by order and sign
+	for (int order = 0; order < 4; order++) {
+		P[order] = balancedSum(PT[order], 0, PT[order].size());
+		N[order] = balancedSum(NT[order], 0, NT[order].size());
+	}
 	
 	// combine sums
 	Tree SUM = tree(0);
@@ -128,6 +156,7 @@ const aterm& aterm::operator += (Tree t)
 {
 	int		op;
 	Tree	x,y;
+	tvec	terms;
 
 	assert(t!=0);
 
@@ -135,6 +164,9 @@ const aterm& aterm::operator += (Tree t)
 		*this += x;
 		*this += y;
 
+	} else if (isSigSum(t, terms)) {
+		for (unsigned int i = 0; i < terms.size(); i++) *this += terms[i];
+
 	} else if (isSigBinOp(t, &op, x, y) && (op == kSub)) {
 		*this += x;
 		*this -= y;
@@ -155,6 +187,7 @@ const aterm& aterm::operator -= (Tree t)
 {
 	int		op;
 	Tree	x,y;
+	tvec	terms;
 
 	assert(t!=0);
 
@@ -162,6 +195,9 @@ const aterm& aterm::operator -= (Tree t)
 		*this -= x;
 		*this -= y;
 
+	} else if (isSigSum(t, terms)) {
+		for (unsigned int i = 0; i < terms.size(); i++) *this -= terms[i];
+
 	} else if (isSigBinOp(t, &op, x, y) && (op == kSub)) {
 		*this -= x;
 		*this += y;
@@ -180,11 +216,11 @@ const aterm& aterm::operator -= (Tree t)
 const aterm& aterm::operator += (const mterm& m)
 {
 	#ifdef TRACE
-    cerr << *this << " aterm::+= " << m << endl;
+    gGlobal->gErrors << *this << " aterm::+= " << m << endl;
 	#endif
 	Tree sig = m.signatureTree();
 	#ifdef TRACE
-    cerr << "signature " << *sig << endl;
+    gGlobal->gErrors << "signature " << *sig << endl;
 	#endif
 	SM::const_iterator p = fSig2MTerms.find(sig);
 	if (p == fSig2MTerms.end()) {
@@ -0,0 +1,276 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2004 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+
+
+
+
+#include <stdio.h>
+#include <limits.h>
+#include <vector>
+#include <algorithm>
+
+#include "signals.hh"
+#include "sigprint.hh"
+#include "recursivness.hh"
+#include "firrecognition.hh"
+
+using namespace std;
+
+
+/*****************************************************************************
+						 FIR recognition
+*****************************************************************************/
+
+/**
+ * A term of a sum : c*x@d, the sign of the term being already applied to c
+ */
+struct firterm
+{
+	Tree	fExp;		///< the original term
+	bool	fNeg;		///< true if the term is subtracted
+	Tree	fDelayed;	///< the delayed signal x@d
+	Tree	fSig;		///< the signal x
+	int		fDelay;		///< the delay d
+	double	fCoef;		///< the coefficient c
+	bool	fReal;		///< true if c is a real constant
+	bool	fUsed;		///< true if the term has been absorbed by a FIR
+};
+
+static Tree makeFIRKey(int minTaps);
+static Tree recognition (Tree k, int minTaps, Tree t);
+static Tree computeRecognition (Tree k, int minTaps, Tree t);
+static Tree recognizeSum (Tree k, int minTaps, Tree t);
+
+
+Tree firRecognition (Tree L, int minTaps)
+{
+	return recognition(makeFIRKey(minTaps), minTaps, L);
+}
+
+
+// -- implementation -----------------
+
+static Tree makeFIRKey(int minTaps)
+{
+	char 	name[256];
+	snprintf(name, 256, "FIR RECOGNITION %d : ", minTaps);
+	return tree(unique(name));
+}
+
+static Tree recognition (Tree k, int minTaps, Tree t)
+{
+	Tree v;
+
+	if (t->arity() == 0) {
+		return t;
+
+	} else if (getProperty(t, k, v)) {
+		// nil indicates that the term is unchanged
+		return isNil(v) ? t : v;
+
+	} else {
+		v = computeRecognition(k, minTaps, t);
+		if (v != t) {
+			setProperty(t, k, v);
+		} else {
+			setProperty(t, k, nil);
+		}
+		return v;
+	}
+}
+
+static Tree computeRecognition (Tree k, int minTaps, Tree exp)
+{
+	int 	op;
+	Tree	x, y, id, size, content, var, body;
+
+	if (isSigTable(exp, id, size, content)) {
+		// table contents are compiled separately
+		return exp;
+
+	} else if (isRec(exp, var, body)) {
+		setProperty(exp, k, nil);
+		return rec(var, recognition(k, minTaps, body));
+
+	} else if (isSigBinOp(exp, &op, x, y) && (op == kAdd || op == kSub)) {
+		return recognizeSum(k, minTaps, exp);
+
+	} else {
+		tvec br;
+		int n = exp->arity();
+		for (int i = 0; i < n; i++) {
+			br.push_back(recognition(k, minTaps, exp->branch(i)));
+		}
+		return tree(exp->node(), br);
+	}
+}
+
+
+/**
+ * Decompose exp as x@d with d a constant integer delay (possibly 0)
+ */
+static void decomposeDelay (Tree exp, Tree& x, int& d)
+{
+	Tree dl;
+
+	if (isSigFixDelay(exp, x, dl) && isSigInt(dl, &d)) {
+		return;
+	} else if (isSigDelay1(exp, x)) {
+		d = 1;
+	} else {
+		x = exp;
+		d = 0;
+	}
+}
+
+/**
+ * Decompose a term as c*x@d or x@d*c or x@d
+ */
+static void decomposeTerm (Tree exp, bool neg, firterm& term)
+{
+	int		op, i;
+	double	r;
+	Tree	x, y;
+
+	term.fExp  = exp;
+	term.fNeg  = neg;
+	term.fCoef = 1.0;
+	term.fReal = false;
+	term.fUsed = false;
+
+	if (isSigBinOp(exp, &op, x, y) && (op == kMul)) {
+		if (isSigInt(y, &i) || isSigReal(y, &r)) { swap(x, y); }
+
+		if (isSigInt(x, &i) && !isNum(y)) {
+			term.fCoef = i;
+			exp = y;
+		} else if (isSigReal(x, &r) && !isNum(y)) {
+			term.fCoef = r;
+			term.fReal = true;
+			exp = y;
+		}
+	}
+	if (neg) term.fCoef = -term.fCoef;
+	term.fDelayed = exp;
+	decomposeDelay(exp, term.fSig, term.fDelay);
+}
+
+/**
+ * Flatten a tree of additions and subtractions into a list of terms
+ */
+static void collectTerms (Tree exp, bool neg, vector<firterm>& terms)
+{
+	int 	op;
+	Tree	x, y;
+
+	if (isSigBinOp(exp, &op, x, y) && (op == kAdd)) {
+		collectTerms(x, neg, terms);
+		collectTerms(y, neg, terms);
+	} else if (isSigBinOp(exp, &op, x, y) && (op == kSub)) {
+		collectTerms(x, neg, terms);
+		collectTerms(y, !neg, terms);
+	} else {
+		firterm	term;
+		decomposeTerm(exp, neg, term);
+		terms.push_back(term);
+	}
+}
+
+/**
+ * Try to build a FIR with the terms of the sum that delay the signal x.
+ * The FIR is rejected if it has not enough taps, if the coefficients are
+ * too sparse, if it would not be a real signal, or if x could depend on the
+ * FIR itself (recursive x not used at delay 0). The input of the FIR
+ * is x@0 as it appears in the sum, recursive projections being only
+ * accessed through delays.
+ */
+static Tree makeFIR (int minTaps, Tree x, vector<firterm>& terms)
+{
+	int		ntaps = 0, maxd = 0, mind = INT_MAX;
+	bool	real = false;
+	Tree	input = x;
+
+	if (isNum(x)) return nil;
+
+	for (unsigned int i = 0; i < terms.size(); i++) {
+		if (!terms[i].fUsed && terms[i].fSig == x) {
+			ntaps++;
+			real |= terms[i].fReal;
+			maxd = max(maxd, terms[i].fDelay);
+			mind = min(mind, terms[i].fDelay);
+			if (terms[i].fDelay == 0) input = terms[i].fDelayed;
+		}
+	}
+
+	if ((ntaps < minTaps) || (2*ntaps < maxd+1) || !real) return nil;
+	if ((mind > 0) && !isNil(symlist(x))) return nil;
+
+	vector<double> coefs(maxd+1, 0.0);
+	for (unsigned int i = 0; i < terms.size(); i++) {
+		if (!terms[i].fUsed && terms[i].fSig == x) {
+			coefs[terms[i].fDelay] += terms[i].fCoef;
+			terms[i].fUsed = true;
+		}
+	}
+
+	tvec c;
+	for (unsigned int i = 0; i < coefs.size(); i++) {
+		c.push_back(sigReal(coefs[i]));
+	}
+	return sigFIR(input, c);
+}
+
+static Tree recognizeSum (Tree k, int minTaps, Tree exp)
+{
+	vector<firterm> terms;
+	collectTerms(exp, false, terms);
+
+	// build the FIRs, in the order of appearance of their input signals
+	Tree sum = nil;
+	for (unsigned int i = 0; i < terms.size(); i++) {
+		if (!terms[i].fUsed) {
+			Tree fir = makeFIR(minTaps, terms[i].fSig, terms);
+			if (!isNil(fir)) {
+				fir = recognition(k, minTaps, fir);
+				sum = isNil(sum) ? fir : sigAdd(sum, fir);
+			}
+		}
+	}
+
+	if (isNil(sum)) {
+		// no FIR found, visit the branches of the sum
+		tvec br;
+		for (int i = 0; i < exp->arity(); i++) {
+			br.push_back(recognition(k, minTaps, exp->branch(i)));
+		}
+		return tree(exp->node(), br);
+	}
+
+	// add the remaining terms
+	for (unsigned int i = 0; i < terms.size(); i++) {
+		if (!terms[i].fUsed) {
+			Tree t = recognition(k, minTaps, terms[i].fExp);
+			sum = (terms[i].fNeg) ? sigSub(sum, t) : sigAdd(sum, t);
+		}
+	}
+	return sum;
+}
@@ -0,0 +1,37 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2004 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+ 
+ 
+
+
+
+#ifndef _FIRRECOGNITION_
+#define _FIRRECOGNITION_
+
+#include "signals.hh"
+
+/**
+ * Replace sums of the form c0*x + c1*x@1 + ... + cn*x@n, with constant
+ * coefficients and at least minTaps terms, by sigFIR(x, {c0,...,cn})
+ */
+Tree firRecognition (Tree L, int minTaps);
+
+#endif
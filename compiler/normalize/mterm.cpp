@@ -3,6 +3,8 @@
 #include "ppsig.hh"
 #include "xtended.hh"
 #include <assert.h>
+#include "exception.hh"
+#include "global.hh"
 //static void collectMulTerms (Tree& coef, map<Tree,int>& M, Tree t, bool invflag=false);
 
 #undef TRACE
@@ -13,7 +15,7 @@ typedef map<Tree,int> MP;
 
 mterm::mterm ()            		: fCoef(sigInt(0)) {}
 mterm::mterm (int k)            : fCoef(sigInt(k)) {}
-mterm::mterm (double k)         : fCoef(sigReal(k)) {}	// cerr << "DOUBLE " << endl; }
+mterm::mterm (double k)         : fCoef(sigReal(k)) {}	// gErrors << "DOUBLE " << endl; }
 mterm::mterm (const mterm& m)   : fCoef(m.fCoef), fFactors(m.fFactors) {}
 
 /**
@@ -377,7 +379,7 @@ static void combineMulLeft(Tree& R, Tree A)
 {
 	if (R && A) 	R = sigMul(R,A);
 	else if (A)		R = A;
-    else exit(1);
+    else throw faustexception();
 }
 
 /**
@@ -387,7 +389,7 @@ static void combineDivLeft(Tree& R, Tree A)
 {
 	if (R && A) 	R = sigDiv(R,A);
 	else if (A)		R = sigDiv(tree(1.0f),A);
-    else exit(1);
+    else throw faustexception();
 }
 
 /**	
@@ -396,7 +398,7 @@ static void combineDivLeft(Tree& R, Tree A)
 static void combineMulDiv(Tree& M, Tree& D, Tree f, int q)
 {
 	#ifdef TRACE
-	cerr << "combineMulDiv (" << M << "/"  << D << "*" << ppsig(f)<< "**" << q << endl;
+	gGlobal->gErrors << "combineMulDiv (" << M << "/"  << D << "*" << ppsig(f)<< "**" << q << endl;
 	#endif
 	if (f) {
         assert(q != 0);
@@ -447,8 +449,8 @@ Tree mterm::normalizedTree(bool signatureMode, bool negativeMode) const
 				}
 			}
 		}
-		if (A[0] != 0) cerr << "A[0] == " << *A[0] << endl; 
-		if (B[0] != 0) cerr << "B[0] == " << *B[0] << endl; 
+		if (A[0] != 0) gGlobal->gErrors << "A[0] == " << *A[0] << endl; 
+		if (B[0] != 0) gGlobal->gErrors << "B[0] == " << *B[0] << endl; 
 		// en principe ici l'order zero est vide car il correspond au coef numerique
 		assert(A[0] == 0);
 		assert(B[0] == 0);
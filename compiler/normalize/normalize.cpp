@@ -12,6 +12,7 @@
 
 #include "mterm.hh"
 #include "aterm.hh"
+#include "global.hh"
 
 #if 0
 static void countAddTerm (map<Tree,Tree>& M, Tree t, bool invflag);
@@ -32,7 +33,7 @@ static void factorizeAddTerm(map<Tree,Tree>& M);
 Tree normalizeAddTerm(Tree t)
 {
 #ifdef TRACE
-	cerr << "START normalizeAddTerm : " << ppsig(t) << endl;
+	gGlobal->gErrors << "START normalizeAddTerm : " << ppsig(t) << endl;
 #endif
 	
 	aterm A(t);
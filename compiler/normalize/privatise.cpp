@@ -28,6 +28,7 @@
 #include "sigprint.hh"
 #include "sigtyperules.hh"
 #include "privatise.hh"
+#include "exception.hh"
 
 
 /*****************************************************************************
@@ -124,7 +125,7 @@ static Tree computePrivatisation(const Tree& k, const Tree& exp)
 		/*	On ne visite pas les contenus des tables
 		*/
 		printf("erreur 1 dans computePrivatisation\n");
-		exit(1);
+		throw faustexception();
 
 	} else if ( isRec(exp, var, body) ) {
 		/*	On ne visite pas les contenus des tables
@@ -167,7 +168,7 @@ static Tree labelize(const Tree& newid, const Tree& exp)
 	} else {
 
 		printf("erreur labelize\n");
-		exit(1);
+		throw faustexception();
 	}
 
 	return exp;
@@ -38,6 +38,7 @@
 #include "compatibility.hh"
 
 #include "normalize.hh"
+#include "global.hh"
 
 #undef TRACE
 
@@ -51,7 +52,7 @@ static Tree traced_simplification(Tree sig)
 {
 	assert(sig);
 #ifdef TRACE
-    cerr << ++TABBER << "Start simplification of : " << ppsig(sig) << endl;
+    gGlobal->gErrors << ++TABBER << "Start simplification of : " << ppsig(sig) << endl;
 	/*
 	fprintf(stderr, "\nStart simplification of : ");
 	printSignal(sig, stderr);
@@ -61,7 +62,7 @@ static Tree traced_simplification(Tree sig)
 	Tree r = simplification(sig);
 	assert(r!=0);
 #ifdef TRACE
-    cerr << --TABBER << "Simplification of : " << ppsig(sig) << " Returns : " << ppsig(r) << endl;
+    gGlobal->gErrors << --TABBER << "Simplification of : " << ppsig(sig) << " Returns : " << ppsig(r) << endl;
 	/*
 	fprintf(stderr, "Simplification of : ");
 	printSignal(sig, stderr);
@@ -86,6 +87,7 @@ static Tree simplification (Tree sig)
 	assert(sig);
 	int		opnum;
 	Tree	t1, t2, t3, t4;
+	tvec	terms;
 
 	xtended* xt = (xtended*) getUserData(sig);
 	// primitive elements
@@ -117,6 +119,11 @@ static Tree simplification (Tree sig)
 
 		else 								return normalizeAddTerm(sig);
 
+	} else if (isSigSum(sig, terms)) {
+
+		// the n-ary sums are normalized at once
+		return normalizeAddTerm(sig);
+
 	} else if (isSigDelay1(sig, t1)) {
 
 		return normalizeDelay1Term (t1);
@@ -212,6 +219,7 @@ static Tree sigMap (Tree key, tfun f, Tree t)
             setProperty(t, key, nil);
         } else {
             setProperty(t, key, r2);
+            keepDefinitionName(t, r2);
         }
         return r2;
     }
@@ -297,9 +305,9 @@ static void eraseProperties (Tree key, Tree t)
 
 void eraseAllProperties(Tree t)
 {
-    cerr << "begin eraseAllProperties" << endl;
+    gGlobal->gErrors << "begin eraseAllProperties" << endl;
 	eraseProperties(tree(Node(unique("erase_"))), t);
-    cerr << "end eraseAllProperties" << endl;
+    gGlobal->gErrors << "end eraseAllProperties" << endl;
 }
 #endif
 
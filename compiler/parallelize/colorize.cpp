@@ -6,6 +6,7 @@
 
 #include "colorize.h"
 #include "signals.hh"
+#include "global.hh"
 
 using namespace std; 
 
@@ -59,11 +60,9 @@ static void clearColors(Tree exp);							///< remove the color property of exp
 int allocateColor(Tree exp)
 {
 //	return int(exp); 
-	static map<Tree,int> colorMap;
-	static int nextFreeColor = 1;
-	int& color = colorMap[exp];
+	int& color = gGlobal->gColorMap[exp];
 	if (!color)
-		color = nextFreeColor++;
+		color = gGlobal->gNextFreeColor++;
 	return color;
 }
 
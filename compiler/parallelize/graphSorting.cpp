@@ -24,11 +24,16 @@ static void setLevel(int order, const lset& T1, lset& T2, lgraph& V)
 }
 
 
-static void resetOrder(Loop* l)
+/**
+ * Reset the order of the loops reachable from l, each one once (the graph
+ * of loops is a DAG, its paths can be exponentially many)
+ */
+static void resetOrder(Loop* l, lset& visited)
 {
+    if (!visited.insert(l).second) return;
     l->fOrder = -1;
     for (lset::const_iterator p = l->fBackwardLoopDependencies.begin(); p!=l->fBackwardLoopDependencies.end(); p++) {
-        resetOrder(*p);
+        resetOrder(*p, visited);
     }
 }
 /**
@@ -37,11 +42,11 @@ static void resetOrder(Loop* l)
  */
 void sortGraph(Loop* root, lgraph& V)
 {
-    lset            T1, T2;
+    lset            T1, T2, visited;
     int             level;
     
     assert(root);
-    resetOrder(root);
+    resetOrder(root, visited);
     T1.insert(root); level=0; V.clear();
     do {
         setLevel(level, T1, T2, V); 
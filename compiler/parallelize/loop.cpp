@@ -1,7 +1,6 @@
+#include <ctype.h>
+#include <sstream>
 #include "loop.hh"
-extern bool gVectorSwitch;
-extern bool gOpenMPSwitch;
-extern bool gOpenMPLoop;
 
 using namespace std;
 
@@ -106,8 +105,8 @@ void Loop::addPostCode (const string& str)
 
 
 /**
- * Absorb a loop by copying its recursive dependencies, its loop dependencies
- * and its lines of exec and post exec code. 
+ * Absorb a loop by copying its recursive dependencies, its loop dependencies,
+ * its names and its lines of exec and post exec code. 
  * @param l the Loop to be absorbed
  */
 void Loop::absorb (Loop* l)    
@@ -115,6 +114,7 @@ void Loop::absorb (Loop* l)
     // the loops must have the same number of iterations
     assert(fSize == l->fSize); 
     fRecSymbolSet = setUnion(fRecSymbolSet, l->fRecSymbolSet);
+    fNames.insert(l->fNames.begin(), l->fNames.end());
 
     // update loop dependencies by adding those from the absorbed loop
     fBackwardLoopDependencies.insert(l->fBackwardLoopDependencies.begin(), l->fBackwardLoopDependencies.end());  
@@ -243,3 +243,85 @@ void Loop::concat(Loop* l)
 	fExtraLoops.push_front(l);
 	fBackwardLoopDependencies = l->fBackwardLoopDependencies;	
 }
+
+/**
+ * Compute the signature of a loop : its lines of exec code where the
+ * identifiers are replaced by their rank of first occurrence. Loops
+ * computing the same expressions on different vectors (typically the
+ * channels of par(i,N,filter)) have the same signature.
+ */
+string Loop::signature()
+{
+    map<string,int>     rank;
+    stringstream        sig;
+
+    sig << fSize;
+    for (list<string>::const_iterator s = fExecCode.begin(); s != fExecCode.end(); s++) {
+        const string& line = *s;
+        sig << '\n';
+        size_t i = 0;
+        while (i < line.size()) {
+            if (isalpha(line[i]) || line[i] == '_') {
+                size_t j = i;
+                while (j < line.size() && (isalnum(line[j]) || line[j] == '_')) j++;
+                string id = line.substr(i, j-i);
+                if (rank.find(id) == rank.end()) {
+                    int r = (int)rank.size();
+                    rank[id] = r;
+                }
+                sig << '$' << rank[id];
+                i = j;
+            } else if (isdigit(line[i])) {
+                // numbers (including their suffix) are kept unchanged
+                while (i < line.size() && (isalnum(line[i]) || line[i] == '.')) sig << line[i++];
+            } else {
+                sig << line[i++];
+            }
+        }
+    }
+    return sig.str();
+}
+
+/**
+ * Print isomorphic and independent loops as a single loop. The lines of
+ * exec code of the different loops (the lanes) are interleaved, so that
+ * the recursions of the different lanes are computed in parallel.
+ * @param n number of tabs of indentation
+ * @param lanes the loops, with the same signature and no extra loops
+ * @param fout output stream
+ */
+void printLanesln(int n, const vector<Loop*>& lanes, ostream& fout)
+{
+    Loop* l0 = lanes[0];
+
+    tab(n,fout); fout << "// LOOP " << l0 << ", " << lanes.size() << " LANES";
+
+    list<string> pre, post;
+    for (unsigned int k = 0; k < lanes.size(); k++) {
+        pre.insert(pre.end(), lanes[k]->fPreCode.begin(), lanes[k]->fPreCode.end());
+        post.insert(post.end(), lanes[k]->fPostCode.begin(), lanes[k]->fPostCode.end());
+    }
+    if (pre.size()>0) {
+        tab(n,fout); fout << "// pre processing";
+        printlines(n, pre, fout);
+    }
+
+    vector<list<string>::const_iterator> lines;
+    for (unsigned int k = 0; k < lanes.size(); k++) {
+        lines.push_back(lanes[k]->fExecCode.begin());
+    }
+    tab(n,fout); fout << "// exec code";
+    tab(n,fout); fout << "for (int i=0; i<" << l0->fSize << "; i++) {";
+    for (unsigned int j = 0; j < l0->fExecCode.size(); j++) {
+        for (unsigned int k = 0; k < lanes.size(); k++) {
+            tab(n+1,fout); fout << *(lines[k]++);
+        }
+    }
+    tab(n,fout); fout << "}";
+
+    if (post.size()>0) {
+        tab(n,fout); fout << "// post processing";
+        printlines(n, post, fout);
+    }
+    tab(n,fout);
+}
@@ -41,6 +41,7 @@ using namespace std;
 #include <stack>
 #include <set>
 #include <map>
+#include <vector>
 #include "tlib.hh"
 
 #define kMaxCategory 32
@@ -69,6 +70,7 @@ struct Loop
     list<Loop*>			fExtraLoops;		///< extra loops that where in sequences
 
     int                 fPrinted;           ///< true when loop has been printed (to track multi-print errors)
+    set<string>         fNames;             ///< definitions of the signals computed by the loop (-prof)
 
 public:
     Loop(Tree recsymbol, Loop* encl, const string& size);   ///< create a recursive loop
@@ -88,6 +90,10 @@ public:
     void absorb(Loop* l);                   ///< absorb a loop inside this one
     // new method
     void concat(Loop* l);
+
+    string signature();                     ///< exec code up to a renaming of identifiers
 };
 
+void printLanesln(int n, const vector<Loop*>& lanes, ostream& fout);   ///< print isomorphic loops as a single loop
+
 #endif
@@ -0,0 +1,418 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+/*
+	astcache : binary cache of the parsed library files
+
+	An entry is the hash-consed DAG of the definitions, in post order :
+	each tree is written once, after its branches, and the branches are
+	given by their position. The numbers are written in the byte order of
+	the machine, the cache being local to it.
+
+	header		"FAUSTAST", format version, compiler version, primitives
+				hash, key, content length
+	symbols		count, then for each symbol : length, characters
+	trees		count, then for each tree : node kind, node value,
+				arity, branches
+	root		the definitions
+	lines		count, then (identifier, line) pairs
+	metadata	count, then (key, value) pairs
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifndef WIN32
+#include <unistd.h>
+#endif
+#ifndef WIN32
+#include <dirent.h>
+#include <utime.h>
+#endif
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <algorithm>
+
+#include "astcache.hh"
+#include "compatibility.hh"
+#include "boxes.hh"
+#include "signals.hh"
+
+static const char	kMagic[] 		= "FAUSTAST";
+static const int	kFormatVersion	= 2;	///< to increment when the parser or the box constructors change
+static const int	kMaxEntries		= 256;	///< the least recently used entries are removed beyond
+
+extern string		gFaustVersion;
+
+enum { kCacheInt, kCacheDouble, kCacheSym, kCachePrim };
+
+/**
+ * The primitives the parser puts in the boxes (boxPrim1 to boxPrim5) :
+ * their addresses are written by position in this table, and its names
+ * are part of the key of the entries
+ */
+#define PRIM(type, f)	{ (void*)(type)f, #f }
+
+static const struct { void* fPrim; const char* fName; } gPrimTable[] = {
+	PRIM(prim1, sigDelay1), PRIM(prim1, sigIntCast), PRIM(prim1, sigFloatCast),
+
+	PRIM(prim2, sigAdd), PRIM(prim2, sigSub), PRIM(prim2, sigMul), PRIM(prim2, sigDiv), PRIM(prim2, sigRem),
+	PRIM(prim2, sigFixDelay), PRIM(prim2, sigPrefix), PRIM(prim2, sigAttach),
+	PRIM(prim2, sigAND), PRIM(prim2, sigOR), PRIM(prim2, sigXOR),
+	PRIM(prim2, sigLeftShift), PRIM(prim2, sigRightShift),
+	PRIM(prim2, sigLT), PRIM(prim2, sigLE), PRIM(prim2, sigGT), PRIM(prim2, sigGE),
+	PRIM(prim2, sigEQ), PRIM(prim2, sigNE),
+
+	PRIM(prim3, sigReadOnlyTable), PRIM(prim3, sigSelect2),
+	PRIM(prim4, sigSelect3),
+	PRIM(prim5, sigWriteReadTable)
+};
+
+static const int kPrimCount = sizeof(gPrimTable) / sizeof(gPrimTable[0]);
+
+
+/**
+ * 64 bits FNV-1a hash of the content of a file, h continues a previous hash
+ */
+static unsigned long long contentHash(const string& text, unsigned long long h = 14695981039346656037ULL)
+{
+	for (unsigned int i = 0; i < text.size(); i++) {
+		h ^= (unsigned char)text[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+/**
+ * Hash of the primitives table : an entry written by a compiler whose
+ * table is different would give other primitives
+ */
+static unsigned long long primHash()
+{
+	string names;
+	for (int k = 0; k < kPrimCount; k++) { names += gPrimTable[k].fName; names += ' '; }
+	return contentHash(names);
+}
+
+/**
+ * The key of the entry of a file : its content, the version of the
+ * compiler and the primitives table, so that another compiler sharing
+ * the directory never loads the entries of this one
+ */
+static unsigned long long entryKey(const string& text)
+{
+	unsigned long long h = contentHash(gFaustVersion);
+	h = contentHash(string((const char*)&kFormatVersion, sizeof(kFormatVersion)), h);
+	unsigned long long p = primHash();
+	h = contentHash(string((const char*)&p, sizeof(p)), h);
+	return contentHash(text, h);
+}
+
+/**
+ * The directory of the cache, created if needed, "" if there is none
+ */
+static string cacheDirectory()
+{
+	string dir;
+	const char* d;
+
+	if ((d = getenv("FAUST_CACHE_DIR")) && d[0]) {
+		dir = d;
+	} else if ((d = getenv("XDG_CACHE_HOME")) && d[0]) {
+		dir = string(d) + "/faust";
+	} else if ((d = getenv("HOME")) && d[0]) {
+		string cache = string(d) + "/.cache";
+		mkdir(cache.c_str(), S_IRWXU);
+		dir = cache + "/faust";
+	} else {
+		return "";
+	}
+	mkdir(dir.c_str(), S_IRWXU);
+
+	struct stat st;
+	return (stat(dir.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) ? dir : "";
+}
+
+static string cachePath(const string& dir, unsigned long long h)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "/%016llx.ast", h);
+	return dir + name;
+}
+
+/**
+ * Keep at most kMaxEntries entries in the directory, removing the least
+ * recently used ones (a load touches its entry). Not done on Windows.
+ */
+static void evictEntries(const string& dir)
+{
+#ifndef WIN32
+	DIR* d = opendir(dir.c_str());
+	if (!d) return;
+
+	vector<pair<time_t,string> > entries;
+	struct dirent* e;
+	while ((e = readdir(d))) {
+		string name = e->d_name;
+		struct stat st;
+		if (name.size() > 4 && name.compare(name.size() - 4, 4, ".ast") == 0
+			&& stat((dir + "/" + name).c_str(), &st) == 0) {
+			entries.push_back(make_pair(st.st_mtime, dir + "/" + name));
+		}
+	}
+	closedir(d);
+
+	if (int(entries.size()) <= kMaxEntries) return;
+	sort(entries.begin(), entries.end());
+	for (unsigned int i = 0; i < entries.size() - kMaxEntries; i++) remove(entries[i].second.c_str());
+#endif
+}
+
+
+//------------------------------- writing -------------------------------
+
+static void putInt(string& out, int x)		{ out.append((const char*)&x, sizeof(x)); }
+static void putDouble(string& out, double x)	{ out.append((const char*)&x, sizeof(x)); }
+
+/**
+ * Collect the symbols and the trees of the entry, the trees in post order
+ */
+class ASTWriter
+{
+	map<Tree,int>	fTreeIndex;
+	map<Sym,int>	fSymIndex;
+
+ public:
+	string			fSymbols;
+	string			fTrees;
+	int				fSymCount;
+	int				fTreeCount;
+	bool			fValid;			///< false if a tree can't be written
+
+	ASTWriter() : fSymCount(0), fTreeCount(0), fValid(true) {}
+
+	int add(Tree t)
+	{
+		map<Tree,int>::iterator p = fTreeIndex.find(t);
+		if (p != fTreeIndex.end()) return p->second;
+
+		vector<int> br;
+		for (int i = 0; i < t->arity(); i++) br.push_back(add(t->branch(i)));
+
+		const Node& n = t->node();
+		switch (n.type()) {
+			case kIntNode :
+				fTrees += char(kCacheInt); putInt(fTrees, n.getInt()); break;
+			case kDoubleNode :
+				fTrees += char(kCacheDouble); putDouble(fTrees, n.getDouble()); break;
+			case kSymNode :
+				fTrees += char(kCacheSym); putInt(fTrees, symIndex(n.getSym())); break;
+			default : {
+				int k = 0;
+				while (k < kPrimCount && gPrimTable[k].fPrim != n.getPointer()) k++;
+				if (k == kPrimCount) fValid = false;
+				fTrees += char(kCachePrim); putInt(fTrees, k);
+			}
+		}
+		putInt(fTrees, int(br.size()));
+		for (unsigned int i = 0; i < br.size(); i++) putInt(fTrees, br[i]);
+
+		return fTreeIndex[t] = fTreeCount++;
+	}
+
+	int symIndex(Sym s)
+	{
+		map<Sym,int>::iterator p = fSymIndex.find(s);
+		if (p != fSymIndex.end()) return p->second;
+
+		const char* str = name(s);
+		putInt(fSymbols, int(strlen(str)));
+		fSymbols += str;
+		return fSymIndex[s] = fSymCount++;
+	}
+};
+
+/**
+ * Write the entry of a parsed file. The entry is written in a temporary
+ * file and renamed, for the compilations running at the same time.
+ */
+void saveParsedFile(const string& text, const ParsedFile& pf)
+{
+	string dir = cacheDirectory();
+	if (dir == "") return;
+
+	ASTWriter w;
+	int root = w.add(pf.fDefinitions);
+	vector<int> lines, meta;
+	for (unsigned int i = 0; i < pf.fDefLines.size(); i++) lines.push_back(w.add(pf.fDefLines[i].first));
+	for (unsigned int i = 0; i < pf.fMetadata.size(); i++) {
+		meta.push_back(w.add(pf.fMetadata[i].first));
+		meta.push_back(w.add(pf.fMetadata[i].second));
+	}
+	if (!w.fValid) return;
+
+	unsigned long long h = entryKey(text);
+	unsigned long long p = primHash();
+	string out(kMagic, 8);
+	putInt(out, kFormatVersion);
+	putInt(out, int(gFaustVersion.size()));
+	out += gFaustVersion;
+	out.append((const char*)&p, sizeof(p));
+	out.append((const char*)&h, sizeof(h));
+	putInt(out, int(text.size()));
+	putInt(out, w.fSymCount);
+	out += w.fSymbols;
+	putInt(out, w.fTreeCount);
+	out += w.fTrees;
+	putInt(out, root);
+	putInt(out, int(lines.size()));
+	for (unsigned int i = 0; i < lines.size(); i++) {
+		putInt(out, lines[i]);
+		putInt(out, pf.fDefLines[i].second);
+	}
+	putInt(out, int(pf.fMetadata.size()));
+	for (unsigned int i = 0; i < meta.size(); i++) putInt(out, meta[i]);
+
+	string path = cachePath(dir, h);
+	stringstream tmp; tmp << path << "." << getpid();
+	{
+		ofstream f(tmp.str().c_str(), ios::binary);
+		f.write(out.data(), out.size());
+		if (!f) { f.close(); remove(tmp.str().c_str()); return; }
+	}
+	if (rename(tmp.str().c_str(), path.c_str()) != 0) remove(tmp.str().c_str());
+	evictEntries(dir);
+}
+
+
+//------------------------------- reading -------------------------------
+
+/**
+ * Bounds checked reading of an entry
+ */
+class ASTReader
+{
+	const string&	fIn;
+	unsigned int	fPos;
+
+ public:
+	bool			fValid;			///< false once the entry is found truncated or inconsistent
+
+	ASTReader(const string& in) : fIn(in), fPos(0), fValid(true) {}
+
+	bool get(void* dst, unsigned int n)
+	{
+		if (!fValid || fIn.size() - fPos < n) { fValid = false; return false; }
+		memcpy(dst, fIn.data() + fPos, n);
+		fPos += n;
+		return true;
+	}
+
+	int getInt()	{ int x = 0; get(&x, sizeof(x)); return x; }
+
+	/// an index in [0, n[
+	int getIndex(int n)
+	{
+		int x = getInt();
+		if (x < 0 || x >= n) { fValid = false; return 0; }
+		return x;
+	}
+
+	string getString(int n)
+	{
+		if (n < 0 || !fValid || fIn.size() - fPos < unsigned(n)) { fValid = false; return ""; }
+		fPos += n;
+		return fIn.substr(fPos - n, n);
+	}
+
+	bool atEnd()	{ return fPos == fIn.size(); }
+};
+
+/**
+ * Load the entry of the file whose content is text
+ */
+bool loadParsedFile(const string& text, ParsedFile& pf)
+{
+	string dir = cacheDirectory();
+	if (dir == "") return false;
+
+	unsigned long long h = entryKey(text);
+	string path = cachePath(dir, h);
+	ifstream f(path.c_str(), ios::binary);
+	if (!f) return false;
+	stringstream buf; buf << f.rdbuf();
+	string in = buf.str();
+
+	ASTReader r(in);
+	char magic[8];
+	unsigned long long p2 = 0, h2 = 0;
+	if (!r.get(magic, 8) || memcmp(magic, kMagic, 8) != 0) return false;
+	if (r.getInt() != kFormatVersion) return false;
+	if (r.getString(r.getInt()) != gFaustVersion) return false;
+	if (!r.get(&p2, sizeof(p2)) || p2 != primHash()) return false;
+	if (!r.get(&h2, sizeof(h2)) || h2 != h) return false;
+	if (r.getInt() != int(text.size())) return false;
+
+	vector<Sym> syms(r.getIndex(in.size() + 1));
+	for (unsigned int i = 0; i < syms.size() && r.fValid; i++) {
+		syms[i] = symbol(r.getString(r.getInt()));
+	}
+
+	vector<Tree> trees(r.getIndex(in.size() + 1));
+	tvec br;
+	for (unsigned int i = 0; i < trees.size() && r.fValid; i++) {
+		char kind = 0;
+		r.get(&kind, 1);
+		Node n(0);
+		switch (kind) {
+			case kCacheInt : 	n = Node(r.getInt()); break;
+			case kCacheDouble :	{ double x = 0; r.get(&x, sizeof(x)); n = Node(x); break; }
+			case kCacheSym : 	n = Node(syms[r.getIndex(syms.size())]); break;
+			case kCachePrim : 	n = Node(gPrimTable[r.getIndex(kPrimCount)].fPrim); break;
+			default :			return false;
+		}
+		br.resize(r.getIndex(in.size() + 1));
+		for (unsigned int k = 0; k < br.size(); k++) br[k] = trees[r.getIndex(i)];
+		if (!r.fValid) return false;
+		trees[i] = tree(n, br);
+	}
+	if (!r.fValid || trees.empty()) return false;
+
+	pf.fDefinitions = trees[r.getIndex(trees.size())];
+	pf.fDefLines.resize(r.getIndex(in.size() + 1));
+	for (unsigned int i = 0; i < pf.fDefLines.size(); i++) {
+		pf.fDefLines[i].first = trees[r.getIndex(trees.size())];
+		pf.fDefLines[i].second = r.getInt();
+	}
+	pf.fMetadata.resize(r.getIndex(in.size() + 1));
+	for (unsigned int i = 0; i < pf.fMetadata.size(); i++) {
+		pf.fMetadata[i].first = trees[r.getIndex(trees.size())];
+		pf.fMetadata[i].second = trees[r.getIndex(trees.size())];
+	}
+	if (!r.fValid || !r.atEnd()) return false;
+#ifndef WIN32
+	utime(path.c_str(), 0);		// recently used, see evictEntries()
+#endif
+	return true;
+}
@@ -0,0 +1,62 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+#ifndef _ASTCACHE_
+#define _ASTCACHE_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "tlib.hh"
+
+using namespace std;
+
+/**
+ * Binary cache of the parsed library files, keyed by the hash of their
+ * content, of the compiler version and of its primitives table. An entry
+ * keeps what the parsing of the file produces : the list of definitions,
+ * the line of each definition (setDefProp) and the metadata declarations
+ * (declareMetadata), to be replayed when the entry is loaded.
+ *
+ * The cache is only used with -lc : the trees loaded from it are not made
+ * in the order of the parser, and as some passes order what they generate
+ * by tree address, the order of some declarations and expressions in the
+ * code may differ from a compilation without the cache (and so the float
+ * rounding of the reassociated expressions). The entries are in
+ * $FAUST_CACHE_DIR, or else in $XDG_CACHE_HOME/faust or $HOME/.cache/faust,
+ * created if needed. At most 256 entries are kept, the least recently
+ * used ones being removed when a new one is written (no limit on Windows).
+ *
+ * Any problem with the cache (no directory, corrupted or stale entry)
+ * only means that the file is parsed again.
+ */
+
+struct ParsedFile
+{
+    Tree                        fDefinitions;   ///< the result of the parser
+    vector<pair<Tree,int> >     fDefLines;      ///< the defined identifiers and their lines, in order
+    vector<pair<Tree,Tree> >    fMetadata;      ///< the declared (key, value), in order
+};
+
+bool    loadParsedFile(const string& text, ParsedFile& pf);     ///< false if text is not in the cache
+void    saveParsedFile(const string& text, const ParsedFile& pf);
+
+#endif
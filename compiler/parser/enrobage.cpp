@@ -29,16 +29,14 @@
 #include <stdlib.h>
 #include "compatibility.hh"
 #include "sourcefetcher.hh"
+#include "exception.hh"
+#include "global.hh"
 #include <errno.h>
 #include <climits>
 
-extern string       gFaustSuperSuperDirectory;
-extern string       gFaustSuperDirectory;
-extern string       gFaustDirectory;
-extern string       gMasterDirectory;
-extern string       gClassName;
-extern bool         gInlineArchSwitch;
-extern list<string> gImportDirList;                 // path to search for imports, components and libraries
+#ifdef WIN32
+#define realpath(N,R) _fullpath((R),(N),FAUST_PATH_MAX)
+#endif
 
 //----------------------------------------------------------------
 
@@ -75,7 +73,7 @@ static string& replaceOccurences(string& str, const string& oldstr, const string
  */
 static string& replaceClassName(string& str)
 {
-    return replaceOccurences(str, "mydsp", gClassName);
+    return replaceOccurences(str, "mydsp", gGlobal->gClassName);
 }
 
 /**
@@ -162,17 +160,16 @@ bool isFaustInclude(const string& s, string& fname)
  */
 
 // to keep track of already injected files
-set<string> alreadyIncluded;
 
 void inject(ostream& dst, const string fname)
 {
-    if (alreadyIncluded.find(fname) == alreadyIncluded.end()) {
-        alreadyIncluded.insert(fname);
+    if (gGlobal->alreadyIncluded.find(fname) == gGlobal->alreadyIncluded.end()) {
+        gGlobal->alreadyIncluded.insert(fname);
         istream* src = open_arch_stream( fname.c_str());
         if (src) {
             streamCopy(*src, dst);
         } else {
-            cerr << "NOT FOUND " << fname << endl;
+            gGlobal->gErrors << "NOT FOUND " << fname << endl;
         }
     }
 }
@@ -185,7 +182,7 @@ void streamCopyUntil(istream& src, ostream& dst, const string& until)
     string	s;
     string  fname;
     while ( getline(src,s) && (s != until) ) {
-        if (gInlineArchSwitch && isFaustInclude(s, fname)) {
+        if (gGlobal->gInlineArchSwitch && isFaustInclude(s, fname)) {
             inject(dst, fname);
         } else {
             dst << replaceClassName(s) << endl;
@@ -209,71 +206,55 @@ void streamCopyUntilEnd(istream& src, ostream& dst)
     streamCopyUntil(src, dst, "<<<FOBIDDEN LINE IN A FAUST ARCHITECTURE FILE>>>");
 }
 
-#define TRY_OPEN(filename)                      \
-    ifstream* f = new ifstream();               \
-    f->open(filename, ifstream::in);            \
-    if (f->is_open()) return f; else delete f;  \
+/**
+ * Try to open the file '<dir>/<filename>', the directories are given by
+ * their names : the current directory of the process is never changed,
+ * the compiler being also used as a library (see libfaust.hh)
+ */
+static ifstream* open_arch_stream_at(const string& dir, const char* filename)
+{
+    string path = dir + '/' + filename;
+    ifstream* f = new ifstream();
+    f->open(path.c_str(), ifstream::in);
+    if (f->is_open()) return f;
+    delete f;
+    return 0;
+}
+
+/**
+ * Try to open the file '<dir>/<path>/<filename>'
+ */
+static ifstream* open_arch_stream_at(const string& dir, const char* path, const char* filename)
+{
+    if (dir == "") return 0;
+    return open_arch_stream_at(dir + '/' + path, filename);
+}
 
 /**
  * Try to open an architecture file searching in various directories
  */
 ifstream* open_arch_stream(const char* filename)
 {
-	char	buffer[FAUST_PATH_MAX];
-    char*	old = getcwd(buffer, FAUST_PATH_MAX);
-	int		err;
+    ifstream* f;
+
+    f = new ifstream();
+    f->open(filename, ifstream::in);
+    if (f->is_open()) return f; else delete f;
 
-    TRY_OPEN(filename);
-    
     char *envpath = getenv("FAUST_LIB_PATH");
-    if (envpath!=NULL) {
-		if (chdir(envpath)==0) {
-			TRY_OPEN(filename);
-		}
-    }
-	err = chdir(old);
-	if ( (chdir(gFaustDirectory.c_str())==0) && (chdir("architecture")==0) ) {
-		//cout << "enrobage.cpp : 'architecture' directory found in gFaustDirectory" << endl;
-        TRY_OPEN(filename);
-	}
-    err = chdir(old);
-    if ((chdir(gFaustSuperDirectory.c_str())==0) && (chdir("architecture")==0) ) {
-        //cout << "enrobage.cpp : 'architecture' directory found in gFaustSuperDirectory" << endl;
-        TRY_OPEN(filename);
-    }
-    err = chdir(old);
-	if ((chdir(gFaustSuperSuperDirectory.c_str())==0) && (chdir("architecture")==0) ) {
-        //cout << "enrobage.cpp : 'architecture' directory found in gFaustSuperSuperDirectory" << endl;
-        TRY_OPEN(filename);
-	}
+    if (envpath!=NULL && (f = open_arch_stream_at(envpath, filename))) return f;
+
+    if ((f = open_arch_stream_at(gGlobal->gFaustDirectory, "architecture", filename))) return f;
+    if ((f = open_arch_stream_at(gGlobal->gFaustSuperDirectory, "architecture", filename))) return f;
+    if ((f = open_arch_stream_at(gGlobal->gFaustSuperSuperDirectory, "architecture", filename))) return f;
 #ifdef INSTALL_PREFIX
-	err = chdir(old);
-	if (chdir(INSTALL_PREFIX "/lib/faust")==0) {
-        TRY_OPEN(filename);
-	}
-    err = chdir(old);
-    if (chdir(INSTALL_PREFIX "/include")==0) {
-        TRY_OPEN(filename);
-    }
+    if ((f = open_arch_stream_at(INSTALL_PREFIX "/lib/faust", filename))) return f;
+    if ((f = open_arch_stream_at(INSTALL_PREFIX "/include", filename))) return f;
 #endif
-	err = chdir(old);
-	if (chdir("/usr/local/lib/faust")==0) {
-        TRY_OPEN(filename);
-	}
-    err = chdir(old);
-    if (chdir("/usr/lib/faust")==0) {
-        TRY_OPEN(filename);
-    }
-    err = chdir(old);
-    if (chdir("/usr/local/include")==0) {
-        TRY_OPEN(filename);
-    }
-    err = chdir(old);
-    if (chdir("/usr/include")==0) {
-        TRY_OPEN(filename);
-    }
-
-    if (err != 0) cerr << "ERROR : cannot change back directory to '" << old << "' : " <<  strerror(errno) << endl;
+    if ((f = open_arch_stream_at("/usr/local/lib/faust", filename))) return f;
+    if ((f = open_arch_stream_at("/usr/lib/faust", filename))) return f;
+    if ((f = open_arch_stream_at("/usr/local/include", filename))) return f;
+    if ((f = open_arch_stream_at("/usr/include", filename))) return f;
 
 	return 0;
 }
@@ -307,7 +288,7 @@ bool check_url(const char* filename)
             fclose(f);
             return true;
         } else {
-            cerr << "ERROR : cannot open file '" << filename << "' : " <<  strerror(errno) << "; for help type \"faust --help\"" << endl;
+            gGlobal->gErrors << "ERROR : cannot open file '" << filename << "' : " <<  strerror(errno) << "; for help type \"faust --help\"" << endl;
             return false;
         }
      
@@ -316,7 +297,7 @@ bool check_url(const char* filename)
         if (http_fetch(filename, &fileBuf) != -1) {
             return true;
         } else {
-            cerr << "ERROR : unable to access URL '" << filename << "' : " << http_strerror() << "; for help type \"faust --help\"" << endl;
+            gGlobal->gErrors << "ERROR : unable to access URL '" << filename << "' : " << http_strerror() << "; for help type \"faust --help\"" << endl;
             return false;
         }
     } else {
@@ -326,7 +307,7 @@ bool check_url(const char* filename)
             fclose(f);
             return true;
         } else {
-            cerr << "ERROR : cannot open file '" << filename << "' : " <<  strerror(errno) << "; for help type \"faust --help\"" << endl;
+            gGlobal->gErrors << "ERROR : cannot open file '" << filename << "' : " <<  strerror(errno) << "; for help type \"faust --help\"" << endl;
             return false;
         }
     }
@@ -334,33 +315,22 @@ bool check_url(const char* filename)
 
 /**
  * Try to open the file '<dir>/<filename>'. If it succeed, it stores the full pathname
- * of the file into <fullpath>
+ * of the file into <fullpath>. The directory is resolved by its name, without
+ * changing the current directory of the process.
  */
 static FILE* fopenat(string& fullpath, const char* dir, const char* filename)
 {
-	int err; 
-    char olddirbuffer[FAUST_PATH_MAX];
     char newdirbuffer[FAUST_PATH_MAX];
-    
-    char* olddir = getcwd(olddirbuffer, FAUST_PATH_MAX);
 
-    if (chdir(dir) == 0) {           
-        FILE* f = fopen(filename, "r");
-	    char* newdir = getcwd(newdirbuffer, FAUST_PATH_MAX);
-        if (!newdir) {
-            cerr << "ERROR : getcwd '" << strerror(errno) << endl;
-            return 0;
-        }
-		fullpath = newdir;
-		fullpath += '/';
-		fullpath += filename;
-        err = chdir(olddir);
-        if (err != 0) cerr << "ERROR : cannot change back directory to '" << olddir << "' : " <<  strerror(errno) << endl;
-        return f;
-    }
-    err = chdir(olddir);
-    if (err != 0) cerr << "ERROR : cannot change back directory to '" << olddir << "' : " <<  strerror(errno) << endl;
-    return 0;
+    char* newdir = realpath(dir, newdirbuffer);
+    if (!newdir) return 0;
+
+    string path = newdir;
+    path += '/';
+    path += filename;
+    FILE* f = fopen(path.c_str(), "r");
+    if (f) fullpath = path;
+    return f;
 }
 
 
@@ -379,30 +349,8 @@ static FILE* fopenat(string& fullpath, const string& dir, const char* filename)
  */
 static FILE* fopenat(string& fullpath, const string& dir, const char* path, const char* filename)
 {
-    int	err;
-    char olddirbuffer[FAUST_PATH_MAX];
-    char newdirbuffer[FAUST_PATH_MAX];
-    
-    char* olddir = getcwd(olddirbuffer, FAUST_PATH_MAX);
-    
-    if (chdir(dir.c_str()) == 0) {
-        if (chdir(path) == 0) {            
-            FILE* f = fopen(filename, "r");
-			char* newdir = getcwd(newdirbuffer, FAUST_PATH_MAX);
-            if (!newdir) {
-                cerr << "ERROR : getcwd '" << strerror(errno) << endl;
-                return 0;
-            }
-            fullpath = newdir;
-			fullpath += '/';
-			fullpath += filename;
-            err = chdir(olddir);
-            return f;
-        }
-    }
-    err = chdir(olddir);
-    if (err != 0) cerr << "ERROR : cannot change back directory to '" << olddir << "' : " <<  strerror(errno) << endl;
-    return 0;
+    if (dir == "") return 0;
+    return fopenat(fullpath, dir + '/' + path, filename);
 }
 
 /**
@@ -432,7 +380,7 @@ static void buildFullPathname(string& fullpath, const char* filename)
 	} else {
 		char* newdir = getcwd(old, FAUST_PATH_MAX);
         if (!newdir) {
-            cerr << "ERROR : getcwd '" << strerror(errno) << endl;
+            gGlobal->gErrors << "ERROR : getcwd '" << strerror(errno) << endl;
             return;
         }
         fullpath = newdir;
@@ -461,7 +409,7 @@ FILE* fopensearch(const char* filename, string& fullpath)
 
     // search file in user supplied directory path
 
-    for (list< string >::iterator i = gImportDirList.begin(); i != gImportDirList.end(); i++) {
+    for (list< string >::iterator i = gGlobal->gImportDirList.begin(); i != gGlobal->gImportDirList.end(); i++) {
         if ((f = fopenat(fullpath, *i, filename))) {
             //std::cerr << "found file : " << fullpath << std::endl;
             return f;
@@ -471,19 +419,19 @@ FILE* fopensearch(const char* filename, string& fullpath)
 
     // search in default directories
 
-    if ((f = fopenat(fullpath, gMasterDirectory, filename))) { 
+    if ((f = fopenat(fullpath, gGlobal->gMasterDirectory, filename))) { 
     	return f;
     }
     if ((envpath = getenv("FAUST_LIB_PATH")) && (f = fopenat(fullpath, envpath, filename))) {
 		return f;
     }
-    if ((f = fopenat(fullpath, gFaustDirectory, "architecture", filename))) { 
+    if ((f = fopenat(fullpath, gGlobal->gFaustDirectory, "architecture", filename))) { 
     	return f;
     }
-    if ((f = fopenat(fullpath, gFaustSuperDirectory, "architecture", filename))) { 
+    if ((f = fopenat(fullpath, gGlobal->gFaustSuperDirectory, "architecture", filename))) { 
     	return f;
     }
-    if ((f = fopenat(fullpath, gFaustSuperSuperDirectory, "architecture", filename))) { 
+    if ((f = fopenat(fullpath, gGlobal->gFaustSuperSuperDirectory, "architecture", filename))) { 
     	return f;
     }
 #ifdef INSTALL_PREFIX
@@ -74,6 +74,7 @@
 #include "sourcereader.hh"
 #include "doc.hh"
 #include "ppbox.hh"
+#include "global.hh"
 
 #include <string>
 #include <list>
@@ -85,19 +86,8 @@
 using namespace std;
 
 extern char* 		yytext;
-extern const char* 	yyfilename;
 extern int 			yylineno;
-extern int 			yyerr;
-extern Tree 		gResult;
-extern bool         gStripDocSwitch;
-extern bool         gLstDependenciesSwitch;
-extern bool         gLstDistributedSwitch;
-extern bool        	gLstMdocTagsSwitch;
 	
-extern map<Tree, set<Tree> > gMetaDataSet;
-extern vector<Tree>          gDocVector;
-extern tvec                  gWaveForm; 
-
 int yylex();
 
 //----------------------------------------------------------
@@ -1766,7 +1756,7 @@ yyreduce:
     {
         case 2:
 #line 310 "parser/faustparser.y" /* yacc.c:1646  */
-    { (yyval.exp) = (yyvsp[0].exp); gResult = formatDefinitions((yyval.exp)); }
+    { (yyval.exp) = (yyvsp[0].exp); gGlobal->gResult = formatDefinitions((yyval.exp)); }
 #line 1771 "parser/faustparser.cpp" /* yacc.c:1646  */
     break;
 
@@ -1796,13 +1786,13 @@ yyreduce:
 
   case 7:
 #line 324 "parser/faustparser.y" /* yacc.c:1646  */
-    { gWaveForm.push_back((yyvsp[0].exp)); }
+    { gGlobal->gWaveForm.push_back((yyvsp[0].exp)); }
 #line 1801 "parser/faustparser.cpp" /* yacc.c:1646  */
     break;
 
   case 8:
 #line 325 "parser/faustparser.y" /* yacc.c:1646  */
-    { gWaveForm.push_back((yyvsp[0].exp)); }
+    { gGlobal->gWaveForm.push_back((yyvsp[0].exp)); }
 #line 1807 "parser/faustparser.cpp" /* yacc.c:1646  */
     break;
 
@@ -1964,19 +1954,19 @@ yyreduce:
 
   case 35:
 #line 375 "parser/faustparser.y" /* yacc.c:1646  */
-    { gLstDependenciesSwitch = (yyvsp[-1].b); }
+    { gGlobal->gLstDependenciesSwitch = (yyvsp[-1].b); }
 #line 1969 "parser/faustparser.cpp" /* yacc.c:1646  */
     break;
 
   case 36:
 #line 376 "parser/faustparser.y" /* yacc.c:1646  */
-    { gStripDocSwitch = (yyvsp[-1].b); gStripDocSwitch==true ? gStripDocSwitch=false : gStripDocSwitch=true; }
+    { gGlobal->gStripDocSwitch = (yyvsp[-1].b); gGlobal->gStripDocSwitch==true ? gGlobal->gStripDocSwitch=false : gGlobal->gStripDocSwitch=true; }
 #line 1975 "parser/faustparser.cpp" /* yacc.c:1646  */
     break;
 
   case 37:
 #line 377 "parser/faustparser.y" /* yacc.c:1646  */
-    { gLstDistributedSwitch = (yyvsp[-1].b); }
+    { gGlobal->gLstDistributedSwitch = (yyvsp[-1].b); }
 #line 1981 "parser/faustparser.cpp" /* yacc.c:1646  */
     break;
 
@@ -2012,13 +2002,13 @@ yyreduce:
 
   case 43:
 #line 389 "parser/faustparser.y" /* yacc.c:1646  */
-    { (yyval.exp) = nil; yyerr++; }
+    { (yyval.exp) = nil; gGlobal->yyerr++; }
 #line 2017 "parser/faustparser.cpp" /* yacc.c:1646  */
     break;
 
   case 44:
 #line 392 "parser/faustparser.y" /* yacc.c:1646  */
-    { (yyval.exp)=(yyvsp[0].exp); setDefProp((yyvsp[0].exp), yyfilename, yylineno); }
+    { (yyval.exp)=(yyvsp[0].exp); setDefProp((yyvsp[0].exp), gGlobal->yyfilename, yylineno); }
 #line 2023 "parser/faustparser.cpp" /* yacc.c:1646  */
     break;
 
@@ -2612,7 +2602,7 @@ yyreduce:
 
   case 143:
 #line 527 "parser/faustparser.y" /* yacc.c:1646  */
-    { (yyval.exp) = boxWaveform(gWaveForm); gWaveForm.clear(); }
+    { (yyval.exp) = boxWaveform(gGlobal->gWaveForm); gGlobal->gWaveForm.clear(); }
 #line 2617 "parser/faustparser.cpp" /* yacc.c:1646  */
     break;
 
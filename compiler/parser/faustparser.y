@@ -13,6 +13,7 @@
 #include "sourcereader.hh"
 #include "doc.hh"
 #include "ppbox.hh"
+#include "global.hh"
 
 #include <string>
 #include <list>
@@ -24,19 +25,8 @@
 using namespace std;
 
 extern char* 		yytext;
-extern const char* 	yyfilename;
 extern int 			yylineno;
-extern int 			yyerr;
-extern Tree 		gResult;
-extern bool         gStripDocSwitch;
-extern bool         gLstDependenciesSwitch;
-extern bool         gLstDistributedSwitch;
-extern bool        	gLstMdocTagsSwitch;
 	
-extern map<Tree, set<Tree> > gMetaDataSet;
-extern vector<Tree>          gDocVector;
-extern tvec                  gWaveForm; 
-
 int yylex();
 
 //----------------------------------------------------------
@@ -307,7 +297,7 @@ Tree unquote(char* str)
 
 %% /* grammar rules and actions follow */
 
-program         : stmtlist                              { $$ = $1; gResult = formatDefinitions($$); }
+program         : stmtlist                              { $$ = $1; gGlobal->gResult = formatDefinitions($$); }
 				;
 
 stmtlist        : /*empty*/                             { $$ = nil; }
@@ -321,8 +311,8 @@ deflist         : /*empty*/                             { $$ = nil; }
 // 				| argument PAR vallist                  { $$ = cons ($1,$3); }
 // 				;
 // 
-vallist         : number                                { gWaveForm.push_back($1); }
-                | vallist PAR number                    { gWaveForm.push_back($3); }
+vallist         : number                                { gGlobal->gWaveForm.push_back($1); }
+                | vallist PAR number                    { gGlobal->gWaveForm.push_back($3); }
                 ;
 
 number			: INT   						{ $$ = boxInt(atoi(yytext)); }
@@ -372,9 +362,9 @@ lstattrlist		: /* empty */							{ }
 				| lstattrlist lstattrdef				{ }
 				;
 
-lstattrdef		: LSTDEPENDENCIES LSTEQ LSTQ lstattrval LSTQ	{ gLstDependenciesSwitch = $4; }
-				| LSTMDOCTAGS LSTEQ LSTQ lstattrval LSTQ		{ gStripDocSwitch = $4; gStripDocSwitch==true ? gStripDocSwitch=false : gStripDocSwitch=true; }
-				| LSTDISTRIBUTED LSTEQ LSTQ lstattrval LSTQ		{ gLstDistributedSwitch = $4; }
+lstattrdef		: LSTDEPENDENCIES LSTEQ LSTQ lstattrval LSTQ	{ gGlobal->gLstDependenciesSwitch = $4; }
+				| LSTMDOCTAGS LSTEQ LSTQ lstattrval LSTQ		{ gGlobal->gStripDocSwitch = $4; gGlobal->gStripDocSwitch==true ? gGlobal->gStripDocSwitch=false : gGlobal->gStripDocSwitch=true; }
+				| LSTDISTRIBUTED LSTEQ LSTQ lstattrval LSTQ		{ gGlobal->gLstDistributedSwitch = $4; }
 				;
 
 lstattrval		: LSTTRUE								{ $$ = true; }
@@ -386,10 +376,10 @@ docmtd          : BMETADATA name EMETADATA				{ $$ = $2; }
 
 definition		: defname LPAR arglist RPAR DEF expression ENDDEF	{ $$ = cons($1,cons($3,$6)); }
 				| defname DEF expression ENDDEF		   	{ $$ = cons($1,cons(nil,$3)); }
-				| error ENDDEF				   		   	{ $$ = nil; yyerr++; }
+				| error ENDDEF				   		   	{ $$ = nil; gGlobal->yyerr++; }
 				;
 
-defname			: ident 								{ $$=$1; setDefProp($1, yyfilename, yylineno); }
+defname			: ident 								{ $$=$1; setDefProp($1, gGlobal->yyfilename, yylineno); }
 				;
 
 params			: ident					   				{ $$ = cons($1,nil); }
@@ -524,7 +514,7 @@ primitive		: INT   						{ $$ = boxInt(atoi(yytext)); }
                 | COMPONENT LPAR uqstring RPAR  { $$ = boxComponent($3); }
                 | LIBRARY LPAR uqstring RPAR    { $$ = boxLibrary($3); }
                 | ENVIRONMENT LBRAQ deflist RBRAQ { $$ = boxWithLocalDef(boxEnvironment(),formatDefinitions($3)); }
-                | WAVEFORM LBRAQ vallist RBRAQ  { $$ = boxWaveform(gWaveForm); gWaveForm.clear(); }
+                | WAVEFORM LBRAQ vallist RBRAQ  { $$ = boxWaveform(gGlobal->gWaveForm); gGlobal->gWaveForm.clear(); }
 
 				| button						{ $$ = $1; }
 				| checkbox						{ $$ = $1; }
@@ -10,19 +10,21 @@
 #include <list>
 #include <string>
 
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 
 #include "sourcereader.hh"
 #include "sourcefetcher.hh"
 #include "enrobage.hh"
 #include "ppbox.hh"
+#include "exception.hh"
+#include "errormsg.hh"
+#include "astcache.hh"
+#include "global.hh"
 
 using namespace std;
 
-extern map<Tree, set<Tree> > gMetaDataSet;
-extern string gMasterDocument;
-extern vector<Tree> gDocVector;
-extern bool gLatexDocSwitch;
-
 /****************************************************************
  						Parser variables
 *****************************************************************/
@@ -32,16 +34,61 @@ int yyparse();
 void yyrestart( FILE *new_file );
 struct yy_buffer_state* yy_scan_string (const char *yy_str  ); // In principle YY_BUFFER_STATE
 
-extern int 		yyerr;
 extern int 		yydebug;
 extern FILE*	yyin;
 extern int		yylineno;
-extern const char * yyfilename;
 
-extern Tree 	gResult;
-extern Tree 	gResult2;
+/**
+ * The lexer and the parser are not reentrant : the compilations running at
+ * the same time parse their files one at a time with this lock (on Windows
+ * the compilations must not overlap)
+ */
+#ifndef _WIN32
+static pthread_mutex_t gParseMutex = PTHREAD_MUTEX_INITIALIZER;
+
+struct ParseLock
+{
+	ParseLock()		{ pthread_mutex_lock(&gParseMutex); }
+	~ParseLock()	{ pthread_mutex_unlock(&gParseMutex); }
+};
+#else
+struct ParseLock {};
+#endif
 
- 
+static vector<pair<Tree,Tree> >* gMetadataRecord = 0;	///< where declareMetadata() also records the declarations, if any
+
+/**
+ * Read the whole content of a file
+ */
+static bool readFile(FILE* f, string& text)
+{
+	char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+	return !ferror(f);
+}
+
+/**
+ * Record in pf the side effects of the parsing of a file, or stop if pf is 0
+ */
+static void startRecording(ParsedFile* pf)
+{
+	recordDefProps(pf ? &pf->fDefLines : 0);
+	gMetadataRecord = pf ? &pf->fMetadata : 0;
+}
+
+/**
+ * Redo the side effects of the parsing of a file loaded from the cache
+ */
+static void replayParsedFile(const ParsedFile& pf)
+{
+	for (unsigned int i = 0; i < pf.fDefLines.size(); i++) {
+		setDefProp(pf.fDefLines[i].first, gGlobal->yyfilename, pf.fDefLines[i].second);
+	}
+	for (unsigned int i = 0; i < pf.fMetadata.size(); i++) {
+		declareMetadata(pf.fMetadata[i].first, pf.fMetadata[i].second);
+	}
+}
 
 
 /**
@@ -66,7 +113,7 @@ static bool standardArgList(Tree args)
 
 static void printPatternError(Tree lhs1, Tree rhs1, Tree lhs2, Tree rhs2)
 {
-	cerr 	<< "ERROR : inconsistent number of parameters in pattern-matching rule: "
+	gGlobal->gErrors 	<< "ERROR : inconsistent number of parameters in pattern-matching rule: "
 			<< boxpp(reverse(lhs2)) << " => " << boxpp(rhs2) << ";"
 			<< " previous rule was: " 
 			<< boxpp(reverse(lhs1)) << " => " << boxpp(rhs1) << ";"
@@ -76,7 +123,7 @@ static void printPatternError(Tree lhs1, Tree rhs1, Tree lhs2, Tree rhs2)
 Tree checkRulelist (Tree lr)
 {
 	Tree lrules = lr;
-	if (isNil(lrules)) { cerr << "ERROR : a case expression can't be empty" << endl; exit(1); }
+	if (isNil(lrules)) { gGlobal->gErrors << "ERROR : a case expression can't be empty" << endl; throw faustexception(); }
 	// first pattern used as a reference
 	Tree lhs1 = hd(hd(lrules));
 	Tree rhs1 = tl(hd(lrules));
@@ -87,7 +134,7 @@ Tree checkRulelist (Tree lr)
 		Tree rhs2 = tl(hd(lrules));
 		if (npat != len(lhs2)) {
 			printPatternError(lhs1,rhs1,lhs2,rhs2);
-			exit(1);
+			throw faustexception();
 		}
 		
 		lhs1 = lhs2;
@@ -127,7 +174,7 @@ static Tree makeDefinition(list<Tree>& variants)
 			Tree cur = *p;
 			if (npat != len(hd(cur))) {
 				printPatternError(hd(prev), tl(prev), hd(cur), tl(cur));
-				exit(1);
+				throw faustexception();
 			}
 			prev = cur;
 			l = cons(*p,l);
@@ -190,63 +237,124 @@ Tree SourceReader::parse(string fname)
 {
 	string	fullpath;
     char*   fileBuf = 0;
+	ParseLock lock;
 	
-	yyerr = 0;
+	gGlobal->yyerr = 0;
 	
-	yyfilename = fname.c_str();
-    if (strstr(yyfilename,"http://") != 0) {
+	gGlobal->yyfilename = fname.c_str();
+    if (fSources.find(fname) != fSources.end()) {
+        // We are requested to parse a source given in memory
+        yy_scan_string(fSources[fname].c_str());
+        yylineno = 1;
+        int r = yyparse();
+        if (r) {
+            gGlobal->gErrors << "Parse error : code = " << r << endl;
+        }
+        if (gGlobal->yyerr > 0) {
+            throw faustexception();
+        }
+
+        // we have parsed a valid source
+        fFilePathnames.push_back(fname);
+        return gGlobal->gResult;
+
+    } else if (strstr(gGlobal->yyfilename,"http://") != 0) {
         // We are requested to parse an URL file
-        int ret = http_fetch(yyfilename, &fileBuf);
+        int ret = http_fetch(gGlobal->yyfilename, &fileBuf);
         if (ret == -1) {
-            http_perror("http fetch");
-            exit(1);
+            gGlobal->gErrors << "http fetch: " << http_strerror() << endl;
+            throw faustexception();
         }
         yy_scan_string(fileBuf);
         yylineno = 1;
         int r = yyparse();
         if (r) {
-            fprintf(stderr, "Parse error : code = %d \n", r);
+            gGlobal->gErrors << "Parse error : code = " << r << endl;
         }
-        if (yyerr > 0) {
+        if (gGlobal->yyerr > 0) {
             //fprintf(stderr, "Erreur de parsing 2, count = %d \n", yyerr);
-            exit(1);
+            throw faustexception();
         }
         
         // we have parsed a valid file
         fFilePathnames.push_back(fullpath);
         free(fileBuf);
-        return gResult;
+        return gGlobal->gResult;
 
     } else {
 		// test for local url
-		if (strstr(yyfilename,"file://") != 0) {
-			yyfilename  = &yyfilename[7]; // skip 'file://'
+		if (strstr(gGlobal->yyfilename,"file://") != 0) {
+			gGlobal->yyfilename  = &gGlobal->yyfilename[7]; // skip 'file://'
 		}
 		
         // We are requested to parse a regular file
-        yyin = fopensearch(yyfilename, fullpath);
+        yyin = fopensearch(gGlobal->yyfilename, fullpath);
         if (yyin == NULL) {
-            fprintf(stderr, "ERROR : Unable to open file  %s \n", yyfilename); 
-            exit(1);
+            gGlobal->gErrors << "ERROR : Unable to open file  " << gGlobal->yyfilename << endl;
+            throw faustexception();
+        }
+
+        // the libraries are taken from the cache of parsed files when possible
+        string      text;
+        ParsedFile  pf;
+        bool        cached = gGlobal->gLibCacheSwitch && gGlobal->gMasterDocument != gGlobal->yyfilename && readFile(yyin, text);
+        if (cached && loadParsedFile(text, pf)) {
+            fclose(yyin);
+            replayParsedFile(pf);
+            fFilePathnames.push_back(fullpath);
+            return pf.fDefinitions;
+        }
+
+        unsigned int ndocs = gGlobal->gDocVector.size();
+        if (cached) {
+            rewind(yyin);
+            startRecording(&pf);
         }
         yyrestart(yyin);	// make sure we scan from file again (in case we scanned a string just before)
         yylineno = 1;
-        int r = yyparse();
+        int r;
+        try {
+            r = yyparse();
+        } catch (faustexception&) {
+            startRecording(0);
+            fclose(yyin);
+            throw;
+        }
+        startRecording(0);
+        fclose(yyin);
         if (r) { 
-            fprintf(stderr, "Parse error : code = %d \n", r); 
+            gGlobal->gErrors << "Parse error : code = " << r << endl; 
         }
-        if (yyerr > 0) {
+        if (gGlobal->yyerr > 0) {
             //fprintf(stderr, "Erreur de parsing 2, count = %d \n", yyerr); 
-            exit(1);
+            throw faustexception();
         }
 
-        // we have parsed a valid file
+        // we have parsed a valid file, the ones with <mdoc> parts are not cached
+        if (cached && gGlobal->gDocVector.size() == ndocs) {
+            pf.fDefinitions = gGlobal->gResult;
+            saveParsedFile(text, pf);
+        }
         fFilePathnames.push_back(fullpath);
-        return gResult;
+        return gGlobal->gResult;
     }
 }
 
 
+/**
+ * Give the text of a source that is not read from a file : a file
+ * imported under this name is parsed from the text
+ *
+ * @param fname the name of the source
+ * @param text the faust definitions it contains
+ */
+
+void SourceReader::setSource(const string& fname, const string& text)
+{
+	fSources[fname] = text;
+}
+
+
 /**
  * Check if a file as been read and is in the "cache"
  * 
@@ -272,7 +380,7 @@ Tree SourceReader::getlist(string fname)
 	if (!cached(fname)) {
 		fFileCache[fname] = parse(fname);
 	}
-    if (fFileCache[fname] == 0) exit(1);
+    if (fFileCache[fname] == 0) throw faustexception();
     return fFileCache[fname];
 }
 
@@ -337,14 +445,15 @@ Tree SourceReader::expandrec(Tree ldef, set<string>& visited, Tree lresult)
 
 void declareMetadata(Tree key, Tree value)
 {
-    if (gMasterDocument == yyfilename) {
+    if (gMetadataRecord) gMetadataRecord->push_back(make_pair(key, value));
+    if (gGlobal->gMasterDocument == gGlobal->yyfilename) {
         // inside master document, no prefix needed to declare metadata
-        gMetaDataSet[key].insert(value);
+        gGlobal->gMetaDataSet[key].insert(value);
     } else {
-        string fkey(yyfilename);
+        string fkey(gGlobal->yyfilename);
         fkey += "/";
         fkey += tree2str(key);
-        gMetaDataSet[tree(fkey.c_str())].insert(value);
+        gGlobal->gMetaDataSet[tree(fkey.c_str())].insert(value);
     }
     //cout << "Master " << gMasterDocument  << ", file " << yyfilename <<  " : declare " << *key << "," << *value << endl;
 }
@@ -353,5 +462,5 @@ void declareMetadata(Tree key, Tree value)
 void declareDoc(Tree t)
 {
 	//gLatexDocSwitch = true;
-	gDocVector.push_back(t);
+	gGlobal->gDocVector.push_back(t);
 }
@@ -5,6 +5,7 @@
 #include <string>
 #include <set>
 #include <vector>
+#include <map>
 
 using namespace std;
 
@@ -17,6 +18,7 @@ class SourceReader
 {
 	map<string, Tree>	fFileCache;
 	vector<string>		fFilePathnames;
+	map<string, string>	fSources;			// sources given in memory, by name
 	Tree parse(string fname);
 	Tree expandrec(Tree ldef, set<string>& visited, Tree lresult);
 	bool cached(string fname);
@@ -25,6 +27,7 @@ public:
 	Tree getlist(string fname);
 	Tree expandlist(Tree ldef);
 	vector<string>	listSrcFiles();
+	void			setSource(const string& fname, const string& text);
 };
 
 
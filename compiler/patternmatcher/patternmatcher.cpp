@@ -14,6 +14,8 @@ using namespace std;
 #include <list>
 #include <set>
 #include <utility>
+#include "exception.hh"
+#include "global.hh"
 
 /* Uncomment for debugging output. */
 //#define DEBUG
@@ -544,21 +546,21 @@ Automaton *make_pattern_matcher(Tree R)
 	       be shadowed. */
 	    Tree lhs1, rhs1, lhs2, rhs2;
 	    if (isCons(rules[ru->r], lhs1, rhs1) &&  isCons(rules[r], lhs2, rhs2)) {
-			cerr 	<< "WARNING : shadowed pattern-matching rule: "
+			gGlobal->gErrors 	<< "WARNING : shadowed pattern-matching rule: "
 				<< boxpp(reverse(lhs2)) << " => " << boxpp(rhs2) << ";"
 				<< " previous rule was: " 
 				<< boxpp(reverse(lhs1)) << " => " << boxpp(rhs1) << ";"
 				<< endl;
 		} else {
-			cerr << "INTERNAL ERROR : " << __FILE__ << ":" << __LINE__ << endl;
-			exit(1);
+			gGlobal->gErrors << "INTERNAL ERROR : " << __FILE__ << ":" << __LINE__ << endl;
+			throw faustexception();
 		}
 	  } else if (ru->r >= r)
 	    break;
     }
   }
 #ifdef DEBUG
-  cerr << "automaton " << A << endl << *A << "end automaton" << endl;
+  gGlobal->gErrors << "automaton " << A << endl << *A << "end automaton" << endl;
 #endif
   return A;
 }
@@ -609,7 +611,7 @@ static int apply_pattern_matcher_internal(Automaton *A, int s, Tree X,
 	if (X==x) {
 	  /* transition on constant */
 #ifdef DEBUG
-      cerr << "state " << s << ", " << *x << ": goto state " << t->state->s << endl;
+      gGlobal->gErrors << "state " << s << ", " << *x << ": goto state " << t->state->s << endl;
 #endif
 	  add_subst(subst, A, s);
 	  s = t->state->s;
@@ -620,7 +622,7 @@ static int apply_pattern_matcher_internal(Automaton *A, int s, Tree X,
 	if (isBoxPatternOp(X, op1, x0, x1) && op == op1) {
 	  /* transition on operation symbol */
 #ifdef DEBUG
-      cerr << "state " << s << ", " << op << ": goto state " << t->state->s << endl;
+      gGlobal->gErrors << "state " << s << ", " << op << ": goto state " << t->state->s << endl;
 #endif
 	  add_subst(subst, A, s);
 	  s = t->state->s;
@@ -637,13 +639,13 @@ static int apply_pattern_matcher_internal(Automaton *A, int s, Tree X,
     t = A->trans(s).begin();
     if (t->is_var_trans()) {
 #ifdef DEBUG
-      cerr << "state " << s << ", _: goto state " << t->state->s << endl;
+      gGlobal->gErrors << "state " << s << ", _: goto state " << t->state->s << endl;
 #endif
       add_subst(subst, A, s);
       s = t->state->s;
     } else {
 #ifdef DEBUG
-      cerr << "state " << s << ", *** match failed ***" << endl;
+      gGlobal->gErrors << "state " << s << ", *** match failed ***" << endl;
 #endif
       s = -1;
     }
@@ -667,7 +669,7 @@ int apply_pattern_matcher(Automaton *A,		// automaton
   vector<Subst> subst(n, Subst());
   /* perform matching, record variable substitutions */
 #ifdef DEBUG
-  cerr << "automaton " << A << ", state " << s << ", start match on arg: " << *X << endl;
+  gGlobal->gErrors << "automaton " << A << ", state " << s << ", start match on arg: " << *X << endl;
 #endif
   s = apply_pattern_matcher_internal(A, s, X, subst);
   C = nil;
@@ -686,7 +688,7 @@ int apply_pattern_matcher(Automaton *A,		// automaton
 	  if (Z != Z1) {
 	    /* failed nonlinearity, add to the set of nonviable rules */
 #ifdef DEBUG
-      cerr << "state " << s << ", rule #" << r->r << ": " <<
+      gGlobal->gErrors << "state " << s << ", rule #" << r->r << ": " <<
 	    *assoc->id << " := " << *Z1 << " *** failed *** old value: " <<
 	    *Z << endl;
 #endif
@@ -695,7 +697,7 @@ int apply_pattern_matcher(Automaton *A,		// automaton
 	} else {
 	  /* bind a variable for the current rule */
 #ifdef DEBUG
-      cerr << "state " << s << ", rule #" << r->r << ": " <<
+      gGlobal->gErrors << "state " << s << ", rule #" << r->r << ": " <<
 	    *assoc->id << " := " << *Z1 << endl;
 #endif
 	  E[r->r] = pushValueDef(assoc->id, Z1, E[r->r]);
@@ -711,19 +713,19 @@ int apply_pattern_matcher(Automaton *A,		// automaton
 	/* return the rhs of the matched rule */
 	C = closure(A->rhs[r->r], nil, nil, E[r->r]);
 #ifdef DEBUG
-    cerr << "state " << s << ", complete match yields rhs #" << r->r <<
+    gGlobal->gErrors << "state " << s << ", complete match yields rhs #" << r->r <<
 	  ": " << *A->rhs[r->r] << endl;
 #endif
 	return s;
       }
     /* if none of the rules were matched then declare a failed match */
 #ifdef DEBUG
-    cerr << "state " << s << ", *** match failed ***" << endl;
+    gGlobal->gErrors << "state " << s << ", *** match failed ***" << endl;
 #endif
     return -1;
   }
 #ifdef DEBUG
-  cerr << "state " << s << ", successful incomplete match" << endl;
+  gGlobal->gErrors << "state " << s << ", successful incomplete match" << endl;
 #endif
   return s;
 }
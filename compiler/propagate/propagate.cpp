@@ -30,6 +30,8 @@
 #include "Text.hh"
 #include "ppsig.hh"
 #include "names.hh"
+#include "exception.hh"
+#include "global.hh"
 
 //extern bool gPrintDocSwitch;
 //static siglist realPropagate (Tree slotenv, Tree path, Tree box, const siglist&  lsig);
@@ -53,11 +55,17 @@ siglist mix(const siglist& lsig, int nbus)
 	siglist dst(nbus);
 	
 	for (int b=0; b<nbus; b++) {
-		Tree t = (b<nlines) ? lsig[b] : sigInt(0);
-		for (int i=b+nbus; i<nlines; i+=nbus) {
-			t = sigAdd(t, lsig[i]);
+		tvec terms;
+		for (int i=b; i<nlines; i+=nbus) {
+			terms.push_back(lsig[i]);
+		}
+		// a single n-ary node instead of a n-deep chain of additions
+		switch (terms.size()) {
+			case 0 : dst[b] = sigInt(0); break;
+			case 1 : dst[b] = terms[0]; break;
+			case 2 : dst[b] = sigAdd(terms[0], terms[1]); break;
+			default : dst[b] = sigSum(terms); break;
 		}
-		dst[b] = t;
 	}
 	return dst;
 }			
@@ -154,8 +162,6 @@ siglist listLift(const siglist& l)
 	return r;
 }
 
-static int	gDummyInput = 10000;
-
 /**
  * Propagate computes the outputs signals of a block-diagram according to a list of input signals.
  *
@@ -215,6 +221,33 @@ bool getPropagateProperty(Tree args, siglist&  lsig)
 siglist realPropagate (Tree slotenv, Tree path, Tree box, const siglist&  lsig);
 
 
+/**
+ * The recursive groups built since the last named definition (with -prof)
+ */
+
+/**
+ * Name the outputs of a definition (with -prof) : the signals and the
+ * recursive groups built by the definition get its name unless an inner
+ * definition named them first.
+ * @param box the block diagram, named if it is the body of a definition
+ * @param mark the number of unnamed groups before the propagation into box
+ * @param lsig the resulting signals
+ */
+static void nameOutputs(Tree box, unsigned int mark, const siglist& lsig)
+{
+    Tree id, other;
+    if (!getDefNameProperty(box, id)) return;
+
+    for (unsigned int i = 0; i < lsig.size(); i++) {
+        if (!getDefinitionName(lsig[i], other)) setDefinitionName(lsig[i], id);
+    }
+    for (unsigned int i = mark; i < gGlobal->gUnnamedRecs.size(); i++) {
+        setDefinitionName(gGlobal->gUnnamedRecs[i], id);
+    }
+    gGlobal->gUnnamedRecs.resize(mark);
+}
+
+
 /**
  * Propagate a list of signals into a block diagram. Do memoization.
  * @param slotenv environment associating slots and signals
@@ -229,8 +262,10 @@ siglist propagate (Tree slotenv, Tree path, Tree box, const siglist&  lsig)
     Tree args =tree(PROPAGATEPROPERTY,slotenv,path,box,listConvert(lsig));
     siglist result;
     if (! getPropagateProperty(args, result)) {
+        unsigned int mark = gGlobal->gUnnamedRecs.size();
         result = realPropagate (slotenv, path, box, lsig);
         setPropagateProperty(args, result);
+        if (gGlobal->gProfSwitch) nameOutputs(box, mark, result);
     }
     //cerr << "propagate in " << boxpp(box) << endl;
     //for (int i=0; i<lsig.size(); i++) { cerr << " -> signal " << i << " : " << *(lsig[i]) << endl; }
@@ -322,7 +357,7 @@ siglist realPropagate (Tree slotenv, Tree path, Tree box, const siglist&  lsig)
 			// test YO simplification des diagrames
 			//fprintf(stderr, "propagate : internal error (slot undefined)\n");
 			//exit(1);
-			sig = sigInput(++gDummyInput);
+			sig = sigInput(++gGlobal->gDummyInput);
 		}
 		return makeList(sig);
 	}
@@ -482,11 +517,13 @@ siglist realPropagate (Tree slotenv, Tree path, Tree box, const siglist&  lsig)
         siglist l1 = propagate(slotenv2, path, t2, l0);
         siglist l2 = propagate(slotenv2, path, t1, listConcat(l1,listLift(lsig)));
         Tree g = rec(listConvert(l2));
+        Tree name;
+        if (gGlobal->gProfSwitch && !getDefinitionName(g, name)) gGlobal->gUnnamedRecs.push_back(g);
         return makeSigProjList(g, out1);
     }
 
 	cout << "ERROR in file " << __FILE__ << ':' << __LINE__ << ", unrecognised box expression : " << boxpp(box) << endl;
-	exit(1);
+	throw faustexception();
 	return siglist();
 }
 
@@ -500,6 +537,8 @@ siglist realPropagate (Tree slotenv, Tree path, Tree box, const siglist&  lsig)
 
 Tree boxPropagateSig (Tree path, Tree box, const siglist& lsig)
 {
-	return listConvert(propagate(nil, path, box, lsig));
+	Tree result = listConvert(propagate(nil, path, box, lsig));
+	gGlobal->gUnnamedRecs.clear();
+	return result;
 }
 
@@ -27,6 +27,7 @@
 #include "prim2.hh"
 #include "xtended.hh"
 #include "recursivness.hh"
+#include "global.hh"
 
 ostream& ppsig::printinfix (ostream& fout, const string& opname, int priority, Tree x, Tree y) const
 {
@@ -143,6 +144,29 @@ ostream& ppsig::printFixDelay (ostream& fout, Tree exp, Tree delay) const
 
 //	else if ( isSigFixDelay(sig, x, y) ) 			{ printinfix(fout, "@", 8, x, y); 	}
 
+ostream& ppsig::printFIR (ostream& fout, Tree sig, Tree exp) const
+{
+	fout << "fir(" << ppsig(exp, fEnv) << ", ";
+	char sep = '{';
+	for (int k = 1; k < sig->arity(); k++) {
+		fout << sep << ppsig(sig->branch(k), fEnv);
+		sep = ',';
+	}
+	return fout << "})";
+}
+
+ostream& ppsig::printSum (ostream& fout, Tree sig) const
+{
+	int priority = gBinOpTable[kAdd]->fPriority;
+	if (fPriority > priority) fout << "(";
+	for (int k = 0; k < sig->arity(); k++) {
+		if (k > 0) fout << gBinOpTable[kAdd]->fName;
+		fout << ppsig(sig->branch(k), fEnv, priority);
+	}
+	if (fPriority > priority) fout << ")";
+	return fout;
+}
+
 ostream& ppsig::printrec (ostream& fout, Tree var, Tree lexp, bool hide) const
 {
 	if (isElement(var, fEnv) ) {
@@ -181,6 +205,7 @@ ostream& ppsig::print (ostream& fout) const
 	int 	i;
 	double	r;
     Tree 	c, sel, x, y, z, u, var, le, label, id, ff, largs, type, name, file;
+	tvec	terms;
 
 		  if ( isList(sig) ) 						{ printlist(fout, sig); }
 	else if ( isProj(sig, &i, x) ) 					{ fout << "proj" << i << '(' << ppsig(x, fEnv) << ')';	}
@@ -200,6 +225,8 @@ ostream& ppsig::print (ostream& fout) const
 	else if ( isSigDelay1(sig, x) ) 				{ fout << ppsig(x, fEnv, 9) << "'"; }
 	//else if ( isSigFixDelay(sig, x, y) ) 			{ printinfix(fout, "@", 8, x, y); 	}
 	else if ( isSigFixDelay(sig, x, y) ) 			{ printFixDelay(fout, x, y); 	}
+	else if ( isSigFIR(sig, x) ) 					{ printFIR(fout, sig, x); 	}
+	else if ( isSigSum(sig, terms) ) 				{ printSum(fout, sig); 	}
 	else if ( isSigPrefix(sig, x, y) ) 				{ printfun(fout, "prefix", x, y); }
 	else if ( isSigIota(sig, x) ) 					{ printfun(fout, "iota", x); }
 	else if ( isSigBinOp(sig, &i, x, y) )			{ printinfix(fout, gBinOpTable[i]->fName, gBinOpTable[i]->fPriority, x, y);  }
@@ -232,7 +259,7 @@ ostream& ppsig::print (ostream& fout) const
 	else if ( isSigAttach(sig, x, y) )				{ printfun(fout, "attach", x, y); }
 	
 	else {
-        cerr << "NOT A SIGNAL : " << *sig << endl;
+        gGlobal->gErrors << "NOT A SIGNAL : " << *sig << endl;
         //exit(1);
 	}
 	return fout;
@@ -74,6 +74,8 @@ private:
 	ostream& printui (ostream& fout, const string& funame, Tree label, Tree cur, Tree lo, Tree hi, Tree step) const;
 	ostream& printlabel (ostream& fout, Tree pathname) const;
 	ostream& printFixDelay (ostream& fout, Tree exp, Tree delay) const;
+	ostream& printFIR (ostream& fout, Tree sig, Tree exp) const;
+	ostream& printSum (ostream& fout, Tree sig) const;
 
 };
 
@@ -19,11 +19,10 @@
  ************************************************************************
  ************************************************************************/
  
-extern int gFloatSize;
 
- 
 #include "prim2.hh"
 #include "stdlib.h"
+#include "global.hh"
 
 Sym FFUN = symbol ("ForeignFunction");
 
@@ -61,7 +60,7 @@ const char* ffname(Tree t)
 {
     Tree namelist = nth(ffsignature(t),1);
     //cerr << "ffname " << tree2str(nth(namelist,gFloatSize-1)) << endl;
-    return tree2str(nth(namelist,gFloatSize-1));
+    return tree2str(nth(namelist,gGlobal->gFloatSize-1));
 }
 
 int ffarity(Tree t)
@@ -28,6 +28,8 @@
 #include "signals.hh"
 #include "ppsig.hh"
 #include "set"
+#include "exception.hh"
+#include "global.hh"
 
 using namespace std;
 
@@ -73,8 +75,8 @@ int getRecursivness(Tree sig)
 {
 	Tree tr;
 	if ( ! getProperty(sig, RECURSIVNESS, tr)) {
-		cerr << "Error in getRecursivness of " << *sig << endl;
-		exit(1);
+		gGlobal->gErrors << "Error in getRecursivness of " << *sig << endl;
+		throw faustexception();
 	}
 	return tree2int(tr);
 }
@@ -0,0 +1,136 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+
+
+#include "sigdag.hh"
+
+/**
+ * Build the post-order array of a signal or a list of signals
+ * @param L the signal or the list of signals
+ */
+SigDAG::SigDAG(Tree L)
+{
+    if (isList(L)) {
+        while (isList(L)) {
+            visit(hd(L));
+            L = tl(L);
+        }
+    } else {
+        visit(L);
+    }
+    fFirstEdge.push_back(fEdgeTarget.size());
+}
+
+
+int SigDAG::index(Tree sig)
+{
+    int i;
+    return fIndex.get(sig, i) ? i : -1;
+}
+
+
+/**
+ * The uses of sig by the code generation, and the branches they come from
+ */
+void SigDAG::uses(Tree sig, vector<Tree>& subs, vector<int>& branches)
+{
+    Tree c, x, y, z;
+
+    branches.clear();
+    if (isSigSelect3(sig, c, x, y, z)) {
+        subs.clear();
+        subs.push_back(c); branches.push_back(0);
+        subs.push_back(c); branches.push_back(0);
+        subs.push_back(y); branches.push_back(2);
+        subs.push_back(x); branches.push_back(1);
+        subs.push_back(z); branches.push_back(3);
+    } else {
+        int n = getSubSignals(sig, subs, false);
+        for (int i=0; i<n; i++) branches.push_back(i);
+    }
+}
+
+
+// a signal being visited, and the next of its uses to visit
+struct SigDAGFrame
+{
+    Tree            fSig;
+    Tree            fDiscoverer;
+    vector<Tree>    fSubs;
+    vector<int>     fBranches;
+    unsigned int    fNext;
+};
+
+/**
+ * Depth first visit of root, without recursion (the signals can be very
+ * deep). A signal is numbered when all its subsignals are.
+ */
+void SigDAG::visit(Tree root)
+{
+    vector<SigDAGFrame> stack;
+
+    if (index(root) < 0) {
+        stack.push_back(SigDAGFrame());
+        stack.back().fSig = root;
+        stack.back().fDiscoverer = 0;
+        stack.back().fNext = 0;
+        uses(root, stack.back().fSubs, stack.back().fBranches);
+        fIndex.set(root, -2);   // discovered
+
+        vector<Tree> discoverers, targets;
+        while (!stack.empty()) {
+            SigDAGFrame& f = stack.back();
+            if (f.fNext < f.fSubs.size()) {
+                Tree s = f.fSubs[f.fNext++];
+                if (index(s) == -1) {
+                    Tree user = f.fSig;
+                    fIndex.set(s, -2);
+                    stack.push_back(SigDAGFrame());     // f is invalid from here
+                    stack.back().fSig = s;
+                    stack.back().fDiscoverer = user;
+                    stack.back().fNext = 0;
+                    uses(s, stack.back().fSubs, stack.back().fBranches);
+                }
+            } else {
+                // all the subsignals are numbered, but a recursive group used in its own definition
+                fIndex.set(f.fSig, fNodes.size());
+                fNodes.push_back(f.fSig);
+                fFirstEdge.push_back(fEdgeBranch.size());
+                for (unsigned int k=0; k<f.fSubs.size(); k++) {
+                    targets.push_back(f.fSubs[k]);
+                    fEdgeBranch.push_back(f.fBranches[k]);
+                }
+                discoverers.push_back(f.fDiscoverer);
+                stack.pop_back();
+            }
+        }
+
+        // every signal of the visit is numbered now
+        for (unsigned int k=0; k<targets.size(); k++) {
+            fEdgeTarget.push_back(index(targets[k]));
+        }
+        for (unsigned int k=0; k<discoverers.size(); k++) {
+            fDiscoverer.push_back(discoverers[k] ? index(discoverers[k]) : -1);
+        }
+    }
+    fRoots.push_back(index(root));
+}
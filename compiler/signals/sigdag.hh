@@ -0,0 +1,65 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2014 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+
+
+#ifndef _SIGDAG_
+#define _SIGDAG_
+
+#include <vector>
+#include "signals.hh"
+#include "property.hh"
+
+using namespace std;
+
+/**
+ * Compact post-order array of a signal forest (a signal or a list of
+ * signals), for the analyses that need every use of every subsignal.
+ *
+ * Each signal appears once, after all its subsignals (but the recursive
+ * groups, used inside their own definitions). The uses are the
+ * ones of the code generation : the sub signals of a sigGen are not
+ * entered, and the condition of a select3 is used twice (it is compiled
+ * as a real if). The signals are numbered from 0 to size()-1 and the uses
+ * of signal i are the edges fFirstEdge[i] to fFirstEdge[i+1]-1.
+ */
+class SigDAG
+{
+    denseproperty<int>  fIndex;         ///< position of each signal in fNodes
+
+    void        visit(Tree root);
+    void        uses(Tree sig, vector<Tree>& subs, vector<int>& branches);
+
+ public:
+    vector<Tree>    fNodes;             ///< the signals, in post order
+    vector<int>     fFirstEdge;         ///< first edge of each signal, plus one past the last edge
+    vector<int>     fEdgeTarget;        ///< the signal used by each edge
+    vector<int>     fEdgeBranch;        ///< the branch of the user through which it is used
+    vector<int>     fDiscoverer;        ///< the user of the first visit of each signal in depth first order, -1 for the roots
+    vector<int>     fRoots;             ///< the roots, in order, with repetitions
+
+    SigDAG(Tree L);
+
+    int     size() const        { return int(fNodes.size()); }
+    int     index(Tree sig);    ///< position of sig, -1 if not in the forest
+};
+
+#endif
@@ -0,0 +1,300 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2004 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+
+
+#include <math.h>
+#include <string.h>
+#include <map>
+#include <set>
+
+#include "sigeval.hh"
+#include "sigtype.hh"
+#include "sigtyperules.hh"
+#include "binop.hh"
+#include "prim2.hh"
+#include "xtended.hh"
+#include "global.hh"
+
+using namespace std;
+
+
+/*****************************************************************************
+					Compile time evaluation of signals
+*****************************************************************************/
+
+/**
+ * Evaluates a signal sample by sample. The values of all the evaluated
+ * subsignals are kept, so that delayed signals and recursive groups can
+ * read their past values.
+ */
+class SignalEvaluator
+{
+	int							fTime;		///< the sample being computed
+	bool						fFailed;	///< true if an unsupported signal was met
+	map<Tree, vector<double> >	fHistory;	///< the values of the subsignals at time 0..fTime
+	set<Tree>					fPending;	///< the recursive projections being computed
+
+	double	eval (Tree sig);
+	double	compute (Tree sig);
+	double	delayed (Tree sig, int d);
+	double	binop (int op, bool isint, double x, double y);
+	double	mathfun (const char* name, const vector<double>& args);
+
+	double	fail ()	{ fFailed = true; return 0; }
+
+  public:
+
+	SignalEvaluator () : fTime(0), fFailed(false) {}
+
+	bool	run (Tree sig, int n, vector<double>& values);
+};
+
+
+bool evalSignal (Tree sig, int n, vector<double>& values)
+{
+	SignalEvaluator E;
+	return E.run(sig, n, values);
+}
+
+
+// -- implementation -----------------
+
+bool SignalEvaluator::run (Tree sig, int n, vector<double>& values)
+{
+	values.resize(n);
+	for (fTime = 0; fTime < n; fTime++) {
+		double v = eval(sig);
+		if (fFailed || v != v || fabs(v) > 1e300) return false;
+		values[fTime] = v;
+	}
+	return true;
+}
+
+/**
+ * The value of sig at the current time. Every subsignal is evaluated at
+ * every time, selections included, to keep the histories complete.
+ */
+double SignalEvaluator::eval (Tree sig)
+{
+	if (fFailed) return 0;
+
+	vector<double>& h = fHistory[sig];
+	if (int(h.size()) > fTime) return h[fTime];
+
+	double v = compute(sig);
+
+	Type t = getCertifiedSigType(sig);
+	if (t && t->nature() == kInt) {
+		v = double(int(v));
+	} else if (gGlobal->gFloatSize == 1) {
+		v = double(float(v));
+	}
+	// compute() may have added other signals to the map
+	vector<double>& g = fHistory[sig];
+	if (int(g.size()) == fTime) g.push_back(v);
+	return v;
+}
+
+/**
+ * The value of sig, d samples ago. The signal is also evaluated at the
+ * current time, unless it is a recursive projection being computed.
+ */
+double SignalEvaluator::delayed (Tree sig, int d)
+{
+	if (d < 0) return fail();
+	if (fPending.count(sig)) {
+		if (d == 0) return fail();
+	} else {
+		double v = eval(sig);
+		if (d == 0) return v;
+	}
+	if (fFailed || fTime < d) return 0;
+	vector<double>& h = fHistory[sig];
+	return (fTime - d < int(h.size())) ? h[fTime - d] : fail();
+}
+
+double SignalEvaluator::compute (Tree sig)
+{
+	int		i, op;
+	double	r;
+	Tree	x, y, z, sel, ff, largs, var, le;
+	tvec	coefs;
+
+	if (isSigInt(sig, &i)) {
+		return i;
+
+	} else if (isSigReal(sig, &r)) {
+		return r;
+
+	} else if (isSigBinOp(sig, &op, x, y)) {
+		double a = eval(x);
+		double b = eval(y);
+		bool isint = getCertifiedSigType(x)->nature() == kInt && getCertifiedSigType(y)->nature() == kInt;
+		return binop(op, isint, a, b);
+
+	} else if (isSigIntCast(sig, x)) {
+		double a = eval(x);
+		if (fabs(a) >= 2147483648.0) return fail();
+		return double(int(a));
+
+	} else if (isSigFloatCast(sig, x)) {
+		return eval(x);
+
+	} else if (isSigDelay1(sig, x)) {
+		return delayed(x, 1);
+
+	} else if (isSigFixDelay(sig, x, y)) {
+		return delayed(x, int(eval(y)));
+
+	} else if (isSigPrefix(sig, x, y)) {
+		double a = eval(x);
+		double b = delayed(y, 1);
+		return (fTime == 0) ? a : b;
+
+	} else if (isSigFIR(sig, x, coefs)) {
+		double s = 0;
+		for (unsigned int k = 0; k < coefs.size(); k++) {
+			double c;
+			if (isSigInt(coefs[k], &i)) {
+				c = i;
+			} else if (!isSigReal(coefs[k], &c)) {
+				return fail();
+			}
+			s += c * delayed(x, k);
+		}
+		return s;
+
+	} else if (isSigSelect2(sig, sel, x, y)) {
+		double s = eval(sel);
+		double a = eval(x);
+		double b = eval(y);
+		return (s != 0) ? b : a;
+
+	} else if (isSigSelect3(sig, sel, x, y, z)) {
+		double s = eval(sel);
+		double a = eval(x);
+		double b = eval(y);
+		double c = eval(z);
+		return (s == 0) ? a : (s == 1) ? b : c;
+
+	} else if (isProj(sig, &i, x) && isRec(x, var, le)) {
+		fPending.insert(sig);
+		double v = eval(nth(le, i));
+		fPending.erase(sig);
+		return v;
+
+	} else if (getUserData(sig)) {
+		xtended* p = (xtended*)getUserData(sig);
+		vector<double> args;
+		for (int k = 0; k < sig->arity(); k++) args.push_back(eval(sig->branch(k)));
+		return mathfun(p->name(), args);
+
+	} else if (isSigFFun(sig, ff, largs)) {
+		vector<double> args;
+		for (; !isNil(largs); largs = tl(largs)) args.push_back(eval(hd(largs)));
+		return mathfun(ffname(ff), args);
+
+	} else {
+		// inputs, user interface, tables, foreign constants and variables...
+		return fail();
+	}
+}
+
+double SignalEvaluator::binop (int op, bool isint, double x, double y)
+{
+	if (isint) {
+		int a = int(x);
+		int b = int(y);
+		switch (op) {
+			// integer arithmetic wraps around like in the generated code
+			case kAdd : return int((unsigned int)a + (unsigned int)b);
+			case kSub : return int((unsigned int)a - (unsigned int)b);
+			case kMul : return int((unsigned int)a * (unsigned int)b);
+			case kDiv : return (b == 0) ? fail() : x/y;
+			case kRem : return (b == 0) ? fail() : a%b;
+			case kLsh : return int((unsigned int)a << (b & 31));
+			case kRsh : return a >> (b & 31);
+			case kAND : return a & b;
+			case kOR  : return a | b;
+			case kXOR : return a ^ b;
+			default	  : break;
+		}
+	} else {
+		switch (op) {
+			case kAdd : return x + y;
+			case kSub : return x - y;
+			case kMul : return x * y;
+			case kDiv : return x / y;
+			case kRem : return fmod(x, y);
+			default	  : break;
+		}
+	}
+	switch (op) {
+		case kGT : return x > y;
+		case kLT : return x < y;
+		case kGE : return x >= y;
+		case kLE : return x <= y;
+		case kEQ : return x == y;
+		case kNE : return x != y;
+		default	 : return fail();
+	}
+}
+
+/**
+ * The mathematical primitives and the usual foreign functions of math.h,
+ * the single and quad precision names being mapped to the double ones
+ */
+double SignalEvaluator::mathfun (const char* name, const vector<double>& args)
+{
+	string f(name);
+	if (f.size() > 1 && f != "ceil" && (f[f.size()-1] == 'f' || f[f.size()-1] == 'l')) {
+		f.erase(f.size()-1);
+	}
+	if (args.size() == 1) {
+		double x = args[0];
+		if (f == "sin")		return sin(x);
+		if (f == "cos")		return cos(x);
+		if (f == "tan")		return tan(x);
+		if (f == "asin")	return asin(x);
+		if (f == "acos")	return acos(x);
+		if (f == "atan")	return atan(x);
+		if (f == "exp")		return exp(x);
+		if (f == "log")		return log(x);
+		if (f == "log10")	return log10(x);
+		if (f == "sqrt")	return sqrt(x);
+		if (f == "abs")		return fabs(x);
+		if (f == "fabs")	return fabs(x);
+		if (f == "floor")	return floor(x);
+		if (f == "ceil")	return ceil(x);
+		if (f == "rint")	return rint(x);
+	} else if (args.size() == 2) {
+		double x = args[0];
+		double y = args[1];
+		if (f == "atan2")	return atan2(x, y);
+		if (f == "pow")		return pow(x, y);
+		if (f == "fmod")	return fmod(x, y);
+		if (f == "remainder")	return remainder(x, y);
+		if (f == "min")		return (x < y) ? x : y;
+		if (f == "max")		return (x > y) ? x : y;
+	}
+	return fail();
+}
@@ -0,0 +1,39 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2004 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+
+
+#ifndef _SIGEVAL_
+#define _SIGEVAL_
+
+#include <vector>
+#include "signals.hh"
+
+/**
+ * Compute at compile time the first n samples of a type annotated signal
+ * that only depends on numbers : no inputs, no user interface elements and
+ * no foreign constants or variables (like the sampling rate). Real values
+ * are rounded at each operation to the precision of the generated code.
+ * Returns false if the signal can't be evaluated.
+ */
+bool evalSignal (Tree sig, int n, std::vector<double>& values);
+
+#endif
@@ -61,6 +61,51 @@ Sym SIGFIXDELAY = symbol ("sigFixDelay");
 Tree  sigFixDelay(Tree t0, Tree t1)					{ return tree(SIGFIXDELAY, t0, sigIntCast(t1)); 		}
 bool  isSigFixDelay(Tree t, Tree& t0, Tree& t1)		{ return isTree(t, SIGFIXDELAY, t0, t1); 	}
 
+Sym SIGFIR = symbol ("SigFIR");
+Tree  sigFIR(Tree x, const tvec& coefs)
+{
+	tvec br;
+	br.push_back(x);
+	br.insert(br.end(), coefs.begin(), coefs.end());
+	return tree(SIGFIR, br);
+}
+
+bool  isSigFIR(Tree t, Tree& x)
+{
+	if (isTree(t, SIGFIR)) {
+		x = t->branch(0);
+		return true;
+	} else {
+		return false;
+	}
+}
+
+bool  isSigFIR(Tree t, Tree& x, tvec& coefs)
+{
+	if (isSigFIR(t, x)) {
+		coefs.assign(t->branches().begin()+1, t->branches().end());
+		return true;
+	} else {
+		return false;
+	}
+}
+
+Sym SIGSUM = symbol ("sigSum");
+Tree  sigSum(const tvec& terms)
+{
+	return tree(SIGSUM, terms);
+}
+
+bool  isSigSum(Tree t, tvec& terms)
+{
+	if (isTree(t, SIGSUM)) {
+		terms = t->branches();
+		return true;
+	} else {
+		return false;
+	}
+}
+
 Sym SIGPREFIX = symbol ("sigPrefix");
 Tree  sigPrefix(Tree t0, Tree t1)					{ return tree(SIGPREFIX, t0, t1); 		}
 bool  isSigPrefix(Tree t, Tree& t0, Tree& t1)		{ return isTree(t, SIGPREFIX, t0, t1); 	}
@@ -67,6 +67,15 @@ bool  isSigDelay1(Tree t, Tree& t0);
 Tree  sigFixDelay(Tree t0, Tree t1);
 bool  isSigFixDelay(Tree t, Tree& t0, Tree& t1);
 
+// FIR filter : sum of c[i]*x@i for constant coefficients c[0..n-1]
+Tree  sigFIR(Tree x, const tvec& coefs);
+bool  isSigFIR(Tree t, Tree& x);
+bool  isSigFIR(Tree t, Tree& x, tvec& coefs);
+
+// n-ary sum of the merged busses, lowered into binary additions by the normalization
+Tree  sigSum(const tvec& terms);
+bool  isSigSum(Tree t, tvec& terms);
+
 Tree  sigPrefix(Tree t0, Tree t1);
 bool  isSigPrefix(Tree t, Tree& t0, Tree& t1);
 
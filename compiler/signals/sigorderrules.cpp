@@ -44,6 +44,8 @@
 #include "tlib.hh"
 #include "sigorderrules.hh"
 #include "xtended.hh"
+#include "exception.hh"
+#include "global.hh"
 
 Tree ORDERPROP = tree(symbol("OrderProp"));
 
@@ -113,6 +115,8 @@ static int infereSigOrder(Tree sig)
 	else if (isSigPrefix(sig, s1, s2)) 			return 3;
 	
 	else if (isSigFixDelay(sig, s1, s2)) 		return 3;
+
+	else if (isSigFIR(sig, s1)) 				return 3;
 	
 	else if (isSigBinOp(sig, &i, s1, s2)) 		return max(O(s1),O(s2));
 	
@@ -144,9 +148,9 @@ static int infereSigOrder(Tree sig)
 		
 	else if (isSigAttach(sig, s1, s2)) 			return O(s1);
 				
-	else if (isRec(sig, var, body))				exit(1); //return 3;  // not supposed to happen.
+	else if (isRec(sig, var, body))				throw faustexception(); //return 3;  // not supposed to happen.
 				
-	else if (isRef(sig, var))					exit(1); //return 3;  // not supposed to happen. 
+	else if (isRef(sig, var))					throw faustexception(); //return 3;  // not supposed to happen. 
 
 	else if (isProj(sig, &i, s1))				return 3;
 	                                                	
@@ -176,8 +180,8 @@ static int infereSigOrder(Tree sig)
 	}
 	
 	// unrecognized signal here
-	fprintf(stderr, "ERROR infering signal order : unrecognized signal  : "); print(sig, stderr); fprintf(stderr, "\n");
-	exit(1);
+	gGlobal->gErrors << "ERROR infering signal order : unrecognized signal  : "; print(sig, gGlobal->gErrors); gGlobal->gErrors << endl;
+	throw faustexception();
 	return 0;
 }
 
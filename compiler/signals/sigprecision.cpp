@@ -0,0 +1,132 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2004 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+
+
+
+
+#include <math.h>
+#include <map>
+
+#include "sigprecision.hh"
+#include "sigtype.hh"
+#include "sigtyperules.hh"
+#include "recursivness.hh"
+#include "binop.hh"
+#include "property.hh"
+
+using namespace std;
+
+
+/*****************************************************************************
+						Feedback gain of the recursions
+*****************************************************************************/
+
+// the maximal absolute value of a signal
+static double magnitude (Tree sig)
+{
+	interval i = getCertifiedSigType(sig)->getInterval();
+	return (i.valid) ? max(fabs(i.lo), fabs(i.hi)) : HUGE_VAL;
+}
+
+// the minimal absolute value of a signal
+static double minMagnitude (Tree sig)
+{
+	interval i = getCertifiedSigType(sig)->getInterval();
+	if (!i.valid || (i.lo <= 0 && i.hi >= 0)) return 0;
+	return min(fabs(i.lo), fabs(i.hi));
+}
+
+// the gain of x in x*y, y not depending on the recursion
+static double scale (double g, Tree y)
+{
+	return (g == 0) ? 0 : g * magnitude(y);
+}
+
+/**
+ * The gain of sig relatively to the values of the recursion rec
+ */
+static double gain (Tree sig, Tree rec, map<Tree, double>& M)
+{
+	if (!isElement(rec, symlist(sig))) return 0;
+
+	map<Tree, double>::iterator p = M.find(sig);
+	if (p != M.end()) return p->second;
+	M[sig] = HUGE_VAL;		// unexpected cycles
+
+	int		i, op;
+	double	g;
+	Tree	x, y, r, sel;
+	tvec	coefs;
+
+	if (isProj(sig, &i, r)) {
+		// a nested recursion depending on rec isn't linear
+		g = (r == rec) ? 1 : HUGE_VAL;
+
+	} else if (isSigDelay1(sig, x) || isSigIntCast(sig, x) || isSigFloatCast(sig, x)) {
+		g = gain(x, rec, M);
+
+	} else if (isSigFixDelay(sig, x, y)) {
+		g = (gain(y, rec, M) > 0) ? HUGE_VAL : gain(x, rec, M);
+
+	} else if (isSigFIR(sig, x, coefs)) {
+		double s = 0;
+		for (unsigned int k = 0; k < coefs.size(); k++) s += magnitude(coefs[k]);
+		g = gain(x, rec, M) * s;
+
+	} else if (isSigBinOp(sig, &op, x, y)) {
+		double gx = gain(x, rec, M);
+		double gy = gain(y, rec, M);
+		switch (op) {
+			case kAdd :
+			case kSub : g = gx + gy; break;
+			case kMul : g = (gx > 0 && gy > 0) ? HUGE_VAL : scale(gx, y) + scale(gy, x); break;
+			case kDiv : g = (gy > 0) ? HUGE_VAL : gx / minMagnitude(y); break;
+			default   : g = HUGE_VAL; break;
+		}
+
+	} else if (isSigSelect2(sig, sel, x, y)) {
+		g = (gain(sel, rec, M) > 0) ? HUGE_VAL : max(gain(x, rec, M), gain(y, rec, M));
+
+	} else {
+		g = HUGE_VAL;
+	}
+
+	M[sig] = g;
+	return g;
+}
+
+// the gain of a recursion, memoized as a property of the tree like the other analyses
+static property<double> gFeedbackGainProperty;
+
+double recFeedbackGain (Tree rec)
+{
+	Tree				var, le;
+	map<Tree, double>	M;
+	double				g = 0;
+
+	if (gFeedbackGainProperty.get(rec, g)) return g;
+
+	if (!isRec(rec, var, le)) return HUGE_VAL;
+	for (; !isNil(le); le = tl(le)) g = max(g, gain(hd(le), rec, M));
+	gFeedbackGainProperty.set(rec, g);
+	return g;
+}
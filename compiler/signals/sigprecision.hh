@@ -0,0 +1,41 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+	Copyright (C) 2003-2004 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+
+
+
+
+#ifndef _SIGPRECISION_
+#define _SIGPRECISION_
+
+#include "signals.hh"
+
+/**
+ * Upper bound of the feedback gain of a recursion : the gain, through its
+ * definitions, from the past values of the recursion to its new values,
+ * computed with the intervals of the signals. HUGE_VAL when the feedback
+ * is not linear or when an interval is unknown. A recursion whose gain may
+ * be close to 1 (high Q filters, accumulators) is sensitive to the rounding
+ * errors of its state.
+ */
+double  recFeedbackGain (Tree rec);
+
+#endif
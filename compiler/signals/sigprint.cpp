@@ -87,6 +87,7 @@ void printSignal(Tree sig, FILE* out, int prec)
 	int 	i;
 	double	r;
     Tree 	 x, y, z, u, le, id;
+	tvec	terms;
 	    
 		 if ( isSigInt(sig, &i) ) 			{ fprintf(out, "%d", i); 	}
 	else if ( isSigReal(sig, &r) ) 			{ fprintf(out, "%f", r); 	}
@@ -107,6 +108,16 @@ void printSignal(Tree sig, FILE* out, int prec)
 		if (prec > 4) fputs(")", out); 	
 	}
 
+	else if ( isSigFIR(sig, x) ) 			{ fputs("fir(", out); printSignal(x,out,0); fprintf(out, ",%d)", sig->arity()-1);	}
+	else if ( isSigSum(sig, terms) ) 		{
+		if (prec > binopprec[kAdd]) fputs("(", out);
+		for (unsigned int k = 0; k < terms.size(); k++) {
+			if (k > 0) fputs(binopname[kAdd], out);
+			printSignal(terms[k], out, binopprec[kAdd]);
+		}
+		if (prec > binopprec[kAdd]) fputs(")", out);
+	}
+
 	else if ( isProj(sig, &i, x) ) 			{ printSignal(x,out,prec); fprintf(out, "#%d", i); 		}
     else if ( isRef(sig, i) ) 				{ fprintf(out, "$%d", i);	}
 	else if ( isRef(sig, x) ) 				{ print(x, out); 			}
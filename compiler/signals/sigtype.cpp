@@ -24,8 +24,10 @@
 #include "tree.hh"
 #include "sigtype.hh"
 #include "property.hh"
+#include "exception.hh"
+#include "global.hh"
 
-int     AudioType::gAllocationCount = 0;
+THREAD_LOCAL int AudioType::gAllocationCount = 0;
 
 bool    SimpleType::isMaximal() const                             ///< true when type is maximal (and therefore can't change depending of hypothesis)
 {
@@ -192,8 +194,8 @@ Type operator| ( const Type& t1, const Type& t2)
 		
 	} else {
 		
-		cerr << "Error : trying to combine incompatible types, " << t1 << " and " << t2 << endl;
-		exit(1);
+		gGlobal->gErrors << "Error : trying to combine incompatible types, " << t1 << " and " << t2 << endl;
+		throw faustexception();
 		return 0;
 	}
 }
@@ -278,8 +280,8 @@ Type checkInt(Type t)
 	// verifie que t est entier
 	SimpleType* st = isSimpleType(t);
 	if (st == 0 || st->nature() > kInt) {
-		cerr << "Error : checkInt failed for type " << t << endl;
-		exit(1);
+		gGlobal->gErrors << "Error : checkInt failed for type " << t << endl;
+		throw faustexception();
 	}
 	return t;
 }
@@ -288,8 +290,8 @@ Type checkKonst(Type t)
 {
 	// verifie que t est constant
 	if (t->variability() > kKonst) {
-		cerr << "Error : checkKonst failed for type " << t << endl;
-		exit(1);
+		gGlobal->gErrors << "Error : checkKonst failed for type " << t << endl;
+		throw faustexception();
 	}
 	return t;
 }	
@@ -298,8 +300,8 @@ Type checkInit(Type t)
 {
 	// verifie que t est connu a l'initialisation
 	if (t->computability() > kInit) {
-		cerr << "Error : checkInit failed for type " << t << endl;
-		exit(1);
+		gGlobal->gErrors << "Error : checkInit failed for type " << t << endl;
+		throw faustexception();
 	}
 	return t;
 }	
@@ -313,8 +315,8 @@ Type checkWRTbl(Type tbl, Type wr)
 {
 	// verifie que wr est compatible avec le contenu de tbl
 	if (wr->nature() > tbl->nature()) {
-		cerr << "Error : checkWRTbl failed, the content of  " << tbl << " is incompatible with " << wr << endl;
-		exit(1);
+		gGlobal->gErrors << "Error : checkWRTbl failed, the content of  " << tbl << " is incompatible with " << wr << endl;
+		throw faustexception();
 	}
 	return tbl;
 }		
@@ -388,8 +390,8 @@ Tree codeAudioType(AudioType* t)
     } else if ((nt = isTupletType(t))) {
         r = codeTupletType(nt);
     } else {
-        cerr << "ERROR in codeAudioType() : invalide pointer " << t << endl;
-        exit(1);
+        gGlobal->gErrors << "ERROR in codeAudioType() : invalide pointer " << t << endl;
+        throw faustexception();
     }
 
     r->setType(t);
@@ -82,7 +82,7 @@ typedef P<AudioType> Type;
 class AudioType
 {
   public:
-    static int  gAllocationCount;
+    static THREAD_LOCAL int  gAllocationCount;	///< the types allocated by the thread (statistics)
   protected:
 	int   		fNature;  		  	///< the kind of data represented
 	int   		fVariability; 	  	///< how fast values change
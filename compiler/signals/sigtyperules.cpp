@@ -26,6 +26,10 @@
 #include <iostream>
 #include <fstream>
 #include <time.h>
+#include <map>
+#include <set>
+#include <vector>
+#include <algorithm>
 
 
 #include "sigtype.hh"
@@ -37,6 +41,9 @@
 #include "sigtyperules.hh"
 #include "xtended.hh"
 #include "recursivness.hh"
+#include "property.hh"
+#include "exception.hh"
+#include "global.hh"
 
 
 //--------------------------------------------------------------------------
@@ -61,6 +68,7 @@ static Type infereDocConstantTblType(Type size, Type init);
 static Type infereDocWriteTblType(Type size, Type init, Type widx, Type wsig);
 static Type infereDocAccessTblType(Type tbl, Type ridx);
 static Type infereWaveformType (Tree lv, Tree env);
+static Type infereFIRType (Tree sig, Tree x, Tree env);
 
 static interval arithmetic (int opcode, const interval& x, const interval& y);
 
@@ -76,36 +84,151 @@ static interval arithmetic (int opcode, const interval& x, const interval& y);
  */
 static Tree NULLTYPEENV = tree(symbol("NullTypeEnv"));
 
-static int countInferences;
-static int countMaximal;
 
+/**
+ * The typing rounds : the type of a tree is computed once per round, the
+ * last round typing a tree is kept in gTypingRound. The round counter and
+ * the stamps belong to the compilation (see global.hh) : the compilations
+ * running in other threads have their own rounds and their own trees.
+ */
+
+static unsigned int typingRound(Tree sig)
+{
+    unsigned int r = 0;
+    gGlobal->gTypingRound.get(sig, r);
+    return r;
+}
+
+/**
+ * The last rounds of the completed type annotations. A tree last typed
+ * by one of them has its final type, reused by the following annotations
+ * (the documentation compiler types again most of the signals of the
+ * main compilation).
+ */
+
+static bool hasFinalType(Tree sig)
+{
+    return sig->getType() && gGlobal->gFinalRounds.count(typingRound(sig));
+}
+
+
+
+/**
+ * The recursive groups referenced by sig, without entering their definitions
+ */
+static void directRecDependencies(Tree sig, set<Tree>& visited, set<Tree>& deps)
+{
+    if (visited.count(sig) || hasFinalType(sig)) return;
+    visited.insert(sig);
+
+    Tree id, body;
+    if (isRec(sig, id, body)) {
+        deps.insert(sig);
+    } else {
+        vector<Tree> subsigs;
+        int n = getSubSignals(sig, subsigs, true);
+        for (int i=0; i<n; i++) directRecDependencies(subsigs[i], visited, deps);
+    }
+}
+
+
+/**
+ * Strongly connected components of the dependency graph of the recursive
+ * groups (Tarjan). The components are produced in topological order :
+ * a component comes after all the components it depends on.
+ */
+struct RecComponents
+{
+    const vector<vector<int> >&  fDeps;
+    vector<int>                  fIndex, fLow;
+    vector<bool>                 fOnStack;
+    vector<int>                  fStack;
+    vector<vector<int> >         fComponents;
+    int                          fCount;
+
+    RecComponents(const vector<vector<int> >& deps)
+        : fDeps(deps), fIndex(deps.size(), -1), fLow(deps.size(), 0), fOnStack(deps.size(), false), fCount(0)
+    {
+        for (int i=0; i<int(deps.size()); i++) {
+            if (fIndex[i] < 0) visit(i);
+        }
+    }
+
+    void visit(int i)
+    {
+        fIndex[i] = fLow[i] = fCount++;
+        fStack.push_back(i);
+        fOnStack[i] = true;
+
+        for (unsigned int k=0; k<fDeps[i].size(); k++) {
+            int j = fDeps[i][k];
+            if (fIndex[j] < 0) {
+                visit(j);
+                fLow[i] = min(fLow[i], fLow[j]);
+            } else if (fOnStack[j]) {
+                fLow[i] = min(fLow[i], fIndex[j]);
+            }
+        }
+
+        if (fLow[i] == fIndex[i]) {
+            vector<int> c;
+            int j;
+            do {
+                j = fStack.back();
+                fStack.pop_back();
+                fOnStack[j] = false;
+                c.push_back(j);
+            } while (j != i);
+            fComponents.push_back(c);
+        }
+    }
+};
+
+
+/**
+ * Set the types of the recursive groups and start a new typing round
+ */
+static void startRecRound(const vector<Tree>& vrec, const vector<Type>& vtype)
+{
+    ++gGlobal->gCurrentRound;
+    for (unsigned int i=0; i<vrec.size(); i++) {
+        setSigType(vrec[i], vtype[i]);
+        gGlobal->gTypingRound.set(vrec[i], gGlobal->gCurrentRound);
+    }
+}
 
 
 /**
  * Fully annotate every subtree of term with type information.
+ * The recursive groups are split into strongly connected components that
+ * are solved in topological order, so that a group is only typed again
+ * when the type of a group it depends on has changed.
  * @param sig the signal term tree to annotate
  */
 
 void typeAnnotation(Tree sig)
 {
     Tree            sl = symlist(sig);
-    int             n = len(sl);
 
     vector<Tree>    vrec, vdef;
     vector<Type>    vtype;
+    map<Tree,int>   vnum;
 
     //cerr << "Symlist " << *sl << endl;
     for (Tree l=sl; isList(l); l=tl(l)) {
         Tree    id, body;
 		assert(isRec(hd(l), id, body));
-		if (!isRec(hd(l), id, body)) {
+		if (!isRec(hd(l), id, body) || hasFinalType(hd(l))) {
 			continue;
 		}
 
+        vnum[hd(l)] = vrec.size();
         vrec.push_back(hd(l));
         vdef.push_back(body);
     }
 
+    int             n = vrec.size();
+
     // init recursive types
     for (int i=0; i<n; i++) {
         vtype.push_back(initialRecType(vdef[i]));
@@ -115,15 +238,63 @@ void typeAnnotation(Tree sig)
     assert (int(vdef.size())==n);
     assert (int(vtype.size())==n);
 
-    // find least fixpoint
-    for (bool finished = false; !finished; ) {
+    // dependency graph of the recursive groups, and its reverse
+    vector<vector<int> > vdeps(n), vusers(n);
+    for (int i=0; i<n; i++) {
+        set<Tree> visited, deps;
+        for (Tree l=vdef[i]; isList(l); l=tl(l)) directRecDependencies(hd(l), visited, deps);
+        for (set<Tree>::iterator p = deps.begin(); p != deps.end(); p++) {
+            int j = vnum[*p];
+            vdeps[i].push_back(j);
+            vusers[j].push_back(i);
+        }
+    }
 
-        // init recursive types
-        CTree::startNewVisit();
-        for (int i=0; i<n; i++) {
-            setSigType(vrec[i], vtype[i]);
-            vrec[i]->setVisited();
+    // find the least fixpoint of each component, its dependencies being solved
+    RecComponents   scc(vdeps);
+    vector<int>     vcomp(n);
+    int             maxRounds = 0;
+
+    for (unsigned int c=0; c<scc.fComponents.size(); c++) {
+        const vector<int>& comp = scc.fComponents[c];
+        for (unsigned int k=0; k<comp.size(); k++) vcomp[comp[k]] = c;
+
+        vector<int> worklist(comp);
+        int         rounds = 0;
+        while (!worklist.empty()) {
+            rounds++;
+            gGlobal->countRecInferences += worklist.size();
+
+            // compute the new types from the types of the previous round
+            startRecRound(vrec, vtype);
+            vector<Type> newtype(worklist.size());
+            for (unsigned int k=0; k<worklist.size(); k++) {
+                newtype[k] = T(vdef[worklist[k]], NULLTYPEENV);
+            }
+
+            // the groups of the component using a group whose type has changed
+            set<int> next;
+            for (unsigned int k=0; k<worklist.size(); k++) {
+                int i = worklist[k];
+                if (newtype[k] != vtype[i]) {
+                    vtype[i] = newtype[k];
+                    for (unsigned int u=0; u<vusers[i].size(); u++) {
+                        if (vcomp[vusers[i][u]] == int(c)) next.insert(vusers[i][u]);
+                    }
+                }
+            }
+            worklist.assign(next.begin(), next.end());
         }
+        maxRounds = max(maxRounds, rounds);
+    }
+    gGlobal->countRecLowerBound += n * maxRounds;
+
+    // type all the definitions with the final types, a single round is
+    // expected, the loop only guards against a missed dependency
+    for (bool finished = false; !finished; ) {
+
+        gGlobal->countGlobalRounds++;
+        startRecRound(vrec, vtype);
 
         // compute recursive types
         for (int i=0; i<n; i++) {
@@ -140,14 +311,17 @@ void typeAnnotation(Tree sig)
 
     // type full term
     T(sig, NULLTYPEENV);
+    gGlobal->gFinalRounds.insert(gGlobal->gCurrentRound);
 }
 
 
 void annotationStatistics()
 {
-    cerr << TABBER << "COUNT INFERENCE  " << countInferences << " AT TIME " << clock()/CLOCKS_PER_SEC << 's' << endl;
-    cerr << TABBER << "COUNT ALLOCATION " << AudioType::gAllocationCount << endl;
-    cerr << TABBER << "COUNT MAXIMAL " << countMaximal << endl;
+    gGlobal->gErrors << TABBER << "COUNT INFERENCE  " << gGlobal->countInferences << " AT TIME " << clock()/CLOCKS_PER_SEC << 's' << endl;
+    gGlobal->gErrors << TABBER << "COUNT ALLOCATION " << AudioType::gAllocationCount << endl;
+    gGlobal->gErrors << TABBER << "COUNT MAXIMAL " << gGlobal->countMaximal << endl;
+    gGlobal->gErrors << TABBER << "COUNT RECURSIVE DEFINITIONS TYPED " << gGlobal->countRecInferences
+         << " (AT LEAST " << max(0, gGlobal->countRecLowerBound - gGlobal->countRecInferences) << " SAVED), FINAL ROUNDS " << gGlobal->countGlobalRounds << endl;
 }
 
 /**
@@ -178,7 +352,7 @@ Type getCertifiedSigType(Tree sig)
  */
 static void setSigType(Tree sig, Type t)
 {
-    TRACE(cerr << TABBER << "SET FIX TYPE OF " << *sig << " TO TYPE " << *t << endl;)
+    TRACE(gGlobal->gErrors << TABBER << "SET FIX TYPE OF " << *sig << " TO TYPE " << *t << endl;)
 	sig->setType(t);
 }
 
@@ -191,9 +365,9 @@ static Type getSigType(Tree sig)
 {
     AudioType* ty = (AudioType*) sig->getType();
     if (ty == 0)
-        TRACE(cerr << TABBER << "GET FIX TYPE OF " << *sig << " HAS NO TYPE YET" << endl;)
+        TRACE(gGlobal->gErrors << TABBER << "GET FIX TYPE OF " << *sig << " HAS NO TYPE YET" << endl;)
     else
-        TRACE(cerr << TABBER << "GET FIX TYPE OF " << *sig << " IS TYPE " << *ty << endl;)
+        TRACE(gGlobal->gErrors << TABBER << "GET FIX TYPE OF " << *sig << " IS TYPE " << *ty << endl;)
     return ty;
 }
 
@@ -222,18 +396,18 @@ static Type getSigType(Tree sig)
  */
 static Type T(Tree term, Tree ignoreenv)
 {
-    TRACE(cerr << ++TABBER << "ENTER T() " << *term << endl;)
+    TRACE(gGlobal->gErrors << ++TABBER << "ENTER T() " << *term << endl;)
 
-    if (term->isAlreadyVisited()) {
+    if (typingRound(term) == gGlobal->gCurrentRound || hasFinalType(term)) {
         Type    ty =  getSigType(term);
-        TRACE(cerr << --TABBER << "EXIT 1 T() " << *term << " AS TYPE " << *ty << endl);
+        TRACE(gGlobal->gErrors << --TABBER << "EXIT 1 T() " << *term << " AS TYPE " << *ty << endl);
         return ty;
 
     } else {
         Type ty = infereSigType(term, ignoreenv);
         setSigType(term,ty);
-        term->setVisited();
-        TRACE(cerr << --TABBER << "EXIT 2 T() " << *term << " AS TYPE " << *ty << endl);
+        gGlobal->gTypingRound.set(term, gGlobal->gCurrentRound);
+        TRACE(gGlobal->gErrors << --TABBER << "EXIT 2 T() " << *term << " AS TYPE " << *ty << endl);
         return ty;
     }
 }
@@ -253,7 +427,7 @@ static Type infereSigType(Tree sig, Tree env)
     Tree		sel, s1, s2, s3, ff, id, ls, l, x, y, z, u, var, body, type, name, file;
 	Tree		label, cur, min, max, step;
 
-    countInferences++;
+    gGlobal->countInferences++;
 
 		 if ( getUserData(sig) ) 			return infereXType(sig, env);
 
@@ -282,6 +456,8 @@ static Type infereSigType(Tree sig, Tree env)
 		return castInterval(sampCast(t1|t2), reunion(t1->getInterval(), t2->getInterval()));
 	}
 
+	else if (isSigFIR(sig, s1))					{   return infereFIRType(sig, s1, env); }
+
 	else if (isSigFixDelay(sig, s1, s2)) 		{
 		Type t1 = T(s1,env);
 		Type t2 = T(s2,env);
@@ -291,15 +467,15 @@ static Type infereSigType(Tree sig, Tree env)
 //				<< t1 << ':' << ppsig(s1) << ", s2 = "
 //                << t2 << ':' << ppsig(s2) << endl;
 		if (!i.valid) {
-			cerr << "ERROR : can't compute the min and max values of : " << ppsig(s2) << endl;
-			cerr << "        used in delay expression : " << ppsig(sig) << endl;
-			cerr << "        (probably a recursive signal)" << endl;
-			exit(1);
+			gGlobal->gErrors << "ERROR : can't compute the min and max values of : " << ppsig(s2) << endl;
+			gGlobal->gErrors << "        used in delay expression : " << ppsig(sig) << endl;
+			gGlobal->gErrors << "        (probably a recursive signal)" << endl;
+			throw faustexception();
 		} else if (i.lo < 0) {
-			cerr << "ERROR : possible negative values of : " << ppsig(s2) << endl;
-			cerr << "        used in delay expression : " << ppsig(sig) << endl;
-			cerr << "        " << i << endl;
-			exit(1);
+			gGlobal->gErrors << "ERROR : possible negative values of : " << ppsig(s2) << endl;
+			gGlobal->gErrors << "        used in delay expression : " << ppsig(sig) << endl;
+			gGlobal->gErrors << "        " << i << endl;
+			throw faustexception();
 		}
 
 		return castInterval(sampCast(t1), reunion(t1->getInterval(), interval(0,0)));
@@ -389,8 +565,8 @@ static Type infereSigType(Tree sig, Tree env)
     else if (isList(sig))                       { return T( hd(sig),env ) * T( tl(sig),env ); }
 
 	// unrecognized signal here
-	fprintf(stderr, "ERROR infering signal type : unrecognized signal  : "); print(sig, stderr); fprintf(stderr, "\n");
-	exit(1);
+	gGlobal->gErrors << "ERROR infering signal type : unrecognized signal  : "; print(sig, gGlobal->gErrors); gGlobal->gErrors << endl;
+	throw faustexception();
 	return 0;
 }
 
@@ -403,8 +579,8 @@ static Type infereProjType(Type t, int i, int vec)
 {
 	TupletType* tt = isTupletType(t);
 	if (tt == 0) {
-		cerr << "ERROR infering projection type, not a tuplet type : " << t << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR infering projection type, not a tuplet type : " << t << endl;
+		throw faustexception();
 	}
 	//return (*tt)[i]	->promoteVariability(t->variability())
 	//		->promoteComputability(t->computability());
@@ -428,13 +604,13 @@ static Type infereWriteTableType(Type tbl, Type wi, Type wd)
 {
 	TableType* tt = isTableType(tbl);
 	if (tt == 0) {
-		cerr << "ERROR infering write table type, wrong table type : " << tbl << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR infering write table type, wrong table type : " << tbl << endl;
+		throw faustexception();
 	}
 	SimpleType* st = isSimpleType(wi);
 	if (st == 0 || st->nature() > kInt) {
-		cerr << "ERROR infering write table type, wrong write index type : " << wi << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR infering write table type, wrong write index type : " << wi << endl;
+		throw faustexception();
 	}
 
 	int n = tt->nature();
@@ -455,13 +631,13 @@ static Type infereReadTableType(Type tbl, Type ri)
 {
 	TableType*	tt = isTableType(tbl);
 	if (tt == 0) {
-		cerr << "ERROR infering read table type, wrong table type : " << tbl << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR infering read table type, wrong table type : " << tbl << endl;
+		throw faustexception();
 	}
 	SimpleType* st = isSimpleType(ri);
 	if (st == 0 || st->nature() > kInt) {
-		cerr << "ERROR infering read table type, wrong write index type : " << ri << endl;
-		exit(1);
+		gGlobal->gErrors << "ERROR infering read table type, wrong write index type : " << ri << endl;
+		throw faustexception();
 	}
 
 	Type temp =  tt->content()->promoteVariability(ri->variability()|tt->variability())
@@ -601,8 +777,8 @@ static Type infereWaveformType (Tree wfsig, Tree env)
     double  lo, hi;
 
     if (n == 0) {
-        std::cerr << "ERROR, empty waveform" << std::endl;
-        exit(1);
+        gGlobal->gErrors << "ERROR, empty waveform" << std::endl;
+        throw faustexception();
     }
 
     lo = hi = tree2float(wfsig->branch(0));
@@ -626,6 +802,30 @@ static Type infereWaveformType (Tree wfsig, Tree env)
 }
 
 
+/**
+ *	Infere the type of a FIR filter. The result is always real and its
+ *	amplitude is bounded by the sum of the absolute values of the coefficients
+ *	times the amplitude of the input signal.
+ */
+static Type infereFIRType (Tree sig, Tree x, Tree env)
+{
+    Type        t = T(x, env);
+    interval    i = t->getInterval();
+    double      g = 0;
+
+    for (int k = 1; k < sig->arity(); k++) {
+        g += fabs(tree2float(sig->branch(k)));
+    }
+
+    if (i.valid) {
+        double m = g * max(fabs(i.lo), fabs(i.hi));
+        return castInterval(floatCast(sampCast(t)), interval(-m, m));
+    } else {
+        return castInterval(floatCast(sampCast(t)), interval());
+    }
+}
+
+
 /**
  *	Infere the type of an extended (primitive) block
  */
@@ -672,8 +872,8 @@ static interval arithmetic (int opcode, const interval& x, const interval& y)
         case kOR:  return x|y;
         case kXOR: return x^y;
         default:
-            cerr << "Unrecognized opcode : " << opcode << endl;
-            exit(1);
+            gGlobal->gErrors << "Unrecognized opcode : " << opcode << endl;
+            throw faustexception();
     }
 
     return interval();
@@ -28,9 +28,6 @@
 #include "sigtype.hh"
 
 
-extern bool gVectorSwitch;
-
-
 /** \file sigtyperules.hh
  * API to the typing system of signals
  *
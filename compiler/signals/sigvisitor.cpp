@@ -2,6 +2,7 @@
 #include <iostream>
 #include <assert.h>
 #include "xtended.hh"
+#include "global.hh"
 
 
 using namespace std;
@@ -121,5 +122,5 @@ void sigvisitor::visit(Tree sig)
 
 void sigvisitor::visitError(Tree sig)
 {
-	cerr << "ERROR visiting signal" << endl;
+	gGlobal->gErrors << "ERROR visiting signal" << endl;
 }
@@ -1,5 +1,7 @@
 #include <signals.hh>
 #include <property.hh>
+#include "exception.hh"
+#include "global.hh"
 
 /**
  * Extract the sub signals of a signal expression, that is not
@@ -31,6 +33,7 @@ int	getSubSignals (Tree sig, vector<Tree>& vsigs, bool visitgen)
 	else if ( isSigDelay1(sig, x) ) 				{ vsigs.push_back(x); return 1;	}
 
 	else if ( isSigFixDelay(sig, x, y) ) 			{ vsigs.push_back(x); vsigs.push_back(y); return 2;	}
+	else if ( isSigFIR(sig, x) ) 					{ vsigs.push_back(x); return 1;	}
     else if ( isSigPrefix(sig, x, y) )              { vsigs.push_back(x); vsigs.push_back(y); return 2;	}
 	else if ( isSigIota(sig, x) ) 					{ vsigs.push_back(x); return 1; }
 
@@ -72,8 +75,8 @@ int	getSubSignals (Tree sig, vector<Tree>& vsigs, bool visitgen)
     else if ( isNil(sig) )                          { return 0; }
 
 	else {
-        cerr << "ERROR, getSubSignals unrecognized signal : " << *sig << endl;
-		exit(1);
+        gGlobal->gErrors << "ERROR, getSubSignals unrecognized signal : " << *sig << endl;
+		throw faustexception();
 	}
 	return 0;
 }
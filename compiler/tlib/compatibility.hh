@@ -84,4 +84,11 @@ void getFaustPathname(char* str, unsigned int size);
 
 #endif
 
+// thread local storage, for the state of the compilation running in a thread (see global.hh)
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 #endif
@@ -107,6 +107,8 @@ This file contains several extensions to the tree library :
 #include "compatibility.hh"
 #include <map>
 #include <cstdlib>
+#include <sstream>
+#include "exception.hh"
 
 // predefined symbols CONS and NIL
 Sym CONS = symbol("cons");
@@ -120,29 +122,29 @@ Tree nil = tree(NIL);
 // Printing of trees with special case for lists
 //------------------------------------------------------------------------------
 
-static bool printlist (Tree l, FILE* out)
+static bool printlist (Tree l, ostream& out)
 {
 	if (isList(l)) {
 		
 		char sep = '(';
 		
 		do {
-			fputc(sep, out); sep = ',';
-			print(hd(l));
+			out << sep; sep = ',';
+			print(hd(l), out);
 			l = tl(l);
 		} while (isList(l));
 		
 		if (! isNil(l)) {
-			fprintf(out, " . ");
+			out << " . ";
 			print(l, out);
 		}
 		
-		fputc(')', out);
+		out << ')';
 		return true;
 		
 	} else if (isNil(l)) {
 		
-		fprintf(out, "nil");
+		out << "nil";
 		return true;
 		
 	} else {
@@ -151,29 +153,37 @@ static bool printlist (Tree l, FILE* out)
 	}
 }
 
-void print (Tree t, FILE* out)
+void print (Tree t, ostream& out)
 {
 	int i; double f; Sym s; void* p;
+	char buf[64];
 	
 	if (printlist(t, out))		return;
 	
 	Node n = t->node();
-		 if (isInt(n, &i)) 		fprintf (out, "%d", i);
-	else if (isDouble(n, &f)) 	fprintf (out, "%f", f);
-	else if (isSym(n, &s)) 		fprintf (out, "%s", name(s));
-	else if (isPointer(n, &p)) 	fprintf (out, "#%p", p);
+		 if (isInt(n, &i)) 		out << i;
+	else if (isDouble(n, &f)) 	{ snprintf(buf, sizeof(buf), "%f", f); out << buf; }
+	else if (isSym(n, &s)) 		out << name(s);
+	else if (isPointer(n, &p)) 	{ snprintf(buf, sizeof(buf), "#%p", p); out << buf; }
 	
 	int k = t->arity();
 	if (k > 0) {
 		char sep = '[';
 		for (int i=0; i<k; i++) {
-			fputc(sep, out); sep = ',';
+			out << sep; sep = ',';
 			print(t->branch(i), out);
 		}
-		fputc(']', out);
+		out << ']';
 	} 
 }
 
+void print (Tree t, FILE* out)
+{
+	ostringstream s;
+	print(t, s);
+	fputs(s.str().c_str(), out);
+}
+
 
 //------------------------------------------------------------------------------
 // Elements of list
@@ -433,7 +443,7 @@ bool getProperty (Tree t, Tree key, Tree& val)
 
 void remProperty (Tree t, Tree key)
 {
-	exit(1); // fonction not implemented
+	throw faustexception(); // fonction not implemented
 }
 #endif
 
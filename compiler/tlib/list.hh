@@ -118,6 +118,7 @@ extern Tree 	nil;
 typedef Tree (*tfun)(Tree);
 
 void print (Tree t, FILE* out=stdout);
+void print (Tree t, ostream& out);
 //bool printlist (const CTree* lc);
 
 // to create new lists
@@ -148,5 +148,48 @@ public:
 };
 
 
+/**
+ * A property stored in a side table indexed by the serial number of the
+ * trees instead of their property lists : no lookup in a map and no tree
+ * allocated for the value. Meant for annotations set on most of the nodes
+ * of large trees.
+ */
+template<class P> class denseproperty
+{
+    vector<P>       fData;
+    vector<bool>    fDefined;
+
+public:
+
+    void set(Tree t, const P& data)
+    {
+        unsigned int i = t->serial();
+        if (i >= fData.size()) {
+            unsigned int n = i + 1 + i/2;
+            fData.resize(n);
+            fDefined.resize(n, false);
+        }
+        fData[i] = data;
+        fDefined[i] = true;
+    }
+
+    bool get(Tree t, P& data)
+    {
+        unsigned int i = t->serial();
+        if (i < fData.size() && fDefined[i]) {
+            data = fData[i];
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    void clear(Tree t)
+    {
+        unsigned int i = t->serial();
+        if (i < fData.size()) { fDefined[i] = false; }
+    }
+};
+
 
 #endif
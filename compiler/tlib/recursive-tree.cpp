@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <limits.h>
 #include "tlib.hh"
+#include "exception.hh"
 
 // Declaration of implementation
 static Tree calcDeBruijn2Sym (Tree t);
@@ -113,6 +114,34 @@ bool isRef(Tree t, Tree& v)
 	return isTree(t, SYMREC, v);
 }
 
+//-----------------------------------------------------------------------------------------
+// Name of the definition a signal or a recursive group comes from, used to name the
+// loops of the profiles. The trees rebuilt by lift and deBruijn2Sym keep it. The open
+// trees being shared by all the recursions with the same structure, the trees closed
+// by substitute get the name of the recursion they are in.
+//-----------------------------------------------------------------------------------------
+Tree DEFINITIONNAME = tree(symbol("DEFINITIONNAME"));
+
+void setDefinitionName(Tree t, Tree name)
+{
+	t->setProperty(DEFINITIONNAME, name);
+}
+
+bool getDefinitionName(Tree t, Tree& name)
+{
+	name = t->getProperty(DEFINITIONNAME);
+	return name != 0;
+}
+
+Tree keepDefinitionName(Tree t, Tree t2)
+{
+	if (t2 != t) {
+		Tree name = t->getProperty(DEFINITIONNAME);
+		if (name && !t2->getProperty(DEFINITIONNAME)) t2->setProperty(DEFINITIONNAME, name);
+	}
+	return t2;
+}
+
 //-----------------------------------------------------------------------------------------
 // L'aperture d'un arbre est la plus profonde reference de Bruijn qu'il contienne.
 // Les references symboliques compte pour zero ce qui veut dire qu'un arbre d'aperture
@@ -200,7 +229,7 @@ static Tree calcliftn(Tree t, int threshold)
 
 	} else if (isRec(t,u)) {
 
-		return rec(liftn(u, threshold+1));
+		return keepDefinitionName(t, rec(liftn(u, threshold+1)));
 
 	} else {
 		int n = t->arity();
@@ -210,7 +239,7 @@ static Tree calcliftn(Tree t, int threshold)
 			br[i] = liftn(t->branch(i), threshold);
 		}
 		//return CTree::make(t->node(), n, br);
-		return CTree::make(t->node(), br);
+		return keepDefinitionName(t, CTree::make(t->node(), br));
 	}
 
 }
@@ -240,7 +269,8 @@ static Tree calcDeBruijn2Sym (Tree t)
 	if (isRec(t,body)) {
 
 		var = tree(unique("W"));
-		return rec(var, deBruijn2Sym(substitute(body,1,ref(var))));
+		Tree r = keepDefinitionName(t, ref(var));	// the same tree as rec(var, ...)
+		return rec(var, deBruijn2Sym(substitute(body,1,r)));
 
 	} else if (isRef(t,var)) {
 
@@ -251,7 +281,7 @@ static Tree calcDeBruijn2Sym (Tree t)
 		fprintf(stderr, "ERREUR, une reference de Bruijn touvee ! : ");
 		printSignal(t, stderr);
 		fprintf(stderr, ")\n");
-		exit(1);
+		throw faustexception();
 		return t;
 
 	} else {
@@ -264,7 +294,7 @@ static Tree calcDeBruijn2Sym (Tree t)
 			br[i] = deBruijn2Sym(t->branch(i));
 		}
 		//return CTree::make(t->node(), a, br);
-		return CTree::make(t->node(), br);
+		return keepDefinitionName(t, CTree::make(t->node(), br));
 	}
 }
 
@@ -291,7 +321,7 @@ static Tree calcsubstitute(Tree t, int level, Tree id)
 		return t;
 	}
 	if (isRef(t,l)) 		 return (l == level) ? id : t;
-	if (isRec(t,body)) 		 return rec(substitute(body, level+1, id));
+	if (isRec(t,body)) 		 return keepDefinitionName(id, rec(substitute(body, level+1, id)));
 
 	int 	ar = t->arity();
 	//Tree	br[4];
@@ -300,7 +330,7 @@ static Tree calcsubstitute(Tree t, int level, Tree id)
 		br[i] = substitute(t->branch(i), level, id);
 	}
 	//return CTree::make(t->node(), ar, br);
-	return CTree::make(t->node(), br);
+	return keepDefinitionName(id, CTree::make(t->node(), br));
 }
 
 
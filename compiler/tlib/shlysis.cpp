@@ -61,6 +61,8 @@ unique to each sharing analysis must be generated.
 
 #include 	"shlysis.hh"
 #include "compatibility.hh"
+#include "exception.hh"
+#include "global.hh"
 
 /**
  * Create a specific property key for the sharing count of subtrees of t
@@ -128,7 +130,7 @@ Tree shlysis(Tree t)
  */
 static void annotate(Tree k, Tree t, barrier foo)
 {
-	cerr << "Annotate " << *t << endl;
+	gGlobal->gErrors << "Annotate " << *t << endl;
 	int c = shcount(k,t);
 	if (c==0) {
 		// First visit
@@ -27,6 +27,8 @@
 //#include <iostream>
 #include <cstdlib>
 #include <cstdio>
+#include "exception.hh"
+#include "global.hh"
 
 
 
@@ -48,17 +50,17 @@ class P {
 		T& operator*() const {
 			if (p == 0) {
 				//throw std::runtime_error("Null dereference in P<?>::operator*() const ");
-				fprintf(stderr, "Null dereference in P<?>::operator*() const \n ");
-				exit(1);
+				gGlobal->gErrors << "Null dereference in P<?>::operator*() const " << std::endl;
+				throw faustexception();
 			}
 			return *p;
 		}
 		T* operator->() const	{ 
 			if (p == 0) {
-				fprintf(stderr, "Null dereference in P<?>::operator->() const \n ");
+				gGlobal->gErrors << "Null dereference in P<?>::operator->() const " << std::endl;
 				//throw std::runtime_error("Null dereference in P<?>::operator->() const ");
 				//std::cerr << "Null dereference in P<?>::operator->() const " << std::endl;
-				exit(1);
+				throw faustexception();
 			}
 			return p;
 		}
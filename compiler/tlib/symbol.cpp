@@ -27,6 +27,9 @@
 #include    <iostream>
 #include    <cstring>
 #include    <assert.h>
+#ifndef _WIN32
+#include    <pthread.h>
+#endif
 
 using namespace std;
 
@@ -36,6 +39,23 @@ using namespace std;
  
 Symbol*	Symbol::gSymbolTable[kHashTableSize];
 
+/**
+ * The compilations running at the same time share the symbols : the hash
+ * table is only accessed with this lock (on Windows the compilations must
+ * not overlap)
+ */
+#ifndef _WIN32
+static pthread_mutex_t gSymbolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+struct SymbolLock
+{
+	SymbolLock()	{ pthread_mutex_lock(&gSymbolMutex); }
+	~SymbolLock()	{ pthread_mutex_unlock(&gSymbolMutex); }
+};
+#else
+struct SymbolLock {};
+#endif
+
 
 /**
  * Search the hash table for the symbol of name \p str or returns a new one.
@@ -75,12 +95,25 @@ Symbol* Symbol::get(const char* rawstr)
     *p++ = 0;
     //----------------------------------------------------
 
+    SymbolLock      lock;
+    return find(str, true);
+}
+
+
+/**
+ * Search the hash table for the symbol of name \p str, the table being locked.
+ * \param str the name of the symbol
+ * \param create true to add a new symbol when there is none
+ * \return the symbol of name str, or 0 if there is none and create is false
+ */
+Symbol* Symbol::find(const char* str, bool create)
+{
     unsigned int 	hsh  = calcHashKey(str);
     int 			bckt = hsh % kHashTableSize;
 	Symbol*			item = gSymbolTable[bckt];
 
     while ( item && !item->equiv(hsh,str) ) item = item->fNext;
-	Symbol* r = item ? item : gSymbolTable[bckt] = new Symbol(str, hsh, gSymbolTable[bckt]);
+	Symbol* r = (item || !create) ? item : gSymbolTable[bckt] = new Symbol(str, hsh, gSymbolTable[bckt]);
 	return r;
 }
 
@@ -93,12 +126,8 @@ Symbol* Symbol::get(const char* rawstr)
 
 bool Symbol::isnew(const char* str)
 {
-    unsigned int    hsh  = calcHashKey(str);
-    int 			bckt = hsh % kHashTableSize;
-	Symbol*			item = gSymbolTable[bckt];
-	
-    while ( item && !item->equiv(hsh,str) ) item = item->fNext;
-	return item == 0;
+    SymbolLock      lock;
+	return find(str, false) == 0;
 }
 
 
@@ -111,21 +140,22 @@ bool Symbol::isnew(const char* str)
 Symbol* Symbol::prefix (const char* str)
 {
 	char 	name[256];
+    SymbolLock  lock;
     
     static map<const char*, unsigned int> gPrefixCounters;
 	
 	for (int n = 0; n<10000; n++) {
 		snprintf(name, 256, "%s%d", str, gPrefixCounters[str]++);
-		if (isnew(name)) return get(name);
+		if (find(name, false) == 0) return find(name, true);
 	}
 	assert(false);
-	return get("UNIQUEOVERFLOW");
+	return find("UNIQUEOVERFLOW", true);
 }	
 
 
 /**
  * Check if the name of the symbol is equal to string \p str
- * This method is used by isnew() and make() when searching the hashtable 
+ * This method is used by find() when searching the hashtable 
  * for an existing symbol.
  *
  * \param hash the hash key of the string (used to speedup the comparison)
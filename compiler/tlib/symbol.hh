@@ -77,6 +77,7 @@ class Symbol
 	static Symbol*		get (const string& str);				///< Get the symbol of name \p str
 	static Symbol* 		get (const char* str);					///< Get the symbol of name \p str
 	static Symbol* 		prefix (const char* str);				///< Creates a new symbol of name prefixed by \p str
+	static Symbol* 		find (const char* str, bool create);	///< Search (and add if create) the symbol of name \p str, the table being locked
 	static bool 		isnew (const char* str);				///< Returns \b true if no symbol of name \p str exists
 	
  public:
@@ -82,6 +82,8 @@ storage of trees.
 #include "tree.hh"
 #include <fstream>
 #include <cstdlib>
+#include "exception.hh"
+#include "global.hh"
 
 Tabber TABBER(1);	
 extern Tabber TABBER;
@@ -90,49 +92,58 @@ extern Tabber TABBER;
 static void error(const char * s, Tree t)
 {
 	//fprintf(stderr, "ERROR : %s (%p)\n", s, t);
-	cerr << "ERROR : " << s << " : " << *t << endl;
+	gGlobal->gErrors << "ERROR : " << s << " : " << *t << endl;
 }
 
-#define ERROR(s,t) { error(s,t); exit(1); }
+#define ERROR(s,t) { error(s,t); throw faustexception(); }
 
 
 Tree CTree::gHashTable[kHashTableSize];
+THREAD_LOCAL TreeSpace* CTree::gSpace = 0;
 bool CTree::gDetails = false;
-unsigned int  CTree::gVisitTime = 0;
+unsigned int  CTree::gSerialCounter = 0;
 
-// Constructor : add the tree to the hash table
+// Constructor : add the tree to the hash table of the current space, or to the shared one
 CTree::CTree (unsigned int hk, const Node& n, const tvec& br) 
 	:	fNode(n), 
 		fType(0),
 		fHashKey(hk), 
 	 	fAperture(calcTreeAperture(n,br)), 
-        fVisitTime(0),
+        fSerial(gSpace ? gSpace->fSerialCounter++ : gSerialCounter++),
+		fShared(gSpace == 0),
 		fBranch(br) 
 { 
 	// link dans la hash table
+	Tree* table = gSpace ? gSpace->fHashTable : gHashTable;
    	int j = hk % kHashTableSize;
-	fNext = gHashTable[j];
-	gHashTable[j] = this;
+	fNext = table[j];
+	table[j] = this;
 
 }
 
-// Destructor : remove the tree form the hash table
+// Destructor : the trees of a space are deleted all together, no need to unlink them
 CTree::~CTree () 
 {
-	int		i = fHashKey % kHashTableSize;
-	Tree	t = gHashTable[i];
-	
-	//printf("Delete of "); this->print(); printf("\n");
-	if (t == this) {
-		gHashTable[i] = fNext;
-	} else {
-		Tree p;
-		while (t != this) {
-			p = t;
-			t = t->fNext;
+}
+
+// The serial numbers of the trees of a space follow the ones of the shared trees
+TreeSpace::TreeSpace ()
+	:	fHashTable((Tree*)calloc(CTree::kHashTableSize, sizeof(Tree))),
+		fSerialCounter(CTree::gSerialCounter)
+{
+}
+
+TreeSpace::~TreeSpace ()
+{
+	for (int i = 0; i < CTree::kHashTableSize; i++) {
+		Tree t = fHashTable[i];
+		while (t) {
+			Tree n = t->fNext;
+			delete t;
+			t = n;
 		}
-		p->fNext = fNext;
 	}
+	free(fHashTable);
 }
 
 // equivalence 
@@ -166,16 +177,11 @@ Tree CTree::make(const Node& n, int ar, Tree* tbl)
 	
 	for (int i=0; i<ar; i++)  br[i] = tbl[i];
 	
-	unsigned int 	hk  = calcTreeHash(n, br);
-	Tree	t = gHashTable[hk % kHashTableSize];
-	
-	while (t && !t->equiv(n, br)) {
-		t = t->fNext;
-	}
-	return (t) ? t : new CTree(hk, n, br);
+	return make(n, br);
 }
 
 
+// the shared trees are searched first, then the ones of the current space
 Tree CTree::make(const Node& n, const tvec& br)
 {
 	unsigned int 	hk  = calcTreeHash(n, br);
@@ -184,6 +190,12 @@ Tree CTree::make(const Node& n, const tvec& br)
 	while (t && !t->equiv(n, br)) {
 		t = t->fNext;
 	}
+	if (!t && gSpace) {
+		t = gSpace->fHashTable[hk % kHashTableSize];
+		while (t && !t->equiv(n, br)) {
+			t = t->fNext;
+		}
+	}
 	return (t) ? t : new CTree(hk, n, br);
 }
 
@@ -226,6 +238,36 @@ void CTree::control ()
 
 }
 
+// the type of a shared tree in the current space, or the one given outside of the spaces
+void* CTree::getSharedType ()
+{
+	map<Tree, void*>::iterator i = gSpace->fSharedTypes.find(this);
+	return (i == gSpace->fSharedTypes.end()) ? fType : i->second;
+}
+
+// a property of a shared tree in the current space, or the one given outside of the spaces
+Tree CTree::getSharedProperty (Tree key)
+{
+	map<Tree, plist>::iterator i = gSpace->fSharedProperties.find(this);
+	if (i != gSpace->fSharedProperties.end()) {
+		plist::iterator j = i->second.find(key);
+		if (j != i->second.end()) return j->second;
+	}
+	plist::iterator j = fProperties.find(key);
+	return (j == fProperties.end()) ? 0 : j->second;
+}
+
+void CTree::clearProperties ()
+{
+	if (fShared && gSpace) {
+		plist& props = gSpace->fSharedProperties[this];
+		props.clear();
+		for (plist::iterator i = fProperties.begin(); i != fProperties.end(); i++) props[i->first] = 0;
+	} else {
+		fProperties = plist();
+	}
+}
+
 // if t has a node of type int, return it otherwise error
 int tree2int (Tree t)
 {
@@ -387,6 +429,15 @@ void* getUserData(Tree t)
 
 void CTree::exportProperties(vector<Tree>& keys, vector<Tree>& values)
 {
+    if (fShared && gSpace) {
+        plist props = fProperties;
+        plist& local = gSpace->fSharedProperties[this];
+        for (plist::const_iterator p = local.begin(); p != local.end(); p++) props[p->first] = p->second;
+        for (plist::const_iterator p = props.begin(); p != props.end(); p++) {
+            if (p->second) { keys.push_back(p->first); values.push_back(p->second); }
+        }
+        return;
+    }
     for (plist::const_iterator p = fProperties.begin(); p != fProperties.end(); p++) {
         keys.push_back(p->first);
         values.push_back(p->second);
@@ -77,6 +77,7 @@
 
 #include "symbol.hh"
 #include "node.hh"
+#include "compatibility.hh"
 #include <vector>
 #include <map>
 #include <assert.h>
@@ -89,6 +90,28 @@ typedef CTree* Tree;
 typedef map<Tree, Tree>	plist;
 typedef vector<Tree>	tvec;
 
+/**
+ * The trees made by one compilation. While a space is current in a thread
+ * (see CTree::setSpace), the new trees made by this thread go to the hash
+ * table of the space, and they are deleted with it. The trees made outside
+ * of the spaces (at static initialization) are shared by all of them and
+ * are left unchanged : the properties and types given to them in a space
+ * are kept by the space.
+ */
+class TreeSpace
+{
+	Tree*				fHashTable;			///< hash table of the trees of the space
+	unsigned int		fSerialCounter;		///< creation number of the next tree of the space
+	map<Tree, plist>	fSharedProperties;	///< properties of the shared trees, 0 for a cleared one
+	map<Tree, void*>	fSharedTypes;		///< types of the shared trees
+
+	friend class CTree;
+
+ public:
+	TreeSpace();
+	~TreeSpace();							///< deletes the trees of the space
+};
+
 /**
  * A CTree = (Node x [CTree]) is a Node associated with a list of subtrees called branches.
  * A CTree = (Node x [CTree]) is the association of a content Node and a list of subtrees
@@ -103,18 +126,20 @@ typedef vector<Tree>	tvec;
  * a deBruijn representation and progressively build a classical representation such that
  * alpha-equivalent recursive CTrees are necesseraly identical (and therefore shared).
  *
- * WARNING : in the current implementation CTrees are allocated but never deleted
+ * The CTrees made during a compilation are deleted at its end with their TreeSpace, the
+ * other ones are never deleted.
  **/
 
 class CTree
 {
  private:
 	static const int 	kHashTableSize = 2000000; //510511;	///< size of the hash table used for "hash consing"
-	static Tree			gHashTable[kHashTableSize];	///< hash table used for "hash consing"
+	static Tree			gHashTable[kHashTableSize];	///< hash table used for "hash consing" of the shared trees
+	static THREAD_LOCAL TreeSpace* gSpace;			///< the space of the trees made by the thread, 0 outside of the compilations
 
  public:
 	static bool			gDetails;					///< Ctree::print() print with more details when true
-    static unsigned int gVisitTime;                 ///< Should be incremented for each new visit to keep track of visited tree.
+    static unsigned int gSerialCounter;             ///< number of shared trees created so far
 
  private:
 	// fields
@@ -124,18 +149,19 @@ class CTree
     plist           fProperties;		///< the properties list attached to the tree
     unsigned int	fHashKey;			///< the hashtable key
     int             fAperture;			///< how "open" is a tree (synthezised field)
-    unsigned int	fVisitTime;			///< keep track of visits
+    unsigned int	fSerial;			///< creation number of the tree, dense index for side tables (see denseproperty)
+    bool			fShared;			///< made outside of the tree spaces
     tvec            fBranch;			///< the subtrees
 
 	CTree (unsigned int hk, const Node& n, const tvec& br); 						///< construction is private, uses tree::make instead
+	~CTree ();																	///< destruction is private, only done by the TreeSpace
+	friend class TreeSpace;
 
 	bool 		equiv 				(const Node& n, const tvec& br) const;	///< used to check if an equivalent tree already exists
 	static unsigned int	calcTreeHash 		(const Node& n, const tvec& br);		///< compute the hash key of a tree according to its node and branches
 	static int	calcTreeAperture 	(const Node& n, const tvec& br);		///< compute how open is a tree
 
  public:
-	~CTree ();
-
 	static Tree make (const Node& n, int ar, Tree br[]);		///< return a new tree or an existing equivalent one
 	static Tree make(const Node& n, const tvec& br);			///< return a new tree or an existing equivalent one
 
@@ -145,6 +171,7 @@ class CTree
     Tree 		branch(int i) const	{ return fBranch[i];	}	///< return the ith branch (subtree) of a tree
     const tvec& branches() const	{ return fBranch;	}       ///< return all branches (subtrees) of a tree
     unsigned int 		hashkey() const		{ return fHashKey; 		}	///< return the hashkey of the tree
+    unsigned int 		serial() const		{ return fSerial; 		}	///< return the creation number of the tree
  	int 		aperture() const	{ return fAperture; 	}	///< return how "open" is a tree in terms of free variables
  	void 		setAperture(int a) 	{ fAperture=a; 			}	///< modify the aperture of a tree
 
@@ -152,25 +179,22 @@ class CTree
 	// Print a tree and the hash table (for debugging purposes)
 	ostream& 	print (ostream& fout) const; 					///< print recursively the content of a tree on a stream
 	static void control ();										///< print the hash table content (for debug purpose)
+	static void setSpace (TreeSpace* s)	{ gSpace = s; }			///< the space of the next trees made by the thread, 0 for none
 
-	// type information
-	void		setType(void* t) 	{ fType = t; }
-	void*		getType() 			{ return fType; }
+	// type information (the ones of the shared trees are kept by the current space)
+	void		setType(void* t) 	{ if (fShared && gSpace) gSpace->fSharedTypes[this] = t; else fType = t; }
+	void*		getType() 			{ return (fShared && gSpace) ? getSharedType() : fType; }
 	
-    // Keep track of visited trees (WARNING : non reentrant)
-    static void     startNewVisit()                 { ++gVisitTime; }
-    bool            isAlreadyVisited()              { return fVisitTime==gVisitTime; }
-    void            setVisited()                    { /*assert(fVisitTime!=gVisitTime);*/ fVisitTime=gVisitTime; }
-
 
-	// Property list of a tree
-	void		setProperty(Tree key, Tree value) { fProperties[key] = value; }
-	void		clearProperty(Tree key) { fProperties.erase(key); }
-	void		clearProperties()		{ fProperties = plist(); }
+	// Property list of a tree (the ones of the shared trees are kept by the current space)
+	void		setProperty(Tree key, Tree value) { if (fShared && gSpace) gSpace->fSharedProperties[this][key] = value; else fProperties[key] = value; }
+	void		clearProperty(Tree key) { if (fShared && gSpace) gSpace->fSharedProperties[this][key] = 0; else fProperties.erase(key); }
+	void		clearProperties();
 
 	void		exportProperties(vector<Tree>& keys, vector<Tree>& values);
 
 	Tree		getProperty(Tree key) {
+		if (fShared && gSpace) return getSharedProperty(key);
 		plist::iterator i = fProperties.find(key);
 		if (i==fProperties.end()) {
 			return 0;
@@ -178,6 +202,10 @@ class CTree
 			return i->second;
 		}
 	}
+
+ private:
+	void*		getSharedType();
+	Tree		getSharedProperty(Tree key);
 };
 
 //---------------------------------API---------------------------------------
@@ -232,6 +260,12 @@ Tree ref(Tree id);							///< create a symbolic recursive reference
 bool isRef(Tree t, int& level);				///< is t a de Bruijn recursive reference
 bool isRef(Tree t, Tree& id);				///< is t a symbolic recursive reference
 
+// name of the definition a signal comes from, kept by lift, deBruijn2Sym and simplify
+
+void setDefinitionName(Tree t, Tree name);
+bool getDefinitionName(Tree t, Tree& name);	///< false if t has no name
+Tree keepDefinitionName(Tree t, Tree t2);	///< t2, rebuilt from t, gets the name of t unless it has one
+
 
 // Open vs Closed regarding de Bruijn references
 
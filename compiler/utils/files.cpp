@@ -24,71 +24,30 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #ifndef WIN32
 #include <unistd.h>
 #endif
 #include <errno.h>
+#include "exception.hh"
+#include "global.hh"
 
 using namespace std;
 
-static string gCurrentDir;			///< Room to save current directory name.
-
-/**
- *Switch back to the previously stored current directory
- */
- 
-int	cholddir()
-{
-    if (chdir(gCurrentDir.c_str()) == 0) {
-		return 0;
-	} else {
-		perror("cholddir");
-		exit(errno);
-	}
-}
-
 /**
- * Create a new directory in the current one to store the diagrams.
- * The current directory is saved to be later restored.
+ * Create a new directory, if it doesn't exist yet. The files are then
+ * written with their paths : the current directory of the process is
+ * never changed, the compiler being also used as a library.
  */
  
-int mkchdir(string dirname)
-{
-    char buffer[FAUST_PATH_MAX];
-	gCurrentDir = getcwd(buffer, FAUST_PATH_MAX);
-   
-	if (gCurrentDir.c_str() != 0) {
-		int status = mkdir(dirname.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
-		if (status == 0 || errno == EEXIST) {
-			if (chdir(dirname.c_str()) == 0) {
-				return 0;
-			}
-		}
-	}
-	perror("mkchdir");
-	exit(errno);
-}
-
 int	makedir(string dirname)
 {
-    char buffer[FAUST_PATH_MAX];
-	gCurrentDir = getcwd(buffer, FAUST_PATH_MAX);
-  
-	if (gCurrentDir.c_str() != 0) {
-		int status = mkdir(dirname.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
-		if (status == 0 || errno == EEXIST) {
-			return 0;
-		}
+	int status = mkdir(dirname.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+	if (status == 0 || errno == EEXIST) {
+		return 0;
 	}
-	perror("makedir");
-	exit(errno);
+	gGlobal->gErrors << "makedir: " << strerror(errno) << endl;
+	throw faustexception(errno);
 }
-
-void getCurrentDir()
-{
-    char buffer[FAUST_PATH_MAX];
-    gCurrentDir = getcwd(buffer, FAUST_PATH_MAX);
-}
-
@@ -24,9 +24,6 @@
 
 #include <string>
 
-int	cholddir();
-int mkchdir(std::string dirname);
 int	makedir(std::string dirname);
-void getCurrentDir();
 
 #endif
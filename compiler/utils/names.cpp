@@ -33,6 +33,7 @@
 #include "ppsig.hh"
 #include "doc_Text.hh"
 #include "Text.hh"
+#include "global.hh"
 #include <assert.h>
 
 
@@ -40,9 +41,6 @@
 // 2009/09/08 : get/setDefNameProperty
 
 
-extern int gMaxNameSize;
-
-
 /**
  * Definition name property : a property to keep track of the definition name
  * of an expression. Whenever an identifier is evaluated, it is attached as a
@@ -61,7 +59,7 @@ void setDefNameProperty(Tree t, const string& name)
 {
 	//cerr << "setDefNameProperty : " << name << " FOR " << t << "#" << boxpp(t) << endl;
 	int		n = (int)name.size();
-	int 	m = (gMaxNameSize>1023) ? 1023 : gMaxNameSize;
+	int 	m = (gGlobal->gMaxNameSize>1023) ? 1023 : gGlobal->gMaxNameSize;
 	if (n > m) {
 		// the name is too long we reduce it to 2/3 of maxsize
 		char 	buf[1024];